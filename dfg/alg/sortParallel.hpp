@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(alg) {
+
+    /*
+     * Stable sort that splits random access range [iterBegin, iterEnd[ into consecutive chunks that are sorted in separate threads
+     * after which the chunks are merged pairwise (merges on the same level are also done in parallel).
+     * Result is identical to std::stable_sort(iterBegin, iterEnd, pred).
+     *
+     * If nMaxThreadCount is 0, sorting is done in thread::defaultThreadPool(), otherwise in nMaxThreadCount dedicated threads.
+     * Ranges smaller than 2 * nMinItemsPerThread are sorted in the calling thread.
+     * Time: O(n log n / T + n log T) with T threads.
+     * Space: as std::stable_sort and std::inplace_merge, i.e. O(n) temporary buffer if available.
+     */
+    template <class Iter_T, class Pred_T>
+    void stableSortParallel(const Iter_T iterBegin, const Iter_T iterEnd, Pred_T pred, size_t nMaxThreadCount = 0, const size_t nMinItemsPerThread = 100000)
+    {
+        const auto nSize = static_cast<size_t>(std::distance(iterBegin, iterEnd));
+        const bool bUsePool = (nMaxThreadCount == 0);
+        if (bUsePool)
+            nMaxThreadCount = DFG_MODULE_NS(thread)::defaultThreadPool().threadCount();
+        const size_t nChunkCount = Max(size_t(1), Min(nMaxThreadCount, nSize / Max(size_t(1), nMinItemsPerThread)));
+        if (nChunkCount <= 1)
+        {
+            std::stable_sort(iterBegin, iterEnd, pred);
+            return;
+        }
+
+        // Chunk boundaries: chunk i is [bounds[i], bounds[i + 1][.
+        std::vector<size_t> bounds(nChunkCount + 1);
+        for (size_t i = 0; i <= nChunkCount; ++i)
+            bounds[i] = i * nSize / nChunkCount;
+
+        const auto runInParallel = [bUsePool](const size_t nTaskCount, const std::function<void (size_t)>& func)
+        {
+            if (bUsePool)
+            {
+                DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nTaskCount, 1, [&](const size_t i0, const size_t i1)
+                {
+                    for (size_t i = i0; i < i1; ++i)
+                        func(i);
+                });
+                return;
+            }
+            std::vector<std::thread> threads;
+            threads.reserve(nTaskCount - 1);
+            for (size_t i = 1; i < nTaskCount; ++i)
+                threads.push_back(std::thread(func, i));
+            func(0);
+            for (auto& thread : threads)
+                thread.join();
+        };
+
+        runInParallel(nChunkCount, [&](const size_t i)
+        {
+            std::stable_sort(iterBegin + bounds[i], iterBegin + bounds[i + 1], pred);
+        });
+
+        // Merging adjacent chunks pairwise until only one is left; left chunk precedes right chunk so stability is preserved.
+        while (bounds.size() > 2)
+        {
+            const size_t nMergeCount = (bounds.size() - 1) / 2;
+            runInParallel(nMergeCount, [&](const size_t i)
+            {
+                std::inplace_merge(iterBegin + bounds[2 * i], iterBegin + bounds[2 * i + 1], iterBegin + bounds[2 * i + 2], pred);
+            });
+            std::vector<size_t> newBounds;
+            newBounds.reserve(nMergeCount + 2);
+            for (size_t i = 0; i < bounds.size(); i += 2)
+                newBounds.push_back(bounds[i]);
+            if (newBounds.back() != bounds.back())
+                newBounds.push_back(bounds.back());
+            bounds.swap(newBounds);
+        }
+    }
+
+    template <class Iter_T>
+    void stableSortParallel(const Iter_T iterBegin, const Iter_T iterEnd)
+    {
+        typedef typename std::iterator_traits<Iter_T>::value_type ValueT;
+        stableSortParallel(iterBegin, iterEnd, [](const ValueT& a, const ValueT& b) { return a < b; });
+    }
+
+}} // module namespace
@@ -6,4 +6,5 @@
 #include "alg/generateAdjacent.hpp"
 #include "alg/rank.hpp"
 #include "alg/sortMultiple.hpp"
+#include "alg/sortParallel.hpp"
 #include "alg/sortSingleItem.hpp"
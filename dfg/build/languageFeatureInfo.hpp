@@ -130,4 +130,9 @@ Notes:
     #define DFG_LANGFEAT_HAS_DEFAULTED_AND_DELETED_FUNCTIONS 0
 #endif
 
-
+// DFG_LANGFEAT_THREAD_LOCAL (availability of thread_local storage class specifier)
+#if (defined(_MSC_VER) && (_MSC_VER < DFG_MSVC_VER_2015)) || (defined(__GNUC__) && !defined(__clang__) && (__GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 8)))
+    #define DFG_LANGFEAT_THREAD_LOCAL 0
+#else
+    #define DFG_LANGFEAT_THREAD_LOCAL 1
+#endif
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../numericTypeTools.hpp"
+#include "../os/TemporaryFileStream.hpp"
+#include "../io/BasicIfStream.hpp"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    // Memory budget that can be shared between multiple CellBlockJournal's, e.g. all undo commands of a single undo stack.
+    // Thread safe.
+    class DFG_CLASS_NAME(CellBlockJournalMemoryBudget)
+    {
+    public:
+        DFG_CLASS_NAME(CellBlockJournalMemoryBudget)(const size_t nLimitInBytes) :
+            m_nLimit(nLimitInBytes),
+            m_nUsed(0)
+        {}
+
+        // Returns true if reservation succeeded in which case caller must later release() the same amount.
+        bool tryReserve(const size_t nBytes)
+        {
+            auto nUsed = m_nUsed.load();
+            do
+            {
+                if (nBytes > m_nLimit || nUsed > m_nLimit - nBytes)
+                    return false;
+            } while (!m_nUsed.compare_exchange_weak(nUsed, nUsed + nBytes));
+            return true;
+        }
+
+        void release(const size_t nBytes)
+        {
+            DFG_ASSERT_CORRECTNESS(m_nUsed.load() >= nBytes);
+            m_nUsed -= nBytes;
+        }
+
+        size_t limit() const { return m_nLimit; }
+        size_t used() const { return m_nUsed.load(); }
+
+    private:
+        const size_t m_nLimit;
+        std::atomic<size_t> m_nUsed;
+    }; // class CellBlockJournalMemoryBudget
+
+    // Append-only compact storage for cell content snapshots, e.g. for storing undo/redo data of big edits.
+    // Cells are stored as blocks of consecutive cells (either down a column or along a row) in a byte arena:
+    // each block has a single header (row, column, count, direction) followed by length-prefixed cell contents.
+    // If memory budget or in-memory limit gets exceeded, arena content is moved to a temporary file
+    // and read back in chunks when iterating.
+    // Null cells are stored separately from empty strings.
+    template <class Index_T = int>
+    class DFG_CLASS_NAME(CellBlockJournal)
+    {
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(CellBlockJournal));
+    public:
+        typedef DFG_CLASS_NAME(CellBlockJournalMemoryBudget) MemoryBudget;
+
+        // spBudget: if given, in-memory data is reserved from budget and when reservation fails, data is spilled to temporary file.
+        // nMaxInMemoryBytes: maximum size of in-memory arena after which data is spilled to temporary file.
+        DFG_CLASS_NAME(CellBlockJournal)(std::shared_ptr<MemoryBudget> spBudget = nullptr, const size_t nMaxInMemoryBytes = NumericTraits<size_t>::maxValue) :
+            m_spBudget(std::move(spBudget)),
+            m_nMaxInMemoryBytes(nMaxInMemoryBytes),
+            m_nReservedFromBudget(0),
+            m_nCurrentBlockHeaderPos(s_nNoBlock),
+            m_nCellCount(0),
+            m_nBlockCount(0),
+            m_nSpilledByteCount(0),
+            m_bSpillFailed(false)
+        {}
+
+        ~DFG_CLASS_NAME(CellBlockJournal)()
+        {
+            releaseBudget();
+        }
+
+        // Adds cell with given content, nullptr means null cell.
+        void add(const Index_T nRow, const Index_T nCol, const char* psz, const size_t nLength)
+        {
+            if (!tryExtendCurrentBlock(nRow, nCol))
+                beginBlock(nRow, nCol);
+            // Content is stored as varint-encoded (length + 1) followed by bytes, 0 means null.
+            appendVarUint((psz) ? static_cast<uint64>(nLength) + 1 : 0);
+            if (psz)
+                m_arena.insert(m_arena.end(), psz, psz + nLength);
+            ++m_nCellCount;
+            onArenaGrowth();
+        }
+
+        void add(const Index_T nRow, const Index_T nCol, const char* psz)
+        {
+            add(nRow, nCol, psz, (psz) ? std::strlen(psz) : 0);
+        }
+
+        // Calls func(nRow, nCol, pszOrNull, nLength) for each cell in insertion order. pszOrNull is null-terminated.
+        // Returns false if spilled data could not be read back.
+        template <class Func_T>
+        bool forEachCell(Func_T&& func) const
+        {
+            std::string sBuffer;
+            if (!m_spilledSegmentSizes.empty())
+            {
+                // Making sure that everything written to temporary file is visible to the separate read handle.
+                auto& ostrm = m_spTempFile->stream();
+                ostrm.flush();
+                if (!ostrm.good())
+                    return false;
+                DFG_MODULE_NS(io)::DFG_CLASS_NAME(BasicIfStream) istrm(m_spTempFile->pathW().c_str());
+                std::vector<char> segment;
+                for (const auto nSegmentSize : m_spilledSegmentSizes)
+                {
+                    segment.resize(nSegmentSize);
+                    if (istrm.readBytes(segment.data(), nSegmentSize) != nSegmentSize)
+                        return false;
+                    forEachCellInArena(segment, sBuffer, func);
+                }
+            }
+            forEachCellInArena(m_arena, sBuffer, func);
+            return true;
+        }
+
+        size_t cellCount() const                { return m_nCellCount; }
+        size_t blockCount() const               { return m_nBlockCount; }
+        bool empty() const                      { return m_nCellCount == 0; }
+        size_t inMemoryByteCount() const        { return m_arena.capacity(); }
+        size_t spilledByteCount() const         { return m_nSpilledByteCount; }
+        bool hasSpilled() const                 { return m_nSpilledByteCount > 0; }
+        bool hasSpillFailed() const             { return m_bSpillFailed; }
+
+    private:
+        enum Direction
+        {
+            DirectionNone,  // Block has single cell.
+            DirectionDown,  // Block cells are (r, c), (r + 1, c), ...
+            DirectionRight  // Block cells are (r, c), (r, c + 1), ...
+        };
+
+        struct BlockHeader
+        {
+            Index_T m_nRow;
+            Index_T m_nCol;
+            Index_T m_nCount;
+            uint8 m_direction;
+        };
+
+        static const size_t s_nNoBlock = size_t(-1);
+        static const size_t s_nHeaderSize = 3 * sizeof(Index_T) + 1;
+        static const size_t s_nMinSpillSize = 65536;
+
+        bool tryExtendCurrentBlock(const Index_T nRow, const Index_T nCol)
+        {
+            if (m_nCurrentBlockHeaderPos == s_nNoBlock || m_currentBlock.m_nCount >= NumericTraits<Index_T>::maxValue)
+                return false;
+            auto& hdr = m_currentBlock;
+            const auto nLast = hdr.m_nCount - 1;
+            Direction dir = static_cast<Direction>(hdr.m_direction);
+            if (dir == DirectionNone)
+            {
+                if (nCol == hdr.m_nCol && nRow == hdr.m_nRow + 1)
+                    dir = DirectionDown;
+                else if (nRow == hdr.m_nRow && nCol == hdr.m_nCol + 1)
+                    dir = DirectionRight;
+                else
+                    return false;
+            }
+            else if (dir == DirectionDown && !(nCol == hdr.m_nCol && nRow == hdr.m_nRow + nLast + 1))
+                return false;
+            else if (dir == DirectionRight && !(nRow == hdr.m_nRow && nCol == hdr.m_nCol + nLast + 1))
+                return false;
+            hdr.m_direction = static_cast<uint8>(dir);
+            ++hdr.m_nCount;
+            writeHeader(m_nCurrentBlockHeaderPos, hdr);
+            return true;
+        }
+
+        void beginBlock(const Index_T nRow, const Index_T nCol)
+        {
+            m_currentBlock.m_nRow = nRow;
+            m_currentBlock.m_nCol = nCol;
+            m_currentBlock.m_nCount = 1;
+            m_currentBlock.m_direction = DirectionNone;
+            m_nCurrentBlockHeaderPos = m_arena.size();
+            m_arena.resize(m_arena.size() + s_nHeaderSize);
+            writeHeader(m_nCurrentBlockHeaderPos, m_currentBlock);
+            ++m_nBlockCount;
+        }
+
+        void writeHeader(const size_t nPos, const BlockHeader& hdr)
+        {
+            char* p = &m_arena[nPos];
+            std::memcpy(p, &hdr.m_nRow, sizeof(Index_T));
+            std::memcpy(p + sizeof(Index_T), &hdr.m_nCol, sizeof(Index_T));
+            std::memcpy(p + 2 * sizeof(Index_T), &hdr.m_nCount, sizeof(Index_T));
+            p[3 * sizeof(Index_T)] = static_cast<char>(hdr.m_direction);
+        }
+
+        static BlockHeader readHeader(const char* p)
+        {
+            BlockHeader hdr;
+            std::memcpy(&hdr.m_nRow, p, sizeof(Index_T));
+            std::memcpy(&hdr.m_nCol, p + sizeof(Index_T), sizeof(Index_T));
+            std::memcpy(&hdr.m_nCount, p + 2 * sizeof(Index_T), sizeof(Index_T));
+            hdr.m_direction = static_cast<uint8>(p[3 * sizeof(Index_T)]);
+            return hdr;
+        }
+
+        void appendVarUint(uint64 val)
+        {
+            while (val >= 0x80)
+            {
+                m_arena.push_back(static_cast<char>((val & 0x7F) | 0x80));
+                val >>= 7;
+            }
+            m_arena.push_back(static_cast<char>(val));
+        }
+
+        static uint64 readVarUint(const char*& p)
+        {
+            uint64 val = 0;
+            int nShift = 0;
+            for (;;)
+            {
+                const auto byte = static_cast<unsigned char>(*p++);
+                val |= static_cast<uint64>(byte & 0x7F) << nShift;
+                if ((byte & 0x80) == 0)
+                    break;
+                nShift += 7;
+            }
+            return val;
+        }
+
+        template <class Func_T>
+        static void forEachCellInArena(const std::vector<char>& arena, std::string& sBuffer, Func_T& func)
+        {
+            const char* p = arena.data();
+            const char* const pEnd = p + arena.size();
+            while (p < pEnd)
+            {
+                const auto hdr = readHeader(p);
+                p += s_nHeaderSize;
+                for (Index_T i = 0; i < hdr.m_nCount; ++i)
+                {
+                    const Index_T r = (hdr.m_direction == DirectionDown) ? hdr.m_nRow + i : hdr.m_nRow;
+                    const Index_T c = (hdr.m_direction == DirectionRight) ? hdr.m_nCol + i : hdr.m_nCol;
+                    const auto nLengthPlusOne = readVarUint(p);
+                    if (nLengthPlusOne == 0)
+                    {
+                        func(r, c, static_cast<const char*>(nullptr), size_t(0));
+                        continue;
+                    }
+                    const auto nLength = static_cast<size_t>(nLengthPlusOne - 1);
+                    sBuffer.assign(p, nLength); // Copying to get null-terminated string.
+                    p += nLength;
+                    func(r, c, sBuffer.c_str(), nLength);
+                }
+            }
+        }
+
+        void onArenaGrowth()
+        {
+            const auto nCapacity = m_arena.capacity();
+            bool bSpill = (nCapacity > m_nMaxInMemoryBytes);
+            if (!bSpill && m_spBudget && nCapacity > m_nReservedFromBudget)
+            {
+                const auto nNeeded = nCapacity - m_nReservedFromBudget;
+                if (m_spBudget->tryReserve(nNeeded))
+                    m_nReservedFromBudget += nNeeded;
+                else
+                    bSpill = (m_arena.size() >= s_nMinSpillSize); // To avoid tiny spill segments, small amount of memory may be used beyond budget.
+            }
+            if (bSpill)
+                spill();
+        }
+
+        void spill()
+        {
+            if (m_bSpillFailed)
+                return; // Keeping everything in memory if temporary file can't be used.
+            if (!m_spTempFile)
+            {
+                m_spTempFile.reset(new DFG_MODULE_NS(os)::DFG_CLASS_NAME(TemporaryFileStream)(nullptr, "dfgCellBlockJournal_", nullptr, "tmp"));
+                if (!m_spTempFile->isOpen())
+                {
+                    m_bSpillFailed = true;
+                    m_spTempFile.reset();
+                    return;
+                }
+            }
+            auto& strm = m_spTempFile->stream();
+            strm.write(m_arena.data(), static_cast<std::streamsize>(m_arena.size()));
+            strm.flush();
+            if (!strm.good())
+            {
+                m_bSpillFailed = true;
+                return;
+            }
+            m_spilledSegmentSizes.push_back(m_arena.size());
+            m_nSpilledByteCount += m_arena.size();
+            std::vector<char>().swap(m_arena);
+            m_nCurrentBlockHeaderPos = s_nNoBlock; // Next cell starts a new block.
+            releaseBudget();
+        }
+
+        void releaseBudget()
+        {
+            if (m_spBudget && m_nReservedFromBudget > 0)
+                m_spBudget->release(m_nReservedFromBudget);
+            m_nReservedFromBudget = 0;
+        }
+
+        std::shared_ptr<MemoryBudget> m_spBudget;
+        size_t m_nMaxInMemoryBytes;
+        size_t m_nReservedFromBudget;
+        std::vector<char> m_arena;
+        BlockHeader m_currentBlock;
+        size_t m_nCurrentBlockHeaderPos;
+        size_t m_nCellCount;
+        size_t m_nBlockCount;
+        size_t m_nSpilledByteCount;
+        std::vector<size_t> m_spilledSegmentSizes;
+        std::unique_ptr<DFG_MODULE_NS(os)::DFG_CLASS_NAME(TemporaryFileStream)> m_spTempFile;
+        bool m_bSpillFailed;
+    }; // class CellBlockJournal
+
+}} // module namespace
@@ -10,6 +10,9 @@
 #include "../io/OfStream.hpp"
 #include "../io/DelimitedTextWriter.hpp"
 #include "Vector.hpp"
+#include <iterator>
+#include <utility>
+#include <vector>
 
 DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
 
@@ -92,13 +95,15 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
             const size_t notFoundCol = DFG_ROOT_NS::NumericTraits<size_t>::maxValue;
             size_t nFirstNonEmptyCol = notFoundCol;
             bool bMostRecentRowHadKeyButNoValue = false;
+            // Collecting items first and inserting them with a single bulk insert instead of sorted insert per item.
+            std::vector<std::pair<StorageStringT, StorageStringT>> loadedItems;
             DelimReader::readFromFile(ReadOnlySzParamC(svConfFilePath.c_str()), cd, [&](const size_t /*nRow*/, const size_t nCol, decltype(cd)& cellData)
             {
                 typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(CsvConfig)::StorageStringT StorageStringT_vc2010_workaround;
                 if (nCol == 0)
                 {
                     if (bMostRecentRowHadKeyButNoValue)
-                        m_mapKeyToValue[baseUri.str()] = DFG_UTF8("");
+                        loadedItems.push_back(std::make_pair(baseUri.str(), StorageStringT_vc2010_workaround(DFG_UTF8(""))));
                     nFirstNonEmptyCol = notFoundCol;
                     bMostRecentRowHadKeyButNoValue = false;
                 }
@@ -109,7 +114,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
                     bMostRecentRowHadKeyButNoValue = false;
                     cellData.setReadStatus(DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextReader)::cellHrvSkipRestOfLine);
                     const auto& buffer = cellData.getBuffer();
-                    m_mapKeyToValue[baseUri.str()] = StorageStringT_vc2010_workaround(SzPtrUtf8(buffer.data()), SzPtrUtf8(buffer.data() + buffer.size()));
+                    loadedItems.push_back(std::make_pair(baseUri.str(), StorageStringT_vc2010_workaround(SzPtrUtf8(buffer.data()), SzPtrUtf8(buffer.data() + buffer.size()))));
                     return;
                 }
 
@@ -123,7 +128,8 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
                 }
             });
             if (bMostRecentRowHadKeyButNoValue)
-                m_mapKeyToValue[baseUri.str()] = DFG_UTF8("");
+                loadedItems.push_back(std::make_pair(baseUri.str(), StorageStringT(DFG_UTF8(""))));
+            m_mapKeyToValue.insertRange(std::make_move_iterator(loadedItems.begin()), std::make_move_iterator(loadedItems.end()), decltype(m_mapKeyToValue)::DuplicatePolicyKeepLast);
         }
 
         StorageStringT value(const StringViewT& svUri, const StringViewT& svDefault = StringViewT()) const
@@ -0,0 +1,210 @@
+#pragma once
+
+/*
+CsvConfigCompiled.hpp
+
+Read-optimized ("compiled") form of CsvConfig for configuration values that are read on hot paths.
+    -CsvConfigKeySet: interns known URIs to integer handles once, typically at startup.
+    -CsvConfigCompiled: immutable snapshot of CsvConfig. Values are interned (equal values are stored once) and can be looked up
+     either by handle (array access) or by URI (single open-addressing hash lookup). Neither lookup allocates.
+    -CsvConfigCompiledHolder: publishes snapshots through ViewableSharedPtrReadMostly so that configuration can be reloaded
+     while readers are using it: reload builds a new snapshot and swaps it in atomically, readers see either the old or the new snapshot as a whole.
+
+Example:
+    CsvConfigKeySet keys;
+    const auto hEncoding = keys.addKey(DFG_UTF8("encoding"));
+    CsvConfigCompiledHolder holder(keys);
+    holder.reloadFromFile("file.csv.conf");
+    auto spViewer = holder.createViewer();
+    ...
+    const auto& spConfig = spViewer->viewCached(); // Wait-free when config hasn't been reloaded.
+    auto p = (spConfig) ? spConfig->valueStrOrNull(hEncoding) : nullptr;
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../build/languageFeatureInfo.hpp"
+#include "CsvConfig.hpp"
+#include "FlatHashMap.hpp"
+#include "ViewableSharedPtr.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    typedef uint32 CsvConfigKeyHandle;
+
+    // Maps URIs to integer handles. Handles are consecutive starting from 0 and stay valid for the lifetime of the key set.
+    // Note: Not thread safe; keys are expected to be added before compiling snapshots.
+    class DFG_CLASS_NAME(CsvConfigKeySet)
+    {
+    public:
+        typedef DFG_CLASS_NAME(CsvConfig)::StringViewT StringViewT;
+
+        static const CsvConfigKeyHandle s_invalidHandle = CsvConfigKeyHandle(-1);
+
+        // Returns handle for given URI adding it if not already present.
+        CsvConfigKeyHandle addKey(const StringViewT& svUri)
+        {
+            const DFG_CLASS_NAME(StringViewC) svRaw = svUri;
+            auto iter = m_keyToHandle.find(svRaw);
+            if (iter != m_keyToHandle.end())
+                return iter->second;
+            const auto h = static_cast<CsvConfigKeyHandle>(m_keys.size());
+            m_keys.push_back(svRaw.toString());
+            m_keyToHandle.insert(m_keys.back(), h);
+            return h;
+        }
+
+        // Returns handle of given URI or s_invalidHandle if not present.
+        CsvConfigKeyHandle handle(const StringViewT& svUri) const
+        {
+            auto iter = m_keyToHandle.find(DFG_CLASS_NAME(StringViewC)(svUri));
+            return (iter != m_keyToHandle.end()) ? iter->second : s_invalidHandle;
+        }
+
+        size_t size() const { return m_keys.size(); }
+
+        // Returns URI of given handle as raw UTF8.
+        const std::string& uriRaw(const CsvConfigKeyHandle h) const
+        {
+            DFG_ASSERT_UB(h < m_keys.size());
+            return m_keys[h];
+        }
+
+    private:
+        std::vector<std::string> m_keys;
+        DFG_CLASS_NAME(FlatHashMap)<std::string, CsvConfigKeyHandle> m_keyToHandle;
+    }; // class CsvConfigKeySet
+
+    // Immutable snapshot of CsvConfig optimized for lookups.
+    class DFG_CLASS_NAME(CsvConfigCompiled)
+    {
+    public:
+        typedef DFG_CLASS_NAME(CsvConfig)::StorageStringT StorageStringT;
+        typedef DFG_CLASS_NAME(CsvConfig)::StringViewT StringViewT;
+
+        DFG_CLASS_NAME(CsvConfigCompiled)()
+        {}
+
+        // Compiles config; handles of keySet are resolved to values of config. Keys added to keySet after this call are not available in this snapshot.
+        DFG_CLASS_NAME(CsvConfigCompiled)(const DFG_CLASS_NAME(CsvConfig)& config, const DFG_CLASS_NAME(CsvConfigKeySet)& keySet = DFG_CLASS_NAME(CsvConfigKeySet)())
+        {
+            DFG_CLASS_NAME(FlatHashMap)<std::string, uint32> valueToIndex;
+            m_uriToValueIndex.reserve(config.entryCount());
+            for (auto iter = config.m_mapKeyToValue.cbegin(), iterEnd = config.m_mapKeyToValue.cend(); iter != iterEnd; ++iter)
+            {
+                const auto& sValueRaw = iter->second.rawStorage();
+                auto iterValue = valueToIndex.find(sValueRaw);
+                uint32 nValueIndex;
+                if (iterValue != valueToIndex.end())
+                    nValueIndex = iterValue->second;
+                else
+                {
+                    nValueIndex = static_cast<uint32>(m_values.size());
+                    m_values.push_back(iter->second);
+                    valueToIndex.insert(sValueRaw, nValueIndex);
+                }
+                m_uriToValueIndex.insert(iter->first.rawStorage(), nValueIndex);
+            }
+
+            m_handleToValueIndex.assign(keySet.size(), static_cast<uint32>(s_nNoValue)); // static_cast to avoid odr-use of s_nNoValue.
+            for (size_t i = 0; i < keySet.size(); ++i)
+            {
+                auto iter = m_uriToValueIndex.find(keySet.uriRaw(static_cast<CsvConfigKeyHandle>(i)));
+                if (iter != m_uriToValueIndex.end())
+                    m_handleToValueIndex[i] = iter->second;
+            }
+        }
+
+        // Returns value of key handle or nullptr if config doesn't have the key. Cost is a single array access.
+        const StorageStringT* valueStrOrNull(const CsvConfigKeyHandle h) const
+        {
+            return (h < m_handleToValueIndex.size() && m_handleToValueIndex[h] != s_nNoValue) ? &m_values[m_handleToValueIndex[h]] : nullptr;
+        }
+
+        // Returns value of URI or nullptr if not found. Cost is a single hash lookup.
+        const StorageStringT* valueStrOrNull(const StringViewT& svUri) const
+        {
+            auto iter = m_uriToValueIndex.find(DFG_CLASS_NAME(StringViewC)(svUri));
+            return (iter != m_uriToValueIndex.end()) ? &m_values[iter->second] : nullptr;
+        }
+
+        template <class Key_T>
+        StorageStringT value(const Key_T& key, const StringViewT& svDefault = StringViewT()) const
+        {
+            auto p = valueStrOrNull(key);
+            return (p) ? *p : svDefault.toString();
+        }
+
+        size_t entryCount() const { return m_uriToValueIndex.size(); }
+
+        // Returns the number of distinct values.
+        size_t internedValueCount() const { return m_values.size(); }
+
+    private:
+        static const uint32 s_nNoValue = uint32(-1);
+
+        std::vector<StorageStringT> m_values;
+        DFG_CLASS_NAME(FlatHashMap)<std::string, uint32> m_uriToValueIndex;
+        std::vector<uint32> m_handleToValueIndex;
+    }; // class CsvConfigCompiled
+
+#if DFG_LANGFEAT_MUTEX_11
+
+    // Holds the current CsvConfigCompiled snapshot; reloading replaces the whole snapshot atomically while existing readers keep their snapshot alive.
+    class DFG_CLASS_NAME(CsvConfigCompiledHolder)
+    {
+    public:
+        typedef DFG_CLASS_NAME(ViewableSharedPtrReadMostly)<const DFG_CLASS_NAME(CsvConfigCompiled)> SharedPtrT;
+        typedef SharedPtrT::ViewerT ViewerT;
+
+        // Key set is copied: changes to keySet after construction are not reflected in snapshots.
+        DFG_CLASS_NAME(CsvConfigCompiledHolder)(DFG_CLASS_NAME(CsvConfigKeySet) keySet = DFG_CLASS_NAME(CsvConfigKeySet)()) :
+            m_keySet(std::move(keySet))
+        {}
+
+        const DFG_CLASS_NAME(CsvConfigKeySet)& keySet() const { return m_keySet; }
+
+        void reset(const DFG_CLASS_NAME(CsvConfig)& config)
+        {
+            m_spSnapshot.reset(std::make_shared<const DFG_CLASS_NAME(CsvConfigCompiled)>(config, m_keySet));
+        }
+
+        // Loads config from file and publishes it. Note that like CsvConfig::loadFromFile(), non-existent file results in an empty config.
+        void reloadFromFile(const DFG_CLASS_NAME(StringViewSzC)& svConfFilePath)
+        {
+            DFG_CLASS_NAME(CsvConfig) config;
+            config.loadFromFile(svConfFilePath);
+            reset(config);
+        }
+
+        // Returns current snapshot, may be empty if no config has been set.
+        std::shared_ptr<const DFG_CLASS_NAME(CsvConfigCompiled)> snapshot() const
+        {
+            return m_spSnapshot.m_spRouter->view();
+        }
+
+        // Creates viewer whose viewCached() is wait-free while snapshot doesn't change. Viewer is not thread safe, use one per thread.
+        std::shared_ptr<ViewerT> createViewer()
+        {
+            return m_spSnapshot.createViewer();
+        }
+
+        // Returns the number of snapshot changes.
+        SharedPtrT::RouterT::VersionT version() const
+        {
+            return m_spSnapshot.version();
+        }
+
+    private:
+        const DFG_CLASS_NAME(CsvConfigKeySet) m_keySet;
+        SharedPtrT m_spSnapshot;
+
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(CsvConfigCompiledHolder));
+    }; // class CsvConfigCompiledHolder
+
+#endif // DFG_LANGFEAT_MUTEX_11
+
+} } // Module namespace
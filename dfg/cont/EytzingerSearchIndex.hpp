@@ -0,0 +1,142 @@
+#pragma once
+
+/*
+EytzingerSearchIndex.hpp
+
+Read-only search structure for sorted keys where keys are stored in Eytzinger (BFS-order of implicit binary tree) layout:
+    -Lower bound search is branchless and prefetches descendants a few levels ahead so that for large key counts
+     search is no longer dominated by cache misses like plain std::lower_bound over sorted array.
+    -Stores a copy of keys and for each key its index in the original sorted sequence, so lookups map directly
+     to positions in the source container. Most beneficial with small trivially copyable keys such as integers.
+    -Source order is not modified: index is an auxiliary structure that must be rebuilt if source changes.
+
+Related reading:
+    -Khuong, Morin: "Array Layouts for Comparison-Based Searching" https://arxiv.org/abs/1509.05053
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include <iterator>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    namespace DFG_DETAIL_NS
+    {
+        // Returns number of trailing one-bits in n.
+        inline size_t countTrailingOnes(size_t n)
+        {
+            n = ~n;
+            if (n == 0)
+                return 8 * sizeof(size_t);
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>((sizeof(size_t) == sizeof(unsigned long long)) ? __builtin_ctzll(n) : __builtin_ctz(static_cast<unsigned int>(n)));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long nIndex;
+            _BitScanForward64(&nIndex, n);
+            return nIndex;
+#elif defined(_MSC_VER)
+            unsigned long nIndex;
+            _BitScanForward(&nIndex, static_cast<unsigned long>(n));
+            return nIndex;
+#else
+            size_t nCount = 0;
+            for (; (n & 1) == 0; n >>= 1)
+                ++nCount;
+            return nCount;
+#endif
+        }
+
+        inline void prefetchForRead(const void* p)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+            DFG_UNUSED(p);
+#endif
+        }
+    } // namespace DFG_DETAIL_NS
+
+    template <class Key_T>
+    class DFG_CLASS_NAME(EytzingerSearchIndex)
+    {
+    public:
+        typedef Key_T key_type;
+
+        DFG_CLASS_NAME(EytzingerSearchIndex)()
+        {}
+
+        // Builds index from sorted range [iterBegin, iterEnd[, keyProjection maps iterator value to key.
+        template <class Iter_T, class KeyProjection_T>
+        DFG_CLASS_NAME(EytzingerSearchIndex)(Iter_T iterBegin, Iter_T iterEnd, KeyProjection_T keyProjection)
+        {
+            build(iterBegin, iterEnd, keyProjection);
+        }
+
+        template <class Iter_T, class KeyProjection_T>
+        void build(const Iter_T iterBegin, const Iter_T iterEnd, KeyProjection_T keyProjection)
+        {
+            const auto nSize = static_cast<size_t>(std::distance(iterBegin, iterEnd));
+            m_keys.clear();
+            m_sortedIndexes.clear();
+            m_keys.reserve(nSize);
+            // Filling in BFS order: node k (1-based) has children 2k and 2k + 1; in-order traversal gives the sorted order.
+            std::vector<size_t> bfsToSorted(nSize);
+            size_t nSortedIndex = 0;
+            fillInOrder(bfsToSorted, nSortedIndex, 1);
+            // Collecting item addresses with a single pass so that non-random access iterators work efficiently as well.
+            std::vector<const typename std::iterator_traits<Iter_T>::value_type*> srcItems;
+            srcItems.reserve(nSize);
+            for (auto iter = iterBegin; iter != iterEnd; ++iter)
+                srcItems.push_back(&*iter);
+            for (size_t k = 0; k < nSize; ++k)
+                m_keys.push_back(keyProjection(*srcItems[bfsToSorted[k]]));
+            m_sortedIndexes = std::move(bfsToSorted);
+        }
+
+        size_t size() const { return m_keys.size(); }
+        bool empty() const  { return m_keys.empty(); }
+
+        // Returns index of the first key in source sequence that is not less than given key, or size() if there is no such key.
+        // Key comparison is done as 'storedKey < key' like in std::lower_bound.
+        template <class T>
+        size_t lowerBound(const T& key) const
+        {
+            const size_t nSize = m_keys.size();
+            const Key_T* const pKeys = m_keys.data();
+            const size_t nKeysPerCacheLine = (sizeof(Key_T) < 64) ? 64 / sizeof(Key_T) : 1;
+            // Prefetching position that is log2(nKeysPerCacheLine) levels below current node; those descendants are adjacent in memory.
+            size_t k = 1;
+            while (k <= nSize)
+            {
+                DFG_DETAIL_NS::prefetchForRead(pKeys + Min(nKeysPerCacheLine * k, nSize) - 1);
+                k = 2 * k + static_cast<size_t>(pKeys[k - 1] < key);
+            }
+            // Going up while last step was to the right, after which the parent is the lower bound node.
+            k >>= DFG_DETAIL_NS::countTrailingOnes(k) + 1;
+            return (k != 0) ? m_sortedIndexes[k - 1] : nSize;
+        }
+
+        const std::vector<Key_T>& keysInEytzingerOrder() const { return m_keys; }
+
+    private:
+        void fillInOrder(std::vector<size_t>& bfsToSorted, size_t& nSortedIndex, const size_t k)
+        {
+            if (k > bfsToSorted.size())
+                return;
+            fillInOrder(bfsToSorted, nSortedIndex, 2 * k);
+            bfsToSorted[k - 1] = nSortedIndex++;
+            fillInOrder(bfsToSorted, nSortedIndex, 2 * k + 1);
+        }
+
+        std::vector<Key_T> m_keys;            // Keys in Eytzinger order, i.e. m_keys[k - 1] is the key of 1-based node k.
+        std::vector<size_t> m_sortedIndexes;  // m_sortedIndexes[k - 1] is the index of m_keys[k - 1] in source sequence.
+    }; // class EytzingerSearchIndex
+
+}} // Module namespace
@@ -0,0 +1,582 @@
+#pragma once
+
+/*
+FlatHashMap.hpp
+
+Implements open-addressing hash map and set (FlatHashMap, FlatHashSet) with the following properties:
+    -Keys, values and one control byte per slot are stored in separate contiguous arrays (SoA).
+    -Slots are probed in groups of 16 control bytes; with SSE2 a whole group is matched with a few instructions, otherwise a scalar fallback is used.
+     Control byte stores 7 bits of hash for full slots so that keys are compared only for probable matches.
+    -Maximum load factor is 7/8. reserve(n) guarantees that inserting up to n items doesn't rehash provided that no items are erased in between.
+    -Any rehash invalidates all iterators and references. Erase invalidates only iterators to erased items.
+    -Iteration order is unspecified.
+    -Keys can be searched without constructing key_type like in MapVector (e.g. std::string keys with const char* or StringViewC).
+     This requires that the hash of search type equals to that of corresponding key; FlatHashDefaultHash provides this for std::string and StringView.
+    -key_type and mapped_type must be default constructible: empty slots hold default constructed objects.
+    -Interface follows MapVector where applicable (find(), hasKey(), insert(), operator[], erase(), reserve()).
+
+Related reading and implementations:
+    -"Designing a Fast, Efficient, Cache-friendly Hash Table, Step by Step" (CppCon 2017, Abseil SwissTable) https://abseil.io/about/design/swisstables
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgAssert.hpp"
+#include "../alg/find.hpp"
+#include "../ReadOnlySzParam.hpp"
+#include "detail/keyContainerUtils.hpp"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DFG_CONT_FLAT_HASH_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define DFG_CONT_FLAT_HASH_USE_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    namespace DFG_DETAIL_NS
+    {
+        inline uint64_t flatHashMix(uint64_t h)
+        {
+            // Finalizer of splitmix64
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebULL;
+            h ^= h >> 31;
+            return h;
+        }
+
+        inline uint64_t flatHashBytes(const void* p, const size_t nSize)
+        {
+            const auto pBytes = static_cast<const unsigned char*>(p);
+            uint64_t h = 0x9E3779B97F4A7C15ULL ^ (nSize * 0xff51afd7ed558ccdULL);
+            size_t i = 0;
+            for (; i + 8 <= nSize; i += 8)
+            {
+                uint64_t k;
+                std::memcpy(&k, pBytes + i, sizeof(k));
+                h = (h ^ flatHashMix(k)) * 0x9E3779B97F4A7C15ULL;
+            }
+            if (i < nSize)
+            {
+                uint64_t k = 0;
+                std::memcpy(&k, pBytes + i, nSize - i);
+                h = (h ^ flatHashMix(k)) * 0x9E3779B97F4A7C15ULL;
+            }
+            return flatHashMix(h);
+        }
+
+        // Returns index of lowest set bit; mask must be non-zero.
+        inline size_t flatHashLowestSetBit(const uint32_t mask)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+            unsigned long nIndex;
+            _BitScanForward(&nIndex, mask);
+            return nIndex;
+#else
+            size_t n = 0;
+            for (uint32_t m = mask; (m & 1) == 0; m >>= 1)
+                ++n;
+            return n;
+#endif
+        }
+
+        static const int8_t gFlatHashCtrlEmpty = -128;
+        static const int8_t gFlatHashCtrlDeleted = -2;
+        static const size_t gFlatHashGroupWidth = 16;
+
+        // Returns bitmask of bytes in group [pCtrl, pCtrl + 16[ that are equal to c.
+        inline uint32_t flatHashMatchByte(const int8_t* pCtrl, const int8_t c)
+        {
+#if DFG_CONT_FLAT_HASH_USE_SSE2
+            const auto group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCtrl));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(c)))));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < gFlatHashGroupWidth; ++i)
+                mask |= static_cast<uint32_t>(pCtrl[i] == c) << i;
+            return mask;
+#endif
+        }
+
+        // Returns bitmask of bytes in group that are empty or deleted (i.e. have sign bit set).
+        inline uint32_t flatHashMatchEmptyOrDeleted(const int8_t* pCtrl)
+        {
+#if DFG_CONT_FLAT_HASH_USE_SSE2
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCtrl))));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < gFlatHashGroupWidth; ++i)
+                mask |= static_cast<uint32_t>(pCtrl[i] < 0) << i;
+            return mask;
+#endif
+        }
+
+        // Value storage for set: stores nothing.
+        struct FlatHashNoValue {};
+
+        template <class T>
+        class FlatHashValueStorage
+        {
+        public:
+            void resize(const size_t n)         { m_values.resize(n); }
+            void clear()                        { m_values.clear(); }
+            T& operator[](const size_t i)       { return m_values[i]; }
+            const T& operator[](const size_t i) const { return m_values[i]; }
+            void swap(FlatHashValueStorage& other) { m_values.swap(other.m_values); }
+            std::vector<T> m_values;
+        };
+
+        template <>
+        class FlatHashValueStorage<FlatHashNoValue>
+        {
+        public:
+            void resize(size_t)                 {}
+            void clear()                        {}
+            FlatHashNoValue& operator[](size_t) { return m_dummy; }
+            const FlatHashNoValue& operator[](size_t) const { return m_dummy; }
+            void swap(FlatHashValueStorage&)    {}
+            FlatHashNoValue m_dummy;
+        };
+
+        template <class Ref_T>
+        class FlatHashArrowProxy
+        {
+        public:
+            FlatHashArrowProxy(Ref_T ref) : m_ref(ref) {}
+            typename std::remove_reference<Ref_T>::type* operator->() { return &m_ref; }
+            Ref_T m_ref;
+        };
+
+        // Forward iterator over full slots. Table_T must provide slotCount(), isFullSlot(i) and slotRef(i).
+        template <class Table_T, class Ref_T>
+        class FlatHashIterator
+        {
+        public:
+            typedef std::forward_iterator_tag                       iterator_category;
+            typedef ptrdiff_t                                       difference_type;
+            typedef typename std::remove_reference<Ref_T>::type     value_type;
+            typedef value_type*                                     pointer;
+            typedef Ref_T                                           reference;
+
+            FlatHashIterator() : m_pTable(nullptr), m_i(0) {}
+            FlatHashIterator(Table_T& rTable, const size_t i) : m_pTable(&rTable), m_i(i) {}
+
+            // Allows conversion from iterator to const_iterator.
+            template <class Table2_T, class Ref2_T>
+            FlatHashIterator(const FlatHashIterator<Table2_T, Ref2_T>& other) : m_pTable(other.m_pTable), m_i(other.m_i) {}
+
+            // Returns iterator to first full slot at or after i.
+            static FlatHashIterator firstFullFrom(Table_T& rTable, size_t i)
+            {
+                const auto nCount = rTable.slotCount();
+                while (i < nCount && !rTable.isFullSlot(i))
+                    ++i;
+                return FlatHashIterator(rTable, i);
+            }
+
+            FlatHashIterator& operator++()
+            {
+                *this = firstFullFrom(*m_pTable, m_i + 1);
+                return *this;
+            }
+
+            FlatHashIterator operator++(int)
+            {
+                auto rv = *this;
+                ++*this;
+                return rv;
+            }
+
+            Ref_T operator*() const                         { return m_pTable->slotRef(m_i); }
+            FlatHashArrowProxy<Ref_T> operator->() const    { return FlatHashArrowProxy<Ref_T>(m_pTable->slotRef(m_i)); }
+
+            bool operator==(const FlatHashIterator& other) const { return m_i == other.m_i; }
+            bool operator!=(const FlatHashIterator& other) const { return !(*this == other); }
+
+            size_t slotIndex() const { return m_i; }
+
+            Table_T* m_pTable;
+            size_t m_i;
+        }; // class FlatHashIterator
+
+        template <class Key_T, class Value_T, class Hash_T>
+        class FlatHashTable
+        {
+        public:
+            typedef Key_T   key_type;
+            typedef size_t  size_type;
+
+            static const size_t s_nNotFound = size_t(-1);
+
+            FlatHashTable() :
+                m_nSize(0),
+                m_nGrowthLeft(0)
+            {}
+
+            FlatHashTable(const FlatHashTable& other) :
+                m_ctrl(other.m_ctrl),
+                m_keys(other.m_keys),
+                m_values(other.m_values),
+                m_nSize(other.m_nSize),
+                m_nGrowthLeft(other.m_nGrowthLeft),
+                m_hasher(other.m_hasher)
+            {}
+
+            FlatHashTable(FlatHashTable&& other) :
+                m_nSize(0),
+                m_nGrowthLeft(0)
+            {
+                swap(other);
+            }
+
+            FlatHashTable& operator=(const FlatHashTable& other)
+            {
+                if (this != &other)
+                {
+                    FlatHashTable temp(other);
+                    swap(temp);
+                }
+                return *this;
+            }
+
+            FlatHashTable& operator=(FlatHashTable&& other)
+            {
+                FlatHashTable temp(std::move(other));
+                swap(temp);
+                return *this;
+            }
+
+            void swap(FlatHashTable& other)
+            {
+                using std::swap;
+                m_ctrl.swap(other.m_ctrl);
+                m_keys.swap(other.m_keys);
+                m_values.swap(other.m_values);
+                swap(m_nSize, other.m_nSize);
+                swap(m_nGrowthLeft, other.m_nGrowthLeft);
+                swap(m_hasher, other.m_hasher);
+            }
+
+            bool    empty() const       { return m_nSize == 0; }
+            size_t  size() const        { return m_nSize; }
+            // Returns number of slots; max item count before rehash is given by maxSizeWithoutRehash().
+            size_t  capacity() const    { return m_ctrl.size(); }
+
+            size_t maxSizeWithoutRehash() const { return maxLoadForCapacity(capacity()); }
+
+            // Removes all items, but keeps allocated slots.
+            void clear()
+            {
+                if (m_nSize == 0 && m_nGrowthLeft == maxLoadForCapacity(capacity()))
+                    return;
+                std::fill(m_ctrl.begin(), m_ctrl.end(), gFlatHashCtrlEmpty);
+                const auto nCapacity = m_keys.size();
+                m_keys.clear();
+                m_keys.resize(nCapacity);
+                m_values.clear();
+                m_values.resize(nCapacity);
+                m_nSize = 0;
+                m_nGrowthLeft = maxLoadForCapacity(nCapacity);
+            }
+
+            // Makes sure that nCount items can be stored without rehash.
+            void reserve(const size_t nCount)
+            {
+                if (nCount <= m_nSize + m_nGrowthLeft)
+                    return;
+                size_t nNewCapacity = gFlatHashGroupWidth;
+                while (maxLoadForCapacity(nNewCapacity) < nCount)
+                    nNewCapacity *= 2;
+                if (nNewCapacity > capacity())
+                    rehash(nNewCapacity);
+            }
+
+            size_t slotCount() const                { return m_ctrl.size(); }
+            bool isFullSlot(const size_t i) const   { return m_ctrl[i] >= 0; }
+
+            // Returns slot index of key or s_nNotFound.
+            template <class T>
+            size_t findSlot(const T& key) const
+            {
+                if (m_nSize == 0)
+                    return s_nNotFound;
+                const auto nHash = static_cast<uint64_t>(m_hasher(key));
+                const auto h2 = hashToCtrl(nHash);
+                const size_t nGroupMask = m_ctrl.size() / gFlatHashGroupWidth - 1;
+                size_t nGroup = static_cast<size_t>(nHash >> 7) & nGroupMask;
+                const int8_t* const pCtrl = m_ctrl.data();
+                for (size_t nProbe = 0; nProbe <= nGroupMask; ++nProbe)
+                {
+                    const auto pGroup = pCtrl + nGroup * gFlatHashGroupWidth;
+                    for (uint32_t mask = flatHashMatchByte(pGroup, h2); mask != 0; mask &= mask - 1)
+                    {
+                        const size_t nSlot = nGroup * gFlatHashGroupWidth + flatHashLowestSetBit(mask);
+                        if (DFG_MODULE_NS(alg)::isKeyMatch(m_keys[nSlot], key))
+                            return nSlot;
+                    }
+                    if (flatHashMatchByte(pGroup, gFlatHashCtrlEmpty) != 0)
+                        return s_nNotFound;
+                    nGroup = (nGroup + nProbe + 1) & nGroupMask; // Triangular probing visits every group when group count is a power of 2.
+                }
+                return s_nNotFound;
+            }
+
+            // Returns (slot, true) if key was not present and a slot with given key and default constructed value was created, (slot, false) otherwise.
+            template <class T>
+            std::pair<size_t, bool> findOrInsertSlot(T&& key)
+            {
+                const auto& searchKey = makeInternalSearchType<Key_T>(key);
+                const auto nExisting = findSlot(searchKey);
+                if (nExisting != s_nNotFound)
+                    return std::pair<size_t, bool>(nExisting, false);
+                const auto nHash = static_cast<uint64_t>(m_hasher(searchKey));
+                auto nSlot = findFirstNonFull(nHash);
+                if (nSlot == s_nNotFound || (m_nGrowthLeft == 0 && m_ctrl[nSlot] == gFlatHashCtrlEmpty))
+                {
+                    // If there are lots of deleted slots, rehashing to same capacity is enough.
+                    rehash((m_nSize < maxLoadForCapacity(capacity()) / 2) ? Max(capacity(), gFlatHashGroupWidth) : Max(2 * capacity(), gFlatHashGroupWidth));
+                    nSlot = findFirstNonFull(nHash);
+                }
+                if (m_ctrl[nSlot] == gFlatHashCtrlEmpty)
+                    --m_nGrowthLeft;
+                m_ctrl[nSlot] = hashToCtrl(nHash);
+                m_keys[nSlot] = Key_T(std::forward<T>(key));
+                ++m_nSize;
+                return std::pair<size_t, bool>(nSlot, true);
+            }
+
+            void eraseSlot(const size_t nSlot)
+            {
+                DFG_ASSERT_UB(nSlot < m_ctrl.size() && isFullSlot(nSlot));
+                // If the group has an empty slot, no probe sequence has continued past this group so slot can be marked empty instead of deleted.
+                const size_t nGroupBegin = nSlot - nSlot % gFlatHashGroupWidth;
+                if (flatHashMatchByte(m_ctrl.data() + nGroupBegin, gFlatHashCtrlEmpty) != 0)
+                {
+                    m_ctrl[nSlot] = gFlatHashCtrlEmpty;
+                    ++m_nGrowthLeft;
+                }
+                else
+                    m_ctrl[nSlot] = gFlatHashCtrlDeleted;
+                m_keys[nSlot] = Key_T();
+                m_values[nSlot] = Value_T();
+                --m_nSize;
+            }
+
+        protected:
+            static size_t maxLoadForCapacity(const size_t nCapacity) { return nCapacity - nCapacity / 8; }
+
+            static int8_t hashToCtrl(const uint64_t nHash) { return static_cast<int8_t>(nHash & 0x7F); }
+
+            size_t findFirstNonFull(const uint64_t nHash) const
+            {
+                if (m_ctrl.empty())
+                    return s_nNotFound;
+                const size_t nGroupMask = m_ctrl.size() / gFlatHashGroupWidth - 1;
+                size_t nGroup = static_cast<size_t>(nHash >> 7) & nGroupMask;
+                for (size_t nProbe = 0; nProbe <= nGroupMask; ++nProbe)
+                {
+                    const auto mask = flatHashMatchEmptyOrDeleted(m_ctrl.data() + nGroup * gFlatHashGroupWidth);
+                    if (mask != 0)
+                        return nGroup * gFlatHashGroupWidth + flatHashLowestSetBit(mask);
+                    nGroup = (nGroup + nProbe + 1) & nGroupMask;
+                }
+                return s_nNotFound;
+            }
+
+            void rehash(const size_t nNewCapacity)
+            {
+                DFG_ASSERT_CORRECTNESS(nNewCapacity % gFlatHashGroupWidth == 0 && maxLoadForCapacity(nNewCapacity) >= m_nSize);
+                FlatHashTable newTable;
+                newTable.m_ctrl.assign(nNewCapacity, gFlatHashCtrlEmpty);
+                newTable.m_keys.resize(nNewCapacity);
+                newTable.m_values.resize(nNewCapacity);
+                newTable.m_nGrowthLeft = maxLoadForCapacity(nNewCapacity);
+                newTable.m_hasher = m_hasher;
+                for (size_t i = 0, nCount = m_ctrl.size(); i < nCount; ++i)
+                {
+                    if (!isFullSlot(i))
+                        continue;
+                    const auto nHash = static_cast<uint64_t>(m_hasher(m_keys[i]));
+                    const auto nSlot = newTable.findFirstNonFull(nHash);
+                    newTable.m_ctrl[nSlot] = hashToCtrl(nHash);
+                    newTable.m_keys[nSlot] = std::move(m_keys[i]);
+                    newTable.m_values[nSlot] = std::move(m_values[i]);
+                    --newTable.m_nGrowthLeft;
+                    ++newTable.m_nSize;
+                }
+                swap(newTable);
+            }
+
+        public:
+            std::vector<int8_t> m_ctrl;                 // Control byte for each slot: empty, deleted or 7 bits of hash for full slot.
+            std::vector<Key_T> m_keys;
+            FlatHashValueStorage<Value_T> m_values;
+            size_t m_nSize;
+            size_t m_nGrowthLeft;                       // Number of empty slots that can be filled before rehash.
+            Hash_T m_hasher;
+        }; // class FlatHashTable
+
+    } // namespace DFG_DETAIL_NS
+
+    // Default hash for FlatHashMap and FlatHashSet. Strings and string views of the same characters have the same hash
+    // which enables heterogeneous lookup; integers are mixed so that both high and low bits are usable.
+    class DFG_CLASS_NAME(FlatHashDefaultHash)
+    {
+    public:
+        template <class Char_T, class Str_T>
+        uint64_t operator()(const DFG_CLASS_NAME(StringView)<Char_T, Str_T>& sv) const { return DFG_DETAIL_NS::flatHashBytes(sv.dataRaw(), sv.size() * sizeof(*sv.dataRaw())); }
+
+        template <class Char_T, class Traits_T, class Alloc_T>
+        uint64_t operator()(const std::basic_string<Char_T, Traits_T, Alloc_T>& s) const { return DFG_DETAIL_NS::flatHashBytes(s.data(), s.size() * sizeof(Char_T)); }
+
+        uint64_t operator()(const char* psz) const { return DFG_DETAIL_NS::flatHashBytes(psz, std::strlen(psz)); }
+        uint64_t operator()(char* psz) const { return operator()(static_cast<const char*>(psz)); }
+
+        template <class T>
+        uint64_t operator()(const T& val) const { return hashImpl(val, std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value>()); }
+
+    private:
+        template <class T> static uint64_t hashImpl(const T& val, std::true_type)   { return DFG_DETAIL_NS::flatHashMix(static_cast<uint64_t>(val)); }
+        template <class T> static uint64_t hashImpl(const T& val, std::false_type)  { return DFG_DETAIL_NS::flatHashMix(static_cast<uint64_t>(std::hash<T>()(val))); }
+    };
+
+    template <class Key_T, class Value_T, class Hash_T = DFG_CLASS_NAME(FlatHashDefaultHash)>
+    class DFG_CLASS_NAME(FlatHashMap) : public DFG_DETAIL_NS::FlatHashTable<Key_T, Value_T, Hash_T>
+    {
+    public:
+        typedef DFG_DETAIL_NS::FlatHashTable<Key_T, Value_T, Hash_T>    BaseClass;
+        typedef DFG_CLASS_NAME(FlatHashMap)                             ThisClass;
+        typedef Key_T                                                   key_type;
+        typedef Value_T                                                 mapped_type;
+        typedef typename BaseClass::size_type                           size_type;
+        typedef std::pair<const Key_T&, Value_T&>                       reference;
+        typedef std::pair<const Key_T&, const Value_T&>                 const_reference;
+        typedef DFG_DETAIL_NS::FlatHashIterator<ThisClass, reference>               iterator;
+        typedef DFG_DETAIL_NS::FlatHashIterator<const ThisClass, const_reference>   const_iterator;
+
+        iterator        begin()         { return iterator::firstFullFrom(*this, 0); }
+        const_iterator  begin() const   { return const_iterator::firstFullFrom(*this, 0); }
+        const_iterator  cbegin() const  { return begin(); }
+        iterator        end()           { return iterator(*this, this->slotCount()); }
+        const_iterator  end() const     { return const_iterator(*this, this->slotCount()); }
+        const_iterator  cend() const    { return end(); }
+
+        template <class T> iterator         find(const T& key)          { return makeIterator(this->findSlot(DFG_DETAIL_NS::makeInternalSearchType<Key_T>(key))); }
+        template <class T> const_iterator   find(const T& key) const    { return makeIterator(this->findSlot(DFG_DETAIL_NS::makeInternalSearchType<Key_T>(key))); }
+
+        template <class T> bool hasKey(const T& key) const { return find(key) != end(); }
+
+        // Returns reference to value of given key inserting default constructed value if not present.
+        template <class T>
+        mapped_type& operator[](T&& key)
+        {
+            return this->m_values[this->findOrInsertSlot(std::forward<T>(key)).first];
+        }
+
+        // Inserts (key, value) if key is not present; existing value is not modified.
+        template <class K_T, class V_T>
+        std::pair<iterator, bool> insert(K_T&& key, V_T&& value)
+        {
+            const auto rv = this->findOrInsertSlot(std::forward<K_T>(key));
+            if (rv.second)
+                this->m_values[rv.first] = std::forward<V_T>(value);
+            return std::pair<iterator, bool>(iterator(*this, rv.first), rv.second);
+        }
+
+        std::pair<iterator, bool> insert(std::pair<key_type, mapped_type>&& newVal)
+        {
+            return insert(std::move(newVal.first), std::move(newVal.second));
+        }
+
+        template <class T>
+        size_type erase(const T& key)
+        {
+            const auto nSlot = this->findSlot(DFG_DETAIL_NS::makeInternalSearchType<Key_T>(key));
+            if (nSlot == BaseClass::s_nNotFound)
+                return 0;
+            this->eraseSlot(nSlot);
+            return 1;
+        }
+
+        // Returns iterator to item following the erased one.
+        iterator erase(const iterator& iter)
+        {
+            if (iter == end())
+                return end();
+            this->eraseSlot(iter.slotIndex());
+            return iterator::firstFullFrom(*this, iter.slotIndex() + 1);
+        }
+
+        reference       slotRef(const size_t i)         { return reference(this->m_keys[i], this->m_values[i]); }
+        const_reference slotRef(const size_t i) const   { return const_reference(this->m_keys[i], this->m_values[i]); }
+
+    private:
+        iterator        makeIterator(const size_t nSlot)        { return (nSlot != BaseClass::s_nNotFound) ? iterator(*this, nSlot) : end(); }
+        const_iterator  makeIterator(const size_t nSlot) const  { return (nSlot != BaseClass::s_nNotFound) ? const_iterator(*this, nSlot) : end(); }
+    }; // class FlatHashMap
+
+    template <class Key_T, class Hash_T = DFG_CLASS_NAME(FlatHashDefaultHash)>
+    class DFG_CLASS_NAME(FlatHashSet) : public DFG_DETAIL_NS::FlatHashTable<Key_T, DFG_DETAIL_NS::FlatHashNoValue, Hash_T>
+    {
+    public:
+        typedef DFG_DETAIL_NS::FlatHashTable<Key_T, DFG_DETAIL_NS::FlatHashNoValue, Hash_T>   BaseClass;
+        typedef DFG_CLASS_NAME(FlatHashSet)                                                 ThisClass;
+        typedef Key_T                                                                       key_type;
+        typedef Key_T                                                                       value_type;
+        typedef typename BaseClass::size_type                                               size_type;
+        typedef const Key_T&                                                                const_reference;
+        typedef DFG_DETAIL_NS::FlatHashIterator<const ThisClass, const_reference>           const_iterator;
+        typedef const_iterator                                                              iterator; // Items are not modifiable through iterators.
+
+        const_iterator  begin() const   { return const_iterator::firstFullFrom(*this, 0); }
+        const_iterator  cbegin() const  { return begin(); }
+        const_iterator  end() const     { return const_iterator(*this, this->slotCount()); }
+        const_iterator  cend() const    { return end(); }
+
+        template <class T>
+        const_iterator find(const T& key) const
+        {
+            const auto nSlot = this->findSlot(DFG_DETAIL_NS::makeInternalSearchType<Key_T>(key));
+            return (nSlot != BaseClass::s_nNotFound) ? const_iterator(*this, nSlot) : end();
+        }
+
+        template <class T> bool hasKey(const T& key) const { return find(key) != end(); }
+
+        template <class T>
+        std::pair<const_iterator, bool> insert(T&& key)
+        {
+            const auto rv = this->findOrInsertSlot(std::forward<T>(key));
+            return std::pair<const_iterator, bool>(const_iterator(*this, rv.first), rv.second);
+        }
+
+        template <class T>
+        size_type erase(const T& key)
+        {
+            const auto nSlot = this->findSlot(DFG_DETAIL_NS::makeInternalSearchType<Key_T>(key));
+            if (nSlot == BaseClass::s_nNotFound)
+                return 0;
+            this->eraseSlot(nSlot);
+            return 1;
+        }
+
+        const_reference slotRef(const size_t i) const { return this->m_keys[i]; }
+    }; // class FlatHashSet
+
+}} // module namespace
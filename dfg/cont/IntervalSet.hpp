@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../numericTypeTools.hpp"
+#include <iterator>
+#include <map>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    // Set of integer values stored as sorted, non-overlapping and non-adjacent closed intervals,
+    // e.g. inserting 1, 2, 3 and 7 results in intervals [1, 3] and [7, 7].
+    // Typical use case is tracking modified rows of a table: memory usage depends on the number of distinct ranges, not on the number of values.
+    template <class T>
+    class DFG_CLASS_NAME(IntervalSet)
+    {
+    public:
+        typedef std::map<T, T> ContainerT; // Maps first value of interval to last.
+
+        // Inserts closed interval [first, last]. If last < first, does nothing.
+        void insertClosed(T first, T last)
+        {
+            if (last < first)
+                return;
+            auto iter = m_intervals.upper_bound(first);
+            if (iter != m_intervals.begin())
+            {
+                auto iterPrev = std::prev(iter);
+                if (isOverlappingOrAdjacent(iterPrev->second, first))
+                {
+                    if (iterPrev->second >= last)
+                        return; // Already fully included.
+                    first = iterPrev->first;
+                    iter = iterPrev;
+                }
+            }
+            while (iter != m_intervals.end() && isOverlappingOrAdjacent(last, iter->first))
+            {
+                last = Max(last, iter->second);
+                iter = m_intervals.erase(iter);
+            }
+            m_intervals.insert(iter, std::make_pair(first, last));
+        }
+
+        void insert(const T val)
+        {
+            insertClosed(val, val);
+        }
+
+        bool hasValue(const T val) const
+        {
+            auto iter = m_intervals.upper_bound(val);
+            if (iter == m_intervals.begin())
+                return false;
+            --iter;
+            return val <= iter->second;
+        }
+
+        bool empty() const { return m_intervals.empty(); }
+
+        size_t intervalCount() const { return m_intervals.size(); }
+
+        // Returns the number of values in the set.
+        uint64 sizeOfSet() const
+        {
+            uint64 nCount = 0;
+            for (const auto& item : m_intervals)
+                nCount += static_cast<uint64>(item.second - item.first) + 1;
+            return nCount;
+        }
+
+        void clear() { m_intervals.clear(); }
+
+        // Calls func(first, last) for each interval in ascending order.
+        template <class Func_T>
+        void forEachInterval(Func_T&& func) const
+        {
+            for (const auto& item : m_intervals)
+                func(item.first, item.second);
+        }
+
+        bool operator==(const DFG_CLASS_NAME(IntervalSet)& other) const { return m_intervals == other.m_intervals; }
+        bool operator!=(const DFG_CLASS_NAME(IntervalSet)& other) const { return !(*this == other); }
+
+    private:
+        // Returns true if interval ending at 'last' overlaps or is adjacent to interval starting at 'first'.
+        static bool isOverlappingOrAdjacent(const T last, const T first)
+        {
+            return first <= last || (last < NumericTraits<T>::maxValue && first == last + 1);
+        }
+
+        ContainerT m_intervals;
+    }; // class IntervalSet
+
+} } // module namespace
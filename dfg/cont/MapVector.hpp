@@ -35,6 +35,7 @@ Related reading and implementations:
 #include "../alg/eraseByTailSwap.hpp"
 #include "../alg/find.hpp"
 #include "../alg/sortMultiple.hpp"
+#include "../alg/sortParallel.hpp"
 #include "../build/languageFeatureInfo.hpp"
 #include "../dfgAssert.hpp"
 #include "detail/keyContainerUtils.hpp"
@@ -42,6 +43,7 @@ Related reading and implementations:
 #include "Vector.hpp"
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -154,7 +156,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
 
             bool                empty() const       { return static_cast<const Impl_T&>(*this).empty(); }
             size_t              size() const        { return static_cast<const Impl_T&>(*this).size(); }
-            void                clear() const       { return static_cast<const Impl_T&>(*this).clear(); }
+            void                clear()             { return static_cast<Impl_T&>(*this).clear(); }
 
             iterator            makeIterator(const size_t i)          { return static_cast<Impl_T&>(*this).makeIterator(i); }
             const_iterator      makeIterator(const size_t i) const    { return static_cast<const Impl_T&>(*this).makeIterator(i); }
@@ -271,6 +273,80 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
                 }
             }
 
+            // Inserts items from range [first, last[ whose value_type has members 'first' and 'second' (e.g. std::pair).
+            // For sorted map, new items are collected to temporary buffer, sorted once (in parallel for large inputs, see stableSortParallel())
+            // and merged with existing items in O(n + m) instead of doing m individual inserts each costing O(n).
+            // For unsorted map this is equivalent to calling insert() or operator[] for each item.
+            // Duplicate keys are handled according to duplicatePolicy.
+            template <class Iter_T>
+            void insertRange(Iter_T first, const Iter_T last, const typename BaseClass::DuplicatePolicy duplicatePolicy = BaseClass::DuplicatePolicyKeepFirst)
+            {
+                if (!this->isSorted())
+                {
+                    for (; first != last; ++first)
+                    {
+                        auto&& item = *first;
+                        if (duplicatePolicy == BaseClass::DuplicatePolicyKeepLast)
+                            (*this)[item.first] = item.second;
+                        else if (!hasKey(item.first))
+                            insertNonExisting(key_type(item.first), mapped_type(item.second));
+                    }
+                    return;
+                }
+                std::vector<std::pair<key_type, mapped_type>> newItems;
+                for (; first != last; ++first)
+                {
+                    auto&& item = *first;
+                    newItems.emplace_back(std::forward<decltype(item)>(item).first, std::forward<decltype(item)>(item).second);
+                }
+                typedef std::pair<key_type, mapped_type> PairT;
+                DFG_MODULE_NS(alg)::stableSortParallel(newItems.begin(), newItems.end(), [](const PairT& a, const PairT& b) { return a.first < b.first; });
+                // Removing duplicates within new items; stable sort keeps items with equal keys in input order.
+                auto iterDest = newItems.begin();
+                for (auto iter = newItems.begin(); iter != newItems.end();)
+                {
+                    auto iterGroupEnd = iter + 1;
+                    while (iterGroupEnd != newItems.end() && isKeyMatch(iterGroupEnd->first, iter->first))
+                        ++iterGroupEnd;
+                    auto& rKept = (duplicatePolicy == BaseClass::DuplicatePolicyKeepLast) ? *(iterGroupEnd - 1) : *iter;
+                    if (&*iterDest != &rKept)
+                        *iterDest = std::move(rKept);
+                    ++iterDest;
+                    iter = iterGroupEnd;
+                }
+                newItems.erase(iterDest, newItems.end());
+                mergeSortedItems(newItems.size(),
+                                 [&](const size_t i) -> key_type& { return newItems[i].first; },
+                                 [&](const size_t i) -> mapped_type& { return newItems[i].second; },
+                                 duplicatePolicy, true);
+            }
+
+            // Replaces content with items from range [first, last[ which need not be sorted. See insertRange() for details.
+            template <class Iter_T>
+            void assign(Iter_T first, const Iter_T last, const typename BaseClass::DuplicatePolicy duplicatePolicy = BaseClass::DuplicatePolicyKeepFirst)
+            {
+                clear();
+                insertRange(first, last, duplicatePolicy);
+            }
+
+            // Inserts all items from other map. If both are sorted, this is done with single O(n + m) merge pass.
+            // With DuplicatePolicyKeepFirst, existing values are kept for keys that exist in both; with DuplicatePolicyKeepLast, values from 'other' are used.
+            void merge(const Impl_T& other, const typename BaseClass::DuplicatePolicy duplicatePolicy = BaseClass::DuplicatePolicyKeepFirst)
+            {
+                if (&other == this)
+                    return;
+                if (!this->isSorted() || !other.isSorted())
+                {
+                    insertRange(other.begin(), other.end(), duplicatePolicy);
+                    return;
+                }
+                const auto otherKeys = other.beginKey();
+                mergeSortedItems(other.size(),
+                                 [&](const size_t i) -> const key_type& { return other.keyIterValueToKeyValue(*(otherKeys + i)); },
+                                 [&](const size_t i) -> const mapped_type& { return other.keyIteratorToValue(otherKeys + i); },
+                                 duplicatePolicy, false);
+            }
+
             void reserve(const size_t nReserve) { static_cast<Impl_T&>(*this).reserve(nReserve); }
 
             size_t capacity() const             { return static_cast<const Impl_T&>(*this).capacity(); }
@@ -283,9 +359,86 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
                     return;
                 if (bSort)
                     sort();
+                else
+                    this->unfreeze();
                 this->m_bSorted = bSort;
             }
 
+            // Makes container read-optimized: sorts it if needed and builds auxiliary search index with keys in Eytzinger layout
+            // so that find() does branchless, prefetching search instead of std::lower_bound over key storage.
+            // Storage and iteration order are not changed. Index is removed by any modifying operation (see unfreeze()), but if keys are modified
+            // directly through key iterators or storage, unfreeze() must be called before next find(); find() asserts that index size matches container size.
+            // Note: the index stores a copy of keys, so this is mostly useful for large maps with cheap-to-copy keys such as integers.
+            void freeze()
+            {
+                setSorting(true);
+                typedef typename BaseClass::template KeyIteratorValueToComparable<const Impl_T> KeyProjection;
+                const auto& rImpl = static_cast<const Impl_T&>(*this);
+                this->m_spFrozenSearchIndex = std::make_shared<typename BaseClass::FrozenSearchIndex>(rImpl.beginKey(), rImpl.endKey(), KeyProjection(rImpl));
+            }
+
+        private:
+            // Merges this (sorted) with nCount sorted items with unique keys that are accessed through functors.
+            // If bMoveFromSource is true, source keys and values are moved from, otherwise copied.
+            template <class KeyAt_T, class ValueAt_T>
+            void mergeSortedItems(const size_t nCount, KeyAt_T keyAt, ValueAt_T valueAt, const typename BaseClass::DuplicatePolicy duplicatePolicy, const bool bMoveFromSource)
+            {
+                if (nCount == 0)
+                    return;
+                auto& rImpl = static_cast<Impl_T&>(*this);
+                const auto pushSource = [&](Impl_T& dest, const size_t i)
+                {
+                    if (bMoveFromSource)
+                        dest.insertNonExistingTo(key_type(std::move(keyAt(i))), mapped_type(std::move(valueAt(i))), dest.endKey());
+                    else
+                        dest.insertNonExistingTo(key_type(keyAt(i)), mapped_type(valueAt(i)), dest.endKey());
+                };
+                // Fast path: all new items come after existing ones.
+                if (empty() || backKey() < keyAt(0))
+                {
+                    reserve(size() + nCount);
+                    for (size_t i = 0; i < nCount; ++i)
+                        pushSource(rImpl, i);
+                    return;
+                }
+                Impl_T merged;
+                merged.reserve(size() + nCount);
+                const size_t nThisCount = size();
+                size_t iThis = 0;
+                size_t iSrc = 0;
+                const auto pushThis = [&]()
+                {
+                    auto iterKey = beginKey() + iThis++;
+                    merged.insertNonExistingTo(std::move(keyIterValueToKeyValue(*iterKey)), std::move(keyIteratorToValue(iterKey)), merged.endKey());
+                };
+                while (iThis < nThisCount && iSrc < nCount)
+                {
+                    const auto& thisKey = keyIterValueToKeyValue(*(beginKey() + iThis));
+                    if (thisKey < keyAt(iSrc))
+                        pushThis();
+                    else if (keyAt(iSrc) < thisKey)
+                        pushSource(merged, iSrc++);
+                    else // Equal keys
+                    {
+                        if (duplicatePolicy == BaseClass::DuplicatePolicyKeepLast)
+                        {
+                            ++iThis;
+                            pushSource(merged, iSrc++);
+                        }
+                        else
+                        {
+                            pushThis();
+                            ++iSrc;
+                        }
+                    }
+                }
+                while (iThis < nThisCount)
+                    pushThis();
+                while (iSrc < nCount)
+                    pushSource(merged, iSrc++);
+                rImpl = std::move(merged);
+            }
+
         }; // class MapVectorCrtp
 
         //template <class T> struct DefaultMapVectorContainerType { typedef std::vector<T> type; };
@@ -325,6 +478,7 @@ public:
     DFG_CLASS_NAME(MapVectorSoA)& operator=(const DFG_CLASS_NAME(MapVectorSoA)& other)
     {
         this->m_bSorted = other.m_bSorted;
+        this->m_spFrozenSearchIndex = other.m_spFrozenSearchIndex;
         m_keyStorage = other.m_keyStorage;
         m_valueStorage = other.m_valueStorage;
         return *this;
@@ -333,6 +487,7 @@ public:
     DFG_CLASS_NAME(MapVectorSoA)& operator=(DFG_CLASS_NAME(MapVectorSoA)&& other)
     {
         this->m_bSorted = other.m_bSorted;
+        this->m_spFrozenSearchIndex = std::move(other.m_spFrozenSearchIndex);
         m_keyStorage = std::move(other.m_keyStorage);
         m_valueStorage = std::move(other.m_valueStorage);
         return *this;
@@ -350,10 +505,11 @@ public:
 
     bool    empty() const   { return m_keyStorage.empty(); }
     size_t  size() const    { return m_keyStorage.size(); }
-    void    clear()         { m_keyStorage.clear(); m_valueStorage.clear(); }
+    void    clear()         { this->unfreeze(); m_keyStorage.clear(); m_valueStorage.clear(); }
 
     iterator insertNonExistingTo(key_type&& key, mapped_type&& value, const key_iterator& insertPos)
     {
+        this->unfreeze();
         const auto nIndex = insertPos - m_keyStorage.begin();
         m_keyStorage.insert(insertPos, std::move(key));
         m_valueStorage.insert(m_valueStorage.begin() + nIndex, std::move(value));
@@ -373,11 +529,13 @@ public:
 
     void sort()
     {
+        this->unfreeze();
         ::DFG_MODULE_NS(alg)::sortMultiple(m_keyStorage, m_valueStorage);
     }
 
     iterator eraseImpl(iterator iterRangeFirst, iterator iterRangeEnd)
     { 
+        this->unfreeze();
         const auto nFirst = iterRangeFirst - this->begin();
         const auto nEnd = iterRangeEnd - this->begin();
         m_keyStorage.erase(m_keyStorage.begin() + nFirst, m_keyStorage.begin() + nEnd);
@@ -387,6 +545,7 @@ public:
 
     void swapElem(const iterator& a, const iterator& b)
     {
+        this->unfreeze();
         const auto nIndexA = a - this->begin();
         const auto nIndexB = b - this->begin();
         using std::swap;
@@ -434,6 +593,7 @@ public:
     DFG_CLASS_NAME(MapVectorAoS)& operator=(const DFG_CLASS_NAME(MapVectorAoS)& other)
     {
         this->m_bSorted = other.m_bSorted;
+        this->m_spFrozenSearchIndex = other.m_spFrozenSearchIndex;
         m_storage = other.m_storage;
         return *this;
     }
@@ -441,6 +601,7 @@ public:
     DFG_CLASS_NAME(MapVectorAoS)& operator=(DFG_CLASS_NAME(MapVectorAoS)&& other)
     {
         this->m_bSorted = other.m_bSorted;
+        this->m_spFrozenSearchIndex = std::move(other.m_spFrozenSearchIndex);
         m_storage = std::move(other.m_storage);
         return *this;
     }
@@ -457,10 +618,11 @@ public:
 
     bool    empty() const   { return m_storage.empty(); }
     size_t  size() const    { return m_storage.size(); }
-    void    clear()         { m_storage.clear(); }
+    void    clear()         { this->unfreeze(); m_storage.clear(); }
 
     iterator insertNonExistingTo(key_type&& key, mapped_type&& value, const key_iterator& iter)
     {
+        this->unfreeze();
         return m_storage.insert(iter, value_type(std::move(key), std::move(value)));
     }
 
@@ -476,6 +638,7 @@ public:
 
     void sort()
     {
+        this->unfreeze();
         std::sort(m_storage.begin(), m_storage.end(), [](const value_type& left, const value_type& right)
         {
             return left.first < right.first;
@@ -484,11 +647,13 @@ public:
 
     iterator eraseImpl(iterator iterRangeFirst, iterator iterRangeEnd)
     {
+        this->unfreeze();
         return m_storage.erase(iterRangeFirst, iterRangeEnd);
     }
 
     void swapElem(const iterator& a, const iterator& b)
     {
+        this->unfreeze();
         std::iter_swap(a, b);
     }
 
@@ -0,0 +1,220 @@
+#pragma once
+
+/*
+OrderStatisticsMultiset.hpp
+
+Sorted multiset that supports insert, erase and access to k'th smallest item in O(log n) (plus small constant block operations)
+making it suitable e.g. for sliding window medians and percentiles.
+
+Implementation is a blocked sorted array:
+    -Items are stored in sorted blocks of size [1, 2 * blockSize], blocks themselves are in ascending order.
+    -Block for an item is found with binary search over the last items of the blocks, item position within block with binary search.
+    -Block sizes are tracked in a Fenwick tree so that both rank of a block and block containing k'th item are found in O(log(blockCount)).
+    -Insert and erase shift at most 2 * blockSize items within a block; when block grows too large it gets split and when it becomes
+     small enough it gets merged with a neighbour, both of which rebuild the Fenwick tree in O(blockCount).
+Compared to node based alternatives (e.g. indexable skiplist or order statistics tree), items are contiguous within blocks which keeps
+cache behaviour good for small item types such as floating point values.
+
+Note: comparison must be strict weak ordering for the stored values, e.g. NaN's are not supported with the default std::less.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgAssert.hpp"
+#include "../dfgBase.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    template <class T, class Pred_T = std::less<T>>
+    class DFG_CLASS_NAME(OrderStatisticsMultiset)
+    {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+        typedef std::vector<T> BlockT;
+
+        DFG_CLASS_NAME(OrderStatisticsMultiset)(const size_t nBlockSize = 64, Pred_T pred = Pred_T()) :
+            m_nBlockSize(Max(size_t(2), nBlockSize)),
+            m_nSize(0),
+            m_pred(pred)
+        {}
+
+        size_t size() const { return m_nSize; }
+        bool empty() const  { return m_nSize == 0; }
+
+        void clear()
+        {
+            m_blocks.clear();
+            m_blockSizeTree.clear();
+            m_nSize = 0;
+        }
+
+        void insert(T val)
+        {
+            if (m_blocks.empty())
+            {
+                m_blocks.push_back(BlockT());
+                m_blocks.back().reserve(2 * m_nBlockSize + 1);
+                m_blocks.back().push_back(std::move(val));
+                m_nSize = 1;
+                rebuildBlockSizeTree();
+                return;
+            }
+            const size_t nBlock = Min(blockLowerBound(val), m_blocks.size() - 1);
+            auto& block = m_blocks[nBlock];
+            block.insert(std::upper_bound(block.begin(), block.end(), val, m_pred), std::move(val));
+            ++m_nSize;
+            if (block.size() > 2 * m_nBlockSize)
+            {
+                BlockT newBlock;
+                newBlock.reserve(2 * m_nBlockSize + 1);
+                newBlock.assign(block.begin() + m_nBlockSize, block.end());
+                block.resize(m_nBlockSize);
+                m_blocks.insert(m_blocks.begin() + nBlock + 1, std::move(newBlock));
+                rebuildBlockSizeTree();
+            }
+            else
+                addToBlockSize(nBlock, 1);
+        }
+
+        // Erases one item equivalent to 'val'. Returns true if an item was erased, false if there was no such item.
+        bool erase(const T& val)
+        {
+            const size_t nBlock = blockLowerBound(val);
+            if (nBlock >= m_blocks.size())
+                return false;
+            auto& block = m_blocks[nBlock];
+            const auto iter = std::lower_bound(block.begin(), block.end(), val, m_pred);
+            if (iter == block.end() || m_pred(val, *iter))
+                return false;
+            block.erase(iter);
+            --m_nSize;
+            if (block.empty())
+            {
+                m_blocks.erase(m_blocks.begin() + nBlock);
+                rebuildBlockSizeTree();
+            }
+            else if (block.size() < m_nBlockSize / 2 && m_blocks.size() > 1)
+            {
+                // Merging with a neighbour if combined size doesn't exceed nominal block size.
+                const size_t nFirst = (nBlock + 1 < m_blocks.size()) ? nBlock : nBlock - 1;
+                auto& left = m_blocks[nFirst];
+                auto& right = m_blocks[nFirst + 1];
+                if (left.size() + right.size() <= m_nBlockSize)
+                {
+                    left.insert(left.end(), right.begin(), right.end());
+                    m_blocks.erase(m_blocks.begin() + nFirst + 1);
+                    rebuildBlockSizeTree();
+                }
+                else
+                    addToBlockSize(nBlock, -1);
+            }
+            else
+                addToBlockSize(nBlock, -1);
+            return true;
+        }
+
+        // Replaces one item equivalent to 'oldVal' with 'newVal'. If there's no item equivalent to 'oldVal', only inserts 'newVal'.
+        void replace(const T& oldVal, T newVal)
+        {
+            erase(oldVal);
+            insert(std::move(newVal));
+        }
+
+        // Returns k'th smallest item (0-based). Precondition: k < size().
+        const T& nth(size_t k) const
+        {
+            DFG_ASSERT_CORRECTNESS(k < m_nSize);
+            // Fenwick tree descent: finds the block where prefix sum of sizes exceeds k.
+            const size_t nBlockCount = m_blockSizeTree.size();
+            size_t nPos = 0;
+            for (size_t nStep = highestPowerOfTwoNotGreaterThan(nBlockCount); nStep != 0; nStep >>= 1)
+            {
+                if (nPos + nStep <= nBlockCount && m_blockSizeTree[nPos + nStep - 1] <= k)
+                {
+                    nPos += nStep;
+                    k -= m_blockSizeTree[nPos - 1];
+                }
+            }
+            return m_blocks[nPos][k];
+        }
+
+        const T& front() const { return nth(0); }
+        const T& back() const  { return nth(m_nSize - 1); }
+
+        // Returns number of items that are less than 'val'.
+        size_t countLessThan(const T& val) const
+        {
+            const size_t nBlock = blockLowerBound(val);
+            if (nBlock >= m_blocks.size())
+                return m_nSize;
+            const auto& block = m_blocks[nBlock];
+            return blockSizePrefixSum(nBlock) + static_cast<size_t>(std::lower_bound(block.begin(), block.end(), val, m_pred) - block.begin());
+        }
+
+        // Calls func(item) for every item in ascending order.
+        template <class Func_T>
+        void forEachInOrder(Func_T&& func) const
+        {
+            for (const auto& block : m_blocks)
+                for (const auto& item : block)
+                    func(item);
+        }
+
+        size_t blockCount() const { return m_blocks.size(); }
+
+    private:
+        // Returns index of first block whose last item is not less than 'val', or blockCount() if there is no such block.
+        size_t blockLowerBound(const T& val) const
+        {
+            const auto iter = std::lower_bound(m_blocks.begin(), m_blocks.end(), val, [&](const BlockT& block, const T& v) { return m_pred(block.back(), v); });
+            return static_cast<size_t>(iter - m_blocks.begin());
+        }
+
+        static size_t highestPowerOfTwoNotGreaterThan(const size_t n)
+        {
+            size_t nPow = 1;
+            while (nPow <= n / 2)
+                nPow *= 2;
+            return (n > 0) ? nPow : 0;
+        }
+
+        void addToBlockSize(const size_t nBlock, const int nDelta)
+        {
+            for (size_t i = nBlock + 1; i <= m_blockSizeTree.size(); i += (i & (~i + 1)))
+                m_blockSizeTree[i - 1] += static_cast<size_t>(nDelta);
+        }
+
+        // Returns sum of sizes of blocks [0, nBlock[.
+        size_t blockSizePrefixSum(size_t nBlock) const
+        {
+            size_t nSum = 0;
+            for (; nBlock > 0; nBlock &= nBlock - 1)
+                nSum += m_blockSizeTree[nBlock - 1];
+            return nSum;
+        }
+
+        void rebuildBlockSizeTree()
+        {
+            const size_t nBlockCount = m_blocks.size();
+            m_blockSizeTree.resize(nBlockCount);
+            for (size_t i = 0; i < nBlockCount; ++i)
+                m_blockSizeTree[i] = m_blocks[i].size();
+            for (size_t i = 1; i <= nBlockCount; ++i)
+            {
+                const size_t nParent = i + (i & (~i + 1));
+                if (nParent <= nBlockCount)
+                    m_blockSizeTree[nParent - 1] += m_blockSizeTree[i - 1];
+            }
+        }
+
+        std::vector<BlockT> m_blocks;
+        std::vector<size_t> m_blockSizeTree; // Fenwick tree of block sizes, 1-based node i is stored at index i - 1.
+        size_t m_nBlockSize;
+        size_t m_nSize;
+        Pred_T m_pred;
+    }; // class OrderStatisticsMultiset
+
+}} // Module namespace
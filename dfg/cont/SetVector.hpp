@@ -23,9 +23,11 @@ Related reading and implementations:
 #include "../dfgDefs.hpp"
 #include "../alg/eraseByTailSwap.hpp"
 #include "../alg/sortMultiple.hpp"
+#include "../alg/sortParallel.hpp"
 #include "../build/languageFeatureInfo.hpp"
 #include "detail/keyContainerUtils.hpp"
 #include <algorithm>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -76,6 +78,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
         DFG_CLASS_NAME(SetVector)& operator=(const DFG_CLASS_NAME(SetVector)& other)
         {
             this->m_bSorted = other.m_bSorted;
+            this->m_spFrozenSearchIndex = other.m_spFrozenSearchIndex;
             m_storage = other.m_storage;
             return *this;
         }
@@ -83,6 +86,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
         DFG_CLASS_NAME(SetVector)& operator=(DFG_CLASS_NAME(SetVector)&& other)
         {
             this->m_bSorted = other.m_bSorted;
+            this->m_spFrozenSearchIndex = std::move(other.m_spFrozenSearchIndex);
             m_storage = std::move(other.m_storage);
             return *this;
         }
@@ -90,7 +94,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
 
         bool                empty() const       { return m_storage.empty(); }
         size_t              size() const        { return m_storage.size(); }
-        void                clear()             { m_storage.clear(); }
+        void                clear()             { this->unfreeze(); m_storage.clear(); }
 
         iterator            begin()             { return m_storage.begin(); }
         const_iterator      begin() const       { return m_storage.begin(); }
@@ -126,6 +130,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
         size_type   erase(const T& key) { auto rv = erase(find(key)); return (rv != end()) ? 1 : 0; } // Returns the number of elements removed.
         iterator    erase(iterator iterRangeFirst, const iterator iterRangeEnd)
         {
+            this->unfreeze();
             if (this->m_bSorted)
                 return m_storage.erase(iterRangeFirst, iterRangeEnd);
             else // With unsorted, swap to-be-removed items to end and erase items from end -> O(1) for single element removal.
@@ -163,6 +168,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
 
         iterator insertNonExistingTo(key_type&& value, iterator insertPos)
         { 
+            this->unfreeze();
             return m_storage.insert(insertPos, std::move(value));
         }
 
@@ -206,12 +212,38 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
             return insert(newVal).first;
         }
 
+        // Inserts items from range [first, last[. For sorted set, items are appended, sorted once (in parallel for large inputs, see stableSortParallel())
+        // and merged with existing items, i.e. O(n + m log m) instead of m individual inserts each costing O(n).
+        // For unsorted set this is equivalent to calling insert() for each item.
+        // Of equal items, the existing one or if not existing, the first one in input is kept.
+        template <class Iter_T>
+        void insertRange(Iter_T first, const Iter_T last)
+        {
+            insertRangeImpl(first, last, false);
+        }
+
+        // Replaces content with items from range [first, last[ which need not be sorted. See insertRange() for details.
+        template <class Iter_T>
+        void assign(Iter_T first, const Iter_T last)
+        {
+            clear();
+            insertRange(first, last);
+        }
+
+        // Inserts all items from other set. If both are sorted, this is done with single O(n + m) merge pass.
+        void merge(const DFG_CLASS_NAME(SetVector)& other)
+        {
+            if (&other != this)
+                insertRangeImpl(other.begin(), other.end(), other.isSorted());
+        }
+
         void reserve(const size_t nReserve) { m_storage.reserve(nReserve); }
 
         size_t capacity() const             { return m_storage.capacity(); }
 
         void sort()
         {
+            this->unfreeze();
             std::sort(m_storage.begin(), m_storage.end(), [](const value_type& left, const value_type& right)
             {
                 return left < right;
@@ -224,9 +256,22 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
                 return;
             if (bSort)
                 sort();
+            else
+                this->unfreeze();
             this->m_bSorted = bSort;
         }
 
+        // Makes container read-optimized: sorts it if needed and builds auxiliary search index with keys in Eytzinger layout
+        // so that find() does branchless, prefetching search instead of std::lower_bound over key storage.
+        // Storage and iteration order are not changed. Index is removed by any modifying operation (see unfreeze()), but if keys are modified
+        // directly through storage, unfreeze() must be called before next find(); find() asserts that index size matches container size.
+        // Note: the index stores a copy of keys, so this is mostly useful for large maps with cheap-to-copy keys such as integers.
+        void freeze()
+        {
+            setSorting(true);
+            this->m_spFrozenSearchIndex = std::make_shared<typename BaseClass::FrozenSearchIndex>(begin(), end(), [](const key_type& key) -> const key_type& { return key; });
+        }
+
         bool operator==(const DFG_CLASS_NAME(SetVector)& other) const
         {
             if (size() != other.size())
@@ -249,6 +294,31 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
             return !(*this == other);
         }
 
+    private:
+        template <class Iter_T>
+        void insertRangeImpl(Iter_T first, const Iter_T last, const bool bSourceSorted)
+        {
+            if (!this->m_bSorted)
+            {
+                for (; first != last; ++first)
+                    insert(*first);
+                return;
+            }
+            if (first == last)
+                return;
+            this->unfreeze();
+            const auto nOldSize = m_storage.size();
+            m_storage.insert(m_storage.end(), first, last);
+            const auto iterMid = m_storage.begin() + nOldSize;
+            const auto pred = [](const value_type& left, const value_type& right) { return left < right; };
+            if (!bSourceSorted)
+                DFG_MODULE_NS(alg)::stableSortParallel(iterMid, m_storage.end(), pred);
+            // inplace_merge is stable so that of equal items existing ones precede the new ones and get kept by unique().
+            std::inplace_merge(m_storage.begin(), iterMid, m_storage.end(), pred);
+            m_storage.erase(std::unique(m_storage.begin(), m_storage.end(), [](const value_type& left, const value_type& right) { return isKeyMatch(left, right); }), m_storage.end());
+        }
+
+    public:
         ContainerT m_storage;
     }; // class SetVector
 
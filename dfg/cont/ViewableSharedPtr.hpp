@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../dfgDefs.hpp"
+#include "../dfgBaseTypedefs.hpp"
 #include "../build/languageFeatureInfo.hpp"
 
 #if DFG_LANGFEAT_MUTEX_11
@@ -8,6 +9,7 @@
 DFG_BEGIN_INCLUDE_WITH_DISABLED_WARNINGS // VC2012 generates C4265 "class has virtual functions, but destructor is not virtual" from <mutex>.
     #include <mutex>
 DFG_END_INCLUDE_WITH_DISABLED_WARNINGS
+#include <atomic>
 #include <map>
 #include <functional>
 #include <memory>
@@ -180,6 +182,250 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
         DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(ViewableSharedPtr));
     };
 
+    namespace DFG_DETAIL_NS
+    {
+        // Router for ViewableSharedPtrReadMostly: read path is lock-free with respect to this object (no mutex is taken in view() or version()),
+        // writers are serialized with a writer mutex and reset notifiers are called with only the notifier mutex held.
+        // Note: since notifiers are called with notifier mutex held, notifiers must not call addResetNotifier() or removeResetNotifier() (would deadlock).
+        template <class T>
+        class DFG_CLASS_NAME(ViewableSharedPtrReadMostlyRouterProxy)
+        {
+        public:
+            typedef std::map<DFG_CLASS_NAME(SourceResetNotifierId), DFG_CLASS_NAME(SourceResetNotifier)> SourceResetNotifierMap;
+            typedef std::mutex MutexT;
+            typedef std::lock_guard<MutexT> LockGuardT;
+            typedef uint64 VersionT;
+
+            DFG_CLASS_NAME(ViewableSharedPtrReadMostlyRouterProxy)() :
+                m_nVersion(0)
+            {}
+
+            void reset(std::shared_ptr<const T> newItem)
+            {
+                {
+                    LockGuardT writeLock(m_writeMutex);
+                    std::atomic_store_explicit(&m_spObj, std::move(newItem), std::memory_order_release);
+                    // Version is incremented after the object has been published so that reader seeing the new version is guaranteed to see the new object.
+                    m_nVersion.fetch_add(1, std::memory_order_release);
+                }
+                LockGuardT notifierLock(m_notifierMutex);
+                for (auto& notifierItem : m_notifiers)
+                {
+                    notifierItem.second(DFG_CLASS_NAME(SourceResetParam)());
+                }
+            }
+
+            std::shared_ptr<const T> view() const
+            {
+                return std::atomic_load_explicit(&m_spObj, std::memory_order_acquire);
+            }
+
+            VersionT version() const
+            {
+                return m_nVersion.load(std::memory_order_acquire);
+            }
+
+            void addResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId) id, DFG_CLASS_NAME(SourceResetNotifier) srn)
+            {
+                LockGuardT lock(m_notifierMutex);
+                m_notifiers[id] = srn;
+            }
+
+            void removeResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId) id)
+            {
+                LockGuardT lock(m_notifierMutex);
+                m_notifiers.erase(id);
+            }
+
+            size_t resetNotifierCount() const
+            {
+                LockGuardT lock(m_notifierMutex);
+                return m_notifiers.size();
+            }
+
+            std::shared_ptr<const T> m_spObj; // Accessed only through std::atomic_* functions.
+            std::atomic<VersionT> m_nVersion;
+            SourceResetNotifierMap m_notifiers;
+            mutable MutexT m_writeMutex;
+            mutable MutexT m_notifierMutex;
+        };
+    } // namespace DFG_DETAIL_NS
+
+    /*
+    Viewer for ViewableSharedPtrReadMostly.
+    Viewer caches a snapshot of the viewed shared_ptr together with the version it was taken from; viewCached() revalidates the snapshot
+    with a single atomic load of the version counter and only when version has changed, reloads the shared_ptr. This makes the common
+    (unchanged) case wait-free and free of reference count traffic on the shared control block.
+    Note: Viewer object itself is not thread safe: typical usage is to have a viewer per reader thread.
+    */
+    template <class T>
+    class DFG_CLASS_NAME(ViewableSharedPtrReadMostlyViewer)
+    {
+    public:
+        typedef DFG_DETAIL_NS::DFG_CLASS_NAME(ViewableSharedPtrReadMostlyRouterProxy)<T> RouterT;
+        typedef typename RouterT::VersionT VersionT;
+
+        DFG_CLASS_NAME(ViewableSharedPtrReadMostlyViewer)(std::shared_ptr<RouterT> spRouter) :
+            m_spRouter(std::move(spRouter)),
+            m_nCachedVersion(0)
+        {
+            if (m_spRouter)
+            {
+                m_nCachedVersion = m_spRouter->version();
+                m_spCached = m_spRouter->view();
+            }
+        }
+
+        // Returns shared_ptr to viewed object or empty. Always reads the shared state, i.e. doesn't use the cached snapshot.
+        std::shared_ptr<const T> view()
+        {
+            return (m_spRouter) ? m_spRouter->view() : std::shared_ptr<const T>();
+        }
+
+        // Returns reference to cached snapshot after revalidating it. Returned reference is valid until next call to viewCached() or until viewer is destroyed.
+        const std::shared_ptr<const T>& viewCached()
+        {
+            if (m_spRouter)
+            {
+                const auto nVersion = m_spRouter->version();
+                if (nVersion != m_nCachedVersion)
+                {
+                    // Note: if there's a reset between version load and view(), snapshot is newer than version implies,
+                    //       which only causes an extra reload on next call.
+                    m_spCached = m_spRouter->view();
+                    m_nCachedVersion = nVersion;
+                }
+            }
+            return m_spCached;
+        }
+
+        // Releases cached snapshot so that viewer doesn't keep an outdated object alive; next viewCached() reloads it.
+        void releaseCached()
+        {
+            m_spCached.reset();
+            m_nCachedVersion = (m_spRouter) ? m_spRouter->version() - 1 : 0;
+        }
+
+        std::shared_ptr<RouterT> m_spRouter;
+        std::shared_ptr<const T> m_spCached;
+        VersionT m_nCachedVersion;
+
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(ViewableSharedPtrReadMostlyViewer));
+    };
+
+    /*
+    Read-mostly variant of ViewableSharedPtr for cases where object is viewed frequently from many threads but reset rarely.
+    Interface is the same as in ViewableSharedPtr, differences are:
+        -View path doesn't take a mutex: shared_ptr is published with std::atomic_store() and read with std::atomic_load().
+        -Viewers can use per-viewer cached snapshot (see ViewableSharedPtrReadMostlyViewer::viewCached()) that is revalidated
+         against a version counter that is incremented on every reset.
+        -Reset notifiers are called without holding any lock that is used by readers, so notifiers can call view() even from other threads.
+         Resets are serialized as a whole: notifiers of one reset complete before the next reset begins.
+        -Notifiers are called with notifier mutex and reset mutex held, so notifiers must not call reset(), addResetNotifier() or removeResetNotifier()
+         since those would deadlock.
+        -Viewers don't own reset notifiers: notifier added with addResetNotifier() stays until removed with removeResetNotifier(),
+         also when it was added with viewer address as id and the viewer gets destroyed.
+    Note: std::atomic_load() for shared_ptr is not guaranteed to be lock-free (e.g. libstdc++ uses a small pool of spinlocks keyed by address),
+          so for hot read loops, viewCached() is the recommended path.
+    */
+    template <class T>
+    class DFG_CLASS_NAME(ViewableSharedPtrReadMostly)
+    {
+    public:
+        typedef DFG_DETAIL_NS::DFG_CLASS_NAME(ViewableSharedPtrReadMostlyRouterProxy)<T> RouterT;
+        typedef DFG_CLASS_NAME(ViewableSharedPtrReadMostlyViewer)<T> ViewerT;
+        typedef std::mutex MutexT;
+        typedef std::lock_guard<MutexT> LockGuardT;
+
+        DFG_CLASS_NAME(ViewableSharedPtrReadMostly)(std::shared_ptr<T> sp = std::shared_ptr<T>()) :
+            m_spObj(std::move(sp))
+        {
+            m_spRouter = std::make_shared<RouterT>();
+            m_spRouter->reset(m_spObj);
+        }
+
+        DFG_CLASS_NAME(ViewableSharedPtrReadMostly)(DFG_CLASS_NAME(ViewableSharedPtrReadMostly)&& other)
+        {
+            LockGuardT lock(other.m_mutex);
+            m_spObj = std::move(other.m_spObj);
+            m_spRouter = std::move(other.m_spRouter);
+        }
+
+        ~DFG_CLASS_NAME(ViewableSharedPtrReadMostly)()
+        {
+            if (m_spRouter)
+                reset(std::shared_ptr<T>());
+        }
+
+        std::shared_ptr<ViewerT> createViewer()
+        {
+            LockGuardT lock(m_mutex);
+            return std::make_shared<ViewerT>(m_spRouter);
+        }
+
+        void reset(std::shared_ptr<T> other = std::shared_ptr<T>())
+        {
+            // m_resetMutex makes the whole reset atomic with respect to other resets so that m_spObj and the object in router can't end up
+            // being from different resets.
+            LockGuardT resetLock(m_resetMutex);
+            std::shared_ptr<RouterT> spRouter;
+            {
+                LockGuardT lock(m_mutex);
+                m_spObj = other;
+                spRouter = m_spRouter;
+            }
+            // Router reset (and notifier calls) is done outside m_mutex so that notifiers can e.g. call sharedPtrCopy().
+            if (spRouter)
+                spRouter->reset(std::move(other));
+        }
+
+        void addResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId) id, DFG_CLASS_NAME(SourceResetNotifier) srn)
+        {
+            LockGuardT lock(m_mutex);
+            if (m_spRouter)
+                m_spRouter->addResetNotifier(id, srn);
+        }
+
+        void removeResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId) id)
+        {
+            LockGuardT lock(m_mutex);
+            if (m_spRouter)
+                m_spRouter->removeResetNotifier(id);
+        }
+
+        // Returns copy of the underlying shared_ptr.
+        std::shared_ptr<T> sharedPtrCopy()
+        {
+            LockGuardT lock(m_mutex);
+            return m_spObj;
+        }
+
+        const T* get() const
+        {
+            LockGuardT lock(m_mutex);
+            return m_spObj.get();
+        }
+
+        // Returns number of resets done, can be used to detect changes.
+        typename RouterT::VersionT version() const
+        {
+            return (m_spRouter) ? m_spRouter->version() : 0;
+        }
+
+        DFG_EXPLICIT_OPERATOR_BOOL_IF_SUPPORTED operator bool() const
+        {
+            LockGuardT lock(m_mutex);
+            return m_spObj != nullptr;
+        }
+
+        std::shared_ptr<T> m_spObj;
+        std::shared_ptr<RouterT> m_spRouter;
+        mutable std::mutex m_mutex;
+        std::mutex m_resetMutex; // Serializes reset() calls.
+
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(ViewableSharedPtrReadMostly));
+    };
+
 } } // module namespace
 
 #endif // DFG_LANGFEAT_MUTEX_11
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../../dfgDefs.hpp"
+#include "../../dfgAssert.hpp"
 #include "../../alg/find.hpp"
 #include "../../ReadOnlySzParam.hpp"
+#include "../EytzingerSearchIndex.hpp"
+#include <memory>
 #include <type_traits>
 
 DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) { namespace DFG_DETAIL_NS {
@@ -58,6 +61,15 @@ public:
     typedef typename Traits_T::key_iterator         key_iterator;
     typedef typename Traits_T::const_key_iterator   const_key_iterator;
 
+    typedef DFG_CLASS_NAME(EytzingerSearchIndex)<key_type> FrozenSearchIndex;
+
+    // Defines which item is kept in bulk operations when there are several items with equal keys.
+    enum DuplicatePolicy
+    {
+        DuplicatePolicyKeepFirst,   // Keeps existing item, or if not existing, the first one in input; i.e. like sequence of insert() calls.
+        DuplicatePolicyKeepLast     // Keeps the last one in input; i.e. like sequence of assignments through operator[].
+    };
+
     template <class This_T>
     class KeyIteratorValueToComparable
     {
@@ -93,7 +105,14 @@ public:
     static auto findImpl(This_T& rThis, const T& keyRaw) -> decltype(rThis.makeIterator(0)) // iterator // std::conditional<std::is_const<This_T>::value, const_iterator, iterator>::type //, decltype(rThis.makeIterator(0))
     {
         const auto& key = makeInternalSearchType<typename This_T::key_type>(keyRaw);
-        if (rThis.isSorted())
+        if (rThis.isSorted() && rThis.m_spFrozenSearchIndex)
+        {
+            // Index is stale if storage was modified without unfreeze(), e.g. through non-const key iterators or storage accessors.
+            DFG_ASSERT_WITH_MSG(rThis.m_spFrozenSearchIndex->size() == rThis.size(), "Frozen search index doesn't match container: keys modified directly without calling unfreeze()?");
+            const auto nPos = rThis.m_spFrozenSearchIndex->lowerBound(key);
+            return (nPos < rThis.size() && isKeyMatch(rThis.keyIterValueToKeyValue(*(rThis.beginKey() + nPos)), key)) ? rThis.makeIterator(nPos) : rThis.end();
+        }
+        else if (rThis.isSorted())
         {
             auto iter = rThis.findInsertPos(rThis, key);
             return (iter != rThis.endKey() && isKeyMatch(rThis.keyIterValueToKeyValue(*iter), key)) ? rThis.makeIterator(iter - rThis.beginKey()) : rThis.end();
@@ -104,7 +123,15 @@ public:
 
     bool isSorted() const       { return m_bSorted; }
 
+    // Returns true if container has read-optimized search index (see freeze() in concrete containers).
+    bool isFrozen() const       { return m_spFrozenSearchIndex != nullptr; }
+
+    // Removes read-optimized search index. Modifying operations call this automatically, but if keys are modified
+    // directly (e.g. through storage or non-const key references), this must be called explicitly.
+    void unfreeze()             { m_spFrozenSearchIndex.reset(); }
+
     bool m_bSorted;
+    std::shared_ptr<const FrozenSearchIndex> m_spFrozenSearchIndex; // Immutable so can be shared by copies.
 
 }; // class KeyContainerBase
 
@@ -7,7 +7,9 @@
 #include "../alg/sortMultiple.hpp"
 #include "../io/textEncodingTypes.hpp"
 #include "../numericTypeTools.hpp"
+#include "../rangeIterator.hpp"
 #include <algorithm>
+#include <iterator>
 #include <vector>
 #include <memory>
 #include <numeric>
@@ -25,6 +27,9 @@
 DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
 
     // Container for table which may have non equal row sizes.
+    // Elements are stored row by row in a single contiguous container and start position of each row is maintained
+    // in a prefix array so that element access is O(1). Appending to the last row is amortized O(1); adding elements to other rows
+    // requires moving all elements after the insert position.
     template <class Elem_T, class Index_T = size_t>
     class DFG_CLASS_NAME(Table)
     {
@@ -38,6 +43,12 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         typedef typename ElementContainerT::iterator iterator;
         typedef typename ElementContainerT::const_iterator const_iterator;
         typedef Elem_T value_type;
+        typedef DFG_CLASS_NAME(RangeIterator_T)<iterator> RowRange;
+        typedef DFG_CLASS_NAME(RangeIterator_T)<const_iterator> ConstRowRange;
+
+        DFG_CLASS_NAME(Table)() :
+            m_rowOffsets(1, 0)
+        {}
 
         iterator begin() { return m_contElems.begin(); }
         const_iterator begin() const { return m_contElems.begin(); }
@@ -52,22 +63,21 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
             if (nRow == NumericTraits<Index_T>::maxValue) // Make sure that nRow + 1 won't overflow.
                 return;
 
-            if (!isValidIndex(m_rowSizes, nRow))
-            {
-                m_rowSizes.resize(nRow + 1, 0);
-            }
+            privateMakeRowExist(nRow);
             DFG_ASSERT_UB(isValidIndex(m_rowSizes, nRow));
             if (nRow + 1 == m_rowSizes.size()) // Adding element as the last item on the last row.
             {
                 m_contElems.push_back(std::move(elem));
                 m_rowSizes.back()++;
+                m_rowOffsets.back()++;
             }
             else
             {
-                const auto nPos = privateGetLinearPosition(nRow + 1, 0);
+                const auto nPos = m_rowOffsets[nRow + 1];
                 auto iterNewPos = m_contElems.begin() + nPos;
                 m_contElems.insert(iterNewPos, std::move(elem));
                 m_rowSizes[nRow]++;
+                privateAddToRowOffsetsAfter(nRow, 1);
             }
         }
 
@@ -75,8 +85,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         {
             if (nRow == NumericTraits<Index_T>::maxValue || nCol == NumericTraits<Index_T>::maxValue) // Make sure that nRow + 1 nor nCol + 1 won't overflow.
                 return;
-            if (!isValidIndex(m_rowSizes, nRow))
-                m_rowSizes.resize(nRow + 1, 0);
+            privateMakeRowExist(nRow);
             if (nRow == m_rowSizes.size() - 1 && nCol == m_rowSizes[nRow]) // If new item is next on row, do pushBackOnRow.
                 pushBackOnRow(nRow, std::move(elem));
             else // Case: not next item on row.
@@ -88,6 +97,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
                     const auto iterAddPos = m_contElems.begin() + nPos;
                     const auto nSizeInc = nCol - nOldRowSize + 1;
                     m_rowSizes[nRow] = nCol + 1;
+                    privateAddToRowOffsetsAfter(nRow, nSizeInc);
                     m_contElems.insert(iterAddPos, nSizeInc, Elem_T());
                     m_contElems[nPos + nSizeInc - 1] = std::move(elem);
                 }
@@ -104,15 +114,15 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         {
             if (!isValidTableIndex(nRow, nCol))
                 return s_nInvalidIndex;
-            const auto nPos = nCol + std::accumulate(m_rowSizes.cbegin(), m_rowSizes.cbegin() + nRow, Index_T(0));
-            return nPos;
+            return m_rowOffsets[nRow] + nCol;
         }
 
         // Like privateGetLinearPosition, but if element at (nRow, nCol) does not exist, returns the index that given element would have if added to table.
+        // Precondition: row nRow must exist.
         Index_T privateGetLinearPositionVirtual(Index_T nRow, Index_T nCol) const
         {
-            const auto nPos = nCol + std::accumulate(m_rowSizes.cbegin(), m_rowSizes.cbegin() + nRow, Index_T(0));
-            return nPos;
+            DFG_ASSERT_UB(isValidIndex(m_rowSizes, nRow));
+            return m_rowOffsets[nRow] + nCol;
         }
 
         bool isValidTableIndex(Index_T row, Index_T col) const
@@ -133,6 +143,33 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
             return isValidIndex(m_rowSizes, nRow) ? m_rowSizes[nRow] : 0;
         }
 
+        // Returns range of elements on given row, empty range if row does not exist.
+        RowRange rowRange(const Index_T nRow)
+        {
+            const auto iterBegin = (isValidIndex(m_rowSizes, nRow)) ? m_contElems.begin() + m_rowOffsets[nRow] : m_contElems.end();
+            return makeRange(iterBegin, iterBegin + getColumnCountOnRow(nRow));
+        }
+
+        ConstRowRange rowRange(const Index_T nRow) const
+        {
+            const auto iterBegin = (isValidIndex(m_rowSizes, nRow)) ? m_contElems.cbegin() + m_rowOffsets[nRow] : m_contElems.cend();
+            return makeRange(iterBegin, iterBegin + getColumnCountOnRow(nRow));
+        }
+
+        // Calls func(nRow, rowRange) for every row in order. Cheaper than accessing elements by (row, col) since
+        // row start is advanced incrementally.
+        template <class Func_T>
+        void forEachRow(Func_T&& func) const
+        {
+            auto iterRowBegin = m_contElems.cbegin();
+            for (Index_T r = 0, nRowCount = getRowCount(); r < nRowCount; ++r)
+            {
+                const auto iterRowEnd = iterRowBegin + m_rowSizes[r];
+                func(r, makeRange(iterRowBegin, iterRowEnd));
+                iterRowBegin = iterRowEnd;
+            }
+        }
+
         // Returns true iff. this is empty or all rows have equal size.
         bool hasSingleColumnCount() const
         {
@@ -159,6 +196,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         {
             m_contElems.clear();
             m_rowSizes.clear();
+            m_rowOffsets.assign(1, 0);
         }
 
         // TODO: test
@@ -177,11 +215,33 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
             const auto excessElems = m_contElems.size() % rowLength;
             if (excessElems > 0)
                 m_rowSizes.push_back(excessElems);
-            DFG_ASSERT(std::accumulate(m_rowSizes.cbegin(), m_rowSizes.cend(), size_t(0)) == m_contElems.size());
+            m_rowOffsets.resize(m_rowSizes.size() + 1);
+            m_rowOffsets[0] = 0;
+            std::partial_sum(m_rowSizes.cbegin(), m_rowSizes.cend(), m_rowOffsets.begin() + 1);
+            DFG_ASSERT(m_rowOffsets.back() == m_contElems.size());
         }
 
+    private:
+        void privateMakeRowExist(const Index_T nRow)
+        {
+            if (m_rowOffsets.empty()) // Can be empty e.g. if moved from.
+                m_rowOffsets.push_back(0);
+            if (isValidIndex(m_rowSizes, nRow))
+                return;
+            m_rowSizes.resize(nRow + 1, 0);
+            m_rowOffsets.resize(nRow + 2, m_rowOffsets.back());
+        }
+
+        void privateAddToRowOffsetsAfter(const Index_T nRow, const Index_T nAddition)
+        {
+            for (auto iter = m_rowOffsets.begin() + nRow + 1, iterEnd = m_rowOffsets.end(); iter != iterEnd; ++iter)
+                *iter += nAddition;
+        }
+
+    public:
         ElementContainerT m_contElems;
         std::vector<Index_T> m_rowSizes;
+        std::vector<Index_T> m_rowOffsets; // m_rowOffsets[r] is the position of the first element of row r in m_contElems; has one item more than m_rowSizes.
     };
 
     namespace DFG_DETAIL_NS
@@ -369,6 +429,111 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         // Return: true if string was added, false otherwise.
         // Note: Even in case of overwrite, previous item is not cleared from string storage (this is implementation detail that is not part of the interface, i.e. it is not to be relied on).
         bool addString(const DFG_CLASS_NAME(StringView)<Char_T, StringT> sv, const Index_T nRow, const Index_T nCol)
+        {
+            if (!privEnsureColumn(nCol))
+                return false;
+            const Char_T* const pData = privStoreString(sv, nCol);
+            if (!pData)
+                return false;
+            privSetRowContent(m_colToRows[nCol], nRow, pData);
+            return true;
+        }
+
+        // Sets elements to rows [nRowBegin, nRowBegin + nCount[ in column nCol: content of row nRowBegin + i is given by strGenerator(i),
+        // which must return an object convertible to StringView (the returned view needs to remain valid only until the next call).
+        // This is an optimized alternative to calling setElement() in a loop: if the range is after existing rows in the column,
+        // row index storage is reserved once and items are appended without lookups.
+        // Return: number of elements that were set (may be less than nCount if an item can't be added, see addString()).
+        template <class Func_T>
+        Index_T setElementsInColumn(const Index_T nCol, const Index_T nRowBegin, const Index_T nCount, Func_T&& strGenerator)
+        {
+            if (nCount <= 0 || !privEnsureColumn(nCol))
+                return 0;
+            auto& rowsInCol = m_colToRows[nCol];
+            const bool bAppending = (rowsInCol.empty() || nRowBegin > rowsInCol.back().first);
+            if (bAppending)
+                rowsInCol.reserve(rowsInCol.size() + static_cast<size_t>(nCount));
+            Index_T nSetCount = 0;
+            for (Index_T i = 0; i < nCount; ++i)
+            {
+                const Char_T* const pData = privStoreString(DFG_CLASS_NAME(StringView)<Char_T, StringT>(strGenerator(i)), nCol);
+                if (!pData)
+                    continue;
+                if (bAppending)
+                    rowsInCol.push_back(IndexPtrPair(nRowBegin + i, pData));
+                else
+                    privSetRowContent(rowsInCol, nRowBegin + i, pData);
+                ++nSetCount;
+            }
+            return nSetCount;
+        }
+
+        // Appends content of other table to this table by adopting its string storage instead of copying strings:
+        // item at (r, c) in other is placed to (nRowOffset + r, columnMap[c]), or to (nRowOffset + r, c) if columnMap is empty.
+        // Only row index entries are processed per cell; if target column has no rows >= nRowOffset, they are simply appended.
+        // Otherwise items are merged and existing items at the same positions are overwritten (as are items from earlier columns of other mapped to the same column).
+        // After this call other is empty but usable. Block size settings of other are not adopted.
+        // Return: false if columnMap is not empty and doesn't have valid target for each column of other; in this case neither table is modified.
+        bool appendTableByAdoptingStorage(DFG_CLASS_NAME(TableSz)& other, const Index_T nRowOffset, const std::vector<Index_T>& columnMap = std::vector<Index_T>())
+        {
+            if (&other == this)
+                return false;
+            const Index_T nOtherColCount = other.colCountByMaxColIndex();
+            if (!columnMap.empty())
+            {
+                if (columnMap.size() < static_cast<size_t>(nOtherColCount))
+                    return false;
+                for (Index_T c = 0; c < nOtherColCount; ++c)
+                {
+                    if (columnMap[c] < 0 || columnMap[c] >= NumericTraits<Index_T>::maxValue)
+                        return false;
+                }
+            }
+            for (Index_T c = 0; c < nOtherColCount; ++c)
+            {
+                const Index_T nTargetCol = (columnMap.empty()) ? c : columnMap[c];
+                if (!privEnsureColumn(nTargetCol))
+                    return false; // Shouldn't happen as column indexes were checked above.
+
+                // Adopted blocks are inserted before the current last block so that it remains the block to which new strings are appended.
+                auto& destBuffers = m_charBuffers[nTargetCol];
+                auto& srcBuffers = other.m_charBuffers[c];
+                const auto iterInsertPos = (destBuffers.empty()) ? destBuffers.end() : destBuffers.end() - 1;
+                destBuffers.insert(iterInsertPos, std::make_move_iterator(srcBuffers.begin()), std::make_move_iterator(srcBuffers.end()));
+                srcBuffers.clear();
+
+                auto& destRows = m_colToRows[nTargetCol];
+                auto& srcRows = other.m_colToRows[c];
+                const bool bAppending = (destRows.empty() || nRowOffset > destRows.back().first);
+                if (bAppending)
+                    destRows.reserve(destRows.size() + srcRows.size());
+                for (auto iter = srcRows.cbegin(), iterEnd = srcRows.cend(); iter != iterEnd; ++iter)
+                {
+                    // Shared empty item is owned by the table object, not by the storage, so it needs to be remapped.
+                    const Char_T* const pData = (iter->second == &other.m_emptyString) ? &m_emptyString : iter->second;
+                    if (bAppending)
+                        destRows.push_back(IndexPtrPair(nRowOffset + iter->first, pData));
+                    else
+                        privSetRowContent(destRows, nRowOffset + iter->first, pData);
+                }
+                srcRows.clear();
+            }
+            m_externalStorages.insert(m_externalStorages.end(), std::make_move_iterator(other.m_externalStorages.begin()), std::make_move_iterator(other.m_externalStorages.end()));
+            other.m_externalStorages.clear();
+            return true;
+        }
+
+        // Keeps given object alive as long as table content may refer to it, i.e. until clear() or destruction.
+        // Used when cell pointers refer to storage not owned by m_charBuffers, e.g. string blocks of a memory mapped snapshot (see tableSnapshot.hpp).
+        // Note: external storage is not included in contentStorageSizeInBytes().
+        void adoptExternalStorage(std::shared_ptr<const void> spStorage)
+        {
+            if (spStorage)
+                m_externalStorages.push_back(std::move(spStorage));
+        }
+
+        // Makes sure that column nCol exists. Return: false if column can't be created.
+        bool privEnsureColumn(const Index_T nCol)
         {
             if (!isValidIndex(m_colToRows, nCol))
             {
@@ -378,15 +543,18 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
                 m_colToRows.resize(nCol + 1);
                 m_charBuffers.resize(nCol + 1);
             }
+            return true;
+        }
 
+        // Stores string to character storage of column nCol and returns pointer to stored null terminated string or nullptr if string can't be stored.
+        // Precondition: column nCol exists.
+        const Char_T* privStoreString(const DFG_CLASS_NAME(StringView)<Char_T, StringT>& sv, const Index_T nCol)
+        {
             const auto nLength = sv.length();
 
             // Optimization: use shared null for empty items.
             if (nLength == 0)
-            {
-                privSetRowContent(m_colToRows[nCol], nRow, &m_emptyString);
-                return true;
-            }
+                return &m_emptyString;
 
             auto& bufferCont = m_charBuffers[nCol];
 
@@ -397,7 +565,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
                 const size_t nNewBlockSize = (m_bAllowStringsLongerThanBlockSize) ? Max(m_nBlockSize, nLength + 1) : m_nBlockSize;
                 // If content has length greater than block size and block size is not allowed to be exceeded, return false as item can't be added.
                 if (nLength >= nNewBlockSize)
-                    return false;
+                    return nullptr;
                 bufferCont.push_back(CharStorageItem(nNewBlockSize));
             }
 
@@ -409,11 +577,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
             currentBuffer.append_unchecked(toCharPtr_raw(sv.begin()), nLength);
             currentBuffer.append_unchecked('\0');
 
-            const Char_T* const pData = &currentBuffer[nBeginIndex];
-
-            privSetRowContent(m_colToRows[nCol], nRow, pData);
-
-            return true;
+            return &currentBuffer[nBeginIndex];
         }
 
         // Shared implementation for const/non-const cases.
@@ -461,6 +625,19 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
                 func(iter->first, SzPtrR(iter->second));
         }
 
+        // Like forEachFwdRowInColumn(), but visits only rows within range [nRowBegin, nRowEnd[.
+        // Unlike calling operator() for each row, this does only one search per call so it is suitable e.g. for processing a column in row range chunks.
+        template <class Func_T>
+        void forEachFwdRowInColumn(const Index_T nCol, const Index_T nRowBegin, const Index_T nRowEnd, Func_T&& func) const
+        {
+            if (!isValidIndex(m_colToRows, nCol) || nRowBegin >= nRowEnd)
+                return;
+
+            const auto& rowsInCol = m_colToRows[nCol];
+            for (auto iter = privLowerBoundInColumn<typename ColumnIndexPairContainer::const_iterator>(rowsInCol, nRowBegin), iterEnd = rowsInCol.end(); iter != iterEnd && iter->first < nRowEnd; ++iter)
+                func(iter->first, SzPtrR(iter->second));
+        }
+
         // Visits all cells that have non-null ptr in unspecified order.
         template <class Func_T>
         void forEachNonNullCell(Func_T&& func) const
@@ -642,6 +819,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         {
             m_charBuffers.clear();
             m_colToRows.clear();
+            m_externalStorages.clear();
         }
 
         void swapCellContentInColumn(ColumnIndexPairContainer& colItems, const Index_T r0, const Index_T r1)
@@ -721,6 +899,7 @@ DFG_ROOT_NS_BEGIN { DFG_SUB_NS(cont) {
         const Char_T m_emptyString; // Shared empty item.
         CharStorageContainer m_charBuffers;
         TableIndexPairContainer m_colToRows;
+        std::vector<std::shared_ptr<const void>> m_externalStorages; // Storages not owned by m_charBuffers that cell pointers may refer to, see adoptExternalStorage().
         size_t m_nBlockSize;
         bool m_bAllowStringsLongerThanBlockSize; // If false, strings longer than m_nBlockSize can't be added to table.
     };
@@ -16,6 +16,10 @@
 #include "CsvConfig.hpp"
 #include "../str/stringLiteralCharToValue.hpp"
 #include "../io/IfmmStream.hpp"
+#include "../rangeIterator.hpp"
+#include "../time/profiling.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <thread>
 
 DFG_ROOT_NS_BEGIN{ 
     
@@ -237,6 +241,8 @@ DFG_ROOT_NS_BEGIN{
                     {
                         auto p0 = (*this)(r, c);
                         auto p1 = other(r, c);
+                        if (!p0 && !p1) // Both non-existent, e.g. in rows shorter than column count.
+                            continue;
 						// TODO: revise logics: implementation below treats null and empty cells as different.
                         if ((!p0 && p1) || (p0 && !p1) || (std::strcmp(toCharPtr_raw(p0), toCharPtr_raw(p1)) != 0)) // TODO: Create comparison function instead of using strcmp().
                             return false;
@@ -254,6 +260,7 @@ DFG_ROOT_NS_BEGIN{
             template <class Char_T1>
             void readFromFileImpl(const DFG_CLASS_NAME(ReadOnlySzParam)<Char_T1>& sPath, const CsvFormatDefinition& formatDef)
             {
+                DFG_PROFILE_ZONE("TableCsv::readFromFile");
                 bool bRead = false;
                 try
                 {
@@ -304,6 +311,8 @@ DFG_ROOT_NS_BEGIN{
 
             void readFromMemory(const char* const pData, const size_t nSize, const CsvFormatDefinition& formatDef)
             {
+                DFG_PROFILE_ZONE("TableCsv::readFromMemory");
+                DFG_PROFILE_COUNTER("TableCsv::readFromMemory bytes", nSize);
                 DFG_MODULE_NS(io)::DFG_CLASS_NAME(BasicImStream) strmBom(pData, nSize);
                 const auto streamBom = DFG_MODULE_NS(io)::checkBOM(strmBom);
                 const auto encoding = (formatDef.textEncoding() == DFG_MODULE_NS(io)::encodingUnknown) ? streamBom : formatDef.textEncoding();
@@ -343,6 +352,7 @@ DFG_ROOT_NS_BEGIN{
             void read(Strm_T& strm, const DFG_CLASS_NAME(CsvFormatDefinition)& formatDef, CharAppender_T)
             {
                 using namespace DFG_MODULE_NS(io);
+                DFG_PROFILE_ZONE("TableCsv::read");
                 this->clear();
 
                 auto cellHandler = [=](const size_t nRow, const size_t nCol, const Char_T* pData, const size_t nCount)
@@ -353,6 +363,8 @@ DFG_ROOT_NS_BEGIN{
                 };
                 typedef DFG_CLASS_NAME(DelimitedTextReader)::ParsingDefinition<char, CharAppender_T> ParseDef;
                 const auto& readFormat = DFG_CLASS_NAME(DelimitedTextReader)::readEx(ParseDef(), strm, formatDef.separatorChar(), formatDef.enclosingChar(), formatDef.eolCharFromEndOfLineType(), cellHandler);
+                DFG_PROFILE_COUNTER("TableCsv::read rows", this->rowCountByMaxRowIndex());
+                DFG_PROFILE_COUNTER("TableCsv::read cells", this->cellCountNonEmpty());
 
                 m_readFormat.separatorChar(readFormat.getSep());
                 m_readFormat.enclosingChar(readFormat.getEnc());
@@ -453,11 +465,82 @@ DFG_ROOT_NS_BEGIN{
                 return WritePolicySimple<Stream_T>(format);
             }
             
+            // Writes cells of columns [nFirstCol, nEndCol[ of given rows as delimited text to a string so that each row, including the last one,
+            // ends with eol. Rows are written in the order given in 'rows' and need not be sorted or contiguous. Only separator, enclosing char,
+            // eol type and enclosement behaviour of 'format' are used: cell bytes are written untranslated in internal encoding, e.g. as UTF-8 for UTF-8 tables.
+            // With many rows, text is generated in parallel row chunks (in thread::defaultThreadPool()) that are concatenated afterwards.
+            // nMaxThreadCount limits the number of chunks; if 0, it is the thread count of the pool.
+            template <class RowCont_T>
+            std::string rowsToDelimitedText(const RowCont_T& rows, const Index_T nFirstCol, const Index_T nEndCol, const CsvFormatDefinition& format, size_t nMaxThreadCount = 0) const
+            {
+                const size_t s_nMinRowsPerThread = 10000;
+                const size_t nRowCount = static_cast<size_t>(std::distance(std::begin(rows), std::end(rows)));
+                if (nRowCount == 0)
+                    return std::string();
+                auto& pool = DFG_MODULE_NS(thread)::defaultThreadPool();
+                if (nMaxThreadCount == 0)
+                    nMaxThreadCount = pool.threadCount();
+                const size_t nThreadCount = Max(size_t(1), Min(nMaxThreadCount, nRowCount / s_nMinRowsPerThread));
+                const size_t nRowsPerThread = nRowCount / nThreadCount;
+                const char cSep = static_cast<char>(format.separatorChar());
+                const char cEnc = static_cast<char>(format.enclosingChar());
+                const char cEol = static_cast<char>(format.eolCharFromEndOfLineType());
+                const std::string sEol = DFG_MODULE_NS(io)::eolStrFromEndOfLineType(format.eolType());
+                const auto eb = format.enclosementBehaviour();
+
+                std::vector<std::string> chunkResults(nThreadCount);
+                const auto processChunk = [&](const size_t nChunk)
+                {
+                    const size_t nBegin = nChunk * nRowsPerThread;
+                    const size_t nEnd = (nChunk + 1 == nThreadCount) ? nRowCount : nBegin + nRowsPerThread;
+                    auto& sOutput = chunkResults[nChunk];
+                    auto iterRow = std::begin(rows);
+                    std::advance(iterRow, nBegin);
+                    for (size_t i = nBegin; i < nEnd; ++i, ++iterRow)
+                    {
+                        const Index_T nRow = static_cast<Index_T>(*iterRow);
+                        for (Index_T nCol = nFirstCol; nCol < nEndCol; ++nCol)
+                        {
+                            if (nCol != nFirstCol)
+                                sOutput.push_back(cSep);
+                            const auto p = toCharPtr_raw((*this)(nRow, nCol));
+                            if (p == nullptr)
+                                continue;
+                            DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextCellWriter)::writeCellFromStrIter(std::back_inserter(sOutput),
+                                                                                                             makeRange(p, p + std::strlen(p)),
+                                                                                                             cSep,
+                                                                                                             cEnc,
+                                                                                                             cEol,
+                                                                                                             eb);
+                        }
+                        sOutput += sEol;
+                    }
+                };
+
+                DFG_MODULE_NS(thread)::parallelFor(pool, 0, nThreadCount, 1, [&](const size_t i0, const size_t i1)
+                {
+                    for (size_t i = i0; i < i1; ++i)
+                        processChunk(i);
+                });
+
+                if (chunkResults.size() == 1)
+                    return std::move(chunkResults.front());
+                size_t nTotalSize = 0;
+                for (const auto& s : chunkResults)
+                    nTotalSize += s.size();
+                std::string sResult;
+                sResult.reserve(nTotalSize);
+                for (const auto& s : chunkResults)
+                    sResult += s;
+                return sResult;
+            }
+
             // Strm must have write()-method which writes bytes untranslated.
             //  TODO: test writing non-square data.
             template <class Strm_T, class Policy_T>
             void writeToStream(Strm_T& strm, Policy_T& policy) const
             {
+                DFG_PROFILE_ZONE("TableCsv::writeToStream");
                 policy.writeBom(strm);
 
                 if (this->m_colToRows.empty())
@@ -490,6 +573,8 @@ DFG_ROOT_NS_BEGIN{
                     if (!nextColItemRowIters.empty()) // Don't write eol after last line. TODO: make this customisable.
                         policy.writeEol(strm);
                 }
+                DFG_PROFILE_COUNTER("TableCsv::writeToStream rows", this->rowCountByMaxRowIndex());
+                DFG_PROFILE_COUNTER("TableCsv::writeToStream cells", this->cellCountNonEmpty());
             }
 
             // Convenience overload, see implementation version for comments.
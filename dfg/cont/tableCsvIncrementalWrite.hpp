@@ -0,0 +1,214 @@
+#pragma once
+
+/*
+tableCsvIncrementalWrite.hpp
+
+Incremental writing of TableCsv: when table has been read from a file and only some rows have been modified since,
+new file can be created by copying bytes of unmodified rows from the source file and formatting only modified rows.
+Cost is then dominated by disk copy speed (copying is done in kernel where available, see FileRangeCopyWriter) instead of CSV formatting.
+
+Row boundaries of the source are determined with delimitedTextRowOffsets(), a light-weight scan that follows the enclosing rules of DelimitedTextReader.
+As a safeguard, writing is refused if the scanned row count doesn't match the table, in which case caller should do a regular full write.
+
+Notes:
+    -Only the content of modified rows is rewritten: original end-of-line bytes are kept for every row and unmodified rows are kept byte-identical.
+     This means that e.g. rows that were shorter than column count in the source are not padded with separators as in full write.
+    -Modified rows are written with the given format, which must match the source (separator, enclosing char, end-of-line and encoding);
+     only single byte separator and enclosing chars with UTF-8 or Latin-1 encodings are supported.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../ReadOnlySzParam.hpp"
+#include "../io/FileRangeCopyWriter.hpp"
+#include "../io/BasicOmcByteStream.hpp"
+#include "../io/IfmmStream.hpp"
+#include "../utf/utfBom.hpp"
+#include "IntervalSet.hpp"
+#include "tableCsv.hpp"
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    // Computes start offsets of rows in delimited text [pData, pData + nSize[ with given enclosing char (s_nMetaCharNone if none) and end-of-line char.
+    // On success, rOffsets has row count + 1 items: start offset of each row followed by nSize. Each row range includes its end-of-line bytes.
+    // Return: false if rows can't be determined unambiguously (e.g. enclosing char after leading whitespace, unclosed enclosed cell at end of data)
+    //         in which case content of rOffsets is unspecified.
+    inline bool delimitedTextRowOffsets(const char* const pData, const size_t nSize, const int32 cSep, const int32 cEnc, const int32 cEol, std::vector<size_t>& rOffsets)
+    {
+        rOffsets.clear();
+        if (cEol < 0 || cEol > 0x7f || cSep > 0x7f || cEnc > 0x7f)
+            return false;
+        const char cEolChar = static_cast<char>(cEol);
+        const bool bHasEnc = (cEnc >= 0);
+        const char cEncChar = (bHasEnc) ? static_cast<char>(cEnc) : '\0';
+        const char cSepChar = (cSep >= 0) ? static_cast<char>(cSep) : cEolChar;
+        size_t nPos = 0;
+        while (nPos < nSize)
+        {
+            rOffsets.push_back(nPos);
+            const char* pEol = static_cast<const char*>(std::memchr(pData + nPos, cEolChar, nSize - nPos));
+            const size_t nEolPos = (pEol) ? static_cast<size_t>(pEol - pData) : nSize;
+            // Fast path: no enclosing chars in [nPos, nEolPos[ means that row ends at the first eol.
+            if (!bHasEnc || std::memchr(pData + nPos, cEncChar, nEolPos - nPos) == nullptr)
+            {
+                nPos = (pEol) ? nEolPos + 1 : nSize;
+                continue;
+            }
+            // Slow path: parse cell by cell.
+            enum { stateCellStart, stateLeadingWhitespace, stateNaked, stateEnclosed, statePastEnclosed } state = stateCellStart;
+            bool bRowEnded = false;
+            for (; nPos < nSize && !bRowEnded; ++nPos)
+            {
+                const char c = pData[nPos];
+                switch (state)
+                {
+                    case stateCellStart:
+                    case stateLeadingWhitespace:
+                        if (c == cEncChar)
+                        {
+                            if (state == stateLeadingWhitespace) // Whether reader skips leading whitespace depends on read flags: can't determine reliably.
+                                return false;
+                            state = stateEnclosed;
+                        }
+                        else if (c == cEolChar)
+                            bRowEnded = true;
+                        else if (c == cSepChar)
+                            state = stateCellStart;
+                        else
+                            state = (c == ' ' || c == '\t') ? stateLeadingWhitespace : stateNaked;
+                        break;
+                    case stateNaked:
+                    case statePastEnclosed: // Reader ignores chars between closing enclosing char and separator/eol.
+                        if (c == cEolChar)
+                            bRowEnded = true;
+                        else if (c == cSepChar)
+                            state = stateCellStart;
+                        break;
+                    case stateEnclosed:
+                        if (c == cEncChar)
+                        {
+                            if (nPos + 1 < nSize && pData[nPos + 1] == cEncChar) // Escaped enclosing char.
+                                ++nPos;
+                            else
+                                state = statePastEnclosed;
+                        }
+                        break;
+                }
+            }
+            if (state == stateEnclosed)
+                return false;
+        }
+        rOffsets.push_back(nSize);
+        return true;
+    }
+
+    namespace DFG_DETAIL_NS
+    {
+        // Returns true if encoding is such that separators, enclosing chars and eol are single bytes and can't appear as part of other code points.
+        inline bool isIncrementalWriteCompatibleEncoding(const DFG_MODULE_NS(io)::TextEncoding encoding)
+        {
+            return encoding == DFG_MODULE_NS(io)::encodingUTF8 || encoding == DFG_MODULE_NS(io)::encodingLatin1;
+        }
+    } // namespace DFG_DETAIL_NS
+
+    // Writes table to sOutputPath so that source rows not included in dirtyRows are copied as such from sSourcePath and rows in dirtyRows are formatted from table.
+    // Table row r corresponds to source row r + nSourceRowOffset; source rows before nSourceRowOffset (e.g. header that is not stored in table) are copied as such.
+    // Requirements:
+    //  -sSourcePath is the file that table was read from or previously written to, and the table has the same row structure as the source,
+    //   i.e. rows have not been inserted, removed or moved since. Row count is verified, other structural changes are not detected.
+    //  -format is the format of the source.
+    //  -sOutputPath is not the same file as sSourcePath.
+    // Return: true if output was written successfully; false if incremental writing was not possible or writing failed.
+    //         In case of false, content of sOutputPath is unspecified and caller is expected to use full write instead.
+    template <class Char_T, class Index_T, DFG_MODULE_NS(io)::TextEncoding InternalEncoding_T>
+    bool writeToFileIncremental(const DFG_CLASS_NAME(TableCsv)<Char_T, Index_T, InternalEncoding_T>& table,
+                                const DFG_CLASS_NAME(ReadOnlySzParamC)& sSourcePath,
+                                const DFG_CLASS_NAME(ReadOnlySzParamC)& sOutputPath,
+                                const DFG_CLASS_NAME(CsvFormatDefinition)& format,
+                                const DFG_CLASS_NAME(IntervalSet)<Index_T>& dirtyRows,
+                                const Index_T nSourceRowOffset = 0)
+    {
+        DFG_PROFILE_ZONE("writeToFileIncremental");
+        typedef DFG_MODULE_NS(io)::BasicOmcByteStream<std::string> RowStreamT;
+        const auto encoding = format.textEncoding();
+        if (!DFG_DETAIL_NS::isIncrementalWriteCompatibleEncoding(encoding) || nSourceRowOffset < 0)
+            return false;
+        const int32 cEol = format.eolCharFromEndOfLineType();
+
+        std::unique_ptr<DFG_MODULE_NS(io)::DFG_CLASS_NAME(FileMemoryMapped)> spSource;
+        try
+        {
+            spSource.reset(new DFG_MODULE_NS(io)::DFG_CLASS_NAME(FileMemoryMapped)(sSourcePath));
+        }
+        catch (...) // Mapping fails e.g. for empty files.
+        {
+            return false;
+        }
+        if (!spSource->is_open())
+            return false;
+        const char* const pData = spSource->data();
+        const size_t nSourceSize = spSource->size();
+        size_t nBomSize = 0;
+        const auto bomBytes = DFG_MODULE_NS(utf)::encodingToBom(encoding);
+        if (bomBytes.size() > 0 && nSourceSize >= bomBytes.size() && std::memcmp(pData, bomBytes.data(), bomBytes.size()) == 0)
+            nBomSize = bomBytes.size();
+        if ((nBomSize > 0) != (format.bomWriting() && bomBytes.size() > 0)) // BOM presence would change.
+            return false;
+        std::vector<size_t> rowOffsets;
+        if (!delimitedTextRowOffsets(pData + nBomSize, nSourceSize - nBomSize, format.separatorChar(), format.enclosingChar(), cEol, rowOffsets))
+            return false;
+
+        const Index_T nTableRowCount = table.rowCountByMaxRowIndex();
+        if (rowOffsets.size() != static_cast<size_t>(nTableRowCount) + static_cast<size_t>(nSourceRowOffset) + 1)
+            return false;
+
+        DFG_MODULE_NS(io)::DFG_CLASS_NAME(FileRangeCopyWriter) writer(sSourcePath, sOutputPath);
+        if (!writer.good())
+            return false;
+
+        const Index_T nColCount = table.colCountByMaxColIndex();
+        auto writeFormat = format;
+        writeFormat.bomWriting(false);
+        auto policy = table.template createWritePolicy<RowStreamT>(writeFormat);
+        std::string sRowBytes;
+        RowStreamT rowStrm(&sRowBytes);
+        uint64 nCopyPos = 0; // Source position from which the next copy starts.
+        const bool bRn = (format.eolType() == DFG_MODULE_NS(io)::EndOfLineTypeRN);
+        dirtyRows.forEachInterval([&](Index_T nFirst, Index_T nLast)
+        {
+            nFirst = Max(nFirst, Index_T(0));
+            nLast = Min(nLast, nTableRowCount - 1);
+            for (Index_T r = nFirst; r <= nLast && writer.good(); ++r)
+            {
+                const size_t nSourceRow = static_cast<size_t>(r) + static_cast<size_t>(nSourceRowOffset);
+                const uint64 nRowBegin = nBomSize + rowOffsets[nSourceRow];
+                uint64 nContentEnd = nBomSize + rowOffsets[nSourceRow + 1];
+                // Keeping original end-of-line bytes: excluding them from the range to replace.
+                if (nContentEnd > nRowBegin && pData[nContentEnd - 1] == static_cast<char>(cEol))
+                {
+                    --nContentEnd;
+                    if (bRn && nContentEnd > nRowBegin && pData[nContentEnd - 1] == '\r')
+                        --nContentEnd;
+                }
+                writer.copyFromSource(nCopyPos, nRowBegin - nCopyPos);
+                sRowBytes.clear();
+                for (Index_T c = 0; c < nColCount; ++c)
+                {
+                    if (c > 0)
+                        policy.writeSeparator(rowStrm, r, c - 1);
+                    policy.write(rowStrm, toCharPtr_raw(table(r, c)), r, c);
+                }
+                writer.write(sRowBytes);
+                nCopyPos = nContentEnd;
+            }
+        });
+        writer.copyFromSource(nCopyPos, nSourceSize - nCopyPos);
+        return writer.close();
+    }
+
+} } // module namespace
@@ -0,0 +1,508 @@
+#pragma once
+
+/*
+tableDiff.hpp
+
+Row-level diff for TableSz-like tables, i.e. tables that provide forEachFwdRowInColumn(col, rowBegin, rowEnd, func), operator()(row, col),
+rowCountByMaxRowIndex() and colCountByMaxColIndex().
+    -Rows are hashed in parallel row chunks with XXH64 of cell contents. Null cells and empty strings hash differently.
+    -Row sequences are matched with patience diff on row hashes: rows whose hash is unique in both ranges are candidate anchors,
+     longest increasing subsequence of candidates gives the matched anchors and the ranges between anchors are processed the same way.
+     Range without unique common rows is matched with LCS if it is small enough, otherwise it is reported as a whole-range change.
+    -Result is a list of hunks, each replacing a range of old rows by a range of new rows. Within a hunk, old and new rows are paired in order
+     and paired rows are compared cell by cell so that modifications within rows are available as individual cells.
+    -Equal hashes are taken as equal rows, i.e. hash collisions are not verified.
+
+Related reading:
+    -Bram Cohen: Patience diff, https://bramcohen.livejournal.com/73318.html
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgAssert.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../SzPtr.hpp"
+#include "../hash/xxHash64.hpp"
+#include "../io/DelimitedTextWriter.hpp"
+#include "../thread/ThreadPool.hpp"
+#include "FlatHashMap.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    template <class Index_T>
+    struct DFG_CLASS_NAME(TableDiffHunk)
+    {
+        Index_T nOldRow;    // First old row replaced by the hunk.
+        Index_T nOldCount;  // Number of old rows replaced by the hunk, 0 for pure insertion.
+        Index_T nNewRow;    // First new row of the hunk.
+        Index_T nNewCount;  // Number of new rows in the hunk, 0 for pure deletion.
+
+        // Number of old and new rows that are paired as modified rows; remaining rows are deletions (old) or insertions (new).
+        Index_T pairedRowCount() const { return Min(nOldCount, nNewCount); }
+    };
+
+    template <class Index_T>
+    struct DFG_CLASS_NAME(TableDiffCellChange)
+    {
+        Index_T nOldRow;
+        Index_T nNewRow;
+        Index_T nCol;
+    };
+
+    namespace DFG_DETAIL_NS
+    {
+        const size_t gnTableDiffRowHashChunkSize = 16384;
+        const size_t gnTableDiffMaxLcsCellCount = size_t(1) << 22; // Maximum (old rows) * (new rows) of a range that is matched with LCS.
+
+        template <class Char_T>
+        inline size_t tableDiffSzLength(const Char_T* psz)
+        {
+            return std::char_traits<Char_T>::length(psz);
+        }
+
+        template <class SzPtr_T>
+        inline bool tableDiffIsCellEqual(const SzPtr_T& a, const SzPtr_T& b)
+        {
+            const auto pA = toCharPtr_raw(a);
+            const auto pB = toCharPtr_raw(b);
+            if (pA == nullptr || pB == nullptr)
+                return pA == pB;
+            const auto nLength = tableDiffSzLength(pA);
+            return nLength == tableDiffSzLength(pB) && std::memcmp(pA, pB, nLength * sizeof(*pA)) == 0;
+        }
+
+        // Builds hunks from increasing match runs.
+        template <class Index_T>
+        class TableDiffHunkBuilder
+        {
+        public:
+            typedef DFG_CLASS_NAME(TableDiffHunk)<Index_T> Hunk;
+
+            TableDiffHunkBuilder(std::vector<Hunk>& rHunks) :
+                m_rHunks(rHunks),
+                m_nNextOld(0),
+                m_nNextNew(0)
+            {}
+
+            // Old rows [iOld, iOld + nCount[ match new rows [iNew, iNew + nCount[; must be called in increasing order.
+            void addMatchRun(const size_t iOld, const size_t iNew, const size_t nCount)
+            {
+                if (nCount == 0)
+                    return;
+                addHunkUntil(iOld, iNew);
+                m_nNextOld = iOld + nCount;
+                m_nNextNew = iNew + nCount;
+            }
+
+            void finish(const size_t nOldCount, const size_t nNewCount)
+            {
+                addHunkUntil(nOldCount, nNewCount);
+            }
+
+        private:
+            void addHunkUntil(const size_t iOld, const size_t iNew)
+            {
+                DFG_ASSERT_UB(iOld >= m_nNextOld && iNew >= m_nNextNew);
+                if (iOld == m_nNextOld && iNew == m_nNextNew)
+                    return;
+                Hunk hunk;
+                hunk.nOldRow = static_cast<Index_T>(m_nNextOld);
+                hunk.nOldCount = static_cast<Index_T>(iOld - m_nNextOld);
+                hunk.nNewRow = static_cast<Index_T>(m_nNextNew);
+                hunk.nNewCount = static_cast<Index_T>(iNew - m_nNextNew);
+                m_rHunks.push_back(hunk);
+            }
+
+            std::vector<Hunk>& m_rHunks;
+            size_t m_nNextOld;
+            size_t m_nNextNew;
+        }; // class TableDiffHunkBuilder
+
+        // Matches old and new hash sequences and passes matches to builder in increasing order.
+        template <class Index_T>
+        class TableDiffMatcher
+        {
+        public:
+            TableDiffMatcher(const std::vector<uint64>& oldHashes, const std::vector<uint64>& newHashes, TableDiffHunkBuilder<Index_T>& rBuilder) :
+                m_oldHashes(oldHashes),
+                m_newHashes(newHashes),
+                m_rBuilder(rBuilder)
+            {}
+
+            void run()
+            {
+                // Ranges are processed with an explicit stack to avoid deep recursion; items are pushed in reverse order so that matches are emitted in increasing order.
+                m_stack.push_back(WorkItem(0, m_oldHashes.size(), 0, m_newHashes.size(), false));
+                while (!m_stack.empty())
+                {
+                    const WorkItem item = m_stack.back();
+                    m_stack.pop_back();
+                    if (item.bMatchRun)
+                        m_rBuilder.addMatchRun(item.iOldBegin, item.iNewBegin, item.iOldEnd - item.iOldBegin);
+                    else
+                        processRange(item.iOldBegin, item.iOldEnd, item.iNewBegin, item.iNewEnd);
+                }
+            }
+
+        private:
+            struct WorkItem
+            {
+                WorkItem(size_t iOldBegin_, size_t iOldEnd_, size_t iNewBegin_, size_t iNewEnd_, bool bMatchRun_) :
+                    iOldBegin(iOldBegin_), iOldEnd(iOldEnd_), iNewBegin(iNewBegin_), iNewEnd(iNewEnd_), bMatchRun(bMatchRun_)
+                {}
+                size_t iOldBegin;
+                size_t iOldEnd;
+                size_t iNewBegin;
+                size_t iNewEnd;
+                bool bMatchRun;
+            };
+
+            struct Occurrence
+            {
+                Occurrence() : nOldCount(0), nNewCount(0), iOld(0), iNew(0) {}
+                uint32 nOldCount;
+                uint32 nNewCount;
+                size_t iOld;
+                size_t iNew;
+            };
+
+            void processRange(size_t iOldBegin, size_t iOldEnd, size_t iNewBegin, size_t iNewEnd)
+            {
+                // Common prefix
+                size_t nPrefix = 0;
+                while (iOldBegin + nPrefix < iOldEnd && iNewBegin + nPrefix < iNewEnd && m_oldHashes[iOldBegin + nPrefix] == m_newHashes[iNewBegin + nPrefix])
+                    ++nPrefix;
+                m_rBuilder.addMatchRun(iOldBegin, iNewBegin, nPrefix);
+                iOldBegin += nPrefix;
+                iNewBegin += nPrefix;
+
+                // Common suffix, emitted after the middle part.
+                size_t nSuffix = 0;
+                while (iOldEnd - nSuffix > iOldBegin && iNewEnd - nSuffix > iNewBegin && m_oldHashes[iOldEnd - nSuffix - 1] == m_newHashes[iNewEnd - nSuffix - 1])
+                    ++nSuffix;
+                if (nSuffix > 0)
+                {
+                    iOldEnd -= nSuffix;
+                    iNewEnd -= nSuffix;
+                    m_stack.push_back(WorkItem(iOldEnd, iOldEnd + nSuffix, iNewEnd, iNewEnd + nSuffix, true));
+                }
+
+                if (iOldBegin == iOldEnd || iNewBegin == iNewEnd)
+                    return;
+
+                if (!pushAnchoredRanges(iOldBegin, iOldEnd, iNewBegin, iNewEnd))
+                    matchWithLcs(iOldBegin, iOldEnd, iNewBegin, iNewEnd);
+            }
+
+            // Finds rows unique in both ranges and pushes matched anchors and ranges between them to stack. Returns false if there were no anchors.
+            bool pushAnchoredRanges(const size_t iOldBegin, const size_t iOldEnd, const size_t iNewBegin, const size_t iNewEnd)
+            {
+                DFG_CLASS_NAME(FlatHashMap)<uint64, Occurrence> occurrences;
+                occurrences.reserve(iOldEnd - iOldBegin);
+                for (size_t i = iOldBegin; i < iOldEnd; ++i)
+                {
+                    auto& occ = occurrences[m_oldHashes[i]];
+                    ++occ.nOldCount;
+                    occ.iOld = i;
+                }
+                for (size_t i = iNewBegin; i < iNewEnd; ++i)
+                {
+                    auto iter = occurrences.find(m_newHashes[i]);
+                    if (iter == occurrences.end())
+                        continue;
+                    ++iter->second.nNewCount;
+                    iter->second.iNew = i;
+                }
+
+                // Candidate new row indexes in old row order.
+                std::vector<size_t> candidateOld;
+                std::vector<size_t> candidateNew;
+                for (size_t i = iOldBegin; i < iOldEnd; ++i)
+                {
+                    const auto& occ = occurrences.find(m_oldHashes[i])->second;
+                    if (occ.nOldCount == 1 && occ.nNewCount == 1)
+                    {
+                        candidateOld.push_back(i);
+                        candidateNew.push_back(occ.iNew);
+                    }
+                }
+                if (candidateOld.empty())
+                    return false;
+
+                // Longest increasing subsequence of candidateNew with patience sorting.
+                std::vector<size_t> pileTops; // Index of candidate at the top of each pile.
+                std::vector<size_t> predecessors(candidateNew.size(), size_t(-1));
+                for (size_t i = 0; i < candidateNew.size(); ++i)
+                {
+                    const auto iter = std::lower_bound(pileTops.begin(), pileTops.end(), candidateNew[i], [&](const size_t nTop, const size_t nVal) { return candidateNew[nTop] < nVal; });
+                    if (iter != pileTops.begin())
+                        predecessors[i] = *(iter - 1);
+                    if (iter == pileTops.end())
+                        pileTops.push_back(i);
+                    else
+                        *iter = i;
+                }
+                std::vector<size_t> anchors; // Candidate indexes in reverse order.
+                for (size_t i = pileTops.back(); i != size_t(-1); i = predecessors[i])
+                    anchors.push_back(i);
+
+                // Pushing in reverse order: range after last anchor, last anchor, range between anchors, ..., range before first anchor.
+                size_t iOldRangeEnd = iOldEnd;
+                size_t iNewRangeEnd = iNewEnd;
+                for (const auto nAnchor : anchors)
+                {
+                    const size_t iOld = candidateOld[nAnchor];
+                    const size_t iNew = candidateNew[nAnchor];
+                    if (iOld + 1 < iOldRangeEnd || iNew + 1 < iNewRangeEnd)
+                        m_stack.push_back(WorkItem(iOld + 1, iOldRangeEnd, iNew + 1, iNewRangeEnd, false));
+                    m_stack.push_back(WorkItem(iOld, iOld + 1, iNew, iNew + 1, true));
+                    iOldRangeEnd = iOld;
+                    iNewRangeEnd = iNew;
+                }
+                if (iOldBegin < iOldRangeEnd || iNewBegin < iNewRangeEnd)
+                    m_stack.push_back(WorkItem(iOldBegin, iOldRangeEnd, iNewBegin, iNewRangeEnd, false));
+                return true;
+            }
+
+            // Matches range with classic LCS dynamic programming if range is small enough; otherwise leaves the whole range unmatched.
+            void matchWithLcs(const size_t iOldBegin, const size_t iOldEnd, const size_t iNewBegin, const size_t iNewEnd)
+            {
+                const size_t nOld = iOldEnd - iOldBegin;
+                const size_t nNew = iNewEnd - iNewBegin;
+                if (nOld > gnTableDiffMaxLcsCellCount / nNew)
+                    return;
+                // lcs[i * (nNew + 1) + j] = LCS length of old[i:] and new[j:]
+                const size_t nStride = nNew + 1;
+                std::vector<uint32> lcs((nOld + 1) * nStride, 0);
+                for (size_t i = nOld; i-- > 0;)
+                {
+                    for (size_t j = nNew; j-- > 0;)
+                    {
+                        lcs[i * nStride + j] = (m_oldHashes[iOldBegin + i] == m_newHashes[iNewBegin + j])
+                                                ? lcs[(i + 1) * nStride + j + 1] + 1
+                                                : Max(lcs[(i + 1) * nStride + j], lcs[i * nStride + j + 1]);
+                    }
+                }
+                size_t i = 0;
+                size_t j = 0;
+                while (i < nOld && j < nNew)
+                {
+                    if (m_oldHashes[iOldBegin + i] == m_newHashes[iNewBegin + j])
+                    {
+                        m_rBuilder.addMatchRun(iOldBegin + i, iNewBegin + j, 1);
+                        ++i;
+                        ++j;
+                    }
+                    else if (lcs[(i + 1) * nStride + j] >= lcs[i * nStride + j + 1])
+                        ++i;
+                    else
+                        ++j;
+                }
+            }
+
+            const std::vector<uint64>& m_oldHashes;
+            const std::vector<uint64>& m_newHashes;
+            TableDiffHunkBuilder<Index_T>& m_rBuilder;
+            std::vector<WorkItem> m_stack;
+        }; // class TableDiffMatcher
+    } // namespace DFG_DETAIL_NS
+
+    // Returns hash for each row [0, nRowCount[ computed from columns [0, nColCount[. Rows with equal content have equal hashes.
+    // Row chunks are hashed in thread::defaultThreadPool(); nMaxThreadCount limits the number of concurrently hashed chunks (0 = no limit).
+    template <class Index_T, class Table_T>
+    std::vector<uint64> tableRowHashes(const Table_T& table, const Index_T nRowCount, const Index_T nColCount, const size_t nMaxThreadCount = 0)
+    {
+        std::vector<uint64> hashes(static_cast<size_t>(Max(Index_T(0), nRowCount)), 0);
+        const size_t nChunkSize = DFG_DETAIL_NS::gnTableDiffRowHashChunkSize;
+        const size_t nChunkCount = (hashes.size() + nChunkSize - 1) / nChunkSize;
+        // Chunks are divided into nPieceCount contiguous pieces that are run as separate tasks.
+        const size_t nPieceCount = (nMaxThreadCount == 0) ? nChunkCount : Min(nMaxThreadCount, nChunkCount);
+        DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nPieceCount, 1, [&](const size_t iPieceBegin, const size_t iPieceEnd)
+        {
+            const size_t iBegin = (iPieceBegin * nChunkCount / nPieceCount) * nChunkSize;
+            const size_t iEnd = Min(hashes.size(), (iPieceEnd * nChunkCount / nPieceCount) * nChunkSize);
+            for (Index_T c = 0; c < nColCount; ++c)
+            {
+                table.forEachFwdRowInColumn(c, static_cast<Index_T>(iBegin), static_cast<Index_T>(iEnd), [&](const Index_T r, const typename Table_T::SzPtrR& tpsz)
+                {
+                    const auto psz = toCharPtr_raw(tpsz);
+                    if (!psz)
+                        return;
+                    // Chaining hash through seed makes it depend on column order; column index in seed separates e.g. (null, "a") from ("a", null).
+                    auto& h = hashes[static_cast<size_t>(r)];
+                    h = DFG_MODULE_NS(hash)::xxHash64(psz, DFG_DETAIL_NS::tableDiffSzLength(psz) * sizeof(*psz), h + static_cast<uint64>(c));
+                });
+            }
+        });
+        return hashes;
+    }
+
+    // Diff between two tables. Typical usage:
+    //      TableDiff<int> diff;
+    //      diff.compute(oldTable, newTable);
+    //      for (const auto& hunk : diff.hunks()) ...
+    template <class Index_T>
+    class DFG_CLASS_NAME(TableDiff)
+    {
+    public:
+        typedef DFG_CLASS_NAME(TableDiffHunk)<Index_T> Hunk;
+        typedef DFG_CLASS_NAME(TableDiffCellChange)<Index_T> CellChange;
+
+        enum RowStatus
+        {
+            RowStatusUnchanged,
+            RowStatusModified,  // Row is paired with an old row and differs from it, see modifiedCells().
+            RowStatusInserted
+        };
+
+        DFG_CLASS_NAME(TableDiff)() :
+            m_nColCount(0)
+        {}
+
+        // Computes diff from oldTable to newTable replacing previous result.
+        // nMaxThreadCount is passed to tableRowHashes().
+        template <class Table_T>
+        void compute(const Table_T& oldTable, const Table_T& newTable, const size_t nMaxThreadCount = 0)
+        {
+            m_hunks.clear();
+            m_modifiedCells.clear();
+            const Index_T nOldRowCount = oldTable.rowCountByMaxRowIndex();
+            const Index_T nNewRowCount = newTable.rowCountByMaxRowIndex();
+            m_nColCount = Max(oldTable.colCountByMaxColIndex(), newTable.colCountByMaxColIndex());
+
+            const auto oldHashes = tableRowHashes(oldTable, nOldRowCount, m_nColCount, nMaxThreadCount);
+            const auto newHashes = tableRowHashes(newTable, nNewRowCount, m_nColCount, nMaxThreadCount);
+
+            DFG_DETAIL_NS::TableDiffHunkBuilder<Index_T> builder(m_hunks);
+            DFG_DETAIL_NS::TableDiffMatcher<Index_T>(oldHashes, newHashes, builder).run();
+            builder.finish(oldHashes.size(), newHashes.size());
+
+            // Cell level differences for paired rows.
+            for (const auto& hunk : m_hunks)
+            {
+                for (Index_T i = 0, nPairCount = hunk.pairedRowCount(); i < nPairCount; ++i)
+                {
+                    for (Index_T c = 0; c < m_nColCount; ++c)
+                    {
+                        if (!DFG_DETAIL_NS::tableDiffIsCellEqual(oldTable(hunk.nOldRow + i, c), newTable(hunk.nNewRow + i, c)))
+                        {
+                            CellChange change;
+                            change.nOldRow = hunk.nOldRow + i;
+                            change.nNewRow = hunk.nNewRow + i;
+                            change.nCol = c;
+                            m_modifiedCells.push_back(change);
+                        }
+                    }
+                }
+            }
+        }
+
+        bool isEmpty() const { return m_hunks.empty(); }
+
+        // Hunks sorted by row.
+        const std::vector<Hunk>& hunks() const { return m_hunks; }
+
+        // Modified cells of paired rows sorted by (row, column).
+        const std::vector<CellChange>& modifiedCells() const { return m_modifiedCells; }
+
+        Index_T columnCount() const { return m_nColCount; }
+
+        Index_T modifiedRowCount() const { return sumOverHunks([](const Hunk& hunk) { return hunk.pairedRowCount(); }); }
+        Index_T insertedRowCount() const { return sumOverHunks([](const Hunk& hunk) { return hunk.nNewCount - hunk.pairedRowCount(); }); }
+        Index_T deletedRowCount() const  { return sumOverHunks([](const Hunk& hunk) { return hunk.nOldCount - hunk.pairedRowCount(); }); }
+
+        // Returns status of new table row, cost is O(log(hunk count)).
+        RowStatus newRowStatus(const Index_T nNewRow) const
+        {
+            const auto pHunk = hunkOfNewRow(nNewRow);
+            if (!pHunk)
+                return RowStatusUnchanged;
+            return (nNewRow - pHunk->nNewRow < pHunk->pairedRowCount()) ? RowStatusModified : RowStatusInserted;
+        }
+
+        // Returns true if cell of new table differs from corresponding old cell, including cells on inserted rows.
+        bool isNewCellChanged(const Index_T nNewRow, const Index_T nCol) const
+        {
+            const auto status = newRowStatus(nNewRow);
+            if (status != RowStatusModified)
+                return status == RowStatusInserted;
+            const auto pred = [](const CellChange& a, const CellChange& b) { return a.nNewRow < b.nNewRow || (a.nNewRow == b.nNewRow && a.nCol < b.nCol); };
+            CellChange searchItem;
+            searchItem.nOldRow = 0;
+            searchItem.nNewRow = nNewRow;
+            searchItem.nCol = nCol;
+            return std::binary_search(m_modifiedCells.begin(), m_modifiedCells.end(), searchItem, pred);
+        }
+
+        // Returns old row corresponding to given new row or -1 if new row is inserted.
+        Index_T oldRowOfNewRow(const Index_T nNewRow) const
+        {
+            const auto iter = std::upper_bound(m_hunks.begin(), m_hunks.end(), nNewRow, [](const Index_T r, const Hunk& hunk) { return r < hunk.nNewRow; });
+            if (iter == m_hunks.begin())
+                return nNewRow;
+            const auto& hunk = *(iter - 1);
+            if (nNewRow >= hunk.nNewRow + hunk.nNewCount) // Unchanged row after hunk
+                return hunk.nOldRow + hunk.nOldCount + (nNewRow - hunk.nNewRow - hunk.nNewCount);
+            return (nNewRow - hunk.nNewRow < hunk.pairedRowCount()) ? hunk.nOldRow + (nNewRow - hunk.nNewRow) : Index_T(-1);
+        }
+
+        // Writes diff as CSV patch:
+        //      @@,<old row>,<old count>,<new row>,<new count>  (header for each hunk, row indexes are zero-based)
+        //      -,<cells of removed old row>                     (for each old row in hunk)
+        //      +,<cells of added new row>                       (for each new row in hunk)
+        // Null cells are written as empty. Old and new tables must be the ones given to compute().
+        template <class Strm_T, class Table_T>
+        void writeCsvPatch(Strm_T& strm, const Table_T& oldTable, const Table_T& newTable, const char cSep = ',', const char cEnc = '"', const char cEol = '\n') const
+        {
+            typedef DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextCellWriter) CellWriter;
+            const auto writeRow = [&](const char cPrefix, const Table_T& table, const Index_T nRow)
+            {
+                strm << cPrefix;
+                for (Index_T c = 0; c < m_nColCount; ++c)
+                {
+                    strm << cSep;
+                    const auto psz = toCharPtr_raw(table(nRow, c));
+                    if (psz)
+                        CellWriter::writeCellStrm(strm, psz, cSep, cEnc, cEol, DFG_MODULE_NS(io)::EbEncloseIfNeeded);
+                }
+                strm << cEol;
+            };
+            for (const auto& hunk : m_hunks)
+            {
+                strm << "@@" << cSep << hunk.nOldRow << cSep << hunk.nOldCount << cSep << hunk.nNewRow << cSep << hunk.nNewCount << cEol;
+                for (Index_T i = 0; i < hunk.nOldCount; ++i)
+                    writeRow('-', oldTable, hunk.nOldRow + i);
+                for (Index_T i = 0; i < hunk.nNewCount; ++i)
+                    writeRow('+', newTable, hunk.nNewRow + i);
+            }
+        }
+
+    private:
+        template <class Func_T>
+        Index_T sumOverHunks(Func_T&& func) const
+        {
+            Index_T nSum = 0;
+            for (const auto& hunk : m_hunks)
+                nSum += func(hunk);
+            return nSum;
+        }
+
+        const Hunk* hunkOfNewRow(const Index_T nNewRow) const
+        {
+            const auto iter = std::upper_bound(m_hunks.begin(), m_hunks.end(), nNewRow, [](const Index_T r, const Hunk& hunk) { return r < hunk.nNewRow; });
+            if (iter == m_hunks.begin())
+                return nullptr;
+            const auto& hunk = *(iter - 1);
+            return (nNewRow < hunk.nNewRow + hunk.nNewCount) ? &hunk : nullptr;
+        }
+
+        std::vector<Hunk> m_hunks;
+        std::vector<CellChange> m_modifiedCells;
+        Index_T m_nColCount;
+    }; // class TableDiff
+
+}} // module namespace
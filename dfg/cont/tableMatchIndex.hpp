@@ -0,0 +1,253 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../isValidIndex.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <algorithm>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    // Stores positions of table cells that match some predicate as sorted row lists per column.
+    // Index is built by scanning the table in parallel row ranges after which queries such as
+    // 'is cell a match' and 'next match from given cell' are answered with binary searches.
+    // Intended to be used with TableSz-like tables that provide forEachFwdRowInColumn(col, rowBegin, rowEnd, func).
+    // Note: Only non-null cells are evaluated, i.e. null cells are never reported as matches.
+    template <class Index_T>
+    class DFG_CLASS_NAME(TableMatchIndex)
+    {
+    public:
+        typedef std::vector<Index_T> RowList;
+
+        enum Direction
+        {
+            DirectionForward,
+            DirectionBackward
+        };
+
+        enum AdvanceStyle
+        {
+            AdvanceStyleRowIncrement,   // Cells are searched in column-major order (i.e. (r, c) -> (r + 1, c) -> ... -> (0, c + 1)).
+            AdvanceStyleLinear          // Cells are searched in row-major order (i.e. (r, c) -> (r, c + 1) -> ... -> (r + 1, 0)).
+        };
+
+        static const Index_T s_nMinRowsPerThread = 10000;
+
+        DFG_CLASS_NAME(TableMatchIndex)() :
+            m_bBuilt(false)
+        {}
+
+        // Builds index for columns [0, nColCount[, or if nColumn >= 0, only for column nColumn.
+        // Row chunks are processed in thread::defaultThreadPool(); pred is called with table element type (e.g. SzPtrR) and it is copied for each chunk.
+        // nMaxThreadCount limits the number of chunks; if 0, it is the thread count of the pool.
+        template <class Table_T, class Pred_T>
+        void build(const Table_T& table, const Index_T nRowCount, const Index_T nColCount, const Index_T nColumn, const Pred_T& pred, size_t nMaxThreadCount = 0)
+        {
+            m_rowsByColumn.assign(static_cast<size_t>(Max(Index_T(0), nColCount)), RowList());
+            m_bBuilt = true;
+            if (nRowCount <= 0 || nColCount <= 0)
+                return;
+            auto& pool = DFG_MODULE_NS(thread)::defaultThreadPool();
+            if (nMaxThreadCount == 0)
+                nMaxThreadCount = pool.threadCount();
+            const Index_T nThreadCount = Max(Index_T(1), Min(static_cast<Index_T>(nMaxThreadCount), nRowCount / s_nMinRowsPerThread));
+            const Index_T nRowsPerThread = nRowCount / nThreadCount;
+            const Index_T nFirstCol = (nColumn >= 0) ? nColumn : 0;
+            const Index_T nEndCol = (nColumn >= 0) ? Min(nColumn + 1, nColCount) : nColCount;
+
+            // Each chunk stores its matches to own row lists which are concatenated afterwards; since chunks are consecutive row ranges, result stays sorted.
+            std::vector<std::vector<RowList>> chunkResults(static_cast<size_t>(nThreadCount), std::vector<RowList>(m_rowsByColumn.size()));
+            const auto processChunk = [&](const Index_T nChunk, Pred_T chunkPred)
+            {
+                const auto nBegin = nChunk * nRowsPerThread;
+                const auto nEnd = (nChunk + 1 == nThreadCount) ? nRowCount : nBegin + nRowsPerThread;
+                auto& results = chunkResults[static_cast<size_t>(nChunk)];
+                for (Index_T c = nFirstCol; c < nEndCol; ++c)
+                {
+                    auto& rows = results[static_cast<size_t>(c)];
+                    table.forEachFwdRowInColumn(c, nBegin, nEnd, [&](const Index_T r, typename Table_T::SzPtrR psz)
+                    {
+                        if (chunkPred(psz))
+                            rows.push_back(r);
+                    });
+                }
+            };
+
+            DFG_MODULE_NS(thread)::parallelFor(pool, 0, static_cast<size_t>(nThreadCount), 1, [&](const size_t i0, const size_t i1)
+            {
+                for (size_t i = i0; i < i1; ++i)
+                    processChunk(static_cast<Index_T>(i), pred);
+            });
+
+            for (size_t c = 0; c < m_rowsByColumn.size(); ++c)
+            {
+                auto& dest = m_rowsByColumn[c];
+                for (size_t i = 0; i < chunkResults.size(); ++i)
+                {
+                    const auto& src = chunkResults[i][c];
+                    dest.insert(dest.end(), src.begin(), src.end());
+                }
+            }
+        }
+
+        bool isBuilt() const { return m_bBuilt; }
+
+        void clear()
+        {
+            m_rowsByColumn.clear();
+            m_bBuilt = false;
+        }
+
+        bool isMatch(const Index_T r, const Index_T c) const
+        {
+            if (!isValidIndex(m_rowsByColumn, c))
+                return false;
+            const auto& rows = m_rowsByColumn[static_cast<size_t>(c)];
+            return std::binary_search(rows.begin(), rows.end(), r);
+        }
+
+        // Sets match status of single cell, e.g. after cell has been edited.
+        void setMatchStatus(const Index_T r, const Index_T c, const bool bMatch)
+        {
+            if (!isValidIndex(m_rowsByColumn, c))
+                return;
+            auto& rows = m_rowsByColumn[static_cast<size_t>(c)];
+            auto iter = std::lower_bound(rows.begin(), rows.end(), r);
+            const bool bExisting = (iter != rows.end() && *iter == r);
+            if (bMatch && !bExisting)
+                rows.insert(iter, r);
+            else if (!bMatch && bExisting)
+                rows.erase(iter);
+        }
+
+        size_t matchCount() const
+        {
+            size_t n = 0;
+            for (const auto& rows : m_rowsByColumn)
+                n += rows.size();
+            return n;
+        }
+
+        size_t matchCountInColumn(const Index_T c) const
+        {
+            return (isValidIndex(m_rowsByColumn, c)) ? m_rowsByColumn[static_cast<size_t>(c)].size() : 0;
+        }
+
+        // Finds next match from (r, c) to given direction wrapping around table end/beginning. Cell (r, c) itself is not considered a match.
+        // If found, sets (r, c) to found position and returns true, otherwise returns false and leaves (r, c) unmodified.
+        // Cost is O(log n + C) for row increment style and O(C * log n) for linear style, where C is column count.
+        bool findNext(Index_T& r, Index_T& c, const Direction direction, const AdvanceStyle advanceStyle) const
+        {
+            if (advanceStyle == AdvanceStyleRowIncrement)
+                return findNextRowIncrement(r, c, direction == DirectionForward);
+
+            // Linear style: finding closest candidate from each column.
+            const Index_T nColCount = static_cast<Index_T>(m_rowsByColumn.size());
+            const bool bForward = (direction == DirectionForward);
+            const auto isBefore = [](const Index_T r0, const Index_T c0, const Index_T r1, const Index_T c1) { return r0 < r1 || (r0 == r1 && c0 < c1); };
+            bool bFound = false;
+            Index_T nBestRow = 0;
+            Index_T nBestCol = 0;
+            const auto considerCandidate = [&](const Index_T rc, const Index_T cc)
+            {
+                if (!bFound || (bForward && isBefore(rc, cc, nBestRow, nBestCol)) || (!bForward && isBefore(nBestRow, nBestCol, rc, cc)))
+                {
+                    bFound = true;
+                    nBestRow = rc;
+                    nBestCol = cc;
+                }
+            };
+            for (Index_T cc = 0; cc < nColCount; ++cc)
+            {
+                const auto& rows = m_rowsByColumn[static_cast<size_t>(cc)];
+                if (bForward)
+                {
+                    // In columns after c, row r itself is after the seed.
+                    auto iter = (cc > c) ? std::lower_bound(rows.begin(), rows.end(), r) : std::upper_bound(rows.begin(), rows.end(), r);
+                    if (iter != rows.end())
+                        considerCandidate(*iter, cc);
+                }
+                else
+                {
+                    auto iter = (cc < c) ? std::upper_bound(rows.begin(), rows.end(), r) : std::lower_bound(rows.begin(), rows.end(), r);
+                    if (iter != rows.begin())
+                        considerCandidate(*(iter - 1), cc);
+                }
+            }
+            if (!bFound)
+            {
+                // Wrapping: taking the first (or last) match in the whole table.
+                for (Index_T cc = 0; cc < nColCount; ++cc)
+                {
+                    const auto& rows = m_rowsByColumn[static_cast<size_t>(cc)];
+                    if (!rows.empty())
+                        considerCandidate((bForward) ? rows.front() : rows.back(), cc);
+                }
+                if (!bFound || (nBestRow == r && nBestCol == c))
+                    return false;
+            }
+            r = nBestRow;
+            c = nBestCol;
+            return true;
+        }
+
+        const RowList& matchingRowsInColumn(const Index_T c) const
+        {
+            DFG_ASSERT_UB(isValidIndex(m_rowsByColumn, c));
+            return m_rowsByColumn[static_cast<size_t>(c)];
+        }
+
+    private:
+        // Column-major search: rows after r in column c, then the columns after c (wrapping from last column to first)
+        // and finally rows before r in column c.
+        bool findNextRowIncrement(Index_T& r, Index_T& c, const bool bForward) const
+        {
+            if (!isValidIndex(m_rowsByColumn, c))
+                return false;
+            const Index_T nColCount = static_cast<Index_T>(m_rowsByColumn.size());
+            const auto& seedRows = m_rowsByColumn[static_cast<size_t>(c)];
+            if (bForward)
+            {
+                auto iter = std::upper_bound(seedRows.begin(), seedRows.end(), r);
+                if (iter != seedRows.end())
+                {
+                    r = *iter;
+                    return true;
+                }
+            }
+            else
+            {
+                auto iter = std::lower_bound(seedRows.begin(), seedRows.end(), r);
+                if (iter != seedRows.begin())
+                {
+                    r = *(iter - 1);
+                    return true;
+                }
+            }
+            for (Index_T i = 1; i < nColCount; ++i)
+            {
+                const auto cc = (bForward) ? (c + i) % nColCount : (c + nColCount - i) % nColCount;
+                const auto& rows = m_rowsByColumn[static_cast<size_t>(cc)];
+                if (!rows.empty())
+                {
+                    r = (bForward) ? rows.front() : rows.back();
+                    c = cc;
+                    return true;
+                }
+            }
+            // Wrapped back to seed column: remaining candidates are on the other side of the seed.
+            if (seedRows.empty())
+                return false;
+            const auto nFound = (bForward) ? seedRows.front() : seedRows.back();
+            if (nFound == r)
+                return false;
+            r = nFound;
+            return true;
+        }
+
+        std::vector<RowList> m_rowsByColumn;
+        bool m_bBuilt;
+    }; // class TableMatchIndex
+
+}} // module namespace
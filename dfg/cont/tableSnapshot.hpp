@@ -0,0 +1,549 @@
+#pragma once
+
+/*
+tableSnapshot.hpp
+
+Binary snapshot of TableSz/TableCsv content for fast reloading of tables parsed from large files.
+Snapshot is typically stored as a sidecar file next to the source (see tableSnapshotPathFromSourcePath()) and is keyed by
+source size, modification time, content hash and the read format that was requested: snapshot is used only if the key matches.
+
+File layout (native byte order; char size, index size and byte order are checked on load):
+    -Header: magic, version, source key, column count and offsets of the sections below.
+    -Column directory: for each column cell count and offsets of the column arrays.
+    -Read format (CsvFormatDefinition) if stored.
+    -For each column (each array 8-byte aligned):
+        -Row indexes of cells in ascending order (Index_T[cell count]).
+        -Offsets of cell strings in the column string block (uint64[cell count]); special values for empty and null cells.
+        -String block: null terminated strings of the column.
+
+Loading memory maps the snapshot and uses the string blocks in place: cell pointers of the table point to the mapping, which is kept
+alive by the table (TableSz::adoptExternalStorage()), so strings are neither parsed nor copied and the content is backed by the page cache.
+Since TableSz indexes cells with pointers, per column (row, pointer) arrays are built from the row and offset arrays on load;
+this is a linear pass done in parallel over columns. Cells modified after load are stored in regular table storage.
+
+Notes:
+    -While table refers to the mapping, snapshot file can't be replaced on Windows (on Linux replacing by rename is fine).
+    -Snapshot is a cache, not an exchange format: it's not portable between platforms with different byte order or type sizes.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../ReadOnlySzParam.hpp"
+#include "../hash/fileHash.hpp"
+#include "../hash/xxHash64.hpp"
+#include "../io/IfmmStream.hpp"
+#include "../os/fileModificationTime.hpp"
+#include "../os/fileSize.hpp"
+#include "../os/OutputFile.hpp"
+#include "../thread/ThreadPool.hpp"
+#include "../time/profiling.hpp"
+#include "table.hpp"
+#include "tableCsv.hpp"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont) {
+
+    enum TableSnapshotSourceCheck
+    {
+        TableSnapshotSourceCheckSizeAndTime,        // Source is considered unchanged if size and modification time match; source content is not read.
+        TableSnapshotSourceCheckSizeTimeAndHash     // Like TableSnapshotSourceCheckSizeAndTime, but also content hash must match; requires reading the source.
+    };
+
+    // Identifies the source from which snapshot was created.
+    class DFG_CLASS_NAME(TableSnapshotSourceKey)
+    {
+    public:
+        DFG_CLASS_NAME(TableSnapshotSourceKey)() :
+            m_nSourceSize(0),
+            m_nSourceModificationTime(0),
+            m_nSourceHash(0),
+            m_nReadOptionsHash(0),
+            m_bHasSourceHash(false)
+        {}
+
+        // Sets size, modification time and, if bComputeHash is true, content hash from file sPath.
+        // Return: false if file doesn't exist or can't be read, in which case key is not modified.
+        bool setFromFile(const DFG_CLASS_NAME(ReadOnlySzParamC)& sPath, const bool bComputeHash)
+        {
+            const auto nModTime = DFG_MODULE_NS(os)::fileModificationTime(sPath);
+            if (nModTime == 0)
+                return false;
+            uint64 nHash = 0;
+            if (bComputeHash)
+            {
+                DFG_MODULE_NS(hash)::DFG_CLASS_NAME(Xxh64Hasher)::DigestBytes digest;
+                if (!DFG_MODULE_NS(hash)::treeHashFile<DFG_MODULE_NS(hash)::DFG_CLASS_NAME(Xxh64Hasher)>(sPath, digest))
+                    return false;
+                nHash = DFG_MODULE_NS(hash)::DFG_DETAIL_NS::readUint64Le(digest.data());
+            }
+            m_nSourceSize = DFG_MODULE_NS(os)::fileSize(sPath);
+            m_nSourceModificationTime = nModTime;
+            m_nSourceHash = nHash;
+            m_bHasSourceHash = bComputeHash;
+            return true;
+        }
+
+        // Returns true if snapshot created with key 'stored' can be used for source with this key.
+        // Hash is compared only if this key has it.
+        bool isMatchForStored(const DFG_CLASS_NAME(TableSnapshotSourceKey)& stored) const
+        {
+            return m_nSourceSize == stored.m_nSourceSize
+                && m_nSourceModificationTime == stored.m_nSourceModificationTime
+                && m_nReadOptionsHash == stored.m_nReadOptionsHash
+                && (!m_bHasSourceHash || (stored.m_bHasSourceHash && m_nSourceHash == stored.m_nSourceHash));
+        }
+
+        uint64 m_nSourceSize;
+        int64 m_nSourceModificationTime; // As returned by os::fileModificationTime().
+        uint64 m_nSourceHash; // Tree hash of source content with Xxh64Hasher, valid if m_bHasSourceHash is true.
+        uint64 m_nReadOptionsHash; // Hash of read options, e.g. of requested CsvFormatDefinition; snapshot is not used if read options differ.
+        bool m_bHasSourceHash;
+    }; // class TableSnapshotSourceKey
+
+    // Returns path of snapshot sidecar file for given source path.
+    template <class Str_T>
+    inline Str_T tableSnapshotPathFromSourcePath(const Str_T& sSourcePath)
+    {
+        return sSourcePath + ".snapshot";
+    }
+
+    namespace DFG_DETAIL_NS
+    {
+        const char gTableSnapshotMagic[8] = { 'D', 'F', 'G', 'T', 'S', 'N', 'A', 'P' };
+        const uint32 gnTableSnapshotVersion = 1;
+        const uint32 gnTableSnapshotEndianTag = 0x01020304;
+        const uint32 gnTableSnapshotFlagHasSourceHash = 0x1;
+        const uint32 gnTableSnapshotFlagHasFormat = 0x2;
+        const uint64 gnTableSnapshotEmptyStringOffset = uint64(-1);
+        const uint64 gnTableSnapshotNullOffset = uint64(-2);
+
+        struct TableSnapshotHeader
+        {
+            char magic[8];
+            uint32 nVersion;
+            uint32 nEndianTag;
+            uint32 nCharSize;
+            uint32 nIndexSize;
+            uint32 nFlags;
+            uint32 nReserved;
+            uint64 nSourceSize;
+            int64 nSourceModificationTime;
+            uint64 nSourceHash;
+            uint64 nReadOptionsHash;
+            uint64 nColumnCount;
+            uint64 nColumnDirectoryOffset;
+            uint64 nFormatOffset;
+            uint64 nFormatSize;
+            uint64 nFileSize;
+        };
+
+        struct TableSnapshotColumnEntry
+        {
+            uint64 nCellCount;
+            uint64 nRowIndexOffset;
+            uint64 nStringOffsetsOffset;
+            uint64 nStringBlockOffset;
+            uint64 nStringBlockSize; // In chars.
+        };
+
+        inline uint64 tableSnapshotAlign(const uint64 n)
+        {
+            return (n + 7) & ~uint64(7);
+        }
+
+        // Returns true if [nOffset, nOffset + nSize[ is within [0, nFileSize[.
+        inline bool isTableSnapshotRangeValid(const uint64 nOffset, const uint64 nSize, const uint64 nFileSize)
+        {
+            return nOffset <= nFileSize && nSize <= nFileSize - nOffset;
+        }
+
+        template <class T>
+        void appendTableSnapshotPod(std::string& s, const T& val)
+        {
+            s.append(reinterpret_cast<const char*>(&val), sizeof(val));
+        }
+
+        inline void appendTableSnapshotString(std::string& s, const std::string& str)
+        {
+            appendTableSnapshotPod(s, static_cast<uint32>(str.size()));
+            s.append(str);
+        }
+
+        template <class T>
+        bool readTableSnapshotPod(const char*& p, const char* const pEnd, T& val)
+        {
+            if (static_cast<size_t>(pEnd - p) < sizeof(T))
+                return false;
+            std::memcpy(&val, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+
+        inline bool readTableSnapshotString(const char*& p, const char* const pEnd, std::string& str)
+        {
+            uint32 nSize;
+            if (!readTableSnapshotPod(p, pEnd, nSize) || static_cast<size_t>(pEnd - p) < nSize)
+                return false;
+            str.assign(p, nSize);
+            p += nSize;
+            return true;
+        }
+    } // namespace DFG_DETAIL_NS
+
+    // Returns CsvFormatDefinition as bytes that can be stored in snapshot and read with tableSnapshotFormatFromBytes().
+    inline std::string tableSnapshotFormatToBytes(const DFG_CLASS_NAME(CsvFormatDefinition)& format)
+    {
+        using namespace DFG_DETAIL_NS;
+        std::string s;
+        appendTableSnapshotPod(s, format.separatorChar());
+        appendTableSnapshotPod(s, format.enclosingChar());
+        appendTableSnapshotPod(s, static_cast<int32>(format.eolType()));
+        appendTableSnapshotPod(s, static_cast<int32>(format.textEncoding()));
+        appendTableSnapshotPod(s, static_cast<int32>(format.enclosementBehaviour()));
+        appendTableSnapshotPod(s, static_cast<uint8>(format.headerWriting()));
+        appendTableSnapshotPod(s, static_cast<uint8>(format.bomWriting()));
+        appendTableSnapshotPod(s, static_cast<uint32>(format.m_genericProperties.size()));
+        for (auto iter = format.m_genericProperties.cbegin(), iterEnd = format.m_genericProperties.cend(); iter != iterEnd; ++iter)
+        {
+            appendTableSnapshotString(s, iter->first);
+            appendTableSnapshotString(s, iter->second);
+        }
+        return s;
+    }
+
+    // Reads format written by tableSnapshotFormatToBytes(). Return: false if bytes are not valid, in which case rFormat is unspecified.
+    inline bool tableSnapshotFormatFromBytes(const char* p, const size_t nSize, DFG_CLASS_NAME(CsvFormatDefinition)& rFormat)
+    {
+        using namespace DFG_DETAIL_NS;
+        const char* const pEnd = p + nSize;
+        int32 nSep, nEnc, nEol, nEncoding, nEb;
+        uint8 nHeader, nBom;
+        uint32 nPropertyCount;
+        if (!readTableSnapshotPod(p, pEnd, nSep) || !readTableSnapshotPod(p, pEnd, nEnc) || !readTableSnapshotPod(p, pEnd, nEol)
+            || !readTableSnapshotPod(p, pEnd, nEncoding) || !readTableSnapshotPod(p, pEnd, nEb) || !readTableSnapshotPod(p, pEnd, nHeader)
+            || !readTableSnapshotPod(p, pEnd, nBom) || !readTableSnapshotPod(p, pEnd, nPropertyCount))
+            return false;
+        rFormat.separatorChar(nSep);
+        rFormat.enclosingChar(nEnc);
+        rFormat.eolType(static_cast<DFG_MODULE_NS(io)::EndOfLineType>(nEol));
+        rFormat.textEncoding(static_cast<DFG_MODULE_NS(io)::TextEncoding>(nEncoding));
+        rFormat.enclosementBehaviour(static_cast<DFG_MODULE_NS(io)::EnclosementBehaviour>(nEb));
+        rFormat.headerWriting(nHeader != 0);
+        rFormat.bomWriting(nBom != 0);
+        rFormat.m_genericProperties.clear();
+        std::string sKey, sValue;
+        for (uint32 i = 0; i < nPropertyCount; ++i)
+        {
+            if (!readTableSnapshotString(p, pEnd, sKey) || !readTableSnapshotString(p, pEnd, sValue))
+                return false;
+            rFormat.setProperty(sKey, sValue);
+        }
+        return p == pEnd;
+    }
+
+    // Writes snapshot of table to sSnapshotPath. If pFormat is not null, it's stored in the snapshot.
+    // Snapshot file is replaced only if writing succeeds.
+    // Return: true if snapshot was written successfully.
+    template <class Char_T, class Index_T, DFG_MODULE_NS(io)::TextEncoding InternalEncoding_T, class InterfaceTypes_T>
+    bool writeTableSnapshot(const DFG_CLASS_NAME(TableSz)<Char_T, Index_T, InternalEncoding_T, InterfaceTypes_T>& table,
+                            const DFG_CLASS_NAME(ReadOnlySzParamC)& sSnapshotPath,
+                            const DFG_CLASS_NAME(TableSnapshotSourceKey)& key,
+                            const DFG_CLASS_NAME(CsvFormatDefinition)* pFormat = nullptr)
+    {
+        using namespace DFG_DETAIL_NS;
+        DFG_PROFILE_ZONE("writeTableSnapshot");
+        typedef std::char_traits<Char_T> CharTraits;
+        const auto& colToRows = table.m_colToRows;
+        const uint64 nColCount = colToRows.size();
+        const std::string sFormatBytes = (pFormat) ? tableSnapshotFormatToBytes(*pFormat) : std::string();
+
+        // Determining layout.
+        TableSnapshotHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, gTableSnapshotMagic, sizeof(header.magic));
+        header.nVersion = gnTableSnapshotVersion;
+        header.nEndianTag = gnTableSnapshotEndianTag;
+        header.nCharSize = sizeof(Char_T);
+        header.nIndexSize = sizeof(Index_T);
+        header.nFlags = ((key.m_bHasSourceHash) ? gnTableSnapshotFlagHasSourceHash : 0) | ((pFormat) ? gnTableSnapshotFlagHasFormat : 0);
+        header.nSourceSize = key.m_nSourceSize;
+        header.nSourceModificationTime = key.m_nSourceModificationTime;
+        header.nSourceHash = key.m_nSourceHash;
+        header.nReadOptionsHash = key.m_nReadOptionsHash;
+        header.nColumnCount = nColCount;
+        header.nColumnDirectoryOffset = tableSnapshotAlign(sizeof(header));
+        header.nFormatOffset = header.nColumnDirectoryOffset + nColCount * sizeof(TableSnapshotColumnEntry);
+        header.nFormatSize = sFormatBytes.size();
+        uint64 nPos = tableSnapshotAlign(header.nFormatOffset + header.nFormatSize);
+        std::vector<TableSnapshotColumnEntry> columnEntries(static_cast<size_t>(nColCount));
+        for (size_t c = 0; c < columnEntries.size(); ++c)
+        {
+            auto& entry = columnEntries[c];
+            entry.nCellCount = colToRows[c].size();
+            entry.nStringBlockSize = 0;
+            for (auto iter = colToRows[c].cbegin(), iterEnd = colToRows[c].cend(); iter != iterEnd; ++iter)
+            {
+                if (iter->second && iter->second[0] != '\0')
+                    entry.nStringBlockSize += CharTraits::length(iter->second) + 1;
+            }
+            entry.nRowIndexOffset = nPos;
+            nPos = tableSnapshotAlign(nPos + entry.nCellCount * sizeof(Index_T));
+            entry.nStringOffsetsOffset = nPos;
+            nPos += entry.nCellCount * sizeof(uint64);
+            entry.nStringBlockOffset = nPos;
+            nPos = tableSnapshotAlign(nPos + entry.nStringBlockSize * sizeof(Char_T));
+        }
+        header.nFileSize = nPos;
+
+        DFG_MODULE_NS(os)::OutputFile_completeOrNone<> outputFile(sSnapshotPath.c_str());
+        auto& ostrm = outputFile.intermediateFileStream();
+        if (!ostrm.is_open())
+        {
+            outputFile.discardIntermediate();
+            return false;
+        }
+        uint64 nWritePos = 0;
+        const auto writeBytes = [&](const void* p, const size_t nSize)
+        {
+            ostrm.write(static_cast<const char*>(p), static_cast<std::streamsize>(nSize));
+            nWritePos += nSize;
+        };
+        const auto writePadding = [&]()
+        {
+            const char zeros[8] = { 0 };
+            writeBytes(zeros, static_cast<size_t>(tableSnapshotAlign(nWritePos) - nWritePos));
+        };
+
+        writeBytes(&header, sizeof(header));
+        writePadding();
+        if (!columnEntries.empty())
+            writeBytes(columnEntries.data(), columnEntries.size() * sizeof(TableSnapshotColumnEntry));
+        writeBytes(sFormatBytes.data(), sFormatBytes.size());
+        writePadding();
+        std::vector<Index_T> rowIndexes;
+        std::vector<uint64> stringOffsets;
+        for (size_t c = 0; c < columnEntries.size(); ++c)
+        {
+            const auto& rows = colToRows[c];
+            rowIndexes.resize(rows.size());
+            stringOffsets.resize(rows.size());
+            uint64 nStringOffset = 0;
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                const Char_T* const psz = rows[i].second;
+                rowIndexes[i] = rows[i].first;
+                if (!psz)
+                    stringOffsets[i] = gnTableSnapshotNullOffset;
+                else if (psz[0] == '\0')
+                    stringOffsets[i] = gnTableSnapshotEmptyStringOffset;
+                else
+                {
+                    stringOffsets[i] = nStringOffset;
+                    nStringOffset += CharTraits::length(psz) + 1;
+                }
+            }
+            DFG_ASSERT_CORRECTNESS(nStringOffset == columnEntries[c].nStringBlockSize);
+            if (!rows.empty())
+            {
+                writeBytes(rowIndexes.data(), rowIndexes.size() * sizeof(Index_T));
+                writePadding();
+                writeBytes(stringOffsets.data(), stringOffsets.size() * sizeof(uint64));
+            }
+            for (auto iter = rows.cbegin(), iterEnd = rows.cend(); iter != iterEnd; ++iter)
+            {
+                if (iter->second && iter->second[0] != '\0')
+                    writeBytes(iter->second, (CharTraits::length(iter->second) + 1) * sizeof(Char_T));
+            }
+            writePadding();
+        }
+        DFG_ASSERT_CORRECTNESS(nWritePos == header.nFileSize);
+        if (!ostrm.good())
+        {
+            outputFile.discardIntermediate();
+            return false;
+        }
+        return (outputFile.writeIntermediateToFinalLocation() == 0);
+    }
+
+    // Reads table from snapshot sSnapshotPath if its key matches with expectedKey (see TableSnapshotSourceKey::isMatchForStored()).
+    // On success, previous content of table is replaced and if pFormat is not null and snapshot has format, it's read to *pFormat.
+    // Return: true if table was read from snapshot; if false, table is not modified.
+    template <class Char_T, class Index_T, DFG_MODULE_NS(io)::TextEncoding InternalEncoding_T, class InterfaceTypes_T>
+    bool readTableSnapshot(DFG_CLASS_NAME(TableSz)<Char_T, Index_T, InternalEncoding_T, InterfaceTypes_T>& table,
+                           const DFG_CLASS_NAME(ReadOnlySzParamC)& sSnapshotPath,
+                           const DFG_CLASS_NAME(TableSnapshotSourceKey)& expectedKey,
+                           DFG_CLASS_NAME(CsvFormatDefinition)* pFormat = nullptr)
+    {
+        using namespace DFG_DETAIL_NS;
+        DFG_PROFILE_ZONE("readTableSnapshot");
+        typedef DFG_CLASS_NAME(TableSz)<Char_T, Index_T, InternalEncoding_T, InterfaceTypes_T> TableT;
+        typedef typename TableT::IndexPtrPair IndexPtrPair;
+        typedef DFG_MODULE_NS(io)::DFG_CLASS_NAME(FileMemoryMapped) MappedFileT;
+        std::shared_ptr<MappedFileT> spMapped;
+        try
+        {
+            spMapped = std::make_shared<MappedFileT>(sSnapshotPath);
+        }
+        catch (...) // Mapping fails e.g. if file doesn't exist.
+        {
+            return false;
+        }
+        if (!spMapped->is_open())
+            return false;
+        const char* const pData = spMapped->data();
+        const uint64 nFileSize = spMapped->size();
+
+        // Validating header.
+        TableSnapshotHeader header;
+        if (nFileSize < sizeof(header))
+            return false;
+        std::memcpy(&header, pData, sizeof(header));
+        if (std::memcmp(header.magic, gTableSnapshotMagic, sizeof(header.magic)) != 0 || header.nVersion != gnTableSnapshotVersion
+            || header.nEndianTag != gnTableSnapshotEndianTag || header.nCharSize != sizeof(Char_T) || header.nIndexSize != sizeof(Index_T)
+            || header.nFileSize != nFileSize)
+            return false;
+        {
+            DFG_CLASS_NAME(TableSnapshotSourceKey) storedKey;
+            storedKey.m_nSourceSize = header.nSourceSize;
+            storedKey.m_nSourceModificationTime = header.nSourceModificationTime;
+            storedKey.m_nSourceHash = header.nSourceHash;
+            storedKey.m_nReadOptionsHash = header.nReadOptionsHash;
+            storedKey.m_bHasSourceHash = (header.nFlags & gnTableSnapshotFlagHasSourceHash) != 0;
+            if (!expectedKey.isMatchForStored(storedKey))
+                return false;
+        }
+        if (header.nColumnCount > static_cast<uint64>(NumericTraits<Index_T>::maxValue)
+            || header.nColumnDirectoryOffset % 8 != 0
+            || header.nColumnCount > nFileSize / sizeof(TableSnapshotColumnEntry)
+            || !isTableSnapshotRangeValid(header.nColumnDirectoryOffset, header.nColumnCount * sizeof(TableSnapshotColumnEntry), nFileSize)
+            || !isTableSnapshotRangeValid(header.nFormatOffset, header.nFormatSize, nFileSize))
+            return false;
+        const auto pColumnEntries = reinterpret_cast<const TableSnapshotColumnEntry*>(pData + header.nColumnDirectoryOffset);
+        const size_t nColCount = static_cast<size_t>(header.nColumnCount);
+        for (size_t c = 0; c < nColCount; ++c)
+        {
+            const auto& entry = pColumnEntries[c];
+            if (entry.nCellCount > nFileSize || entry.nStringBlockSize > nFileSize
+                || entry.nRowIndexOffset % 8 != 0 || entry.nStringOffsetsOffset % 8 != 0
+                || !isTableSnapshotRangeValid(entry.nRowIndexOffset, entry.nCellCount * sizeof(Index_T), nFileSize)
+                || !isTableSnapshotRangeValid(entry.nStringOffsetsOffset, entry.nCellCount * sizeof(uint64), nFileSize)
+                || !isTableSnapshotRangeValid(entry.nStringBlockOffset, entry.nStringBlockSize * sizeof(Char_T), nFileSize))
+                return false;
+            // Requiring null at the end of the string block guarantees that every string in the block is terminated.
+            const auto pStringBlock = reinterpret_cast<const Char_T*>(pData + entry.nStringBlockOffset);
+            if (entry.nStringBlockSize > 0 && pStringBlock[entry.nStringBlockSize - 1] != '\0')
+                return false;
+        }
+        DFG_CLASS_NAME(CsvFormatDefinition) format(',', '"', DFG_MODULE_NS(io)::EndOfLineTypeN, DFG_MODULE_NS(io)::encodingUTF8);
+        const bool bHasFormat = (header.nFlags & gnTableSnapshotFlagHasFormat) != 0;
+        if (bHasFormat && !tableSnapshotFormatFromBytes(pData + header.nFormatOffset, static_cast<size_t>(header.nFormatSize), format))
+            return false;
+
+        // Building cell index from row and string offset arrays; strings are used from the mapping.
+        // Index is built to separate containers and swapped to table on success so that table is not modified on failure.
+        typename TableT::TableIndexPairContainer colToRows(nColCount);
+        const Char_T* const pEmptyString = &table.m_emptyString;
+        std::atomic<bool> bValid(true);
+        DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nColCount, 1, [&](const size_t c0, const size_t c1)
+        {
+            for (size_t c = c0; c < c1 && bValid; ++c)
+            {
+                const auto& entry = pColumnEntries[c];
+                const size_t nCellCount = static_cast<size_t>(entry.nCellCount);
+                const auto pRows = reinterpret_cast<const Index_T*>(pData + entry.nRowIndexOffset);
+                const auto pOffsets = reinterpret_cast<const uint64*>(pData + entry.nStringOffsetsOffset);
+                const auto pStringBlock = reinterpret_cast<const Char_T*>(pData + entry.nStringBlockOffset);
+                auto& rows = colToRows[c];
+                rows.reserve(nCellCount);
+                for (size_t i = 0; i < nCellCount; ++i)
+                {
+                    const uint64 nOffset = pOffsets[i];
+                    const Char_T* pCell = nullptr;
+                    if (nOffset < entry.nStringBlockSize)
+                        pCell = pStringBlock + nOffset;
+                    else if (nOffset == gnTableSnapshotEmptyStringOffset)
+                        pCell = pEmptyString;
+                    else if (nOffset != gnTableSnapshotNullOffset)
+                        bValid = false;
+                    // Rows must be valid indexes and strictly increasing as columns are searched with binary search.
+                    if (static_cast<uint64>(pRows[i]) >= static_cast<uint64>(NumericTraits<Index_T>::maxValue) || (i > 0 && !(pRows[i - 1] < pRows[i])))
+                        bValid = false;
+                    if (!bValid)
+                        break;
+                    rows.push_back(IndexPtrPair(pRows[i], pCell));
+                }
+            }
+        });
+        if (!bValid)
+            return false;
+
+        table.clear();
+        table.m_colToRows.swap(colToRows);
+        table.m_charBuffers.resize(nColCount);
+        table.adoptExternalStorage(spMapped);
+        if (pFormat && bHasFormat)
+            *pFormat = format;
+        return true;
+    }
+
+    // Reads table from sPath using its snapshot sidecar if the snapshot is valid for the file and for formatDef; otherwise reads the file
+    // with TableCsv::readFromFile() and, if bUpdateSnapshot is true, writes a new snapshot (failure to write snapshot is ignored).
+    // 'check' defines how source is verified to be unchanged, see TableSnapshotSourceCheck.
+    // Return: true if table was read from snapshot.
+    template <class Char_T, class Index_T, DFG_MODULE_NS(io)::TextEncoding InternalEncoding_T>
+    bool readFromFileUsingSnapshot(DFG_CLASS_NAME(TableCsv)<Char_T, Index_T, InternalEncoding_T>& table,
+                                   const DFG_CLASS_NAME(ReadOnlySzParamC)& sPath,
+                                   const DFG_CLASS_NAME(CsvFormatDefinition)& formatDef,
+                                   const TableSnapshotSourceCheck check = TableSnapshotSourceCheckSizeTimeAndHash,
+                                   const bool bUpdateSnapshot = true)
+    {
+        const std::string sSnapshotPath = tableSnapshotPathFromSourcePath(std::string(sPath.c_str()));
+        const std::string sReadOptionBytes = tableSnapshotFormatToBytes(formatDef);
+        DFG_CLASS_NAME(TableSnapshotSourceKey) key;
+        key.m_nReadOptionsHash = DFG_MODULE_NS(hash)::xxHash64(sReadOptionBytes.data(), sReadOptionBytes.size());
+        if (!key.setFromFile(sPath, check == TableSnapshotSourceCheckSizeTimeAndHash))
+        {
+            table.readFromFile(sPath, formatDef);
+            return false;
+        }
+        auto readFormat = table.readFormat();
+        if (readTableSnapshot(table, sSnapshotPath, key, &readFormat))
+        {
+            table.m_readFormat = readFormat;
+            table.m_saveFormat = readFormat;
+            return true;
+        }
+        // Key for new snapshot is determined before reading so that changes made to source during reading are not masked.
+        if (bUpdateSnapshot && !key.m_bHasSourceHash && !key.setFromFile(sPath, true))
+        {
+            table.readFromFile(sPath, formatDef);
+            return false;
+        }
+        table.readFromFile(sPath, formatDef);
+        if (bUpdateSnapshot)
+        {
+            DFG_CLASS_NAME(TableSnapshotSourceKey) keyAfterRead = key;
+            if (keyAfterRead.setFromFile(sPath, false) && keyAfterRead.isMatchForStored(key))
+            {
+                const auto format = table.readFormat();
+                writeTableSnapshot(table, sSnapshotPath, key, &format);
+            }
+        }
+        return false;
+    }
+
+    template <class Char_T, class Index_T, DFG_MODULE_NS(io)::TextEncoding InternalEncoding_T>
+    bool readFromFileUsingSnapshot(DFG_CLASS_NAME(TableCsv)<Char_T, Index_T, InternalEncoding_T>& table,
+                                   const DFG_CLASS_NAME(ReadOnlySzParamC)& sPath,
+                                   const TableSnapshotSourceCheck check = TableSnapshotSourceCheckSizeTimeAndHash,
+                                   const bool bUpdateSnapshot = true)
+    {
+        return readFromFileUsingSnapshot(table, sPath, table.defaultReadFormat(), check, bUpdateSnapshot);
+    }
+
+} } // module namespace
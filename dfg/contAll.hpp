@@ -2,15 +2,25 @@
 
 #include "cont.hpp"
 #include "cont/arrayWrapper.hpp"
+#include "cont/CellBlockJournal.hpp"
 #include "cont/contAlg.hpp"
 #include "cont/CsvConfig.hpp"
+#include "cont/CsvConfigCompiled.hpp"
 #include "cont/tableCsv.hpp"
+#include "cont/tableCsvIncrementalWrite.hpp"
 #include "cont/elementType.hpp"
+#include "cont/EytzingerSearchIndex.hpp"
+#include "cont/FlatHashMap.hpp"
 #include "cont/interleavedXsortedTwoChannelWrapper.hpp"
+#include "cont/IntervalSet.hpp"
 #include "cont/MapVector.hpp"
+#include "cont/OrderStatisticsMultiset.hpp"
 #include "cont/SetVector.hpp"
 #include "cont/SortedSequence.hpp"
 #include "cont/table.hpp"
+#include "cont/tableDiff.hpp"
+#include "cont/tableMatchIndex.hpp"
+#include "cont/tableSnapshot.hpp"
 #include "cont/TorRef.hpp"
 #include "cont/TrivialPair.hpp"
 #include "cont/UniqueResourceHolder.hpp"
@@ -0,0 +1,384 @@
+#pragma once
+
+/*
+coMoments.hpp
+
+Single-pass, numerically stable accumulation of means and co-moments of k variables from which full covariance and correlation
+matrices can be computed.
+
+    -CoMomentAccumulator keeps count, means and co-moment matrix C_ij = sum((x_i - mean_i) * (x_j - mean_j)) updated with Welford's
+     method (addRow()) or block-wise (addBlock()): a block of rows is centered with its own means and its co-moments are combined
+     with the accumulated ones using the pairwise formula of Chan et al. The same formula is used in merge() so that accumulators
+     computed e.g. in different threads can be combined.
+    -coMomentsParallel() computes the accumulator for columns given as contiguous arrays in a single sweep.
+    -coMomentsFromTableColumns() does the same for cells of a TableSz/TableCsv parsing them to double on the fly.
+
+Rows with a NaN in any of the variables are skipped (i.e. listwise deletion of missing values).
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgAssert.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../SzPtr.hpp"
+#include "../numeric/parallel.hpp"
+#include "../str/strTo.hpp"
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN { DFG_SUB_NS(dataAnalysis) {
+
+namespace DFG_DETAIL_NS
+{
+    // Number of rows that addBlock() centers and multiplies at a time: small enough for the centered block of a few dozen variables
+    // to stay in L2-cache, large enough to make the O(k^2) combine step cheap compared to the O(k^2 * rows) products.
+    const size_t gnCoMomentBlockRows = 256;
+
+    // Returns sum(a[i] * b[i]) using independent partial sums so that compiler can vectorize the loop.
+    inline double dotProduct(const double* a, const double* b, const size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; ++i)
+            s0 += a[i] * b[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    inline bool isCellWhitespace(const char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Parses null terminated string to double; returns NaN for empty and non-numeric strings.
+    // Accepted are decimal numbers with optional sign and exponent ('.' as decimal separator), leading and trailing whitespace is ignored.
+    // Infinity and NaN texts and hexadecimal notation are not accepted. Parsing is done with str::strToByNoThrowLexCast() so result doesn't depend on C locale.
+    inline double cellToDouble(const char* psz)
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        if (psz == nullptr)
+            return nan;
+        while (isCellWhitespace(*psz))
+            ++psz;
+        const char* pEnd = psz;
+        bool bHasDigit = false;
+        for (; *pEnd != '\0' && !isCellWhitespace(*pEnd); ++pEnd)
+        {
+            const char c = *pEnd;
+            if (c >= '0' && c <= '9')
+                bHasDigit = true;
+            else if (c != '+' && c != '-' && c != '.' && c != 'e' && c != 'E')
+                return nan;
+        }
+        const char* pTrailing = pEnd;
+        while (isCellWhitespace(*pTrailing))
+            ++pTrailing;
+        if (!bHasDigit || *pTrailing != '\0')
+            return nan;
+        double val = nan;
+        bool bOk = false;
+        if (*pEnd == '\0')
+            DFG_MODULE_NS(str)::strToByNoThrowLexCast(psz, val, &bOk);
+        else
+            DFG_MODULE_NS(str)::strToByNoThrowLexCast(std::string(psz, pEnd), val, &bOk);
+        return (bOk) ? val : nan;
+    }
+} // namespace DFG_DETAIL_NS
+
+class DFG_CLASS_NAME(CoMomentAccumulator)
+{
+public:
+    explicit DFG_CLASS_NAME(CoMomentAccumulator)(const size_t nVariableCount = 0) :
+        m_nVariableCount(nVariableCount),
+        m_nCount(0),
+        m_means(nVariableCount, 0.0),
+        m_coMoments(nVariableCount * nVariableCount, 0.0)
+    {}
+
+    size_t variableCount() const { return m_nVariableCount; }
+    uint64 count() const         { return m_nCount; }
+
+    // Adds one observation; pRow must point to variableCount() values.
+    void addRow(const double* const pRow)
+    {
+        const size_t k = m_nVariableCount;
+        for (size_t i = 0; i < k; ++i)
+        {
+            if (std::isnan(pRow[i]))
+                return;
+        }
+        ++m_nCount;
+        const double nInv = 1.0 / static_cast<double>(m_nCount);
+        m_deltas.resize(k);
+        for (size_t i = 0; i < k; ++i)
+        {
+            m_deltas[i] = pRow[i] - m_means[i];
+            m_means[i] += m_deltas[i] * nInv;
+        }
+        // C_ij += (x_i - oldMean_i) * (x_j - newMean_j) = delta_i * delta_j * (n - 1) / n
+        const double factor = static_cast<double>(m_nCount - 1) * nInv;
+        for (size_t i = 0; i < k; ++i)
+        {
+            const double di = m_deltas[i] * factor;
+            double* pRowC = &m_coMoments[i * k];
+            for (size_t j = i; j < k; ++j)
+                pRowC[j] += di * m_deltas[j];
+        }
+    }
+
+    // Adds nRowCount observations given column-wise: columns[i][r] is the value of variable i on row r.
+    void addBlock(const double* const* const columns, const size_t nRowCount)
+    {
+        const size_t k = m_nVariableCount;
+        if (k == 0)
+            return;
+        const size_t nBlockRows = DFG_DETAIL_NS::gnCoMomentBlockRows;
+        m_centered.resize(k * nBlockRows);
+        m_blockMeans.resize(k);
+        m_validRows.resize(nBlockRows);
+        for (size_t nBlockBegin = 0; nBlockBegin < nRowCount; nBlockBegin += nBlockRows)
+        {
+            const size_t nBlockEnd = Min(nRowCount, nBlockBegin + nBlockRows);
+
+            // Finding rows that have no missing values.
+            size_t nValid = 0;
+            for (size_t r = nBlockBegin; r < nBlockEnd; ++r)
+            {
+                bool bValid = true;
+                for (size_t i = 0; i < k && bValid; ++i)
+                    bValid = !std::isnan(columns[i][r]);
+                if (bValid)
+                    m_validRows[nValid++] = r;
+            }
+            if (nValid == 0)
+                continue;
+
+            // Gathering and centering the block with its own means.
+            const double nValidInv = 1.0 / static_cast<double>(nValid);
+            for (size_t i = 0; i < k; ++i)
+            {
+                const double* const pSrc = columns[i];
+                double* const pDst = &m_centered[i * nBlockRows];
+                double sum = 0;
+                if (nValid == nBlockEnd - nBlockBegin)
+                {
+                    for (size_t r = 0; r < nValid; ++r)
+                    {
+                        pDst[r] = pSrc[nBlockBegin + r];
+                        sum += pDst[r];
+                    }
+                }
+                else
+                {
+                    for (size_t r = 0; r < nValid; ++r)
+                    {
+                        pDst[r] = pSrc[m_validRows[r]];
+                        sum += pDst[r];
+                    }
+                }
+                const double mean = sum * nValidInv;
+                for (size_t r = 0; r < nValid; ++r)
+                    pDst[r] -= mean;
+                m_blockMeans[i] = mean;
+            }
+
+            // Combining block co-moments with accumulated ones:
+            // C = C_a + C_b + delta_i * delta_j * n_a * n_b / n, where delta = mean_b - mean_a.
+            const double nA = static_cast<double>(m_nCount);
+            const double nB = static_cast<double>(nValid);
+            const double nNew = nA + nB;
+            const double crossFactor = nA * nB / nNew;
+            m_deltas.resize(k);
+            for (size_t i = 0; i < k; ++i)
+                m_deltas[i] = m_blockMeans[i] - m_means[i];
+            for (size_t i = 0; i < k; ++i)
+            {
+                const double* const pCi = &m_centered[i * nBlockRows];
+                double* const pRowC = &m_coMoments[i * k];
+                const double di = m_deltas[i] * crossFactor;
+                for (size_t j = i; j < k; ++j)
+                    pRowC[j] += DFG_DETAIL_NS::dotProduct(pCi, &m_centered[j * nBlockRows], nValid) + di * m_deltas[j];
+            }
+            for (size_t i = 0; i < k; ++i)
+                m_means[i] += m_deltas[i] * nB / nNew;
+            m_nCount += nValid;
+        }
+    }
+
+    // Merges statistics of 'other' into this so that result is as if all observations of 'other' had been added to this.
+    // Precondition: other.variableCount() == variableCount()
+    void merge(const DFG_CLASS_NAME(CoMomentAccumulator)& other)
+    {
+        DFG_ASSERT_UB(other.m_nVariableCount == m_nVariableCount);
+        if (other.m_nCount == 0)
+            return;
+        if (m_nCount == 0)
+        {
+            m_nCount = other.m_nCount;
+            m_means = other.m_means;
+            m_coMoments = other.m_coMoments;
+            return;
+        }
+        const size_t k = m_nVariableCount;
+        const double nA = static_cast<double>(m_nCount);
+        const double nB = static_cast<double>(other.m_nCount);
+        const double nNew = nA + nB;
+        const double crossFactor = nA * nB / nNew;
+        m_deltas.resize(k);
+        for (size_t i = 0; i < k; ++i)
+            m_deltas[i] = other.m_means[i] - m_means[i];
+        for (size_t i = 0; i < k; ++i)
+        {
+            const double di = m_deltas[i] * crossFactor;
+            for (size_t j = i; j < k; ++j)
+                m_coMoments[i * k + j] += other.m_coMoments[i * k + j] + di * m_deltas[j];
+        }
+        for (size_t i = 0; i < k; ++i)
+            m_means[i] += m_deltas[i] * nB / nNew;
+        m_nCount += other.m_nCount;
+    }
+
+    double mean(const size_t i) const
+    {
+        return (m_nCount > 0) ? m_means[i] : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Returns sum((x_i - mean_i) * (x_j - mean_j)).
+    double coMoment(const size_t i, const size_t j) const
+    {
+        return (i <= j) ? m_coMoments[i * m_nVariableCount + j] : m_coMoments[j * m_nVariableCount + i];
+    }
+
+    // Returns covariance of variables i and j; with nDeltaDegreesOfFreedom = 1 (default) returns sample covariance, with 0 population covariance.
+    double covariance(const size_t i, const size_t j, const size_t nDeltaDegreesOfFreedom = 1) const
+    {
+        if (m_nCount <= nDeltaDegreesOfFreedom)
+            return std::numeric_limits<double>::quiet_NaN();
+        return coMoment(i, j) / static_cast<double>(m_nCount - nDeltaDegreesOfFreedom);
+    }
+
+    // Returns Pearson correlation of variables i and j.
+    double correlation(const size_t i, const size_t j) const
+    {
+        if (m_nCount == 0)
+            return std::numeric_limits<double>::quiet_NaN();
+        return coMoment(i, j) / std::sqrt(coMoment(i, i) * coMoment(j, j));
+    }
+
+    // Returns k x k covariance matrix in row-major order.
+    std::vector<double> covarianceMatrix(const size_t nDeltaDegreesOfFreedom = 1) const
+    {
+        return privMatrix([&](const size_t i, const size_t j) { return covariance(i, j, nDeltaDegreesOfFreedom); });
+    }
+
+    // Returns k x k correlation matrix in row-major order.
+    std::vector<double> correlationMatrix() const
+    {
+        return privMatrix([&](const size_t i, const size_t j) { return correlation(i, j); });
+    }
+
+private:
+    template <class Func_T>
+    std::vector<double> privMatrix(Func_T func) const
+    {
+        const size_t k = m_nVariableCount;
+        std::vector<double> rv(k * k);
+        for (size_t i = 0; i < k; ++i)
+        {
+            for (size_t j = i; j < k; ++j)
+            {
+                rv[i * k + j] = func(i, j);
+                rv[j * k + i] = rv[i * k + j];
+            }
+        }
+        return rv;
+    }
+
+    size_t m_nVariableCount;
+    uint64 m_nCount;
+    std::vector<double> m_means;
+    std::vector<double> m_coMoments; // Row-major k x k, only upper triangle (j >= i) is maintained.
+    // Scratch buffers, kept as members to avoid reallocation on every call.
+    std::vector<double> m_deltas;
+    std::vector<double> m_blockMeans;
+    std::vector<double> m_centered;
+    std::vector<size_t> m_validRows;
+}; // class CoMomentAccumulator
+
+// Computes co-moments of columns given as pointers to nRowCount contiguous doubles in a single sweep using at most nMaxThreadCount
+// threads (0 = automatic). Rows are processed in fixed size chunks whose results are merged pairwise so the result does not depend on
+// the thread count.
+inline DFG_CLASS_NAME(CoMomentAccumulator) coMomentsParallel(const std::vector<const double*>& columns, const size_t nRowCount, const size_t nMaxThreadCount = 0)
+{
+    typedef DFG_CLASS_NAME(CoMomentAccumulator) AccT;
+    using namespace DFG_MODULE_NS(numeric)::DFG_DETAIL_NS;
+    const size_t k = columns.size();
+    const size_t nChunkCount = Max(size_t(1), (nRowCount + gnParallelChunkSize - 1) / gnParallelChunkSize);
+    std::vector<AccT> partials(nChunkCount, AccT(k));
+    forEachChunkParallel(nRowCount, gnParallelChunkSize, nMaxThreadCount, [&](const size_t nChunk, const size_t iBegin, const size_t iEnd)
+    {
+        std::vector<const double*> chunkColumns(k);
+        for (size_t i = 0; i < k; ++i)
+            chunkColumns[i] = columns[i] + iBegin;
+        partials[nChunk].addBlock(chunkColumns.data(), iEnd - iBegin);
+    });
+    return combinePairwise(partials, [](AccT a, const AccT& b) { a.merge(b); return a; });
+}
+
+// Overload for a container of contiguous double containers, e.g. std::vector<std::vector<double>>. If columns have different sizes,
+// only the rows present in all columns are used.
+template <class ColumnCont_T>
+DFG_CLASS_NAME(CoMomentAccumulator) coMomentsParallel(const ColumnCont_T& columns, const size_t nMaxThreadCount = 0)
+{
+    std::vector<const double*> ptrs;
+    size_t nRowCount = (std::numeric_limits<size_t>::max)();
+    for (const auto& col : columns)
+    {
+        ptrs.push_back(DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::contiguousPtr(col));
+        nRowCount = Min(nRowCount, static_cast<size_t>(::DFG_ROOT_NS::count(col)));
+    }
+    return coMomentsParallel(ptrs, (!ptrs.empty()) ? nRowCount : 0, nMaxThreadCount);
+}
+
+// Computes co-moments of given columns of a TableSz/TableCsv (with char-based storage). Cells are parsed to double on the fly in row chunks
+// of nRowsPerChunk; missing, empty and non-numeric cells are treated as missing values so the row they are on is skipped.
+template <class Table_T, class IndexCont_T>
+DFG_CLASS_NAME(CoMomentAccumulator) coMomentsFromTableColumns(const Table_T& table, const IndexCont_T& columnIndexes, const size_t nMaxThreadCount = 0, const size_t nRowsPerChunk = 8192)
+{
+    typedef DFG_CLASS_NAME(CoMomentAccumulator) AccT;
+    typedef decltype(table.rowCountByMaxRowIndex()) IndexT;
+    using namespace DFG_MODULE_NS(numeric)::DFG_DETAIL_NS;
+    const std::vector<IndexT> cols(std::begin(columnIndexes), std::end(columnIndexes));
+    const size_t k = cols.size();
+    const size_t nRowCount = static_cast<size_t>(table.rowCountByMaxRowIndex());
+    const size_t nChunkSize = Max(size_t(1), nRowsPerChunk);
+    const size_t nChunkCount = Max(size_t(1), (nRowCount + nChunkSize - 1) / nChunkSize);
+    std::vector<AccT> partials(nChunkCount, AccT(k));
+    forEachChunkParallel(nRowCount, nChunkSize, nMaxThreadCount, [&](const size_t nChunk, const size_t iBegin, const size_t iEnd)
+    {
+        const size_t nRows = iEnd - iBegin;
+        std::vector<double> values(k * nRows, std::numeric_limits<double>::quiet_NaN());
+        std::vector<const double*> ptrs(k);
+        for (size_t i = 0; i < k; ++i)
+        {
+            double* const pDst = &values[i * nRows];
+            ptrs[i] = pDst;
+            table.forEachFwdRowInColumn(cols[i], static_cast<IndexT>(iBegin), static_cast<IndexT>(iEnd), [&](const IndexT nRow, decltype(table(0, 0)) tpsz)
+            {
+                pDst[static_cast<size_t>(nRow) - iBegin] = DFG_DETAIL_NS::cellToDouble(toCharPtr_raw(tpsz));
+            });
+        }
+        partials[nChunk].addBlock(ptrs.data(), nRows);
+    });
+    return combinePairwise(partials, [](AccT a, const AccT& b) { a.merge(b); return a; });
+}
+
+}} // module dataAnalysis
@@ -3,6 +3,10 @@
 #include "../dfgDefs.hpp"
 #include "../math/pow.hpp"
 #include "../alg/rank.hpp"
+#include "../numeric/parallel.hpp"
+#include <array>
+#include <limits>
+#include <vector>
 #include <iterator> // std::begin et al
 #include <cmath>
 
@@ -73,6 +77,49 @@ double correlation(const Cont0_T& cont0, const Cont1_T& cont1)
     return correlation(cont0, cont1, trueFunc);
 }
 
+// Parallel version of correlation(cont0, cont1) for contiguous ranges: sums are computed in a single pass over both ranges
+// in chunks that are distributed among threads and partial sums are combined deterministically (see numeric/parallel.hpp).
+// Returns NaN if ranges have different sizes.
+template <class Cont0_T, class Cont1_T>
+double correlationParallel(const Cont0_T& cont0, const Cont1_T& cont1, const size_t nMaxThreadCount = 0)
+{
+    const size_t nCount = ::DFG_ROOT_NS::count(cont0);
+    if (nCount != ::DFG_ROOT_NS::count(cont1))
+        return std::numeric_limits<double>::quiet_NaN();
+    const auto p0 = DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::contiguousPtr(cont0);
+    const auto p1 = DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::contiguousPtr(cont1);
+    typedef std::array<double, 5> SumsT; // sum0, sum1, sumSquare0, sumSquare1, productSum
+    const size_t nChunkCount = Max(size_t(1), (nCount + DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::gnParallelChunkSize - 1) / DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::gnParallelChunkSize);
+    std::vector<SumsT> partials(nChunkCount, SumsT());
+    DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::forEachChunkParallel(nCount, DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::gnParallelChunkSize, nMaxThreadCount, [&](const size_t nChunk, const size_t iBegin, const size_t iEnd)
+    {
+        SumsT sums = {{ 0, 0, 0, 0, 0 }};
+        for (size_t i = iBegin; i < iEnd; ++i)
+        {
+            const double v0 = p0[i];
+            const double v1 = p1[i];
+            sums[0] += v0;
+            sums[1] += v1;
+            sums[2] += v0 * v0;
+            sums[3] += v1 * v1;
+            sums[4] += v0 * v1;
+        }
+        partials[nChunk] = sums;
+    });
+    const auto sums = DFG_MODULE_NS(numeric)::DFG_DETAIL_NS::combinePairwise(partials, [](const SumsT& a, const SumsT& b)
+    {
+        SumsT rv;
+        for (size_t i = 0; i < rv.size(); ++i)
+            rv[i] = a[i] + b[i];
+        return rv;
+    });
+    const double xAvg = sums[0] / nCount;
+    const double yAvg = sums[1] / nCount;
+    const double var1 = sums[2] - nCount * DFG_MODULE_NS(math)::pow2(xAvg);
+    const double var2 = sums[3] - nCount * DFG_MODULE_NS(math)::pow2(yAvg);
+    return (sums[4] - nCount * xAvg * yAvg) / std::sqrt(var1 * var2);
+}
+
 template <class Cont0_T, class Cont1_T>
 double correlationRankSpearman(const Cont0_T& cont0, const Cont1_T& cont1)
 {
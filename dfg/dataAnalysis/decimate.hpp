@@ -0,0 +1,175 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include <cmath>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN { DFG_SUB_NS(dataAnalysis) {
+
+// Decimates values by splitting index range [0, nSize[ into buckets of (almost) equal size and choosing from each bucket
+// the indexes of minimum and maximum values. Typical use case is to reduce line graph points to display resolution
+// (e.g. bucket per pixel) so that spikes remain visible.
+// Returns selected indexes in ascending order; there are at most 2 * nBucketCount of them. If nSize <= 2 * nBucketCount, returns all indexes.
+// Note: NaN values are never selected unless they are the only values in a bucket in which case nothing gets selected from the bucket.
+template <class Cont_T>
+std::vector<size_t> decimateIndexesMinMax(const Cont_T& values, const size_t nBucketCount)
+{
+    const size_t nSize = ::DFG_ROOT_NS::count(values);
+    std::vector<size_t> indexes;
+    if (nSize <= 2 * nBucketCount)
+    {
+        indexes.resize(nSize);
+        for (size_t i = 0; i < nSize; ++i)
+            indexes[i] = i;
+        return indexes;
+    }
+    indexes.reserve(2 * nBucketCount);
+    for (size_t nBucket = 0; nBucket < nBucketCount; ++nBucket)
+    {
+        const size_t nBegin = nBucket * nSize / nBucketCount;
+        const size_t nEnd = (nBucket + 1) * nSize / nBucketCount;
+        size_t iMin = nEnd;
+        size_t iMax = nEnd;
+        for (size_t i = nBegin; i < nEnd; ++i)
+        {
+            const auto val = values[i];
+            if (val != val) // NaN
+                continue;
+            if (iMin == nEnd || val < values[iMin])
+                iMin = i;
+            if (iMax == nEnd || val > values[iMax])
+                iMax = i;
+        }
+        if (iMin == nEnd)
+            continue;
+        indexes.push_back(Min(iMin, iMax));
+        if (iMin != iMax)
+            indexes.push_back(Max(iMin, iMax));
+    }
+    return indexes;
+}
+
+// Like decimateIndexesMinMax(), but buckets are x-intervals of equal width over [min(x), max(x)] instead of index ranges of equal size,
+// so that unevenly spaced points (e.g. rows with gaps) get one bucket per equal x-distance (e.g. per pixel).
+// From each bucket, indexes of minimum and maximum y-values are chosen.
+// Points are expected to be ordered by x (non-decreasing) and x-values to be finite; if x is not ordered, falls back to decimateIndexesMinMax(yValues).
+// Returns selected indexes in ascending order; there are at most 2 * nBucketCount of them. If nSize <= 2 * nBucketCount, returns all indexes.
+template <class XCont_T, class YCont_T>
+std::vector<size_t> decimateIndexesMinMaxByX(const XCont_T& xValues, const YCont_T& yValues, const size_t nBucketCount)
+{
+    const size_t nSize = Min(::DFG_ROOT_NS::count(xValues), ::DFG_ROOT_NS::count(yValues));
+    if (nSize <= 2 * nBucketCount)
+        return decimateIndexesMinMax(yValues, nBucketCount);
+    for (size_t i = 1; i < nSize; ++i)
+    {
+        if (xValues[i] < xValues[i - 1])
+            return decimateIndexesMinMax(yValues, nBucketCount);
+    }
+    std::vector<size_t> indexes;
+    indexes.reserve(2 * nBucketCount);
+    const double xMin = static_cast<double>(xValues[0]);
+    const double xRange = static_cast<double>(xValues[nSize - 1]) - xMin;
+    const auto bucketOf = [&](const size_t i) -> size_t
+    {
+        if (!(xRange > 0))
+            return 0;
+        return Min(nBucketCount - 1, static_cast<size_t>((static_cast<double>(xValues[i]) - xMin) / xRange * static_cast<double>(nBucketCount)));
+    };
+    // Since x is ordered, each bucket is a contiguous index range.
+    for (size_t nBegin = 0; nBegin < nSize;)
+    {
+        const size_t nBucket = bucketOf(nBegin);
+        size_t nEnd = nBegin + 1;
+        while (nEnd < nSize && bucketOf(nEnd) == nBucket)
+            ++nEnd;
+        size_t iMin = nEnd;
+        size_t iMax = nEnd;
+        for (size_t i = nBegin; i < nEnd; ++i)
+        {
+            const auto val = yValues[i];
+            if (val != val) // NaN
+                continue;
+            if (iMin == nEnd || val < yValues[iMin])
+                iMin = i;
+            if (iMax == nEnd || val > yValues[iMax])
+                iMax = i;
+        }
+        if (iMin != nEnd)
+        {
+            indexes.push_back(Min(iMin, iMax));
+            if (iMin != iMax)
+                indexes.push_back(Max(iMin, iMax));
+        }
+        nBegin = nEnd;
+    }
+    return indexes;
+}
+
+// Decimates xy-data using Largest-Triangle-Three-Buckets algorithm: first and last points are always kept and from each
+// intermediate bucket the point forming the largest triangle with the previously selected point and the average of the next bucket is chosen.
+// Compared to decimateIndexesMinMax(), this tends to preserve the visual shape better with a given point count, but doesn't guarantee that all extremes are kept.
+// Points are expected to be ordered by x and not to contain NaN values.
+// Returns selected indexes in ascending order; there are min(nSize, nMaxOutputCount) of them (with nMaxOutputCount < 3 treated as 3).
+template <class XCont_T, class YCont_T>
+std::vector<size_t> decimateIndexesLttb(const XCont_T& xValues, const YCont_T& yValues, size_t nMaxOutputCount)
+{
+    const size_t nSize = Min(::DFG_ROOT_NS::count(xValues), ::DFG_ROOT_NS::count(yValues));
+    nMaxOutputCount = Max(nMaxOutputCount, size_t(3));
+    std::vector<size_t> indexes;
+    if (nSize <= nMaxOutputCount)
+    {
+        indexes.resize(nSize);
+        for (size_t i = 0; i < nSize; ++i)
+            indexes[i] = i;
+        return indexes;
+    }
+    indexes.reserve(nMaxOutputCount);
+    indexes.push_back(0);
+    // Buckets cover range [1, nSize - 1[, i.e. everything except the first and last point.
+    const size_t nBucketCount = nMaxOutputCount - 2;
+    const size_t nInnerCount = nSize - 2;
+    const auto bucketBegin = [&](const size_t nBucket) { return 1 + nBucket * nInnerCount / nBucketCount; };
+    size_t iPrev = 0;
+    for (size_t nBucket = 0; nBucket < nBucketCount; ++nBucket)
+    {
+        // Average of next bucket; for the last bucket, the next 'bucket' is the last point.
+        double avgX = 0;
+        double avgY = 0;
+        {
+            const size_t nNextBegin = bucketBegin(nBucket + 1);
+            const size_t nNextEnd = (nBucket + 1 < nBucketCount) ? bucketBegin(nBucket + 2) : nSize;
+            for (size_t i = nNextBegin; i < nNextEnd; ++i)
+            {
+                avgX += static_cast<double>(xValues[i]);
+                avgY += static_cast<double>(yValues[i]);
+            }
+            const auto nCount = static_cast<double>(nNextEnd - nNextBegin);
+            avgX /= nCount;
+            avgY /= nCount;
+        }
+
+        const double prevX = static_cast<double>(xValues[iPrev]);
+        const double prevY = static_cast<double>(yValues[iPrev]);
+        const size_t nBegin = bucketBegin(nBucket);
+        const size_t nEnd = bucketBegin(nBucket + 1);
+        double maxArea = -1;
+        size_t iSelected = nBegin;
+        for (size_t i = nBegin; i < nEnd; ++i)
+        {
+            // Twice the triangle area; factor doesn't matter in comparison.
+            const double area = std::abs((prevX - avgX) * (static_cast<double>(yValues[i]) - prevY) - (prevX - static_cast<double>(xValues[i])) * (avgY - prevY));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                iSelected = i;
+            }
+        }
+        indexes.push_back(iSelected);
+        iPrev = iSelected;
+    }
+    indexes.push_back(nSize - 1);
+    return indexes;
+}
+
+}} // module namespace
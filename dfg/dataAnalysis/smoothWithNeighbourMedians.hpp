@@ -5,61 +5,182 @@
 #include "../func/memFunc.hpp"
 #include "../dfgBase.hpp"
 #include "../cont/elementType.hpp"
-#include "../cont/SortedSequence.hpp"
+#include "../cont/OrderStatisticsMultiset.hpp"
 #include "../numeric/median.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 DFG_ROOT_NS_BEGIN { DFG_SUB_NS(dataAnalysis) {
 
+namespace DFG_DETAIL_NS
+{
+    // Replaces dst[i] for i in [iBegin, iEnd[ with orderStatisticFunc(window), where window is an OrderStatisticsMultiset
+    // containing values src[i - nWindowRadius], ..., src[i + nWindowRadius] (clipped to [0, nSize[).
+    // Values are read from src only before dst at the same index is written so src and dst may be the same object if iBegin == 0.
+    // Time: O((iEnd - iBegin + nWindowRadius) * log(nWindowRadius)), space: O(nWindowRadius).
+    template <class Src_T, class Dst_T, class OrderStatisticFunc_T>
+    void smoothWithNeighbourOrderStatistic(const Src_T& src, Dst_T& dst, const size_t nSize, const size_t nWindowRadius, const size_t iBegin, const size_t iEnd, OrderStatisticFunc_T orderStatisticFunc)
+    {
+        typedef typename std::remove_const<typename std::remove_reference<decltype(src[0])>::type>::type ValueT;
+        DFG_ASSERT_CORRECTNESS(iBegin == 0 || static_cast<const void*>(&src) != static_cast<const void*>(&dst));
+
+        if (nSize == 0)
+            return;
+        const size_t nRadius = Min(nWindowRadius, nSize - 1);
+
+        // Ring buffer of values currently in window so that removed values are available even if dst overwrites src.
+        // Before removal, window temporarily covers 2 * nRadius + 2 items.
+        const size_t nRingSize = Min(nSize, 2 * nRadius + 2);
+        std::vector<ValueT> windowValues(nRingSize);
+
+        DFG_MODULE_NS(cont)::DFG_CLASS_NAME(OrderStatisticsMultiset)<ValueT> window;
+
+        const size_t iFirstInserted = (iBegin >= nRadius) ? iBegin - nRadius : 0;
+        size_t iWnd = iFirstInserted;
+        for (size_t iCont = iBegin; iCont < iEnd; ++iCont)
+        {
+            const auto endWndItem = Min(iCont + nRadius + 1, nSize);
+            for (; iWnd < endWndItem; ++iWnd)
+            {
+                const ValueT val = src[iWnd];
+                windowValues[iWnd % nRingSize] = val;
+                window.insert(val);
+            }
+            if (iCont > nRadius && iCont - nRadius - 1 >= iFirstInserted)
+                window.erase(windowValues[(iCont - nRadius - 1) % nRingSize]);
+            dst[iCont] = orderStatisticFunc(window);
+        }
+    }
+
+    // Splits [0, nSize[ into segments and calls func(iBegin, iEnd) for each in separate threads.
+    template <class Func_T>
+    void forEachSegmentParallel(const size_t nSize, const size_t nMinItemsPerThread, size_t nMaxThreadCount, Func_T func)
+    {
+        const bool bUsePool = (nMaxThreadCount == 0);
+        if (bUsePool)
+            nMaxThreadCount = DFG_MODULE_NS(thread)::defaultThreadPool().threadCount();
+        const size_t nSegmentCount = Max(size_t(1), Min(nMaxThreadCount, nSize / Max(size_t(1), nMinItemsPerThread)));
+        if (bUsePool)
+        {
+            DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nSegmentCount, 1, [&](const size_t i0, const size_t i1)
+            {
+                for (size_t i = i0; i < i1; ++i)
+                    func(i * nSize / nSegmentCount, (i + 1) * nSize / nSegmentCount);
+            });
+            return;
+        }
+        std::vector<std::thread> threads;
+        threads.reserve(nSegmentCount - 1);
+        for (size_t i = 1; i < nSegmentCount; ++i)
+            threads.push_back(std::thread(func, i * nSize / nSegmentCount, (i + 1) * nSize / nSegmentCount));
+        func(size_t(0), nSize / nSegmentCount);
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    template <class T>
+    class MedianInOrderStatisticsMultiset
+    {
+    public:
+        template <class Window_T>
+        T operator()(const Window_T& window) const
+        {
+            // Like numeric::medianInSorted(): middle item or average of the two middle items.
+            const size_t n = window.size();
+            return (n % 2 == 1) ? window.nth(n / 2) : (window.nth(n / 2 - 1) + window.nth(n / 2)) / 2;
+        }
+    };
+
+    template <class T>
+    class PercentileInOrderStatisticsMultiset
+    {
+    public:
+        PercentileInOrderStatisticsMultiset(const double percentile) :
+            m_percentile(percentile)
+        {
+            ::DFG_ROOT_NS::limit(m_percentile, 0, 100);
+        }
+
+        template <class Window_T>
+        T operator()(const Window_T& window) const
+        {
+            // Same index as in numeric::percentileInSorted_enclosingElemIndex().
+            const size_t n = window.size();
+            return window.nth(Min(n - 1, ::DFG_ROOT_NS::floorToInteger<size_t>(n * m_percentile / 100.0)));
+        }
+
+        double m_percentile;
+    };
+
+    template <class Cont_T, class OrderStatisticFunc_T>
+    void smoothWithNeighbourOrderStatisticParallel(Cont_T& cont, const size_t nWindowRadius, const size_t nMaxThreadCount, const size_t nMinItemsPerThread, OrderStatisticFunc_T func)
+    {
+        typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Cont_T>::type ValueT;
+        const size_t nSize = ::DFG_ROOT_NS::count(cont);
+        if (nWindowRadius < 1 || nSize <= 1)
+            return;
+        // Each segment needs to fill initial window of up to 2 * nWindowRadius items so segments much shorter than that would be mostly overhead.
+        const size_t nMinSegmentSize = Max(nMinItemsPerThread, 2 * Min(nWindowRadius, nSize));
+        if (nSize < 2 * nMinSegmentSize)
+        {
+            smoothWithNeighbourOrderStatistic(cont, cont, nSize, nWindowRadius, 0, nSize, func);
+            return;
+        }
+        // Segments read neighbours outside their own range so source values are taken from a copy.
+        const std::vector<ValueT> src(std::begin(cont), std::end(cont));
+        forEachSegmentParallel(nSize, nMinSegmentSize, nMaxThreadCount, [&](const size_t iBegin, const size_t iEnd)
+        {
+            smoothWithNeighbourOrderStatistic(src, cont, nSize, nWindowRadius, iBegin, iEnd, func);
+        });
+    }
+} // namespace DFG_DETAIL_NS
+
 // Convert values in an container into a median values of local neighbour window.
 // For example with value in the middle of container [k] -> median([k-nWindowSize], ..., [k], ..., [k+nWindowSize])
 // On boundaries the median is calculated from as many elements as there are in the window. For example on first element
 // window consists only of right side neighbours, on second there's only one left neighbour.
+// Time: O(n * log(nWindowRadius)), window is maintained in cont::OrderStatisticsMultiset.
 // TODO: Write using iterators so that the algorithm works also for non-indexed containers.
 template <class Cont_T>
 void smoothWithNeighbourMedians(Cont_T&& cont, const size_t nWindowRadiusRequest = 1)
 {
     typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Cont_T>::type ValueT;
-
     const auto nSize = ::DFG_ROOT_NS::count(cont);
-
     if (nWindowRadiusRequest < 1 || nSize <= 1)
-    {
         return;
-    }
-
-    const auto nWindowRadius = Min(nWindowRadiusRequest, nSize - 1);
-
-    // If nWindowRadius is small, using this non-heap allocated array. TODO: use soo-vector
-    ValueT originalValuesStatic[3] = { 0, 0, 0 };
-    std::vector<ValueT> vecOriginalValues;
-    if (nWindowRadius >= DFG_COUNTOF(originalValuesStatic))
-        vecOriginalValues.resize(nWindowRadius + 1, 0);
-    DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ArrayWrapperT)<ValueT> originalVals((vecOriginalValues.empty()) ? originalValuesStatic : &vecOriginalValues[0], nWindowRadius + 1);
-
-    DFG_MODULE_NS(cont)::DFG_CLASS_NAME(SortedSequence)<std::vector<ValueT>> window;
+    DFG_DETAIL_NS::smoothWithNeighbourOrderStatistic(cont, cont, nSize, nWindowRadiusRequest, 0, nSize, DFG_DETAIL_NS::MedianInOrderStatisticsMultiset<ValueT>());
+}
 
-    const auto nMaxWindowSize = Min(nSize, 1 + 2 * nWindowRadius);
-    window.reserve(nMaxWindowSize);
+// Like smoothWithNeighbourMedians(), but replaces values by given percentile (in range [0, 100]) of the neighbour window.
+// Percentile is chosen from window items like in numeric::percentileInSorted_enclosingElem().
+template <class Cont_T>
+void smoothWithNeighbourPercentiles(Cont_T&& cont, const size_t nWindowRadiusRequest, const double percentile)
+{
+    typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Cont_T>::type ValueT;
+    const auto nSize = ::DFG_ROOT_NS::count(cont);
+    if (nWindowRadiusRequest < 1 || nSize <= 1)
+        return;
+    DFG_DETAIL_NS::smoothWithNeighbourOrderStatistic(cont, cont, nSize, nWindowRadiusRequest, 0, nSize, DFG_DETAIL_NS::PercentileInOrderStatisticsMultiset<ValueT>(percentile));
+}
 
-    size_t iWnd = 0;
-    for (size_t iCont = 0; iCont < nSize; ++iCont)
-    {
-        const auto lowerWindowItem = (iCont >= nWindowRadius) ? iCont - nWindowRadius : 0;
-        const auto endWndItem = Min(iCont + nWindowRadius + 1, nSize);
-        const auto nCurrentWindowSize = endWndItem - lowerWindowItem;
+// Multithreaded version of smoothWithNeighbourMedians(): container is split into segments that are processed in separate threads.
+// Result is identical to smoothWithNeighbourMedians(). If nMaxThreadCount is 0, work is done in thread::defaultThreadPool().
+// Note: for multithreaded processing, allocates a temporary copy of the values.
+template <class Cont_T>
+void smoothWithNeighbourMediansParallel(Cont_T&& cont, const size_t nWindowRadius = 1, const size_t nMaxThreadCount = 0, const size_t nMinItemsPerThread = 10000)
+{
+    typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Cont_T>::type ValueT;
+    DFG_DETAIL_NS::smoothWithNeighbourOrderStatisticParallel(cont, nWindowRadius, nMaxThreadCount, nMinItemsPerThread, DFG_DETAIL_NS::MedianInOrderStatisticsMultiset<ValueT>());
+}
 
-        for (; iWnd < endWndItem; ++iWnd)
-        {
-            if (window.size() < nMaxWindowSize)
-                window.insert(cont[iWnd]);
-            else
-                window.replace(originalVals[iCont % originalVals.size()], cont[iWnd]);
-        }
-        if (window.size() > nCurrentWindowSize)
-            window.erase(originalVals[(iCont - nWindowRadius - 1) % originalVals.size()]);
-        originalVals[iCont % originalVals.size()] = cont[iCont];
-        cont[iCont] = DFG_MODULE_NS(numeric)::medianInSorted(window);
-    }
+// Multithreaded version of smoothWithNeighbourPercentiles(), see smoothWithNeighbourMediansParallel() for details.
+template <class Cont_T>
+void smoothWithNeighbourPercentilesParallel(Cont_T&& cont, const size_t nWindowRadius, const double percentile, const size_t nMaxThreadCount = 0, const size_t nMinItemsPerThread = 10000)
+{
+    typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Cont_T>::type ValueT;
+    DFG_DETAIL_NS::smoothWithNeighbourOrderStatisticParallel(cont, nWindowRadius, nMaxThreadCount, nMinItemsPerThread, DFG_DETAIL_NS::PercentileInOrderStatisticsMultiset<ValueT>(percentile));
 }
 
 }} // module namespace
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "dataAnalysis/coMoments.hpp"
 #include "dataAnalysis/correlation.hpp"
+#include "dataAnalysis/decimate.hpp"
 #include "dataAnalysis/smoothWithNeighbourAverages.hpp"
 #include "dataAnalysis/smoothWithNeighbourMedians.hpp"
@@ -0,0 +1,516 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgAssert.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Streaming quantile estimators with bounded memory. Unlike MemFuncMedian, which stores every value, these keep a summary ("sketch")
+// whose size does not depend on the number of values and which can be merged (e.g. results from different threads or shards) and serialized.
+//  -MemFuncQuantileTDigest: merging t-digest (Dunning & Ertl). Accuracy is best near the tails (e.g. p99, p999), error bound is empirical.
+//  -MemFuncQuantileKll: KLL sketch (Karnin, Lang & Liberty). Rank error has probabilistic guarantee uniform over all quantiles.
+// NaN's are ignored by both.
+// Serialized format stores values as raw IEEE doubles in native byte order, i.e. it is portable only between platforms with the same endianness.
+
+DFG_ROOT_NS_BEGIN { DFG_SUB_NS(func) {
+
+namespace DFG_DETAIL_NS
+{
+    template <class T, class Cont_T>
+    inline void appendPodBytes(Cont_T& dest, const T& val)
+    {
+        const auto p = reinterpret_cast<const char*>(&val);
+        dest.insert(dest.end(), p, p + sizeof(T));
+    }
+
+    // Reads T from [p, pEnd[ advancing p. Returns false if there are not enough bytes.
+    template <class T>
+    inline bool readPodBytes(const char*& p, const char* const pEnd, T& val)
+    {
+        if (static_cast<size_t>(pEnd - p) < sizeof(T))
+            return false;
+        std::memcpy(&val, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    const uint32 gnTDigestSerializationMagic = 0x31474454; // "TDG1"
+    const uint32 gnKllSerializationMagic     = 0x314C4C4B; // "KLL1"
+} // namespace DFG_DETAIL_NS
+
+/* Functor that estimates quantiles of it's call parameters with t-digest.
+ * Values are summarised as centroids (mean, weight) whose maximum weight is limited by scale function k(q) = compression / (2 * pi) * asin(2q - 1),
+ * which allows only small centroids near q = 0 and q = 1. The number of centroids is at most about 'compression' (plus buffer of 5 * compression
+ * unmerged values), e.g. with default compression 100 memory usage is a few kilobytes regardless of the number of values.
+ * Accuracy: error in quantile is typically in the order of q * (1 - q) / compression in rank, e.g. p99 and p1 are much more accurate than median;
+ * this is empirical behaviour, not a strict guarantee. Minimum and maximum are exact.
+ * Example:
+ *     DFG_CLASS_NAME(MemFuncQuantileTDigest)<double> mf;
+ *     for (...) mf(val);
+ *     const auto p99 = mf.quantile(0.99);
+ */
+template <class Data_T = double>
+class DFG_CLASS_NAME(MemFuncQuantileTDigest)
+{
+public:
+    typedef std::pair<double, double> CentroidT; // (mean, weight)
+
+    DFG_CLASS_NAME(MemFuncQuantileTDigest)(const double compression = 100) :
+        m_compression(Max(10.0, compression)),
+        m_totalWeight(0),
+        m_minValue(std::numeric_limits<double>::infinity()),
+        m_maxValue(-std::numeric_limits<double>::infinity())
+    {}
+
+    void operator()(const Data_T& val)
+    {
+        const double d = static_cast<double>(val);
+        if (std::isnan(d))
+            return;
+        m_minValue = Min(m_minValue, d);
+        m_maxValue = Max(m_maxValue, d);
+        m_buffer.push_back(CentroidT(d, 1));
+        m_totalWeight += 1;
+        if (m_buffer.size() >= bufferCapacity())
+            privCompress();
+    }
+
+    // Merges content of 'other' to this. Compression of this is used for the result.
+    void merge(const DFG_CLASS_NAME(MemFuncQuantileTDigest)& other)
+    {
+        if (other.m_totalWeight <= 0)
+            return;
+        m_minValue = Min(m_minValue, other.m_minValue);
+        m_maxValue = Max(m_maxValue, other.m_maxValue);
+        m_buffer.insert(m_buffer.end(), other.m_centroids.begin(), other.m_centroids.end());
+        m_buffer.insert(m_buffer.end(), other.m_buffer.begin(), other.m_buffer.end());
+        m_totalWeight += other.m_totalWeight;
+        privCompress();
+    }
+
+    // Merges buffered values to centroids. Calling this before (possibly concurrent) const queries avoids merging the buffer in every query.
+    void compress()
+    {
+        privCompress();
+    }
+
+    // Returns estimate of q-quantile, q in [0, 1]. Returns NaN if no values have been added.
+    // Like all const members, does not modify this: if there are buffered values, they are merged to a temporary centroid list.
+    double quantile(double q) const
+    {
+        if (m_totalWeight <= 0)
+            return std::numeric_limits<double>::quiet_NaN();
+        std::vector<CentroidT> tempCentroids;
+        const auto& centroids = privMergedCentroids(tempCentroids);
+        limit(q, 0.0, 1.0);
+        if (centroids.size() == 1)
+            return centroids[0].first;
+        // Interpolating linearly between points (0, min), (centre of centroid i, mean_i) and (totalWeight, max).
+        const double index = q * m_totalWeight;
+        double prevPos = 0;
+        double prevVal = m_minValue;
+        double cumWeight = 0;
+        for (const auto& c : centroids)
+        {
+            const double pos = cumWeight + c.second / 2;
+            if (index <= pos)
+                return privInterpolate(prevPos, prevVal, pos, c.first, index);
+            prevPos = pos;
+            prevVal = c.first;
+            cumWeight += c.second;
+        }
+        return privInterpolate(prevPos, prevVal, m_totalWeight, m_maxValue, index);
+    }
+
+    double median() const { return quantile(0.5); }
+
+    uint64 callCount() const    { return static_cast<uint64>(m_totalWeight); }
+    double minValue() const     { return (m_totalWeight > 0) ? m_minValue : std::numeric_limits<double>::quiet_NaN(); }
+    double maxValue() const     { return (m_totalWeight > 0) ? m_maxValue : std::numeric_limits<double>::quiet_NaN(); }
+    double compression() const  { return m_compression; }
+
+    // Returns the number of centroids after merging buffered values.
+    size_t centroidCount() const
+    {
+        std::vector<CentroidT> tempCentroids;
+        return privMergedCentroids(tempCentroids).size();
+    }
+
+    void clear()
+    {
+        *this = DFG_CLASS_NAME(MemFuncQuantileTDigest)(m_compression);
+    }
+
+    // Appends serialized representation to 'dest' (e.g. std::vector<char> or std::string).
+    template <class Cont_T>
+    void serialize(Cont_T& dest) const
+    {
+        std::vector<CentroidT> tempCentroids;
+        const auto& centroids = privMergedCentroids(tempCentroids);
+        DFG_DETAIL_NS::appendPodBytes(dest, DFG_DETAIL_NS::gnTDigestSerializationMagic);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_compression);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_totalWeight);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_minValue);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_maxValue);
+        DFG_DETAIL_NS::appendPodBytes(dest, static_cast<uint64>(centroids.size()));
+        for (const auto& c : centroids)
+        {
+            DFG_DETAIL_NS::appendPodBytes(dest, c.first);
+            DFG_DETAIL_NS::appendPodBytes(dest, c.second);
+        }
+    }
+
+    // Replaces content of this with serialized data created by serialize().
+    // Returns true if successful; if data is invalid, returns false and leaves this unmodified.
+    bool deserialize(const void* const pData, const size_t nSize)
+    {
+        const char* p = static_cast<const char*>(pData);
+        const char* const pEnd = p + nSize;
+        uint32 nMagic = 0;
+        uint64 nCentroidCount = 0;
+        DFG_CLASS_NAME(MemFuncQuantileTDigest) temp;
+        if (!DFG_DETAIL_NS::readPodBytes(p, pEnd, nMagic) || nMagic != DFG_DETAIL_NS::gnTDigestSerializationMagic
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_compression)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_totalWeight)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_minValue)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_maxValue)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, nCentroidCount)
+            || nCentroidCount > static_cast<uint64>(pEnd - p) / (2 * sizeof(double)))
+        {
+            return false;
+        }
+        temp.m_centroids.resize(static_cast<size_t>(nCentroidCount));
+        for (auto& c : temp.m_centroids)
+        {
+            DFG_DETAIL_NS::readPodBytes(p, pEnd, c.first);
+            DFG_DETAIL_NS::readPodBytes(p, pEnd, c.second);
+        }
+        *this = std::move(temp);
+        return true;
+    }
+
+private:
+    size_t bufferCapacity() const { return static_cast<size_t>(5 * m_compression); }
+
+    static double privInterpolate(const double x0, const double y0, const double x1, const double y1, const double x)
+    {
+        return (x1 > x0) ? y0 + (y1 - y0) * (x - x0) / (x1 - x0) : y1;
+    }
+
+    double scaleK(double q) const
+    {
+        limit(q, 0.0, 1.0);
+        return m_compression / (2 * privPi()) * std::asin(2 * q - 1);
+    }
+
+    double scaleKInverse(const double k) const
+    {
+        const double kMax = m_compression / 4;
+        if (k >= kMax)
+            return 1;
+        return (std::sin(k * 2 * privPi() / m_compression) + 1) / 2;
+    }
+
+    static double privPi() { return 3.14159265358979323846; }
+
+    // Merges buffered values and existing centroids to new centroid list.
+    void privCompress()
+    {
+        if (m_buffer.empty())
+            return;
+        m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+        privMergeItems(m_buffer, m_centroids);
+        m_buffer.clear();
+    }
+
+    // Returns centroids that include buffered values: m_centroids if there are no buffered values, otherwise rTemp to which the merge result is written.
+    // Result is identical to what m_centroids would be after privCompress().
+    const std::vector<CentroidT>& privMergedCentroids(std::vector<CentroidT>& rTemp) const
+    {
+        if (m_buffer.empty())
+            return m_centroids;
+        std::vector<CentroidT> items;
+        items.reserve(m_buffer.size() + m_centroids.size());
+        items.insert(items.end(), m_buffer.begin(), m_buffer.end());
+        items.insert(items.end(), m_centroids.begin(), m_centroids.end());
+        privMergeItems(items, rTemp);
+        return rTemp;
+    }
+
+    // Sorts non-empty 'items' (values and centroids) and merges them to rCentroids.
+    void privMergeItems(std::vector<CentroidT>& items, std::vector<CentroidT>& rCentroids) const
+    {
+        std::sort(items.begin(), items.end(), [](const CentroidT& a, const CentroidT& b) { return a.first < b.first; });
+        rCentroids.clear();
+        const double total = m_totalWeight;
+        double weightSoFar = 0;
+        CentroidT current = items.front();
+        double weightLimit = total * scaleKInverse(scaleK(0) + 1);
+        for (size_t i = 1, nCount = items.size(); i < nCount; ++i)
+        {
+            const auto& item = items[i];
+            if (weightSoFar + current.second + item.second <= weightLimit)
+            {
+                current.second += item.second;
+                current.first += (item.first - current.first) * item.second / current.second;
+            }
+            else
+            {
+                weightSoFar += current.second;
+                rCentroids.push_back(current);
+                weightLimit = total * scaleKInverse(scaleK(weightSoFar / total) + 1);
+                current = item;
+            }
+        }
+        rCentroids.push_back(current);
+    }
+
+    double m_compression;
+    double m_totalWeight;
+    double m_minValue;
+    double m_maxValue;
+    std::vector<CentroidT> m_centroids; // Sorted by mean.
+    std::vector<CentroidT> m_buffer;    // Unmerged values and centroids.
+}; // class MemFuncQuantileTDigest
+
+/* Functor that estimates quantiles of it's call parameters with KLL sketch.
+ * Values are kept in compactors (levels) where item on level h represents 2^h original values; when a level becomes full, it is sorted
+ * and every other item (random offset) is promoted to the next level. Level capacities decrease geometrically (factor 2/3) from the top level,
+ * so memory usage is O(k) items plus O(log(n / k)) levels.
+ * Accuracy: normalized rank error is roughly inversely proportional to k: with default k = 200 it is about 1.3 % for a single quantile query
+ * and about 1.65 % for all quantiles simultaneously with high probability (99%), i.e. about 2.6 / k and 3.3 / k,
+ * independent of the quantile and of the input distribution. Minimum and maximum are exact.
+ * Randomness comes from internal deterministic generator so that results are reproducible for given input order.
+ */
+template <class Data_T = double>
+class DFG_CLASS_NAME(MemFuncQuantileKll)
+{
+public:
+    DFG_CLASS_NAME(MemFuncQuantileKll)(const uint32 k = 200) :
+        m_nK(Max(uint32(8), k)),
+        m_nCount(0),
+        m_nItemCount(0),
+        m_nCapacity(0),
+        m_minValue(std::numeric_limits<double>::infinity()),
+        m_maxValue(-std::numeric_limits<double>::infinity()),
+        m_nRandomState(0x9E3779B97F4A7C15ull)
+    {
+        m_levels.resize(1);
+        m_nCapacity = privTotalCapacity();
+    }
+
+    void operator()(const Data_T& val)
+    {
+        const double d = static_cast<double>(val);
+        if (std::isnan(d))
+            return;
+        m_minValue = Min(m_minValue, d);
+        m_maxValue = Max(m_maxValue, d);
+        m_levels[0].push_back(d);
+        ++m_nCount;
+        ++m_nItemCount;
+        if (m_nItemCount >= m_nCapacity)
+            privCompress();
+    }
+
+    // Merges content of 'other' to this. Precondition: k of both sketches is the same (otherwise error bound of the result is not defined by k of this).
+    void merge(const DFG_CLASS_NAME(MemFuncQuantileKll)& other)
+    {
+        DFG_ASSERT_CORRECTNESS(m_nK == other.m_nK);
+        if (other.m_nCount == 0)
+            return;
+        m_minValue = Min(m_minValue, other.m_minValue);
+        m_maxValue = Max(m_maxValue, other.m_maxValue);
+        if (m_levels.size() < other.m_levels.size())
+            m_levels.resize(other.m_levels.size());
+        for (size_t h = 0; h < other.m_levels.size(); ++h)
+            m_levels[h].insert(m_levels[h].end(), other.m_levels[h].begin(), other.m_levels[h].end());
+        m_nCount += other.m_nCount;
+        m_nItemCount += other.m_nItemCount;
+        m_nCapacity = privTotalCapacity();
+        while (m_nItemCount >= m_nCapacity)
+            privCompress();
+    }
+
+    // Returns estimate of q-quantile, q in [0, 1], as the smallest retained value whose weighted rank is at least q * callCount().
+    // Returns NaN if no values have been added.
+    double quantile(double q) const
+    {
+        if (m_nCount == 0)
+            return std::numeric_limits<double>::quiet_NaN();
+        limit(q, 0.0, 1.0);
+        if (q <= 0)
+            return m_minValue;
+        if (q >= 1)
+            return m_maxValue;
+        std::vector<std::pair<double, uint64>> items;
+        items.reserve(static_cast<size_t>(m_nItemCount));
+        for (size_t h = 0; h < m_levels.size(); ++h)
+        {
+            for (const auto& v : m_levels[h])
+                items.push_back(std::make_pair(v, uint64(1) << h));
+        }
+        std::sort(items.begin(), items.end());
+        const double target = q * static_cast<double>(m_nCount);
+        uint64 nCumWeight = 0;
+        for (const auto& item : items)
+        {
+            nCumWeight += item.second;
+            if (static_cast<double>(nCumWeight) >= target)
+                return item.first;
+        }
+        return m_maxValue;
+    }
+
+    double median() const { return quantile(0.5); }
+
+    // Returns estimate of fraction of added values that are less or equal to 'val'.
+    double rank(const double val) const
+    {
+        if (m_nCount == 0)
+            return std::numeric_limits<double>::quiet_NaN();
+        uint64 nWeight = 0;
+        for (size_t h = 0; h < m_levels.size(); ++h)
+        {
+            for (const auto& v : m_levels[h])
+            {
+                if (v <= val)
+                    nWeight += uint64(1) << h;
+            }
+        }
+        return static_cast<double>(nWeight) / static_cast<double>(m_nCount);
+    }
+
+    uint64 callCount() const    { return m_nCount; }
+    double minValue() const     { return (m_nCount > 0) ? m_minValue : std::numeric_limits<double>::quiet_NaN(); }
+    double maxValue() const     { return (m_nCount > 0) ? m_maxValue : std::numeric_limits<double>::quiet_NaN(); }
+    uint32 k() const            { return m_nK; }
+    size_t retainedItemCount() const { return static_cast<size_t>(m_nItemCount); }
+
+    void clear()
+    {
+        *this = DFG_CLASS_NAME(MemFuncQuantileKll)(m_nK);
+    }
+
+    // Appends serialized representation to 'dest' (e.g. std::vector<char> or std::string).
+    template <class Cont_T>
+    void serialize(Cont_T& dest) const
+    {
+        DFG_DETAIL_NS::appendPodBytes(dest, DFG_DETAIL_NS::gnKllSerializationMagic);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_nK);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_nCount);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_minValue);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_maxValue);
+        DFG_DETAIL_NS::appendPodBytes(dest, m_nRandomState);
+        DFG_DETAIL_NS::appendPodBytes(dest, static_cast<uint32>(m_levels.size()));
+        for (const auto& level : m_levels)
+        {
+            DFG_DETAIL_NS::appendPodBytes(dest, static_cast<uint64>(level.size()));
+            for (const auto& v : level)
+                DFG_DETAIL_NS::appendPodBytes(dest, v);
+        }
+    }
+
+    // Replaces content of this with serialized data created by serialize().
+    // Returns true if successful; if data is invalid, returns false and leaves this unmodified.
+    bool deserialize(const void* const pData, const size_t nSize)
+    {
+        const char* p = static_cast<const char*>(pData);
+        const char* const pEnd = p + nSize;
+        uint32 nMagic = 0;
+        uint32 nLevelCount = 0;
+        DFG_CLASS_NAME(MemFuncQuantileKll) temp;
+        if (!DFG_DETAIL_NS::readPodBytes(p, pEnd, nMagic) || nMagic != DFG_DETAIL_NS::gnKllSerializationMagic
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_nK)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_nCount)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_minValue)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_maxValue)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, temp.m_nRandomState)
+            || !DFG_DETAIL_NS::readPodBytes(p, pEnd, nLevelCount)
+            || nLevelCount == 0 || nLevelCount > 64)
+        {
+            return false;
+        }
+        temp.m_levels.resize(nLevelCount);
+        temp.m_nItemCount = 0;
+        for (auto& level : temp.m_levels)
+        {
+            uint64 nLevelSize = 0;
+            if (!DFG_DETAIL_NS::readPodBytes(p, pEnd, nLevelSize) || nLevelSize > static_cast<uint64>(pEnd - p) / sizeof(double))
+                return false;
+            level.resize(static_cast<size_t>(nLevelSize));
+            for (auto& v : level)
+                DFG_DETAIL_NS::readPodBytes(p, pEnd, v);
+            temp.m_nItemCount += nLevelSize;
+        }
+        temp.m_nCapacity = temp.privTotalCapacity();
+        *this = std::move(temp);
+        return true;
+    }
+
+private:
+    size_t privLevelCapacity(const size_t h) const
+    {
+        const size_t nDepth = m_levels.size() - 1 - h;
+        return Max(size_t(2), static_cast<size_t>(std::ceil(m_nK * std::pow(2.0 / 3.0, static_cast<double>(nDepth)))));
+    }
+
+    uint64 privTotalCapacity() const
+    {
+        uint64 nCapacity = 0;
+        for (size_t h = 0; h < m_levels.size(); ++h)
+            nCapacity += privLevelCapacity(h);
+        return nCapacity;
+    }
+
+    bool privRandomBit()
+    {
+        // splitmix64
+        uint64 z = (m_nRandomState += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return ((z ^ (z >> 31)) & 1) != 0;
+    }
+
+    // Compacts the lowest level that is at or over its capacity.
+    void privCompress()
+    {
+        for (size_t h = 0; h < m_levels.size(); ++h)
+        {
+            if (m_levels[h].size() < privLevelCapacity(h))
+                continue;
+            if (h + 1 == m_levels.size())
+                m_levels.resize(m_levels.size() + 1);
+            auto& level = m_levels[h];
+            auto& nextLevel = m_levels[h + 1];
+            std::sort(level.begin(), level.end());
+            // With odd size the smallest item stays on this level; the rest are compacted pairwise.
+            const size_t nKept = level.size() % 2;
+            const size_t nOffset = privRandomBit() ? 1 : 0;
+            for (size_t i = nKept + nOffset; i < level.size(); i += 2)
+                nextLevel.push_back(level[i]);
+            m_nItemCount -= (level.size() - nKept) / 2;
+            level.resize(nKept);
+            m_nCapacity = privTotalCapacity();
+            return;
+        }
+        m_nCapacity = privTotalCapacity();
+    }
+
+    uint32 m_nK;
+    uint64 m_nCount;     // Number of added values.
+    uint64 m_nItemCount; // Number of retained items.
+    uint64 m_nCapacity;  // Total capacity of all levels; compression is triggered when m_nItemCount reaches this.
+    double m_minValue;
+    double m_maxValue;
+    uint64 m_nRandomState;
+    std::vector<std::vector<double>> m_levels;
+}; // class MemFuncQuantileKll
+
+}} // module func
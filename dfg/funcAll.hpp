@@ -3,3 +3,4 @@
 #include "func.hpp"
 #include "func/memFunc.hpp"
 #include "func/memFuncMedian.hpp"
+#include "func/memFuncQuantile.hpp"
@@ -3,6 +3,9 @@
 #include "dfgBase.hpp"
 #include "str/hex.hpp"
 #include "str/stringFixedCapacity.hpp"
+#include "hash/xxHash64.hpp"
+#include "hash/sha256.hpp"
+#include "hash/fileHash.hpp"
 
 #if defined(_WIN32)
     #include <Windows.h>
@@ -18,7 +21,7 @@ enum HashType {HashTypeMd5 = CALG_MD5, HashTypeSha1 = CALG_SHA1};
 
 //===================================================================
 // Class: HashCreator
-// Description: Creates hashes of bytes(MD5, SHA1)
+// Description: Creates hashes of bytes(MD5, SHA1) using Windows CryptoAPI. For portable hashing, see Xxh64Hasher and Sha256Hasher.
 // Example: HashCreator() hc;
 //			hc.Process(buffer, nbSize);
 //			hc.ToStr<TCHAR>()
@@ -0,0 +1,218 @@
+#pragma once
+
+/*
+fileHash.hpp
+
+Hashing of large memory blocks and files with any hasher that has the interface of Xxh64Hasher/Sha256Hasher
+(default constructor, process(pData, nSize), digestBytes()).
+    -hashFile(): streams file content to hasher; file is memory mapped when possible and read in large blocks otherwise.
+    -treeHash()/treeHashFile(): splits data into fixed size leaves that are hashed in parallel and combines leaf digests to a root digest.
+     Result depends only on content and leaf size, not on thread count, but differs from the plain hash of the same content.
+    -TreeHasher: computes the same tree hash incrementally from sequentially given data (serially, without keeping data in memory).
+
+Example use case is change detection before reloading a large file: compare stored digest with treeHashFile() of the current file.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../ReadOnlySzParam.hpp"
+#include "../io/BasicIfStream.hpp"
+#include "../io/IfmmStream.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <cstdio>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(hash) {
+
+const size_t gnDefaultTreeHashLeafSize = size_t(1) << 22; // 4 MiB
+
+namespace DFG_DETAIL_NS
+{
+    const size_t gnFileHashReadBlockSize = size_t(1) << 20;
+
+    inline void appendUint64Le(std::vector<uint8>& bytes, const uint64 n)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            bytes.push_back(static_cast<uint8>(n >> (8 * i)));
+    }
+
+    // Calls func(pData, nSize, bWholeContent) for file content: whole content at once if file can be memory mapped, in blocks otherwise.
+    // Return: false if file couldn't be read. Exceptions from func are not caught.
+    template <class Char_T, class Func_T>
+    bool forFileContent(const DFG_CLASS_NAME(ReadOnlySzParam)<Char_T>& sPath, Func_T&& func)
+    {
+        {
+            DFG_MODULE_NS(io)::DFG_CLASS_NAME(FileMemoryMapped) mappedFile;
+            try
+            {
+                mappedFile.open(sPath);
+            }
+            catch (...) // Mapping fails e.g. for empty files; falling back to reading.
+            {}
+            if (mappedFile.is_open())
+            {
+                func(mappedFile.data(), mappedFile.size(), true);
+                return true;
+            }
+        }
+        DFG_MODULE_NS(io)::DFG_CLASS_NAME(BasicIfStream) istrm(sPath);
+        if (!istrm.good())
+            return false;
+        std::vector<char> buffer(gnFileHashReadBlockSize);
+        for (;;)
+        {
+            const auto nRead = istrm.readBytes(buffer.data(), buffer.size());
+            if (nRead > 0)
+                func(buffer.data(), nRead, false);
+            if (nRead < buffer.size())
+                break;
+        }
+        // Short read is either end of file or read error; the latter must not be reported as successfully read content.
+        return std::ferror(istrm.m_pFile) == 0;
+    }
+
+    template <class Hasher_T>
+    typename Hasher_T::DigestBytes treeHashRoot(const uint64 nSize, const size_t nLeafSize, const std::vector<typename Hasher_T::DigestBytes>& leafDigests)
+    {
+        std::vector<uint8> header;
+        appendUint64Le(header, nSize);
+        appendUint64Le(header, nLeafSize);
+        Hasher_T rootHasher;
+        rootHasher.process(header.data(), header.size());
+        for (const auto& digest : leafDigests)
+            rootHasher.process(digest.data(), digest.size());
+        return rootHasher.digestBytes();
+    }
+} // namespace DFG_DETAIL_NS
+
+// Returns tree hash of [pData, pData + nSize[: root = H(size as uint64le || leaf size as uint64le || H(leaf_0) || H(leaf_1) || ...).
+// Leaves are hashed in thread::defaultThreadPool(); nMaxThreadCount limits the number of concurrently hashed leaves (0 = no limit).
+template <class Hasher_T>
+typename Hasher_T::DigestBytes treeHash(const void* pData, const size_t nSize, size_t nLeafSize = gnDefaultTreeHashLeafSize, const size_t nMaxThreadCount = 0)
+{
+    nLeafSize = Max(size_t(1), nLeafSize);
+    const size_t nLeafCount = (nSize + nLeafSize - 1) / nLeafSize;
+    std::vector<typename Hasher_T::DigestBytes> leafDigests(nLeafCount);
+    const uint8* const p = static_cast<const uint8*>(pData);
+    // Leaves are divided into nPieceCount contiguous pieces that are run as separate tasks.
+    const size_t nPieceCount = (nMaxThreadCount == 0) ? nLeafCount : Min(nMaxThreadCount, nLeafCount);
+    DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nPieceCount, 1, [&](const size_t iPieceBegin, const size_t iPieceEnd)
+    {
+        const size_t nLeafEnd = iPieceEnd * nLeafCount / nPieceCount;
+        for (size_t nLeaf = iPieceBegin * nLeafCount / nPieceCount; nLeaf < nLeafEnd; ++nLeaf)
+        {
+            const size_t iBegin = nLeaf * nLeafSize;
+            Hasher_T hasher;
+            hasher.process(p + iBegin, Min(nSize, iBegin + nLeafSize) - iBegin);
+            leafDigests[nLeaf] = hasher.digestBytes();
+        }
+    });
+    return DFG_DETAIL_NS::treeHashRoot<Hasher_T>(nSize, nLeafSize, leafDigests);
+}
+
+// Computes treeHash() incrementally: data can be given in arbitrary sized pieces with process(), only one leaf hasher and leaf digests are kept in memory.
+// digestBytes() returns the same as treeHash() would for the concatenation of all processed data.
+template <class Hasher_T>
+class DFG_CLASS_NAME(TreeHasher)
+{
+public:
+    typedef typename Hasher_T::DigestBytes DigestBytes;
+
+    DFG_CLASS_NAME(TreeHasher)(const size_t nLeafSize = gnDefaultTreeHashLeafSize) :
+        m_nLeafSize(Max(size_t(1), nLeafSize)),
+        m_nLeafFill(0),
+        m_nTotalSize(0)
+    {}
+
+    void process(const void* pData, size_t nSize)
+    {
+        const uint8* p = static_cast<const uint8*>(pData);
+        m_nTotalSize += nSize;
+        while (nSize > 0)
+        {
+            const size_t nTake = Min(nSize, m_nLeafSize - m_nLeafFill);
+            m_leafHasher.process(p, nTake);
+            p += nTake;
+            nSize -= nTake;
+            m_nLeafFill += nTake;
+            if (m_nLeafFill == m_nLeafSize)
+                finishLeaf();
+        }
+    }
+
+    // Returns digest of data processed so far.
+    DigestBytes digestBytes() const
+    {
+        if (m_nLeafFill == 0)
+            return DFG_DETAIL_NS::treeHashRoot<Hasher_T>(m_nTotalSize, m_nLeafSize, m_leafDigests);
+        auto leafDigests = m_leafDigests;
+        leafDigests.push_back(m_leafHasher.digestBytes());
+        return DFG_DETAIL_NS::treeHashRoot<Hasher_T>(m_nTotalSize, m_nLeafSize, leafDigests);
+    }
+
+private:
+    void finishLeaf()
+    {
+        m_leafDigests.push_back(m_leafHasher.digestBytes());
+        m_leafHasher = Hasher_T();
+        m_nLeafFill = 0;
+    }
+
+    size_t m_nLeafSize;
+    size_t m_nLeafFill;
+    uint64 m_nTotalSize;
+    Hasher_T m_leafHasher;
+    std::vector<DigestBytes> m_leafDigests;
+};
+
+// Processes content of file at sPath with rHasher. Return: false if file couldn't be read.
+template <class Hasher_T>
+bool hashFile(const DFG_CLASS_NAME(ReadOnlySzParamC)& sPath, Hasher_T& rHasher)
+{
+    return DFG_DETAIL_NS::forFileContent(sPath, [&](const char* p, const size_t n, bool) { rHasher.process(p, n); });
+}
+
+template <class Hasher_T>
+bool hashFile(const DFG_CLASS_NAME(ReadOnlySzParamW)& sPath, Hasher_T& rHasher)
+{
+    return DFG_DETAIL_NS::forFileContent(sPath, [&](const char* p, const size_t n, bool) { rHasher.process(p, n); });
+}
+
+namespace DFG_DETAIL_NS
+{
+    template <class Hasher_T, class Char_T>
+    bool treeHashFileImpl(const DFG_CLASS_NAME(ReadOnlySzParam)<Char_T>& sPath, typename Hasher_T::DigestBytes& rDigest, const size_t nLeafSize, const size_t nMaxThreadCount)
+    {
+        DFG_CLASS_NAME(TreeHasher)<Hasher_T> streamHasher(nLeafSize); // Used only if file can't be mapped.
+        bool bMapped = false;
+        const bool bOk = forFileContent(sPath, [&](const char* p, const size_t n, const bool bWholeContent)
+        {
+            if (bWholeContent)
+            {
+                rDigest = treeHash<Hasher_T>(p, n, nLeafSize, nMaxThreadCount);
+                bMapped = true;
+            }
+            else
+                streamHasher.process(p, n);
+        });
+        if (bOk && !bMapped)
+            rDigest = streamHasher.digestBytes();
+        return bOk;
+    }
+} // namespace DFG_DETAIL_NS
+
+// Computes treeHash() of file content. Return: false if file couldn't be read, in which case rDigest is not modified.
+template <class Hasher_T>
+bool treeHashFile(const DFG_CLASS_NAME(ReadOnlySzParamC)& sPath, typename Hasher_T::DigestBytes& rDigest, const size_t nLeafSize = gnDefaultTreeHashLeafSize, const size_t nMaxThreadCount = 0)
+{
+    return DFG_DETAIL_NS::treeHashFileImpl<Hasher_T>(sPath, rDigest, nLeafSize, nMaxThreadCount);
+}
+
+template <class Hasher_T>
+bool treeHashFile(const DFG_CLASS_NAME(ReadOnlySzParamW)& sPath, typename Hasher_T::DigestBytes& rDigest, const size_t nLeafSize = gnDefaultTreeHashLeafSize, const size_t nMaxThreadCount = 0)
+{
+    return DFG_DETAIL_NS::treeHashFileImpl<Hasher_T>(sPath, rDigest, nLeafSize, nMaxThreadCount);
+}
+
+}} // module hash
@@ -0,0 +1,168 @@
+#pragma once
+
+/*
+sha256.hpp
+
+Portable streaming SHA-256 (FIPS 180-4) for file integrity checks and other uses where cryptographic strength is needed.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../str/hex.hpp"
+#include <array>
+#include <cstring>
+#include <string>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(hash) {
+
+namespace DFG_DETAIL_NS
+{
+    inline uint32 rotr32(const uint32 x, const int r)
+    {
+        return (x >> r) | (x << (32 - r));
+    }
+
+    inline uint32 readUint32Be(const uint8* p)
+    {
+        return (static_cast<uint32>(p[0]) << 24) | (static_cast<uint32>(p[1]) << 16) | (static_cast<uint32>(p[2]) << 8) | static_cast<uint32>(p[3]);
+    }
+
+    const uint32 gSha256RoundConstants[64] =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+} // namespace DFG_DETAIL_NS
+
+// Streaming SHA-256 hasher.
+class DFG_CLASS_NAME(Sha256Hasher)
+{
+public:
+    typedef std::array<uint8, 32> DigestBytes;
+    static const size_t s_nDigestSize = 32;
+
+    DFG_CLASS_NAME(Sha256Hasher)()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        static const uint32 initialState[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+        std::memcpy(m_state, initialState, sizeof(m_state));
+        m_nTotalLength = 0;
+        m_nBufferSize = 0;
+    }
+
+    DFG_CLASS_NAME(Sha256Hasher)& process(const void* pData, size_t nSize)
+    {
+        const uint8* p = static_cast<const uint8*>(pData);
+        m_nTotalLength += nSize;
+        if (m_nBufferSize > 0)
+        {
+            const size_t nFill = Min(sizeof(m_buffer) - m_nBufferSize, nSize);
+            std::memcpy(m_buffer + m_nBufferSize, p, nFill);
+            m_nBufferSize += nFill;
+            p += nFill;
+            nSize -= nFill;
+            if (m_nBufferSize < sizeof(m_buffer))
+                return *this;
+            processBlocks(m_buffer, 1);
+            m_nBufferSize = 0;
+        }
+        const size_t nBlocks = nSize / 64;
+        processBlocks(p, nBlocks);
+        p += 64 * nBlocks;
+        nSize -= 64 * nBlocks;
+        if (nSize > 0)
+            std::memcpy(m_buffer, p, nSize);
+        m_nBufferSize = nSize;
+        return *this;
+    }
+
+    // Returns digest of data processed so far; doesn't modify state so processing may continue after this call.
+    DigestBytes digestBytes() const
+    {
+        DFG_CLASS_NAME(Sha256Hasher) temp(*this);
+        const uint64 nBitLength = m_nTotalLength * 8;
+        uint8 padding[72] = { 0x80 };
+        const size_t nPadLength = (m_nBufferSize < 56) ? 56 - m_nBufferSize : 120 - m_nBufferSize;
+        for (size_t i = 0; i < 8; ++i)
+            padding[nPadLength + i] = static_cast<uint8>(nBitLength >> (56 - 8 * i));
+        temp.process(padding, nPadLength + 8);
+        DigestBytes digest;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            digest[4 * i]     = static_cast<uint8>(temp.m_state[i] >> 24);
+            digest[4 * i + 1] = static_cast<uint8>(temp.m_state[i] >> 16);
+            digest[4 * i + 2] = static_cast<uint8>(temp.m_state[i] >> 8);
+            digest[4 * i + 3] = static_cast<uint8>(temp.m_state[i]);
+        }
+        return digest;
+    }
+
+    // Returns digest as upper case hex string (as given by str::bytesToHexStr()).
+    std::string toStr() const
+    {
+        const auto digest = digestBytes();
+        return DFG_MODULE_NS(str)::bytesToHexStr(digest.data(), digest.size());
+    }
+
+private:
+    void processBlocks(const uint8* p, const size_t nBlockCount)
+    {
+        using namespace DFG_DETAIL_NS;
+        for (size_t nBlock = 0; nBlock < nBlockCount; ++nBlock, p += 64)
+        {
+            uint32 w[64];
+            for (size_t i = 0; i < 16; ++i)
+                w[i] = readUint32Be(p + 4 * i);
+            for (size_t i = 16; i < 64; ++i)
+            {
+                const uint32 s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const uint32 s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32 a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+            for (size_t i = 0; i < 64; ++i)
+            {
+                const uint32 S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+                const uint32 ch = (e & f) ^ (~e & g);
+                const uint32 temp1 = h + S1 + ch + gSha256RoundConstants[i] + w[i];
+                const uint32 S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+                const uint32 maj = (a & b) ^ (a & c) ^ (b & c);
+                const uint32 temp2 = S0 + maj;
+                h = g;
+                g = f;
+                f = e;
+                e = d + temp1;
+                d = c;
+                c = b;
+                b = a;
+                a = temp1 + temp2;
+            }
+            m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
+            m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+        }
+    }
+
+    uint32 m_state[8];
+    uint64 m_nTotalLength;
+    uint8 m_buffer[64];
+    size_t m_nBufferSize;
+}; // class Sha256Hasher
+
+// Returns SHA-256 digest of given bytes as upper case hex string.
+inline std::string sha256Str(const void* pData, const size_t nSize)
+{
+    return DFG_CLASS_NAME(Sha256Hasher)().process(pData, nSize).toStr();
+}
+
+}} // module hash
@@ -0,0 +1,205 @@
+#pragma once
+
+/*
+xxHash64.hpp
+
+Portable implementation of XXH64 (https://github.com/Cyan4973/xxHash), a fast non-cryptographic 64-bit hash.
+Suitable e.g. for hash tables, deduplication, interning keys and change detection; not suitable where collisions may be crafted by an adversary.
+Output is identical to the reference implementation and doesn't depend on platform endianness.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../str/hex.hpp"
+#include <array>
+#include <cstring>
+#include <string>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(hash) {
+
+namespace DFG_DETAIL_NS
+{
+    inline uint64 readUint64Le(const uint8* p)
+    {
+        return  static_cast<uint64>(p[0])        | (static_cast<uint64>(p[1]) << 8)  | (static_cast<uint64>(p[2]) << 16) | (static_cast<uint64>(p[3]) << 24) |
+               (static_cast<uint64>(p[4]) << 32) | (static_cast<uint64>(p[5]) << 40) | (static_cast<uint64>(p[6]) << 48) | (static_cast<uint64>(p[7]) << 56);
+    }
+
+    inline uint32 readUint32Le(const uint8* p)
+    {
+        return static_cast<uint32>(p[0]) | (static_cast<uint32>(p[1]) << 8) | (static_cast<uint32>(p[2]) << 16) | (static_cast<uint32>(p[3]) << 24);
+    }
+
+    inline uint64 rotl64(const uint64 x, const int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    const uint64 gXxh64Prime1 = 11400714785074694791ULL;
+    const uint64 gXxh64Prime2 = 14029467366897019727ULL;
+    const uint64 gXxh64Prime3 = 1609587929392839161ULL;
+    const uint64 gXxh64Prime4 = 9650029242287828579ULL;
+    const uint64 gXxh64Prime5 = 2870177450012600261ULL;
+
+    inline uint64 xxh64Round(uint64 acc, const uint64 nInput)
+    {
+        acc += nInput * gXxh64Prime2;
+        acc = rotl64(acc, 31);
+        return acc * gXxh64Prime1;
+    }
+
+    inline uint64 xxh64MergeRound(uint64 acc, const uint64 nVal)
+    {
+        acc ^= xxh64Round(0, nVal);
+        return acc * gXxh64Prime1 + gXxh64Prime4;
+    }
+
+    // Processes the remaining (< 32) bytes and applies final avalanche.
+    inline uint64 xxh64Finalize(uint64 h, const uint8* p, size_t nLength)
+    {
+        for (; nLength >= 8; nLength -= 8, p += 8)
+        {
+            h ^= xxh64Round(0, readUint64Le(p));
+            h = rotl64(h, 27) * gXxh64Prime1 + gXxh64Prime4;
+        }
+        if (nLength >= 4)
+        {
+            h ^= static_cast<uint64>(readUint32Le(p)) * gXxh64Prime1;
+            h = rotl64(h, 23) * gXxh64Prime2 + gXxh64Prime3;
+            p += 4;
+            nLength -= 4;
+        }
+        for (; nLength > 0; --nLength, ++p)
+        {
+            h ^= (*p) * gXxh64Prime5;
+            h = rotl64(h, 11) * gXxh64Prime1;
+        }
+        h ^= h >> 33;
+        h *= gXxh64Prime2;
+        h ^= h >> 29;
+        h *= gXxh64Prime3;
+        h ^= h >> 32;
+        return h;
+    }
+} // namespace DFG_DETAIL_NS
+
+// Streaming XXH64 hasher. Feeding data in pieces gives the same result as hashing it at once.
+class DFG_CLASS_NAME(Xxh64Hasher)
+{
+public:
+    typedef uint64 HashValue;
+    typedef std::array<uint8, 8> DigestBytes;
+    static const size_t s_nDigestSize = 8;
+
+    DFG_CLASS_NAME(Xxh64Hasher)(const uint64 nSeed = 0)
+    {
+        reset(nSeed);
+    }
+
+    void reset(const uint64 nSeed = 0)
+    {
+        using namespace DFG_DETAIL_NS;
+        m_nSeed = nSeed;
+        m_acc[0] = nSeed + gXxh64Prime1 + gXxh64Prime2;
+        m_acc[1] = nSeed + gXxh64Prime2;
+        m_acc[2] = nSeed;
+        m_acc[3] = nSeed - gXxh64Prime1;
+        m_nTotalLength = 0;
+        m_nBufferSize = 0;
+    }
+
+    DFG_CLASS_NAME(Xxh64Hasher)& process(const void* pData, size_t nSize)
+    {
+        const uint8* p = static_cast<const uint8*>(pData);
+        m_nTotalLength += nSize;
+        if (m_nBufferSize + nSize < sizeof(m_buffer))
+        {
+            if (nSize > 0)
+                std::memcpy(m_buffer + m_nBufferSize, p, nSize);
+            m_nBufferSize += nSize;
+            return *this;
+        }
+        if (m_nBufferSize > 0)
+        {
+            const size_t nFill = sizeof(m_buffer) - m_nBufferSize;
+            std::memcpy(m_buffer + m_nBufferSize, p, nFill);
+            processStripes(m_buffer, 1);
+            p += nFill;
+            nSize -= nFill;
+            m_nBufferSize = 0;
+        }
+        const size_t nStripes = nSize / 32;
+        processStripes(p, nStripes);
+        p += 32 * nStripes;
+        nSize -= 32 * nStripes;
+        if (nSize > 0)
+            std::memcpy(m_buffer, p, nSize);
+        m_nBufferSize = nSize;
+        return *this;
+    }
+
+    // Returns hash of data processed so far; doesn't modify state so processing may continue after this call.
+    HashValue hashValue() const
+    {
+        using namespace DFG_DETAIL_NS;
+        uint64 h;
+        if (m_nTotalLength >= 32)
+        {
+            h = rotl64(m_acc[0], 1) + rotl64(m_acc[1], 7) + rotl64(m_acc[2], 12) + rotl64(m_acc[3], 18);
+            for (size_t i = 0; i < 4; ++i)
+                h = xxh64MergeRound(h, m_acc[i]);
+        }
+        else
+            h = m_nSeed + gXxh64Prime5;
+        h += m_nTotalLength;
+        return xxh64Finalize(h, m_buffer, m_nBufferSize);
+    }
+
+    // Returns hash in canonical (big endian) byte representation.
+    DigestBytes digestBytes() const
+    {
+        const auto h = hashValue();
+        DigestBytes bytes;
+        for (size_t i = 0; i < 8; ++i)
+            bytes[i] = static_cast<uint8>(h >> (56 - 8 * i));
+        return bytes;
+    }
+
+    // Returns hash as upper case hex string (as given by str::bytesToHexStr()).
+    std::string toStr() const
+    {
+        const auto bytes = digestBytes();
+        return DFG_MODULE_NS(str)::bytesToHexStr(bytes.data(), bytes.size());
+    }
+
+private:
+    void processStripes(const uint8* p, const size_t nStripeCount)
+    {
+        using namespace DFG_DETAIL_NS;
+        // Local copies allow the four independent lanes to stay in registers.
+        uint64 v0 = m_acc[0], v1 = m_acc[1], v2 = m_acc[2], v3 = m_acc[3];
+        for (size_t i = 0; i < nStripeCount; ++i, p += 32)
+        {
+            v0 = xxh64Round(v0, readUint64Le(p));
+            v1 = xxh64Round(v1, readUint64Le(p + 8));
+            v2 = xxh64Round(v2, readUint64Le(p + 16));
+            v3 = xxh64Round(v3, readUint64Le(p + 24));
+        }
+        m_acc[0] = v0; m_acc[1] = v1; m_acc[2] = v2; m_acc[3] = v3;
+    }
+
+    uint64 m_nSeed;
+    uint64 m_acc[4];
+    uint64 m_nTotalLength;
+    uint8 m_buffer[32];
+    size_t m_nBufferSize;
+}; // class Xxh64Hasher
+
+// Returns XXH64 hash of given bytes.
+inline uint64 xxHash64(const void* pData, const size_t nSize, const uint64 nSeed = 0)
+{
+    return DFG_CLASS_NAME(Xxh64Hasher)(nSeed).process(pData, nSize).hashValue();
+}
+
+}} // module hash
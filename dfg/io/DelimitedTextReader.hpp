@@ -16,6 +16,7 @@
 #include "../cont/vectorSso.hpp"
 #include "../build/inlineTools.hpp"
 #include "../preprocessor/compilerInfoMsvc.hpp"
+#include "../time/profiling.hpp"
 
 #include <iterator>
 
@@ -1344,6 +1345,7 @@ public:
     template <class CellReader_T, class CellHandler_T>
     static DFG_DELIMITED_TEXT_READER_INLINING void read(CellReader_T& reader, CellHandler_T&& cellHandler)
     {
+        DFG_PROFILE_ZONE("DelimitedTextReader::read");
         CellReader_T::CellParsingImplementations::read(reader, std::forward<CellHandler_T>(cellHandler));
     }
 
@@ -0,0 +1,245 @@
+#pragma once
+
+/*
+FileRangeCopyWriter.hpp
+
+Output file writer that, in addition to writing bytes, can copy byte ranges from a source file.
+On Linux copying is done in kernel with copy_file_range() (if available) or sendfile() so that copied bytes are not transferred through user space;
+elsewhere and as fallback, copying uses read/write with large blocks.
+
+Example use case is rewriting a large file where only small parts have changed: unchanged ranges are copied and only changed parts written.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../ReadOnlySzParam.hpp"
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/sendfile.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+    #define DFG_FILE_RANGE_COPY_WRITER_USE_FD 1
+    #if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+        #define DFG_FILE_RANGE_COPY_WRITER_HAS_COPY_FILE_RANGE 1
+    #else
+        #define DFG_FILE_RANGE_COPY_WRITER_HAS_COPY_FILE_RANGE 0
+    #endif
+#else
+    #include <fstream>
+    #define DFG_FILE_RANGE_COPY_WRITER_USE_FD 0
+    #define DFG_FILE_RANGE_COPY_WRITER_HAS_COPY_FILE_RANGE 0
+#endif
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(io) {
+
+    class DFG_CLASS_NAME(FileRangeCopyWriter)
+    {
+    public:
+        static const size_t s_nWriteBufferSize = size_t(1) << 20;
+
+        // Opens sSourcePath for reading and creates (or truncates) sOutputPath for writing. Use isOpen() to check success.
+        // Note: source and output must not be the same file.
+        DFG_CLASS_NAME(FileRangeCopyWriter)(const DFG_CLASS_NAME(ReadOnlySzParamC)& sSourcePath, const DFG_CLASS_NAME(ReadOnlySzParamC)& sOutputPath) :
+            m_bGood(false)
+        {
+#if DFG_FILE_RANGE_COPY_WRITER_USE_FD
+            m_fdSource = ::open(sSourcePath.c_str(), O_RDONLY);
+            m_fdOutput = (m_fdSource != -1) ? ::open(sOutputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666) : -1;
+            m_bGood = (m_fdSource != -1 && m_fdOutput != -1);
+#else
+            m_source.open(sSourcePath.c_str(), std::ios::binary);
+            if (m_source.is_open())
+                m_output.open(sOutputPath.c_str(), std::ios::binary | std::ios::trunc);
+            m_bGood = m_source.is_open() && m_output.is_open();
+#endif
+            if (m_bGood)
+                m_writeBuffer.reserve(s_nWriteBufferSize);
+        }
+
+        ~DFG_CLASS_NAME(FileRangeCopyWriter)()
+        {
+            close();
+        }
+
+        bool isOpen() const
+        {
+#if DFG_FILE_RANGE_COPY_WRITER_USE_FD
+            return m_fdOutput != -1;
+#else
+            return m_output.is_open();
+#endif
+        }
+
+        // Returns false if any operation has failed.
+        bool good() const { return m_bGood; }
+
+        // Writes bytes to output. Writes are buffered.
+        bool write(const char* p, const size_t nSize)
+        {
+            if (!m_bGood)
+                return false;
+            if (m_writeBuffer.size() + nSize > s_nWriteBufferSize)
+            {
+                flushWriteBuffer();
+                if (nSize >= s_nWriteBufferSize)
+                    return writeToOutput(p, nSize);
+            }
+            m_writeBuffer.append(p, nSize);
+            return m_bGood;
+        }
+
+        bool write(const std::string& s)
+        {
+            return write(s.data(), s.size());
+        }
+
+        // Appends source bytes [nOffset, nOffset + nCount[ to output.
+        bool copyFromSource(uint64 nOffset, uint64 nCount)
+        {
+            if (!m_bGood || !flushWriteBuffer())
+                return false;
+#if DFG_FILE_RANGE_COPY_WRITER_USE_FD
+            // Methods are tried in order copy_file_range() -> sendfile() -> pread()/write(); a method that fails once is not tried again.
+            while (nCount > 0 && m_bGood)
+            {
+                const size_t nRequest = static_cast<size_t>(Min(nCount, uint64(1) << 30));
+                ssize_t nCopied = -1;
+    #if DFG_FILE_RANGE_COPY_WRITER_HAS_COPY_FILE_RANGE
+                if (m_bTryCopyFileRange)
+                {
+                    loff_t offsetIn = static_cast<loff_t>(nOffset);
+                    nCopied = ::copy_file_range(m_fdSource, &offsetIn, m_fdOutput, nullptr, nRequest, 0);
+                    if (nCopied < 0 && errno == EINTR)
+                        continue;
+                    m_bTryCopyFileRange = (nCopied > 0);
+                }
+    #endif
+                if (nCopied <= 0 && m_bTrySendfile)
+                {
+                    off_t offsetIn = static_cast<off_t>(nOffset);
+                    nCopied = ::sendfile(m_fdOutput, m_fdSource, &offsetIn, nRequest);
+                    if (nCopied < 0 && errno == EINTR)
+                        continue;
+                    m_bTrySendfile = (nCopied > 0);
+                }
+                if (nCopied <= 0)
+                    nCopied = copyWithReadWrite(nOffset, nRequest);
+                if (nCopied <= 0) // Error or unexpected end of source.
+                {
+                    m_bGood = false;
+                    break;
+                }
+                nOffset += static_cast<uint64>(nCopied);
+                nCount -= static_cast<uint64>(nCopied);
+            }
+#else
+            std::vector<char> buffer(static_cast<size_t>(Min(nCount, uint64(s_nWriteBufferSize))));
+            m_source.seekg(static_cast<std::streamoff>(nOffset));
+            while (nCount > 0 && m_bGood)
+            {
+                const auto nRequest = static_cast<size_t>(Min(nCount, uint64(buffer.size())));
+                m_source.read(buffer.data(), static_cast<std::streamsize>(nRequest));
+                const auto nRead = static_cast<size_t>(m_source.gcount());
+                if (nRead == 0 || !writeToOutput(buffer.data(), nRead))
+                    m_bGood = false;
+                nCount -= nRead;
+            }
+            m_source.clear();
+#endif
+            return m_bGood;
+        }
+
+        // Flushes pending writes and closes files. Return: good() after closing.
+        bool close()
+        {
+            if (!isOpen())
+                return m_bGood;
+            flushWriteBuffer();
+#if DFG_FILE_RANGE_COPY_WRITER_USE_FD
+            if (::close(m_fdOutput) != 0)
+                m_bGood = false;
+            m_fdOutput = -1;
+            if (m_fdSource != -1)
+                ::close(m_fdSource);
+            m_fdSource = -1;
+#else
+            m_output.close();
+            if (m_output.fail())
+                m_bGood = false;
+            m_source.close();
+#endif
+            return m_bGood;
+        }
+
+    private:
+        bool flushWriteBuffer()
+        {
+            if (!m_writeBuffer.empty())
+            {
+                writeToOutput(m_writeBuffer.data(), m_writeBuffer.size());
+                m_writeBuffer.clear();
+            }
+            return m_bGood;
+        }
+
+        bool writeToOutput(const char* p, size_t nSize)
+        {
+#if DFG_FILE_RANGE_COPY_WRITER_USE_FD
+            while (nSize > 0 && m_bGood)
+            {
+                const auto nWritten = ::write(m_fdOutput, p, nSize);
+                if (nWritten < 0 && errno == EINTR)
+                    continue;
+                if (nWritten <= 0)
+                    m_bGood = false;
+                else
+                {
+                    p += nWritten;
+                    nSize -= static_cast<size_t>(nWritten);
+                }
+            }
+#else
+            m_output.write(p, static_cast<std::streamsize>(nSize));
+            if (!m_output.good())
+                m_bGood = false;
+#endif
+            return m_bGood;
+        }
+
+#if DFG_FILE_RANGE_COPY_WRITER_USE_FD
+        // Copies at most nCount bytes from source offset nOffset with pread/write, returns the number of bytes copied or -1 on error.
+        ssize_t copyWithReadWrite(const uint64 nOffset, const size_t nCount)
+        {
+            if (m_readBuffer.empty())
+                m_readBuffer.resize(s_nWriteBufferSize);
+            ssize_t nRead;
+            do
+            {
+                nRead = ::pread(m_fdSource, m_readBuffer.data(), Min(nCount, m_readBuffer.size()), static_cast<off_t>(nOffset));
+            } while (nRead < 0 && errno == EINTR);
+            if (nRead <= 0)
+                return nRead;
+            return (writeToOutput(m_readBuffer.data(), static_cast<size_t>(nRead))) ? nRead : -1;
+        }
+
+        int m_fdSource = -1;
+        int m_fdOutput = -1;
+        bool m_bTryCopyFileRange = (DFG_FILE_RANGE_COPY_WRITER_HAS_COPY_FILE_RANGE != 0);
+        bool m_bTrySendfile = true;
+        std::vector<char> m_readBuffer;
+#else
+        std::ifstream m_source;
+        std::ofstream m_output;
+#endif
+        bool m_bGood;
+        std::string m_writeBuffer;
+
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(FileRangeCopyWriter));
+    }; // class FileRangeCopyWriter
+
+} } // module namespace
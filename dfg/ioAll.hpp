@@ -10,6 +10,7 @@
 #include "io/DelimitedTextReader.hpp"
 #include "io/DelimitedTextWriter.hpp"
 #include "io/fileToByteContainer.hpp"
+#include "io/FileRangeCopyWriter.hpp"
 #include "io/IfmmStream.hpp"
 #include "io/IfStream.hpp"
 #include "io/ImcByteStream.hpp"
@@ -46,6 +46,12 @@ public:
 		return iter;
 	}
 
+	DFG_CLASS_NAME(InterleavedSemiIterator)& operator--()
+	{
+		m_pData -= m_nChannelCount;
+		return *this;
+	}
+
 	const Data_T& operator*() const
 	{
 		return *m_pData;
@@ -89,6 +95,11 @@ public:
 		return (*this);
 	}
 
+	DFG_CLASS_NAME(InterleavedSemiIterator)& operator-=(difference_type off)
+	{
+		return (*this += -off);
+	}
+
 	Data_T* m_pData;
 	difference_type m_nChannelCount;
 }; // class DFG_CLASS_NAME(InterleavedSemiIterator)
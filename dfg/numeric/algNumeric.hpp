@@ -7,10 +7,31 @@
 #include "average.hpp"
 #include "vectorizingLoop.hpp"
 #include "rescale.hpp"
+#include "simdKernels.hpp"
+#include <type_traits>
 
 
 DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
 
+    namespace DFG_DETAIL_NS
+    {
+        // True if 'Arr_T op= T' can be done with SIMD kernel of Arr_T, i.e. if arithmetic is done in Arr_T so that result equals 'Arr_T op= Arr_T(val)'.
+        template <class Arr_T, class T, bool IntegersSupported>
+        struct IsSimdForEachCompatible : public std::integral_constant<bool,
+            (std::is_same<Arr_T, double>::value || std::is_same<Arr_T, float>::value || (IntegersSupported && std::is_same<Arr_T, int32>::value))
+            && std::is_same<typename std::common_type<Arr_T, T>::type, Arr_T>::value>
+        {};
+
+        template <class Arr_T, class T> void forEachAddImpl(Arr_T* const arr, const size_t nSize, const T val, std::true_type)       { addSimd(arr, nSize, static_cast<Arr_T>(val)); }
+        template <class Arr_T, class T> void forEachAddImpl(Arr_T* const arr, const size_t nSize, const T val, std::false_type)      { DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, += val); }
+        template <class Arr_T, class T> void forEachSubtractImpl(Arr_T* const arr, const size_t nSize, const T val, std::true_type)  { subtractSimd(arr, nSize, static_cast<Arr_T>(val)); }
+        template <class Arr_T, class T> void forEachSubtractImpl(Arr_T* const arr, const size_t nSize, const T val, std::false_type) { DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, -= val); }
+        template <class Arr_T, class T> void forEachMultiplyImpl(Arr_T* const arr, const size_t nSize, const T val, std::true_type)  { multiplySimd(arr, nSize, static_cast<Arr_T>(val)); }
+        template <class Arr_T, class T> void forEachMultiplyImpl(Arr_T* const arr, const size_t nSize, const T val, std::false_type) { DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, *= val); }
+        template <class Arr_T, class T> void forEachDivideImpl(Arr_T* const arr, const size_t nSize, const T val, std::true_type)    { divideSimd(arr, nSize, static_cast<Arr_T>(val)); }
+        template <class Arr_T, class T> void forEachDivideImpl(Arr_T* const arr, const size_t nSize, const T val, std::false_type)   { DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, /= val); }
+    } // namespace DFG_DETAIL_NS
+
 	template <class MutableSource_T, class Source1_T, class Func>
 	void transformInPlace(MutableSource_T* const mutableSource, const size_t nSize0, const Source1_T* const source1, const size_t nSize1, Func func)
 	{
@@ -63,7 +84,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
 	{
 		if (addValue == 0)
 			return;
-        DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, += addValue);
+        DFG_DETAIL_NS::forEachAddImpl(arr, nSize, addValue, DFG_DETAIL_NS::IsSimdForEachCompatible<Arr_T, T, true>());
 	}
 
 	template <class Cont_T, class T>
@@ -77,7 +98,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
 	{
 		if (mul == 1)
 			return;
-        DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, *= mul);
+        DFG_DETAIL_NS::forEachMultiplyImpl(arr, nSize, mul, DFG_DETAIL_NS::IsSimdForEachCompatible<Arr_T, T, false>());
 	}
 
 	template <class Cont_T, class T>
@@ -91,7 +112,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
     {
         if (val == 0)
             return;
-        DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, -= val);
+        DFG_DETAIL_NS::forEachSubtractImpl(arr, nSize, val, DFG_DETAIL_NS::IsSimdForEachCompatible<Arr_T, T, true>());
     }
 
     template <class Cont_T, class T>
@@ -105,7 +126,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
     {
         if (val == 1)
             return;
-        DFG_ZIMPL_VECTORIZING_LOOP_RHS(arr, nSize, /= val);
+        DFG_DETAIL_NS::forEachDivideImpl(arr, nSize, val, DFG_DETAIL_NS::IsSimdForEachCompatible<Arr_T, T, false>());
     }
 
     template <class Cont_T, class T>
@@ -0,0 +1,367 @@
+#pragma once
+
+/*
+parallel.hpp
+
+Multithreaded versions of numeric reductions, transforms and selections for contiguous ranges.
+    -Input is split into fixed size chunks that are distributed among threads. Partial results are stored per chunk and
+     combined pairwise in chunk order so results are reproducible: they don't depend on thread count or on scheduling.
+     Note that for floating point reductions the result may differ in the last bits from the single threaded version since
+     summation order is different.
+    -Median and percentile use parallel selection (quickselect where counting and partitioning rounds are done in parallel)
+     instead of sorting.
+    -In all functions, nMaxThreadCount == 0 means that work is run in thread::defaultThreadPool(), otherwise in nMaxThreadCount dedicated threads.
+     Small inputs are processed in the calling thread.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../ptrToContiguousMemory.hpp"
+#include "../cont/elementType.hpp"
+#include "rescale.hpp"
+#include "simdKernels.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
+
+    namespace DFG_DETAIL_NS
+    {
+        // Chunk size used by parallel reductions; fixed so that results don't depend on thread count.
+        const size_t gnParallelChunkSize = 65536;
+
+        // Calls func(nChunk, iBegin, iEnd) for each chunk of [0, nSize[ (chunk i is [i * nChunkSize, min(nSize, (i + 1) * nChunkSize)[)
+        // using at most nMaxThreadCount threads (calling thread included) or, if nMaxThreadCount is 0, thread::defaultThreadPool().
+        template <class Func_T>
+        void forEachChunkParallel(const size_t nSize, const size_t nChunkSize, const size_t nMaxThreadCount, Func_T&& func)
+        {
+            const size_t nChunkCount = (nSize + nChunkSize - 1) / nChunkSize;
+            if (nMaxThreadCount == 0)
+            {
+                DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nChunkCount, 1, [&](const size_t c0, const size_t c1)
+                {
+                    for (size_t nChunk = c0; nChunk < c1; ++nChunk)
+                        func(nChunk, nChunk * nChunkSize, Min(nSize, (nChunk + 1) * nChunkSize));
+                });
+                return;
+            }
+            const size_t nThreadCount = Max(size_t(1), Min(nMaxThreadCount, nChunkCount));
+            std::atomic<size_t> nNextChunk(0);
+            const auto worker = [&]()
+            {
+                for (size_t nChunk = nNextChunk++; nChunk < nChunkCount; nChunk = nNextChunk++)
+                    func(nChunk, nChunk * nChunkSize, Min(nSize, (nChunk + 1) * nChunkSize));
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(nThreadCount - 1);
+            for (size_t i = 1; i < nThreadCount; ++i)
+                threads.push_back(std::thread(worker));
+            worker();
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        // Combines items pairwise in order ((p0 + p1) + (p2 + p3)) + ... and returns the result. Precondition: !partials.empty().
+        template <class T, class Combine_T>
+        T combinePairwise(std::vector<T>& partials, Combine_T combine)
+        {
+            DFG_ASSERT_UB(!partials.empty());
+            for (size_t nCount = partials.size(); nCount > 1; nCount = (nCount + 1) / 2)
+            {
+                for (size_t i = 0; 2 * i < nCount; ++i)
+                    partials[i] = (2 * i + 1 < nCount) ? combine(partials[2 * i], partials[2 * i + 1]) : partials[2 * i];
+            }
+            return partials[0];
+        }
+
+        // Chunk-wise reduction: reduceChunk(p + iBegin, iEnd - iBegin) for each chunk, then combines partials pairwise.
+        template <class Result_T, class T, class ReduceChunk_T, class Combine_T>
+        Result_T reduceParallel(const T* const p, const size_t nSize, const size_t nMaxThreadCount, ReduceChunk_T reduceChunk, Combine_T combine)
+        {
+            const size_t nChunkCount = (nSize + gnParallelChunkSize - 1) / gnParallelChunkSize;
+            std::vector<Result_T> partials(Max(size_t(1), nChunkCount), reduceChunk(p, 0));
+            forEachChunkParallel(nSize, gnParallelChunkSize, nMaxThreadCount, [&](const size_t nChunk, const size_t iBegin, const size_t iEnd)
+            {
+                partials[nChunk] = reduceChunk(p + iBegin, iEnd - iBegin);
+            });
+            return combinePairwise(partials, combine);
+        }
+
+        template <class Iterable_T>
+        auto contiguousPtr(Iterable_T& iterable) -> decltype(ptrToContiguousMemory(iterable))
+        {
+            DFG_STATIC_ASSERT(IsContiguousRange<Iterable_T>::value, "Parallel numeric algorithms require contiguous range");
+            return ptrToContiguousMemory(iterable);
+        }
+
+        // Returns k'th smallest (0-based) value in data; data is used as work buffer and its content is unspecified after the call.
+        // If pLower is not null, it receives (k-1)'th smallest value (requires k > 0), e.g. for median of even sized data without second selection.
+        // Precondition: k < data.size() and values are not NaN.
+        template <class T>
+        T nthSmallestParallelModifying(std::vector<T>& data, size_t k, const size_t nMaxThreadCount, T* pLower = nullptr)
+        {
+            DFG_ASSERT_UB(pLower == nullptr || k > 0);
+            // Below this size, std::nth_element in single thread is used.
+            const size_t nSerialThreshold = 4 * gnParallelChunkSize;
+            std::vector<T> buffer;
+            // Largest value so far discarded from below the kept range; candidate for *pLower.
+            bool bHasDiscardedLowerMax = false;
+            T discardedLowerMax = T();
+            const auto updateLower = [&](const T& val)
+            {
+                if (!bHasDiscardedLowerMax || discardedLowerMax < val)
+                    discardedLowerMax = val;
+                bHasDiscardedLowerMax = true;
+            };
+            while (data.size() > nSerialThreshold)
+            {
+                const size_t nSize = data.size();
+                // Pivot is median of evenly spaced sample, so choice is deterministic.
+                const size_t nSampleSize = 1023;
+                std::vector<T> sample(nSampleSize);
+                for (size_t i = 0; i < nSampleSize; ++i)
+                    sample[i] = data[i * nSize / nSampleSize];
+                std::nth_element(sample.begin(), sample.begin() + nSampleSize / 2, sample.end());
+                const T pivot = sample[nSampleSize / 2];
+
+                // Counting items less than and equal to pivot per chunk.
+                const size_t nChunkCount = (nSize + gnParallelChunkSize - 1) / gnParallelChunkSize;
+                std::vector<size_t> lessCounts(nChunkCount);
+                std::vector<size_t> equalCounts(nChunkCount);
+                std::vector<T> lessMaxes((pLower) ? nChunkCount : 0); // Valid for chunks with lessCounts[i] != 0.
+                forEachChunkParallel(nSize, gnParallelChunkSize, nMaxThreadCount, [&](const size_t nChunk, const size_t iBegin, const size_t iEnd)
+                {
+                    size_t nLess = 0;
+                    size_t nEqual = 0;
+                    T lessMax = T();
+                    for (size_t i = iBegin; i < iEnd; ++i)
+                    {
+                        const bool bLess = (data[i] < pivot);
+                        if (pLower && bLess && (nLess == 0 || lessMax < data[i]))
+                            lessMax = data[i];
+                        nLess += bLess;
+                        nEqual += (data[i] == pivot);
+                    }
+                    lessCounts[nChunk] = nLess;
+                    equalCounts[nChunk] = nEqual;
+                    if (pLower)
+                        lessMaxes[nChunk] = lessMax;
+                });
+                size_t nLessTotal = 0;
+                size_t nEqualTotal = 0;
+                for (size_t i = 0; i < nChunkCount; ++i)
+                {
+                    nLessTotal += lessCounts[i];
+                    nEqualTotal += equalCounts[i];
+                }
+                if (k >= nLessTotal && k < nLessTotal + nEqualTotal)
+                {
+                    if (pLower)
+                    {
+                        if (k > nLessTotal) // Case: another item equal to pivot is just below.
+                            *pLower = pivot;
+                        else
+                        {
+                            for (size_t i = 0; i < nChunkCount; ++i)
+                            {
+                                if (lessCounts[i] != 0)
+                                    updateLower(lessMaxes[i]);
+                            }
+                            *pLower = discardedLowerMax;
+                        }
+                    }
+                    return pivot;
+                }
+                const bool bKeepLess = (k < nLessTotal);
+                if (!bKeepLess)
+                {
+                    k -= nLessTotal + nEqualTotal;
+                    updateLower(pivot); // Discarded items below kept range are <= pivot and pivot itself is among them.
+                }
+
+                // Compacting kept side to buffer: chunk i writes to offset given by prefix sum of kept counts.
+                std::vector<size_t> offsets(nChunkCount + 1, 0);
+                for (size_t i = 0; i < nChunkCount; ++i)
+                {
+                    const size_t nChunkItems = Min(nSize, (i + 1) * gnParallelChunkSize) - i * gnParallelChunkSize;
+                    offsets[i + 1] = offsets[i] + ((bKeepLess) ? lessCounts[i] : nChunkItems - lessCounts[i] - equalCounts[i]);
+                }
+                buffer.resize(offsets.back());
+                forEachChunkParallel(nSize, gnParallelChunkSize, nMaxThreadCount, [&](const size_t nChunk, const size_t iBegin, const size_t iEnd)
+                {
+                    size_t nOut = offsets[nChunk];
+                    for (size_t i = iBegin; i < iEnd; ++i)
+                    {
+                        if ((bKeepLess) ? data[i] < pivot : pivot < data[i])
+                            buffer[nOut++] = data[i];
+                    }
+                });
+                data.swap(buffer);
+            }
+            std::nth_element(data.begin(), data.begin() + k, data.end());
+            if (pLower)
+            {
+                if (k > 0)
+                    updateLower(*std::max_element(data.begin(), data.begin() + k));
+                *pLower = discardedLowerMax;
+            }
+            return data[k];
+        }
+    } // namespace DFG_DETAIL_NS
+
+    // Parallel version of accumulate() for contiguous ranges. Chunks are summed sequentially and partial sums are combined pairwise.
+    template <class Iterable_T, class Sum_T>
+    Sum_T accumulateParallel(const Iterable_T& iterable, const Sum_T initialValue, const size_t nMaxThreadCount = 0)
+    {
+        const auto p = DFG_DETAIL_NS::contiguousPtr(iterable);
+        typedef typename std::remove_const<typename std::remove_pointer<decltype(p)>::type>::type ValueT;
+        const auto sum = DFG_DETAIL_NS::reduceParallel<Sum_T>(p, count(iterable), nMaxThreadCount,
+            [](const ValueT* const pChunk, const size_t n)
+            {
+                Sum_T chunkSum = 0;
+                for (size_t i = 0; i < n; ++i)
+                    chunkSum += pChunk[i];
+                return chunkSum;
+            },
+            [](const Sum_T& a, const Sum_T& b) { return static_cast<Sum_T>(a + b); });
+        return static_cast<Sum_T>(initialValue + sum);
+    }
+
+    // Parallel version of average() for contiguous ranges of floating point values. For empty range, returns NaN.
+    template <class Iterable_T>
+    auto averageParallel(const Iterable_T& iterable, const size_t nMaxThreadCount = 0) -> typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type
+    {
+        typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type ValueT;
+        DFG_STATIC_ASSERT(std::is_floating_point<ValueT>::value, "averageParallel() is implemented only for floating point types.");
+        const auto nCount = count(iterable);
+        if (nCount == 0)
+            return std::numeric_limits<ValueT>::quiet_NaN();
+        return accumulateParallel(iterable, ValueT(0), nMaxThreadCount) / static_cast<ValueT>(nCount);
+    }
+
+    // Parallel version of summaryStatistics() for contiguous double or float ranges.
+    template <class Iterable_T>
+    SummaryStatistics summaryStatisticsParallel(const Iterable_T& iterable, const size_t nMaxThreadCount = 0)
+    {
+        const auto p = DFG_DETAIL_NS::contiguousPtr(iterable);
+        typedef typename std::remove_const<typename std::remove_pointer<decltype(p)>::type>::type ValueT;
+        return DFG_DETAIL_NS::reduceParallel<SummaryStatistics>(p, count(iterable), nMaxThreadCount,
+            [](const ValueT* const pChunk, const size_t n) { return summaryStatistics(pChunk, n); },
+            [](const SummaryStatistics& a, const SummaryStatistics& b)
+            {
+                if (a.count == 0)
+                    return b;
+                if (b.count == 0)
+                    return a;
+                SummaryStatistics rv;
+                rv.count = a.count + b.count;
+                rv.minValue = Min(a.minValue, b.minValue);
+                rv.maxValue = Max(a.maxValue, b.maxValue);
+                // NaN of either chunk propagates like in summaryStatistics().
+                DFG_DETAIL_NS::setNanIf(a.minValue != a.minValue || b.minValue != b.minValue, rv.minValue, rv.maxValue);
+                rv.sum = a.sum + b.sum;
+                rv.sumOfSquares = a.sumOfSquares + b.sumOfSquares;
+                return rv;
+            });
+    }
+
+    // Computes dest[i] = func(source[i]) for contiguous source in parallel; dest may be the same as source.
+    // Note: func is called concurrently from multiple threads.
+    template <class Iterable_T, class Dest_T, class Func_T>
+    void transform1Parallel(const Iterable_T& source, Dest_T* const dest, Func_T func, const size_t nMaxThreadCount = 0)
+    {
+        const auto p = DFG_DETAIL_NS::contiguousPtr(source);
+        DFG_DETAIL_NS::forEachChunkParallel(count(source), DFG_DETAIL_NS::gnParallelChunkSize, nMaxThreadCount, [&](size_t, const size_t iBegin, const size_t iEnd)
+        {
+            for (size_t i = iBegin; i < iEnd; ++i)
+                dest[i] = func(p[i]);
+        });
+    }
+
+    // Parallel version of rescale() for contiguous floating point ranges; result is identical to rescale().
+    template <class Iterable_T, class T>
+    void rescaleParallel(Iterable_T& iterable, const T& newLimit0, const T& newLimit1, const size_t nMaxThreadCount = 0)
+    {
+        const auto p = DFG_DETAIL_NS::contiguousPtr(iterable);
+        typedef typename std::remove_pointer<decltype(p)>::type ValueT;
+        DFG_STATIC_ASSERT(std::is_floating_point<ValueT>::value, "Only floating point types are supported in " DFG_CURRENT_FUNCTION_NAME);
+        const size_t nSize = count(iterable);
+        if (nSize == 0)
+            return;
+        typedef std::pair<ValueT, ValueT> MinMaxT;
+        const auto minMax = DFG_DETAIL_NS::reduceParallel<MinMaxT>(p, nSize, nMaxThreadCount,
+            [](const ValueT* const pChunk, const size_t n)
+            {
+                if (n == 0)
+                    return MinMaxT(std::numeric_limits<ValueT>::max(), std::numeric_limits<ValueT>::lowest());
+                const auto rv = std::minmax_element(pChunk, pChunk + n);
+                return MinMaxT(*rv.first, *rv.second);
+            },
+            [](const MinMaxT& a, const MinMaxT& b) { return MinMaxT((b.first < a.first) ? b.first : a.first, (a.second < b.second) ? b.second : a.second); });
+        const ValueT oldMin = minMax.first;
+        const auto oldRange = minMax.second - oldMin;
+        const ValueT minEnd = ValueT(newLimit0);
+        const auto newRange = newLimit1 - newLimit0;
+        const auto scaleFactor = (oldRange > 0) ? newRange / oldRange : 0;
+        DFG_DETAIL_NS::forEachChunkParallel(nSize, DFG_DETAIL_NS::gnParallelChunkSize, nMaxThreadCount, [&](size_t, const size_t iBegin, const size_t iEnd)
+        {
+            if (scaleFactor != 0)
+                DFG_DETAIL_NS::rescaleContiguous(p + iBegin, iEnd - iBegin, minEnd, oldMin, scaleFactor,
+                    std::integral_constant<bool, std::is_same<ValueT, T>::value && std::is_same<ValueT, typename std::remove_const<decltype(scaleFactor)>::type>::value>());
+            else
+                std::fill(p + iBegin, p + iEnd, minEnd);
+        });
+    }
+
+    // Returns k'th smallest (0-based) value of contiguous range using parallel selection; input is not modified.
+    // Precondition: k < count(iterable) and values are not NaN.
+    template <class Iterable_T>
+    auto nthSmallestParallel(const Iterable_T& iterable, const size_t k, const size_t nMaxThreadCount = 0) -> typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type
+    {
+        typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type ValueT;
+        const size_t nSize = count(iterable);
+        DFG_ASSERT_UB(k < nSize);
+        std::vector<ValueT> data(nSize);
+        transform1Parallel(iterable, data.data(), [](const ValueT& v) { return v; }, nMaxThreadCount);
+        return DFG_DETAIL_NS::nthSmallestParallelModifying(data, k, nMaxThreadCount);
+    }
+
+    // Parallel version of median() for contiguous floating point ranges; result is identical to median(). For empty range returns NaN.
+    template <class Iterable_T>
+    auto medianParallel(const Iterable_T& iterable, const size_t nMaxThreadCount = 0) -> typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type
+    {
+        typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type ValueT;
+        DFG_STATIC_ASSERT(std::is_floating_point<ValueT>::value, "medianParallel() accepts only floating point types");
+        const size_t nSize = count(iterable);
+        if (nSize == 0)
+            return std::numeric_limits<ValueT>::quiet_NaN();
+        std::vector<ValueT> data(nSize);
+        transform1Parallel(iterable, data.data(), [](const ValueT& v) { return v; }, nMaxThreadCount);
+        if (nSize % 2 == 1)
+            return DFG_DETAIL_NS::nthSmallestParallelModifying(data, nSize / 2, nMaxThreadCount);
+        // Even size: lower median is selected along with the upper one.
+        ValueT lower = ValueT();
+        const ValueT upper = DFG_DETAIL_NS::nthSmallestParallelModifying(data, nSize / 2, nMaxThreadCount, &lower);
+        return (lower + upper) / 2;
+    }
+
+    // Returns the same element as percentileInSorted_enclosingElem() would return for sorted copy of given range, but without sorting.
+    // For empty range returns ValueT().
+    template <class Iterable_T>
+    auto percentileParallel_enclosingElem(const Iterable_T& iterable, double percentile, const size_t nMaxThreadCount = 0) -> typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type
+    {
+        typedef typename DFG_MODULE_NS(cont)::DFG_CLASS_NAME(ElementType)<Iterable_T>::type ValueT;
+        const size_t nSize = count(iterable);
+        if (nSize == 0)
+            return ValueT();
+        limit(percentile, 0, 100);
+        const size_t nIndex = Min(nSize - 1, floorToInteger<size_t>(nSize * percentile / 100.0));
+        return nthSmallestParallel(iterable, nIndex, nMaxThreadCount);
+    }
+
+}} // module namespace
@@ -5,6 +5,7 @@
 #include <type_traits>
 #include "../ptrToContiguousMemory.hpp"
 #include "vectorizingLoop.hpp"
+#include "simdKernels.hpp"
 
 DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
 
@@ -19,12 +20,28 @@ namespace DFG_DETAIL_NS
         });
     }
 
+    template <class Value_T, class New_T, class Scale_T>
+    void rescaleContiguous(Value_T* p, const size_t nSize, New_T minEnd, Value_T oldMin, Scale_T scaleFactor, std::false_type)
+    {
+        DFG_ZIMPL_VECTORIZING_LOOP_RHS(p, nSize, = minEnd + (p[i] - oldMin) * scaleFactor);
+    }
+
+    // Overload for cases where all computation is done in Value_T (double or float) so SIMD kernel gives identical result.
+    template <class Value_T, class New_T, class Scale_T>
+    void rescaleContiguous(Value_T* p, const size_t nSize, New_T minEnd, Value_T oldMin, Scale_T scaleFactor, std::true_type)
+    {
+        affineTransformSimd(p, nSize, oldMin, scaleFactor, minEnd);
+    }
+
     template <class Iterable_T, class Value_T, class New_T, class Scale_T>
     void rescaleImpl(Iterable_T& iterable, New_T minEnd, Value_T oldMin, Scale_T scaleFactor, std::true_type)
     {
         auto p = ::DFG_ROOT_NS::ptrToContiguousMemory(iterable);
         const auto nSize = count(iterable);
-        DFG_ZIMPL_VECTORIZING_LOOP_RHS(p, nSize, = minEnd + (p[i] - oldMin) * scaleFactor);
+        typedef typename std::remove_pointer<decltype(p)>::type ElementT;
+        rescaleContiguous(p, nSize, minEnd, oldMin, scaleFactor, std::integral_constant<bool,
+            (std::is_same<ElementT, double>::value || std::is_same<ElementT, float>::value)
+            && std::is_same<ElementT, Value_T>::value && std::is_same<ElementT, New_T>::value && std::is_same<ElementT, Scale_T>::value>());
     }
 }
 
@@ -0,0 +1,1154 @@
+#pragma once
+
+/*
+simdKernels.hpp
+
+Explicit SIMD kernels for core numeric reductions and element-wise operations on contiguous double, float and int32 arrays.
+    -Kernels are implemented for SSE2 and AVX2 with scalar fallback; best available implementation is chosen at runtime
+     based on CPU detection (see simdLevel()). AVX2 kernels are compiled with function level target attributes so
+     no special compiler flags are needed.
+    -Reductions use multiple independent accumulators. Since this changes the order of additions compared to plain loop,
+     floating point results may differ in the last bits between SIMD levels. For accurate sums of large arrays, Kahan and pairwise
+     summation are available through SummationMethod.
+    -Element-wise operations give identical results regardless of the SIMD level.
+    -Min and max are identical regardless of the SIMD level; NaN's propagate, i.e. if input has NaN, min and max are NaN.
+Note: Kahan summation relies on strict IEEE semantics: it doesn't work if compiled with options like -ffast-math or /fp:fast.
+
+Compile time options:
+    -DFG_NUMERIC_SIMD_DISABLE: if defined, only scalar kernels are compiled.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../dfgAssert.hpp"
+#include "../ptrToContiguousMemory.hpp"
+#include <atomic>
+#include <limits>
+#include <utility>
+
+#if !defined(DFG_NUMERIC_SIMD_DISABLE) && (defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || (defined(__i386__) && defined(__SSE2__)))
+    #define DFG_NUMERIC_SIMD_X86 1
+    #include <emmintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #include <immintrin.h>
+        #define DFG_ZIMPL_NUMERIC_TARGET_AVX2
+        #define DFG_NUMERIC_SIMD_AVX2 (_MSC_VER >= 1900)
+    #elif defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+        #include <immintrin.h>
+        #define DFG_ZIMPL_NUMERIC_TARGET_AVX2 __attribute__((target("avx2")))
+        #define DFG_NUMERIC_SIMD_AVX2 1
+    #else
+        #define DFG_NUMERIC_SIMD_AVX2 0
+    #endif
+#else
+    #define DFG_NUMERIC_SIMD_X86 0
+    #define DFG_NUMERIC_SIMD_AVX2 0
+#endif
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(numeric) {
+
+    enum SimdLevel
+    {
+        SimdLevelScalar = 0,
+        SimdLevelSse2   = 1,
+        SimdLevelAvx2   = 2
+    };
+
+    enum SummationMethod
+    {
+        SummationMethodMultiAccumulator, // Fastest, error grows linearly with item count like in plain loop (but with smaller constant).
+        SummationMethodKahan,            // Compensated summation: error is practically independent of item count. About half the speed of multi accumulator.
+        SummationMethodPairwise          // Error grows logarithmically with item count, almost as fast as multi accumulator.
+    };
+
+    // Result of summaryStatistics(). For empty input, count is 0, sums are 0 and min/max are NaN.
+    struct SummaryStatistics
+    {
+        SummaryStatistics() :
+            count(0),
+            minValue(std::numeric_limits<double>::quiet_NaN()),
+            maxValue(std::numeric_limits<double>::quiet_NaN()),
+            sum(0),
+            sumOfSquares(0)
+        {}
+
+        double mean() const     { return (count > 0) ? sum / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN(); }
+        // Returns population variance, i.e. sum of squared deviations divided by count.
+        // Note: computed as E[x^2] - E[x]^2 which suffers from cancellation if variance is small compared to mean; see Welford's algorithm for robust alternative.
+        double variance() const { return (count > 0) ? Max(0.0, sumOfSquares / static_cast<double>(count) - mean() * mean()) : std::numeric_limits<double>::quiet_NaN(); }
+
+        size_t count;
+        double minValue;
+        double maxValue;
+        double sum;
+        double sumOfSquares;
+    };
+
+    namespace DFG_DETAIL_NS
+    {
+        inline SimdLevel detectSimdLevelImpl()
+        {
+#if DFG_NUMERIC_SIMD_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            const int nMaxLeaf = info[0];
+            __cpuid(info, 1);
+            if ((info[3] & (1 << 26)) == 0) // SSE2
+                return SimdLevelScalar;
+        #if DFG_NUMERIC_SIMD_AVX2
+            const bool bOsXsave = (info[2] & (1 << 27)) != 0;
+            const bool bAvx = (info[2] & (1 << 28)) != 0;
+            if (nMaxLeaf >= 7 && bOsXsave && bAvx && (_xgetbv(0) & 6) == 6) // OS saves xmm and ymm registers
+            {
+                __cpuidex(info, 7, 0);
+                if ((info[1] & (1 << 5)) != 0) // AVX2
+                    return SimdLevelAvx2;
+            }
+        #else
+            DFG_UNUSED(nMaxLeaf);
+        #endif
+            return SimdLevelSse2;
+    #else
+            __builtin_cpu_init();
+        #if DFG_NUMERIC_SIMD_AVX2
+            if (__builtin_cpu_supports("avx2"))
+                return SimdLevelAvx2;
+        #endif
+            return (__builtin_cpu_supports("sse2")) ? SimdLevelSse2 : SimdLevelScalar;
+    #endif
+#else
+            return SimdLevelScalar;
+#endif
+        }
+
+        inline std::atomic<int>& simdLevelLimitStorage()
+        {
+            static std::atomic<int> nLimit(SimdLevelAvx2);
+            return nLimit;
+        }
+    } // namespace DFG_DETAIL_NS
+
+    // Returns the best SIMD level supported by both the CPU and the build.
+    inline SimdLevel detectSimdLevel()
+    {
+        static const SimdLevel level = DFG_DETAIL_NS::detectSimdLevelImpl();
+        return level;
+    }
+
+    // Returns SIMD level used by the kernels, i.e. min(detectSimdLevel(), limit set with setSimdLevelLimit()).
+    inline SimdLevel simdLevel()
+    {
+        return static_cast<SimdLevel>(Min(static_cast<int>(detectSimdLevel()), DFG_DETAIL_NS::simdLevelLimitStorage().load(std::memory_order_relaxed)));
+    }
+
+    // Sets maximum SIMD level that kernels may use, e.g. for testing and benchmarking. Affects all threads.
+    inline void setSimdLevelLimit(const SimdLevel level)
+    {
+        DFG_DETAIL_NS::simdLevelLimitStorage().store(level, std::memory_order_relaxed);
+    }
+
+    namespace DFG_DETAIL_NS
+    {
+        // Adds 'val' to Kahan sum (sum, c) where c is the negative of accumulated low order bits.
+        template <class T>
+        inline void kahanAdd(T& sum, T& c, const T val)
+        {
+            const T y = val - c;
+            const T t = sum + y;
+            c = (t - sum) - y;
+            sum = t;
+        }
+
+        // ----------------------------------------------------------------------------------------------------
+        // Scalar kernels
+
+        template <class Acc_T, class T>
+        Acc_T sumScalar(const T* const p, const size_t n)
+        {
+            Acc_T a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                a0 += p[i];
+                a1 += p[i + 1];
+                a2 += p[i + 2];
+                a3 += p[i + 3];
+            }
+            for (; i < n; ++i)
+                a0 += p[i];
+            return (a0 + a1) + (a2 + a3);
+        }
+
+        template <class T>
+        T kahanSumScalar(const T* const p, const size_t n, T sum = 0, T c = 0)
+        {
+            for (size_t i = 0; i < n; ++i)
+                kahanAdd(sum, c, p[i]);
+            return sum - c;
+        }
+
+        // Min/max of input that has NaN's are NaN regardless of SIMD level (plain Min()/Max() and SIMD min/max instructions would give order dependent results).
+        template <class T>
+        inline void setNanIf(const bool bNan, T& rMin, T& rMax)
+        {
+            if (bNan)
+                rMin = rMax = std::numeric_limits<T>::quiet_NaN();
+        }
+
+        template <class T>
+        void summaryStatisticsScalar(const T* const p, const size_t n, SummaryStatistics& stats)
+        {
+            if (n == 0)
+                return;
+            T minVal = p[0];
+            T maxVal = p[0];
+            double s0 = 0, s1 = 0, q0 = 0, q1 = 0;
+            bool bNan = false;
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                const double v0 = p[i];
+                const double v1 = p[i + 1];
+                minVal = Min(minVal, Min(p[i], p[i + 1]));
+                maxVal = Max(maxVal, Max(p[i], p[i + 1]));
+                bNan |= (p[i] != p[i]) | (p[i + 1] != p[i + 1]);
+                s0 += v0;
+                s1 += v1;
+                q0 += v0 * v0;
+                q1 += v1 * v1;
+            }
+            for (; i < n; ++i)
+            {
+                const double v = p[i];
+                minVal = Min(minVal, p[i]);
+                maxVal = Max(maxVal, p[i]);
+                bNan |= (p[i] != p[i]);
+                s0 += v;
+                q0 += v * v;
+            }
+            setNanIf(bNan, minVal, maxVal);
+            stats.count = n;
+            stats.minValue = minVal;
+            stats.maxValue = maxVal;
+            stats.sum = s0 + s1;
+            stats.sumOfSquares = q0 + q1;
+        }
+
+        template <class T>
+        std::pair<T, T> minMaxScalar(const T* const p, const size_t n)
+        {
+            T minVal = p[0];
+            T maxVal = p[0];
+            bool bNan = (p[0] != p[0]);
+            for (size_t i = 1; i < n; ++i)
+            {
+                minVal = Min(minVal, p[i]);
+                maxVal = Max(maxVal, p[i]);
+                bNan |= (p[i] != p[i]);
+            }
+            setNanIf(bNan, minVal, maxVal);
+            return std::make_pair(minVal, maxVal);
+        }
+
+#if DFG_NUMERIC_SIMD_X86
+        // ----------------------------------------------------------------------------------------------------
+        // SSE2 kernels
+
+        inline double horizontalSum(const __m128d v)
+        {
+            return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+        }
+
+        inline float horizontalSum(const __m128 v)
+        {
+            const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+        }
+
+        inline double sumSse2(const double* const p, const size_t n)
+        {
+            __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd(), a2 = _mm_setzero_pd(), a3 = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                a0 = _mm_add_pd(a0, _mm_loadu_pd(p + i));
+                a1 = _mm_add_pd(a1, _mm_loadu_pd(p + i + 2));
+                a2 = _mm_add_pd(a2, _mm_loadu_pd(p + i + 4));
+                a3 = _mm_add_pd(a3, _mm_loadu_pd(p + i + 6));
+            }
+            double sum = horizontalSum(_mm_add_pd(_mm_add_pd(a0, a1), _mm_add_pd(a2, a3)));
+            for (; i < n; ++i)
+                sum += p[i];
+            return sum;
+        }
+
+        inline float sumSse2(const float* const p, const size_t n)
+        {
+            __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                a0 = _mm_add_ps(a0, _mm_loadu_ps(p + i));
+                a1 = _mm_add_ps(a1, _mm_loadu_ps(p + i + 4));
+                a2 = _mm_add_ps(a2, _mm_loadu_ps(p + i + 8));
+                a3 = _mm_add_ps(a3, _mm_loadu_ps(p + i + 12));
+            }
+            float sum = horizontalSum(_mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3)));
+            for (; i < n; ++i)
+                sum += p[i];
+            return sum;
+        }
+
+        inline int64 sumSse2(const int32* const p, const size_t n)
+        {
+            __m128i a0 = _mm_setzero_si128(), a1 = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                // Sign extending 4 x int32 to 2 x (2 x int64).
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                const __m128i sign = _mm_srai_epi32(v, 31);
+                a0 = _mm_add_epi64(a0, _mm_unpacklo_epi32(v, sign));
+                a1 = _mm_add_epi64(a1, _mm_unpackhi_epi32(v, sign));
+            }
+            int64 lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(a0, a1));
+            int64 sum = lanes[0] + lanes[1];
+            for (; i < n; ++i)
+                sum += p[i];
+            return sum;
+        }
+
+        inline double kahanSumSse2(const double* const p, const size_t n)
+        {
+            __m128d s = _mm_setzero_pd(), c = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                const __m128d y = _mm_sub_pd(_mm_loadu_pd(p + i), c);
+                const __m128d t = _mm_add_pd(s, y);
+                c = _mm_sub_pd(_mm_sub_pd(t, s), y);
+                s = t;
+            }
+            double sLanes[2], cLanes[2];
+            _mm_storeu_pd(sLanes, s);
+            _mm_storeu_pd(cLanes, c);
+            double sum = 0, comp = 0;
+            kahanAdd(sum, comp, sLanes[0]);
+            kahanAdd(sum, comp, sLanes[1]);
+            kahanAdd(sum, comp, -cLanes[0]);
+            kahanAdd(sum, comp, -cLanes[1]);
+            return kahanSumScalar(p + i, n - i, sum, comp);
+        }
+
+        inline float kahanSumSse2(const float* const p, const size_t n)
+        {
+            __m128 s = _mm_setzero_ps(), c = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 y = _mm_sub_ps(_mm_loadu_ps(p + i), c);
+                const __m128 t = _mm_add_ps(s, y);
+                c = _mm_sub_ps(_mm_sub_ps(t, s), y);
+                s = t;
+            }
+            float sLanes[4], cLanes[4];
+            _mm_storeu_ps(sLanes, s);
+            _mm_storeu_ps(cLanes, c);
+            float sum = 0, comp = 0;
+            for (size_t k = 0; k < 4; ++k)
+                kahanAdd(sum, comp, sLanes[k]);
+            for (size_t k = 0; k < 4; ++k)
+                kahanAdd(sum, comp, -cLanes[k]);
+            return kahanSumScalar(p + i, n - i, sum, comp);
+        }
+
+        inline void summaryStatisticsSse2(const double* const p, const size_t n, SummaryStatistics& stats)
+        {
+            if (n < 2)
+                return summaryStatisticsScalar(p, n, stats);
+            __m128d vMin = _mm_loadu_pd(p), vMax = vMin, vNan = _mm_setzero_pd();
+            __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), q0 = _mm_setzero_pd(), q1 = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128d v0 = _mm_loadu_pd(p + i);
+                const __m128d v1 = _mm_loadu_pd(p + i + 2);
+                vMin = _mm_min_pd(vMin, _mm_min_pd(v0, v1));
+                vMax = _mm_max_pd(vMax, _mm_max_pd(v0, v1));
+                vNan = _mm_or_pd(vNan, _mm_cmpunord_pd(v0, v1));
+                s0 = _mm_add_pd(s0, v0);
+                s1 = _mm_add_pd(s1, v1);
+                q0 = _mm_add_pd(q0, _mm_mul_pd(v0, v0));
+                q1 = _mm_add_pd(q1, _mm_mul_pd(v1, v1));
+            }
+            double mins[2], maxs[2];
+            _mm_storeu_pd(mins, vMin);
+            _mm_storeu_pd(maxs, vMax);
+            double minVal = Min(mins[0], mins[1]);
+            double maxVal = Max(maxs[0], maxs[1]);
+            bool bNan = (_mm_movemask_pd(vNan) != 0);
+            double sum = horizontalSum(_mm_add_pd(s0, s1));
+            double sumSq = horizontalSum(_mm_add_pd(q0, q1));
+            for (; i < n; ++i)
+            {
+                minVal = Min(minVal, p[i]);
+                maxVal = Max(maxVal, p[i]);
+                bNan |= (p[i] != p[i]);
+                sum += p[i];
+                sumSq += p[i] * p[i];
+            }
+            setNanIf(bNan, minVal, maxVal);
+            stats.count = n;
+            stats.minValue = minVal;
+            stats.maxValue = maxVal;
+            stats.sum = sum;
+            stats.sumOfSquares = sumSq;
+        }
+
+        inline void summaryStatisticsSse2(const float* const p, const size_t n, SummaryStatistics& stats)
+        {
+            if (n < 4)
+                return summaryStatisticsScalar(p, n, stats);
+            __m128 vMin = _mm_loadu_ps(p), vMax = vMin, vNan = _mm_setzero_ps();
+            __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), q0 = _mm_setzero_pd(), q1 = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(p + i);
+                vMin = _mm_min_ps(vMin, v);
+                vMax = _mm_max_ps(vMax, v);
+                vNan = _mm_or_ps(vNan, _mm_cmpunord_ps(v, v));
+                // Sums are accumulated as doubles.
+                const __m128d d0 = _mm_cvtps_pd(v);
+                const __m128d d1 = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+                s0 = _mm_add_pd(s0, d0);
+                s1 = _mm_add_pd(s1, d1);
+                q0 = _mm_add_pd(q0, _mm_mul_pd(d0, d0));
+                q1 = _mm_add_pd(q1, _mm_mul_pd(d1, d1));
+            }
+            float mins[4], maxs[4];
+            _mm_storeu_ps(mins, vMin);
+            _mm_storeu_ps(maxs, vMax);
+            float minVal = Min(Min(mins[0], mins[1]), Min(mins[2], mins[3]));
+            float maxVal = Max(Max(maxs[0], maxs[1]), Max(maxs[2], maxs[3]));
+            bool bNan = (_mm_movemask_ps(vNan) != 0);
+            double sum = horizontalSum(_mm_add_pd(s0, s1));
+            double sumSq = horizontalSum(_mm_add_pd(q0, q1));
+            for (; i < n; ++i)
+            {
+                const double v = p[i];
+                minVal = Min(minVal, p[i]);
+                maxVal = Max(maxVal, p[i]);
+                bNan |= (p[i] != p[i]);
+                sum += v;
+                sumSq += v * v;
+            }
+            setNanIf(bNan, minVal, maxVal);
+            stats.count = n;
+            stats.minValue = minVal;
+            stats.maxValue = maxVal;
+            stats.sum = sum;
+            stats.sumOfSquares = sumSq;
+        }
+
+        inline std::pair<double, double> minMaxSse2(const double* const p, const size_t n)
+        {
+            if (n < 2)
+                return minMaxScalar(p, n);
+            __m128d vMin = _mm_loadu_pd(p), vMax = vMin, vNan = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                const __m128d v = _mm_loadu_pd(p + i);
+                vMin = _mm_min_pd(vMin, v);
+                vMax = _mm_max_pd(vMax, v);
+                vNan = _mm_or_pd(vNan, _mm_cmpunord_pd(v, v));
+            }
+            double mins[2], maxs[2];
+            _mm_storeu_pd(mins, vMin);
+            _mm_storeu_pd(maxs, vMax);
+            bool bNan = (_mm_movemask_pd(vNan) != 0);
+            std::pair<double, double> rv(Min(mins[0], mins[1]), Max(maxs[0], maxs[1]));
+            for (; i < n; ++i)
+            {
+                rv.first = Min(rv.first, p[i]);
+                rv.second = Max(rv.second, p[i]);
+                bNan |= (p[i] != p[i]);
+            }
+            setNanIf(bNan, rv.first, rv.second);
+            return rv;
+        }
+
+        inline std::pair<float, float> minMaxSse2(const float* const p, const size_t n)
+        {
+            if (n < 4)
+                return minMaxScalar(p, n);
+            __m128 vMin = _mm_loadu_ps(p), vMax = vMin, vNan = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(p + i);
+                vMin = _mm_min_ps(vMin, v);
+                vMax = _mm_max_ps(vMax, v);
+                vNan = _mm_or_ps(vNan, _mm_cmpunord_ps(v, v));
+            }
+            float mins[4], maxs[4];
+            _mm_storeu_ps(mins, vMin);
+            _mm_storeu_ps(maxs, vMax);
+            bool bNan = (_mm_movemask_ps(vNan) != 0);
+            std::pair<float, float> rv(Min(Min(mins[0], mins[1]), Min(mins[2], mins[3])), Max(Max(maxs[0], maxs[1]), Max(maxs[2], maxs[3])));
+            for (; i < n; ++i)
+            {
+                rv.first = Min(rv.first, p[i]);
+                rv.second = Max(rv.second, p[i]);
+                bNan |= (p[i] != p[i]);
+            }
+            setNanIf(bNan, rv.first, rv.second);
+            return rv;
+        }
+
+        // Element-wise operations: p[i] = op(p[i], val). Op_T provides scalar and SSE2 versions.
+        struct SimdOpAdd
+        {
+            template <class T> static T scalar(const T a, const T b) { return a + b; }
+            static __m128d sse2(const __m128d a, const __m128d b) { return _mm_add_pd(a, b); }
+            static __m128 sse2(const __m128 a, const __m128 b) { return _mm_add_ps(a, b); }
+            static __m128i sse2(const __m128i a, const __m128i b) { return _mm_add_epi32(a, b); }
+        };
+
+        struct SimdOpSubtract
+        {
+            template <class T> static T scalar(const T a, const T b) { return a - b; }
+            static __m128d sse2(const __m128d a, const __m128d b) { return _mm_sub_pd(a, b); }
+            static __m128 sse2(const __m128 a, const __m128 b) { return _mm_sub_ps(a, b); }
+            static __m128i sse2(const __m128i a, const __m128i b) { return _mm_sub_epi32(a, b); }
+        };
+
+        struct SimdOpMultiply
+        {
+            template <class T> static T scalar(const T a, const T b) { return a * b; }
+            static __m128d sse2(const __m128d a, const __m128d b) { return _mm_mul_pd(a, b); }
+            static __m128 sse2(const __m128 a, const __m128 b) { return _mm_mul_ps(a, b); }
+        };
+
+        struct SimdOpDivide
+        {
+            template <class T> static T scalar(const T a, const T b) { return a / b; }
+            static __m128d sse2(const __m128d a, const __m128d b) { return _mm_div_pd(a, b); }
+            static __m128 sse2(const __m128 a, const __m128 b) { return _mm_div_ps(a, b); }
+        };
+
+        template <class Op_T>
+        void elementwiseSse2(double* const p, const size_t n, const double val)
+        {
+            const __m128d v = _mm_set1_pd(val);
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+                _mm_storeu_pd(p + i, Op_T::sse2(_mm_loadu_pd(p + i), v));
+            for (; i < n; ++i)
+                p[i] = Op_T::scalar(p[i], val);
+        }
+
+        template <class Op_T>
+        void elementwiseSse2(float* const p, const size_t n, const float val)
+        {
+            const __m128 v = _mm_set1_ps(val);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(p + i, Op_T::sse2(_mm_loadu_ps(p + i), v));
+            for (; i < n; ++i)
+                p[i] = Op_T::scalar(p[i], val);
+        }
+
+        template <class Op_T>
+        void elementwiseSse2(int32* const p, const size_t n, const int32 val)
+        {
+            const __m128i v = _mm_set1_epi32(val);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), Op_T::sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), v));
+            for (; i < n; ++i)
+                p[i] = static_cast<int32>(static_cast<uint32>(Op_T::scalar(int64(p[i]), int64(val)))); // Wrapping like SIMD version.
+        }
+
+        inline void affineTransformSse2(double* const p, const size_t n, const double sub, const double mul, const double add)
+        {
+            const __m128d vSub = _mm_set1_pd(sub), vMul = _mm_set1_pd(mul), vAdd = _mm_set1_pd(add);
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+                _mm_storeu_pd(p + i, _mm_add_pd(vAdd, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(p + i), vSub), vMul)));
+            for (; i < n; ++i)
+                p[i] = add + (p[i] - sub) * mul;
+        }
+
+        inline void affineTransformSse2(float* const p, const size_t n, const float sub, const float mul, const float add)
+        {
+            const __m128 vSub = _mm_set1_ps(sub), vMul = _mm_set1_ps(mul), vAdd = _mm_set1_ps(add);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(p + i, _mm_add_ps(vAdd, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + i), vSub), vMul)));
+            for (; i < n; ++i)
+                p[i] = add + (p[i] - sub) * mul;
+        }
+#endif // DFG_NUMERIC_SIMD_X86
+
+#if DFG_NUMERIC_SIMD_AVX2
+        // ----------------------------------------------------------------------------------------------------
+        // AVX2 kernels
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline double horizontalSumAvx2(const __m256d v)
+        {
+            return horizontalSum(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline float horizontalSumAvx2(const __m256 v)
+        {
+            return horizontalSum(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline double sumAvx2(const double* const p, const size_t n)
+        {
+            __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd(), a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p + i));
+                a1 = _mm256_add_pd(a1, _mm256_loadu_pd(p + i + 4));
+                a2 = _mm256_add_pd(a2, _mm256_loadu_pd(p + i + 8));
+                a3 = _mm256_add_pd(a3, _mm256_loadu_pd(p + i + 12));
+            }
+            double sum = horizontalSumAvx2(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+            for (; i < n; ++i)
+                sum += p[i];
+            return sum;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline float sumAvx2(const float* const p, const size_t n)
+        {
+            __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps(), a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                a0 = _mm256_add_ps(a0, _mm256_loadu_ps(p + i));
+                a1 = _mm256_add_ps(a1, _mm256_loadu_ps(p + i + 8));
+                a2 = _mm256_add_ps(a2, _mm256_loadu_ps(p + i + 16));
+                a3 = _mm256_add_ps(a3, _mm256_loadu_ps(p + i + 24));
+            }
+            float sum = horizontalSumAvx2(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+            for (; i < n; ++i)
+                sum += p[i];
+            return sum;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline int64 sumAvx2(const int32* const p, const size_t n)
+        {
+            __m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))));
+                a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 4))));
+            }
+            int64 lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(a0, a1));
+            int64 sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < n; ++i)
+                sum += p[i];
+            return sum;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline double kahanSumAvx2(const double* const p, const size_t n)
+        {
+            __m256d s = _mm256_setzero_pd(), c = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m256d y = _mm256_sub_pd(_mm256_loadu_pd(p + i), c);
+                const __m256d t = _mm256_add_pd(s, y);
+                c = _mm256_sub_pd(_mm256_sub_pd(t, s), y);
+                s = t;
+            }
+            double sLanes[4], cLanes[4];
+            _mm256_storeu_pd(sLanes, s);
+            _mm256_storeu_pd(cLanes, c);
+            double sum = 0, comp = 0;
+            for (size_t k = 0; k < 4; ++k)
+                kahanAdd(sum, comp, sLanes[k]);
+            for (size_t k = 0; k < 4; ++k)
+                kahanAdd(sum, comp, -cLanes[k]);
+            return kahanSumScalar(p + i, n - i, sum, comp);
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline float kahanSumAvx2(const float* const p, const size_t n)
+        {
+            __m256 s = _mm256_setzero_ps(), c = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256 y = _mm256_sub_ps(_mm256_loadu_ps(p + i), c);
+                const __m256 t = _mm256_add_ps(s, y);
+                c = _mm256_sub_ps(_mm256_sub_ps(t, s), y);
+                s = t;
+            }
+            float sLanes[8], cLanes[8];
+            _mm256_storeu_ps(sLanes, s);
+            _mm256_storeu_ps(cLanes, c);
+            float sum = 0, comp = 0;
+            for (size_t k = 0; k < 8; ++k)
+                kahanAdd(sum, comp, sLanes[k]);
+            for (size_t k = 0; k < 8; ++k)
+                kahanAdd(sum, comp, -cLanes[k]);
+            return kahanSumScalar(p + i, n - i, sum, comp);
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void summaryStatisticsAvx2(const double* const p, const size_t n, SummaryStatistics& stats)
+        {
+            if (n < 4)
+                return summaryStatisticsScalar(p, n, stats);
+            __m256d vMin = _mm256_loadu_pd(p), vMax = vMin, vNan = _mm256_setzero_pd();
+            __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), q0 = _mm256_setzero_pd(), q1 = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256d v0 = _mm256_loadu_pd(p + i);
+                const __m256d v1 = _mm256_loadu_pd(p + i + 4);
+                vMin = _mm256_min_pd(vMin, _mm256_min_pd(v0, v1));
+                vMax = _mm256_max_pd(vMax, _mm256_max_pd(v0, v1));
+                vNan = _mm256_or_pd(vNan, _mm256_cmp_pd(v0, v1, _CMP_UNORD_Q));
+                s0 = _mm256_add_pd(s0, v0);
+                s1 = _mm256_add_pd(s1, v1);
+                q0 = _mm256_add_pd(q0, _mm256_mul_pd(v0, v0));
+                q1 = _mm256_add_pd(q1, _mm256_mul_pd(v1, v1));
+            }
+            double mins[4], maxs[4];
+            _mm256_storeu_pd(mins, vMin);
+            _mm256_storeu_pd(maxs, vMax);
+            double minVal = Min(Min(mins[0], mins[1]), Min(mins[2], mins[3]));
+            double maxVal = Max(Max(maxs[0], maxs[1]), Max(maxs[2], maxs[3]));
+            bool bNan = (_mm256_movemask_pd(vNan) != 0);
+            double sum = horizontalSumAvx2(_mm256_add_pd(s0, s1));
+            double sumSq = horizontalSumAvx2(_mm256_add_pd(q0, q1));
+            for (; i < n; ++i)
+            {
+                minVal = Min(minVal, p[i]);
+                maxVal = Max(maxVal, p[i]);
+                bNan |= (p[i] != p[i]);
+                sum += p[i];
+                sumSq += p[i] * p[i];
+            }
+            setNanIf(bNan, minVal, maxVal);
+            stats.count = n;
+            stats.minValue = minVal;
+            stats.maxValue = maxVal;
+            stats.sum = sum;
+            stats.sumOfSquares = sumSq;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void summaryStatisticsAvx2(const float* const p, const size_t n, SummaryStatistics& stats)
+        {
+            if (n < 8)
+                return summaryStatisticsScalar(p, n, stats);
+            __m256 vMin = _mm256_loadu_ps(p), vMax = vMin, vNan = _mm256_setzero_ps();
+            __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), q0 = _mm256_setzero_pd(), q1 = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256 v = _mm256_loadu_ps(p + i);
+                vMin = _mm256_min_ps(vMin, v);
+                vMax = _mm256_max_ps(vMax, v);
+                vNan = _mm256_or_ps(vNan, _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+                const __m256d d0 = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+                const __m256d d1 = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+                s0 = _mm256_add_pd(s0, d0);
+                s1 = _mm256_add_pd(s1, d1);
+                q0 = _mm256_add_pd(q0, _mm256_mul_pd(d0, d0));
+                q1 = _mm256_add_pd(q1, _mm256_mul_pd(d1, d1));
+            }
+            float mins[8], maxs[8];
+            _mm256_storeu_ps(mins, vMin);
+            _mm256_storeu_ps(maxs, vMax);
+            float minVal = mins[0];
+            float maxVal = maxs[0];
+            for (size_t k = 1; k < 8; ++k)
+            {
+                minVal = Min(minVal, mins[k]);
+                maxVal = Max(maxVal, maxs[k]);
+            }
+            bool bNan = (_mm256_movemask_ps(vNan) != 0);
+            double sum = horizontalSumAvx2(_mm256_add_pd(s0, s1));
+            double sumSq = horizontalSumAvx2(_mm256_add_pd(q0, q1));
+            for (; i < n; ++i)
+            {
+                const double v = p[i];
+                minVal = Min(minVal, p[i]);
+                maxVal = Max(maxVal, p[i]);
+                bNan |= (p[i] != p[i]);
+                sum += v;
+                sumSq += v * v;
+            }
+            setNanIf(bNan, minVal, maxVal);
+            stats.count = n;
+            stats.minValue = minVal;
+            stats.maxValue = maxVal;
+            stats.sum = sum;
+            stats.sumOfSquares = sumSq;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline std::pair<double, double> minMaxAvx2(const double* const p, const size_t n)
+        {
+            if (n < 4)
+                return minMaxScalar(p, n);
+            __m256d vMin = _mm256_loadu_pd(p), vMax = vMin, vNan = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m256d v = _mm256_loadu_pd(p + i);
+                vMin = _mm256_min_pd(vMin, v);
+                vMax = _mm256_max_pd(vMax, v);
+                vNan = _mm256_or_pd(vNan, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+            }
+            double mins[4], maxs[4];
+            _mm256_storeu_pd(mins, vMin);
+            _mm256_storeu_pd(maxs, vMax);
+            bool bNan = (_mm256_movemask_pd(vNan) != 0);
+            std::pair<double, double> rv(Min(Min(mins[0], mins[1]), Min(mins[2], mins[3])), Max(Max(maxs[0], maxs[1]), Max(maxs[2], maxs[3])));
+            for (; i < n; ++i)
+            {
+                rv.first = Min(rv.first, p[i]);
+                rv.second = Max(rv.second, p[i]);
+                bNan |= (p[i] != p[i]);
+            }
+            setNanIf(bNan, rv.first, rv.second);
+            return rv;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline std::pair<float, float> minMaxAvx2(const float* const p, const size_t n)
+        {
+            if (n < 8)
+                return minMaxScalar(p, n);
+            __m256 vMin = _mm256_loadu_ps(p), vMax = vMin, vNan = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256 v = _mm256_loadu_ps(p + i);
+                vMin = _mm256_min_ps(vMin, v);
+                vMax = _mm256_max_ps(vMax, v);
+                vNan = _mm256_or_ps(vNan, _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+            }
+            float mins[8], maxs[8];
+            _mm256_storeu_ps(mins, vMin);
+            _mm256_storeu_ps(maxs, vMax);
+            bool bNan = (_mm256_movemask_ps(vNan) != 0);
+            std::pair<float, float> rv(mins[0], maxs[0]);
+            for (size_t k = 1; k < 8; ++k)
+            {
+                rv.first = Min(rv.first, mins[k]);
+                rv.second = Max(rv.second, maxs[k]);
+            }
+            for (; i < n; ++i)
+            {
+                rv.first = Min(rv.first, p[i]);
+                rv.second = Max(rv.second, p[i]);
+                bNan |= (p[i] != p[i]);
+            }
+            setNanIf(bNan, rv.first, rv.second);
+            return rv;
+        }
+
+        // AVX2 element-wise kernels are written per operation since target attributed functions can't be passed through functor templates portably.
+    #define DFG_ZIMPL_NUMERIC_AVX2_ELEMENTWISE(NAME, PD_FUNC, PS_FUNC, SCALAR_OP) \
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void NAME(double* const p, const size_t n, const double val) \
+        { \
+            const __m256d v = _mm256_set1_pd(val); \
+            size_t i = 0; \
+            for (; i + 4 <= n; i += 4) \
+                _mm256_storeu_pd(p + i, PD_FUNC(_mm256_loadu_pd(p + i), v)); \
+            for (; i < n; ++i) \
+                p[i] = p[i] SCALAR_OP val; \
+        } \
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void NAME(float* const p, const size_t n, const float val) \
+        { \
+            const __m256 v = _mm256_set1_ps(val); \
+            size_t i = 0; \
+            for (; i + 8 <= n; i += 8) \
+                _mm256_storeu_ps(p + i, PS_FUNC(_mm256_loadu_ps(p + i), v)); \
+            for (; i < n; ++i) \
+                p[i] = p[i] SCALAR_OP val; \
+        }
+
+        DFG_ZIMPL_NUMERIC_AVX2_ELEMENTWISE(addAvx2, _mm256_add_pd, _mm256_add_ps, +)
+        DFG_ZIMPL_NUMERIC_AVX2_ELEMENTWISE(subtractAvx2, _mm256_sub_pd, _mm256_sub_ps, -)
+        DFG_ZIMPL_NUMERIC_AVX2_ELEMENTWISE(multiplyAvx2, _mm256_mul_pd, _mm256_mul_ps, *)
+        DFG_ZIMPL_NUMERIC_AVX2_ELEMENTWISE(divideAvx2, _mm256_div_pd, _mm256_div_ps, /)
+    #undef DFG_ZIMPL_NUMERIC_AVX2_ELEMENTWISE
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void addAvx2(int32* const p, const size_t n, const int32 val)
+        {
+            const __m256i v = _mm256_set1_epi32(val);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i), _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), v));
+            for (; i < n; ++i)
+                p[i] = static_cast<int32>(static_cast<uint32>(p[i]) + static_cast<uint32>(val));
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void subtractAvx2(int32* const p, const size_t n, const int32 val)
+        {
+            addAvx2(p, n, static_cast<int32>(0u - static_cast<uint32>(val)));
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void affineTransformAvx2(double* const p, const size_t n, const double sub, const double mul, const double add)
+        {
+            const __m256d vSub = _mm256_set1_pd(sub), vMul = _mm256_set1_pd(mul), vAdd = _mm256_set1_pd(add);
+            size_t i = 0;
+            // Note: explicit mul and add (not FMA) so that result is identical to scalar version.
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(p + i, _mm256_add_pd(vAdd, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(p + i), vSub), vMul)));
+            for (; i < n; ++i)
+                p[i] = add + (p[i] - sub) * mul;
+        }
+
+        DFG_ZIMPL_NUMERIC_TARGET_AVX2 inline void affineTransformAvx2(float* const p, const size_t n, const float sub, const float mul, const float add)
+        {
+            const __m256 vSub = _mm256_set1_ps(sub), vMul = _mm256_set1_ps(mul), vAdd = _mm256_set1_ps(add);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(p + i, _mm256_add_ps(vAdd, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p + i), vSub), vMul)));
+            for (; i < n; ++i)
+                p[i] = add + (p[i] - sub) * mul;
+        }
+#endif // DFG_NUMERIC_SIMD_AVX2
+
+        template <class T>
+        T sumMultiAccumulator(const T* const p, const size_t n, const SimdLevel level)
+        {
+#if DFG_NUMERIC_SIMD_AVX2
+            if (level >= SimdLevelAvx2)
+                return sumAvx2(p, n);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+            if (level >= SimdLevelSse2)
+                return sumSse2(p, n);
+#endif
+            DFG_UNUSED(level);
+            return sumScalar<T>(p, n);
+        }
+
+        template <class T>
+        T sumKahan(const T* const p, const size_t n, const SimdLevel level)
+        {
+#if DFG_NUMERIC_SIMD_AVX2
+            if (level >= SimdLevelAvx2)
+                return kahanSumAvx2(p, n);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+            if (level >= SimdLevelSse2)
+                return kahanSumSse2(p, n);
+#endif
+            DFG_UNUSED(level);
+            return kahanSumScalar(p, n);
+        }
+
+        template <class T>
+        T sumPairwise(const T* const p, const size_t n, const SimdLevel level)
+        {
+            // Base case is multi accumulator sum which is itself blockwise so base case can be relatively large.
+            const size_t nBaseCaseSize = 256;
+            if (n <= nBaseCaseSize)
+                return sumMultiAccumulator(p, n, level);
+            const size_t nHalf = n / 2;
+            return sumPairwise(p, nHalf, level) + sumPairwise(p + nHalf, n - nHalf, level);
+        }
+
+        template <class T>
+        void summaryStatisticsImpl(const T* const p, const size_t n, SummaryStatistics& stats, const SimdLevel level)
+        {
+#if DFG_NUMERIC_SIMD_AVX2
+            if (level >= SimdLevelAvx2)
+                return summaryStatisticsAvx2(p, n, stats);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+            if (level >= SimdLevelSse2)
+                return summaryStatisticsSse2(p, n, stats);
+#endif
+            DFG_UNUSED(level);
+            summaryStatisticsScalar(p, n, stats);
+        }
+
+        template <class T>
+        std::pair<T, T> minMaxImpl(const T* const p, const size_t n, const SimdLevel level)
+        {
+#if DFG_NUMERIC_SIMD_AVX2
+            if (level >= SimdLevelAvx2)
+                return minMaxAvx2(p, n);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+            if (level >= SimdLevelSse2)
+                return minMaxSse2(p, n);
+#endif
+            DFG_UNUSED(level);
+            return minMaxScalar(p, n);
+        }
+    } // namespace DFG_DETAIL_NS
+
+    // Returns sum of p[0], ..., p[n - 1] using given summation method.
+    inline double sumSimd(const double* const p, const size_t n, const SummationMethod method = SummationMethodMultiAccumulator)
+    {
+        const auto level = simdLevel();
+        switch (method)
+        {
+            case SummationMethodKahan:    return DFG_DETAIL_NS::sumKahan(p, n, level);
+            case SummationMethodPairwise: return DFG_DETAIL_NS::sumPairwise(p, n, level);
+            default:                      return DFG_DETAIL_NS::sumMultiAccumulator(p, n, level);
+        }
+    }
+
+    // Returns sum of p[0], ..., p[n - 1] accumulated in float. For large arrays, consider Kahan or pairwise summation or summaryStatistics() which sums in double.
+    inline float sumSimd(const float* const p, const size_t n, const SummationMethod method = SummationMethodMultiAccumulator)
+    {
+        const auto level = simdLevel();
+        switch (method)
+        {
+            case SummationMethodKahan:    return DFG_DETAIL_NS::sumKahan(p, n, level);
+            case SummationMethodPairwise: return DFG_DETAIL_NS::sumPairwise(p, n, level);
+            default:                      return DFG_DETAIL_NS::sumMultiAccumulator(p, n, level);
+        }
+    }
+
+    // Returns sum of p[0], ..., p[n - 1] as int64 so result doesn't overflow unless n is astronomical. Integer sum is exact so summation method is ignored.
+    inline int64 sumSimd(const int32* const p, const size_t n, const SummationMethod method = SummationMethodMultiAccumulator)
+    {
+        DFG_UNUSED(method);
+        const auto level = simdLevel();
+#if DFG_NUMERIC_SIMD_AVX2
+        if (level >= SimdLevelAvx2)
+            return DFG_DETAIL_NS::sumAvx2(p, n);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+        if (level >= SimdLevelSse2)
+            return DFG_DETAIL_NS::sumSse2(p, n);
+#endif
+        DFG_UNUSED(level);
+        return DFG_DETAIL_NS::sumScalar<int64>(p, n);
+    }
+
+    template <class Cont_T>
+    auto sumSimd(const Cont_T& cont, const SummationMethod method = SummationMethodMultiAccumulator) -> decltype(sumSimd(ptrToContiguousMemory(cont), size_t(0), method))
+    {
+        return sumSimd(ptrToContiguousMemory(cont), count(cont), method);
+    }
+
+    // Computes count, min, max, sum and sum of squares in a single pass. If there are NaN's, min and max are NaN (and sums are NaN as well).
+    inline SummaryStatistics summaryStatistics(const double* const p, const size_t n)
+    {
+        SummaryStatistics stats;
+        DFG_DETAIL_NS::summaryStatisticsImpl(p, n, stats, simdLevel());
+        return stats;
+    }
+
+    inline SummaryStatistics summaryStatistics(const float* const p, const size_t n)
+    {
+        SummaryStatistics stats;
+        DFG_DETAIL_NS::summaryStatisticsImpl(p, n, stats, simdLevel());
+        return stats;
+    }
+
+    template <class Cont_T>
+    SummaryStatistics summaryStatistics(const Cont_T& cont)
+    {
+        return summaryStatistics(ptrToContiguousMemory(cont), count(cont));
+    }
+
+    // Returns (min, max) of non-empty array. If there are NaN's, both are NaN.
+    inline std::pair<double, double> minMaxSimd(const double* const p, const size_t n)
+    {
+        DFG_ASSERT_UB(n > 0);
+        return DFG_DETAIL_NS::minMaxImpl(p, n, simdLevel());
+    }
+
+    inline std::pair<float, float> minMaxSimd(const float* const p, const size_t n)
+    {
+        DFG_ASSERT_UB(n > 0);
+        return DFG_DETAIL_NS::minMaxImpl(p, n, simdLevel());
+    }
+
+    // Element-wise in-place operations p[i] = p[i] op val; results are identical to plain loop.
+    // Note: for int32, addition and subtraction wrap on overflow.
+#if DFG_NUMERIC_SIMD_AVX2
+    #define DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_AVX2(NAME) \
+        if (level >= SimdLevelAvx2) \
+            return DFG_DETAIL_NS::NAME##Avx2(p, n, val);
+#else
+    #define DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_AVX2(NAME)
+#endif
+#if DFG_NUMERIC_SIMD_X86
+    #define DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_SSE2(OP) \
+        if (level >= SimdLevelSse2) \
+            return DFG_DETAIL_NS::elementwiseSse2<DFG_DETAIL_NS::SimdOp##OP>(p, n, val);
+#else
+    #define DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_SSE2(OP)
+#endif
+#define DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(NAME, OP, T, SCALAR_STATEMENT) \
+    inline void NAME##Simd(T* const p, const size_t n, const T val) \
+    { \
+        const auto level = simdLevel(); \
+        DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_AVX2(NAME) \
+        DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_SSE2(OP) \
+        DFG_UNUSED(level); \
+        for (size_t i = 0; i < n; ++i) \
+            SCALAR_STATEMENT; \
+    }
+
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(add,      Add,      double, p[i] += val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(add,      Add,      float,  p[i] += val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(add,      Add,      int32,  p[i] = static_cast<int32>(static_cast<uint32>(p[i]) + static_cast<uint32>(val)))
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(subtract, Subtract, double, p[i] -= val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(subtract, Subtract, float,  p[i] -= val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(subtract, Subtract, int32,  p[i] = static_cast<int32>(static_cast<uint32>(p[i]) - static_cast<uint32>(val)))
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(multiply, Multiply, double, p[i] *= val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(multiply, Multiply, float,  p[i] *= val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(divide,   Divide,   double, p[i] /= val)
+    DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE(divide,   Divide,   float,  p[i] /= val)
+
+#undef DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE
+#undef DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_SSE2
+#undef DFG_ZIMPL_NUMERIC_SIMD_ELEMENTWISE_AVX2
+
+    // Computes p[i] = add + (p[i] - sub) * mul with results identical to plain loop.
+    inline void affineTransformSimd(double* const p, const size_t n, const double sub, const double mul, const double add)
+    {
+        const auto level = simdLevel();
+#if DFG_NUMERIC_SIMD_AVX2
+        if (level >= SimdLevelAvx2)
+            return DFG_DETAIL_NS::affineTransformAvx2(p, n, sub, mul, add);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+        if (level >= SimdLevelSse2)
+            return DFG_DETAIL_NS::affineTransformSse2(p, n, sub, mul, add);
+#endif
+        DFG_UNUSED(level);
+        for (size_t i = 0; i < n; ++i)
+            p[i] = add + (p[i] - sub) * mul;
+    }
+
+    inline void affineTransformSimd(float* const p, const size_t n, const float sub, const float mul, const float add)
+    {
+        const auto level = simdLevel();
+#if DFG_NUMERIC_SIMD_AVX2
+        if (level >= SimdLevelAvx2)
+            return DFG_DETAIL_NS::affineTransformAvx2(p, n, sub, mul, add);
+#endif
+#if DFG_NUMERIC_SIMD_X86
+        if (level >= SimdLevelSse2)
+            return DFG_DETAIL_NS::affineTransformSse2(p, n, sub, mul, add);
+#endif
+        DFG_UNUSED(level);
+        for (size_t i = 0; i < n; ++i)
+            p[i] = add + (p[i] - sub) * mul;
+    }
+
+}} // module namespace
@@ -5,8 +5,10 @@
 #include "numeric/average.hpp"
 #include "numeric/integration.hpp"
 #include "numeric/median.hpp"
+#include "numeric/parallel.hpp"
 #include "numeric/percentile.hpp"
 #include "numeric/percentileRange.hpp"
 #include "numeric/rescale.hpp"
+#include "numeric/simdKernels.hpp"
 #include "numeric/trimByPercentileRange.hpp"
 #include "numeric/vectorizingLoop.hpp"
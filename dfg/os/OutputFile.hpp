@@ -38,12 +38,14 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(os) {
             : m_pathDestination(std::move(sPath))
             , m_bAutoDiscardIntermediateFile(true)
             , m_bFinalDestinationWritten(false)
+            , m_bExternalIntermediateFile(false)
+            , m_bIntermediateDiscarded(false)
         {
         }
 
         ~OutputFile_completeOrNone()
         {
-            if (!m_bFinalDestinationWritten)
+            if (!m_bFinalDestinationWritten && !m_bIntermediateDiscarded)
                 writeIntermediateToFinalLocation();
             if (m_bAutoDiscardIntermediateFile)
                 discardIntermediate();
@@ -52,6 +54,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(os) {
         IntermediateFileStreamT& intermediateFileStream()
         {
             m_bFinalDestinationWritten = false;
+            m_bIntermediateDiscarded = false;
             if (!m_intermediateStream.is_open())
             {
                 m_pathIntermediate = generateIntermediatePath(m_pathDestination);
@@ -66,15 +69,29 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(os) {
         IntermediateMemoryStreamT& intermediateMemoryStream(const size_t nReserveHint = 0)
         {
             m_bFinalDestinationWritten = false;
+            m_bIntermediateDiscarded = false;
             if (nReserveHint > 0)
                 m_intermediateMemoryStream.tryReserve(nReserveHint);
             return m_intermediateMemoryStream;
         }
 
+        // Returns path of intermediate file for callers that write the intermediate file themselves (e.g. with OS file APIs) instead of using intermediateFileStream().
+        // writeIntermediateToFinalLocation() moves the file to destination.
+        // Returns empty if intermediate path couldn't be generated.
+        const PathStringT& intermediateFilePathForExternalWrite()
+        {
+            m_bFinalDestinationWritten = false;
+            m_bIntermediateDiscarded = false;
+            if (m_pathIntermediate.empty())
+                m_pathIntermediate = generateIntermediatePath(m_pathDestination);
+            m_bExternalIntermediateFile = !m_pathIntermediate.empty();
+            return m_pathIntermediate;
+        }
+
         // Returns 0 on success, otherwise ErrorCode
         int writeIntermediateToFinalLocation()
         {
-            const bool bIntermediateFile = m_intermediateStream.is_open();
+            const bool bIntermediateFile = m_intermediateStream.is_open() || m_bExternalIntermediateFile;
 
             if (bIntermediateFile)
             {
@@ -117,14 +134,21 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(os) {
             return 0;
         }
 
+        // Removes intermediate data. Destination won't be written by destructor after this call unless new intermediate is requested
+        // (otherwise destructor would overwrite destination with empty content). Does not affect isFinalDestinationWritten().
         void discardIntermediate()
         {
             m_intermediateStream.close();
             if (!m_pathIntermediate.empty())
                 removeFile(m_pathIntermediate.c_str());
             m_intermediateMemoryStream.releaseData();
+            m_bExternalIntermediateFile = false;
+            m_bIntermediateDiscarded = true;
         }
 
+        bool isFinalDestinationWritten() const { return m_bFinalDestinationWritten; }
+        bool isIntermediateDiscarded() const { return m_bIntermediateDiscarded; }
+
         static PathStringT generateIntermediatePath(const PathStringT& sDestinationPath)
         {
             PathStringT s = sDestinationPath + ".part";
@@ -154,6 +178,8 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(os) {
         IntermediateMemoryStreamT m_intermediateMemoryStream;
         bool m_bAutoDiscardIntermediateFile;
         bool m_bFinalDestinationWritten;
+        bool m_bExternalIntermediateFile;
+        bool m_bIntermediateDiscarded; // True if discardIntermediate() has been called after latest intermediate request.
         
     }; // Class OutputFile_completeOrNone
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "fileSize.hpp"
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(os) {
+
+// Returns last modification time of file as nanoseconds since 1970-01-01 00:00 UTC or 0 if file does not exist or can't be accessed.
+// Note: resolution depends on platform and file system; on platforms other than Linux resolution is one second.
+template <class Char_T>
+inline int64 fileModificationTimeT(const DFG_CLASS_NAME(ReadOnlySzParam)<Char_T>& sFile)
+{
+    auto info = DFG_DETAIL_NS::stat(DFG_MODULE_NS(io)::pathStrToFileApiFriendlyPath(sFile));
+    if (info.first != 0)
+        return 0;
+#if defined(__linux__)
+    return static_cast<int64>(info.second.st_mtim.tv_sec) * 1000000000 + static_cast<int64>(info.second.st_mtim.tv_nsec);
+#else
+    return static_cast<int64>(info.second.st_mtime) * 1000000000;
+#endif
+}
+
+inline int64 fileModificationTime(const DFG_CLASS_NAME(ReadOnlySzParamC)& sFile) { return fileModificationTimeT<char>(sFile); }
+inline int64 fileModificationTime(const DFG_CLASS_NAME(ReadOnlySzParamW)& sFile) { return fileModificationTimeT<wchar_t>(sFile); }
+
+} } // module namespace
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "os.hpp"
+#include "os/fileModificationTime.hpp"
 #include "os/fileSize.hpp"
 #include "os/memoryMappedFile.hpp"
 #include "os/OutputFile.hpp"
@@ -2,6 +2,7 @@
 #include "CsvItemModel.hpp"
 #include "qtIncludeHelpers.hpp"
 #include "PropertyHelper.hpp"
+#include "connectHelper.hpp"
 
 DFG_BEGIN_INCLUDE_QT_HEADERS
 #include <QUndoStack>
@@ -23,10 +24,13 @@ DFG_END_INCLUDE_QT_HEADERS
 #include "../io/DelimitedTextReader.hpp"
 #include "../io/OfStream.hpp"
 #include "../time/timerCpu.hpp"
+#include "../time/profiling.hpp"
 #include "../cont/CsvConfig.hpp"
 #include "../cont/SetVector.hpp"
 #include "../str/strTo.hpp"
 #include "../os/OutputFile.hpp"
+#include "../cont/tableCsvIncrementalWrite.hpp"
+#include "../thread/ThreadPool.hpp"
 
 namespace
 {
@@ -239,6 +243,31 @@ DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::DFG_CLASS_NAME(CsvItemModel)()
     m_readTimeInSeconds(-1),
     m_writeTimeInSeconds(-1)
 {
+    // Keeping highlighter match indexes in sync with content: cell edits are updated incrementally, structural changes cause rebuild.
+    // These are connected here so that they get called before views connected later query data().
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::dataChanged, this, &DFG_CLASS_NAME(CsvItemModel)::updateHighlighterMatchIndexes));
+    const auto rebuilder = [&]() { rebuildHighlighterMatchIndexes(); };
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::rowsInserted, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::rowsRemoved, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::rowsMoved, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::columnsInserted, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::columnsRemoved, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::columnsMoved, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::layoutChanged, this, rebuilder));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::modelReset, this, rebuilder));
+
+    // Tracking modified rows for incremental save: cell edits mark rows dirty, other changes make incremental save unavailable until next full save.
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::dataChanged, this, &DFG_CLASS_NAME(CsvItemModel)::onDataChangedForIncrementalSave));
+    const auto incrementalSaveInvalidator = [&]() { invalidateIncrementalSaveSource(); };
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::rowsInserted, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::rowsRemoved, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::rowsMoved, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::columnsInserted, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::columnsRemoved, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::columnsMoved, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::layoutChanged, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::modelReset, this, incrementalSaveInvalidator));
+    DFG_QT_VERIFY_CONNECT(connect(this, &QAbstractItemModel::headerDataChanged, this, incrementalSaveInvalidator));
 }
 
 DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::~DFG_CLASS_NAME(CsvItemModel)()
@@ -271,15 +300,35 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveToFile(const QString&
     return saveToFile(sPath, SaveOptions(this));
 }
 
+namespace
+{
+    // Returns format that saveImpl() uses for given options.
+    ::DFG_ROOT_NS::DFG_CLASS_NAME(CsvFormatDefinition) effectiveSaveFormat(const ::DFG_ROOT_NS::DFG_CLASS_NAME(CsvFormatDefinition)& options)
+    {
+        auto format = options;
+        if (DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextReader)::isMetaChar(format.separatorChar()))
+            format.separatorChar(',');
+        if (format.textEncoding() == DFG_MODULE_NS(io)::encodingUnknown)
+            format.textEncoding(DFG_MODULE_NS(io)::encodingUTF8);
+        if (DFG_MODULE_NS(utf)::encodingToBom(format.textEncoding()).size() == 0)
+            format.bomWriting(false); // E.g. Latin-1 has no BOM so nothing gets written.
+        return format;
+    }
+} // unnamed namespace
+
 template <class OutFile_T, class Stream_T>
 bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveToFileImpl(const QString& sPath, OutFile_T& outFile, Stream_T& strm, const SaveOptions& options)
 {
     const bool bSuccess = saveImpl(strm, options);
     if (bSuccess)
     {
-        outFile.writeIntermediateToFinalLocation();
+        const bool bWrittenToDestination = (outFile.writeIntermediateToFinalLocation() == 0);
         setFilePathWithSignalEmit(sPath);
         setModifiedStatus(false);
+        if (bWrittenToDestination)
+            setIncrementalSaveSource(sPath, effectiveSaveFormat(options));
+        else
+            invalidateIncrementalSaveSource();
     }
     else
         outFile.discardIntermediate();
@@ -287,6 +336,93 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveToFileImpl(const QStri
     return bSuccess;
 }
 
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::setIncrementalSaveSource(const QString& sPath, const DFG_CLASS_NAME(CsvFormatDefinition)& format)
+{
+    const QFileInfo fileInfo(sPath);
+    m_dirtyRows.clear();
+    m_spIncrementalSaveSource.reset(new IncrementalSaveSource(format));
+    m_spIncrementalSaveSource->m_sPath = fileInfo.absoluteFilePath();
+    m_spIncrementalSaveSource->m_nSize = fileInfo.size();
+    m_spIncrementalSaveSource->m_lastModified = fileInfo.lastModified();
+}
+
+bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::isAsciiContent() const
+{
+    const auto isAsciiQString = [](const QString& s) { return std::all_of(s.cbegin(), s.cend(), [](const QChar& ch) { return ch.unicode() < 0x80; }); };
+    if (!std::all_of(m_vecColInfo.cbegin(), m_vecColInfo.cend(), [&](const ColInfo& colInfo) { return isAsciiQString(colInfo.m_name); }))
+        return false;
+    bool bAscii = true;
+    for (int c = 0, nColCount = getColumnCount(); c < nColCount && bAscii; ++c)
+    {
+        m_table.forEachFwdRowInColumn(c, [&](const int, const SzPtrUtf8R psz)
+        {
+            for (auto p = psz.c_str(); bAscii && *p != '\0'; ++p)
+                bAscii = (static_cast<unsigned char>(*p) < 0x80);
+        });
+    }
+    return bAscii;
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::invalidateIncrementalSaveSource()
+{
+    m_spIncrementalSaveSource.reset();
+    m_dirtyRows.clear();
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::onDataChangedForIncrementalSave(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (m_spIncrementalSaveSource)
+        m_dirtyRows.insertClosed(topLeft.row(), bottomRight.row());
+}
+
+bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveToFileIncremental(const QString& sPath, const SaveOptions& options)
+{
+    if (!m_spIncrementalSaveSource)
+        return false;
+    const auto& source = *m_spIncrementalSaveSource;
+    const auto format = effectiveSaveFormat(options);
+    const auto& sourceFormat = source.m_format;
+    // Source must have header row since model stores it separately from the table, and format must be identical to make copied and rewritten rows consistent.
+    // In source format, bomWriting() tells whether the source has BOM.
+    if (!sourceFormat.headerWriting() || !format.headerWriting()
+        || format.separatorChar() != sourceFormat.separatorChar()
+        || format.enclosingChar() != sourceFormat.enclosingChar()
+        || format.eolType() != sourceFormat.eolType()
+        || format.textEncoding() != sourceFormat.textEncoding()
+        || format.bomWriting() != sourceFormat.bomWriting())
+    {
+        return false;
+    }
+    const QFileInfo sourceInfo(source.m_sPath);
+    if (!sourceInfo.isFile() || sourceInfo.size() != source.m_nSize || sourceInfo.lastModified() != source.m_lastModified)
+        return false; // Source has been changed after it was read or saved.
+
+    DFG_PROFILE_ZONE("CsvItemModel::saveToFileIncremental");
+    DFG_MODULE_NS(time)::DFG_CLASS_NAME(TimerCpu) writeTimer;
+
+    DFG_MODULE_NS(os)::OutputFile_completeOrNone<> outFile(qStringToFileApi8Bit(sPath));
+    const auto sIntermediatePath = outFile.intermediateFilePathForExternalWrite();
+    if (sIntermediatePath.empty() || !DFG_MODULE_NS(cont)::writeToFileIncremental(m_table, qStringToFileApi8Bit(source.m_sPath), sIntermediatePath, format, m_dirtyRows, 1))
+    {
+        outFile.discardIntermediate();
+        return false;
+    }
+    if (outFile.writeIntermediateToFinalLocation() != 0)
+    {
+        outFile.discardIntermediate(); // Auto-discard is not used for externally written intermediate so removing it here.
+        return false;
+    }
+
+    DFG_PROFILE_COUNTER("CsvItemModel::saveToFileIncremental dirty rows", m_dirtyRows.sizeOfSet());
+    m_table.saveFormat(options);
+    m_writeTimeInSeconds = static_cast<decltype(m_writeTimeInSeconds)>(writeTimer.elapsedWallSeconds());
+    setFilePathWithSignalEmit(sPath);
+    setModifiedStatus(false);
+    setIncrementalSaveSource(sPath, format);
+    Q_EMIT sigOnSaveToFileCompleted(true, static_cast<double>(m_writeTimeInSeconds));
+    return true;
+}
+
 auto DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::getOutputFileSizeEstimate() const -> uint64
 {
     const uint64 nRows = static_cast<uint64>(m_table.rowCountByMaxRowIndex());
@@ -303,6 +439,10 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveToFile(const QString&
     if (!QDir().mkpath(QFileInfo(sPath).absolutePath())) // Make sure that the target folder exists, otherwise opening the file will fail.
         return false;
 
+    // If content has been read from a file and only cells have been edited since, try to save by rewriting only modified rows.
+    if (saveToFileIncremental(sPath, options))
+        return true;
+
     DFG_MODULE_NS(os)::OutputFile_completeOrNone<> outFile(qStringToFileApi8Bit(sPath));
 
     const auto nSizeHint = getOutputFileSizeEstimate();
@@ -366,6 +506,7 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::save(StreamT& strm, const
 template <class Stream_T>
 bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveImpl(Stream_T& strm, const SaveOptions& options)
 {
+    DFG_PROFILE_ZONE("CsvItemModel::save");
     DFG_MODULE_NS(time)::DFG_CLASS_NAME(TimerCpu) writeTimer;
 
     const QChar cSep = (DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextReader)::isMetaChar(options.separatorChar())) ? ',' : options.separatorChar();
@@ -416,6 +557,7 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::saveImpl(Stream_T& strm, c
     m_table.saveFormat(options);
 
     m_writeTimeInSeconds = static_cast<decltype(m_writeTimeInSeconds)>(writeTimer.elapsedWallSeconds());
+    DFG_PROFILE_COUNTER("CsvItemModel::save rows", m_table.rowCountByMaxRowIndex());
 
     return strm.good();
 }
@@ -454,6 +596,7 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::clear()
 {
     m_table.clear();
     m_vecColInfo.clear();
+    invalidateIncrementalSaveSource();
     setFilePathWithSignalEmit(QString());
     m_bModified = false;
     m_nRowCount = 0;
@@ -483,6 +626,7 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::openFromMemory(const char*
 
 bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::readData(const LoadOptions& options, std::function<void()> tableFiller)
 {
+    DFG_PROFILE_ZONE("CsvItemModel::open");
     DFG_MODULE_NS(time)::DFG_CLASS_NAME(TimerCpu) readTimer;
 
     beginResetModel();
@@ -542,6 +686,7 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::readData(const LoadOptions
     m_bResetting = false;
 
     m_readTimeInSeconds = static_cast<decltype(m_readTimeInSeconds)>(readTimer.elapsedWallSeconds());
+    DFG_PROFILE_COUNTER("CsvItemModel::open rows", m_nRowCount);
     if (m_pUndoStack)
         m_pUndoStack->clear();
     Q_EMIT sigOnNewSourceOpened();
@@ -630,9 +775,8 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::mergeAnotherTableToThis(co
                 nThisOriginalRowCount + nOtherRowCount
               : getRowCountUpperBound();
 
-    // TODO: implement merging in m_table implementation. For example when merging big tables, this current implementation
-    //       copies data one-by-one while m_table could probably do it more efficiently by directly copying the string storage. In case of modifiable 'other',
-    //       this.m_table could adopt the string storage.
+    // Note: Since 'other' is const, its string storage can't be adopted so content is copied cell by cell.
+    //       For merging tables that are not needed afterwards, see importFiles() which uses TableSz::appendTableByAdoptingStorage().
     beginInsertRows(QModelIndex(), nThisOriginalRowCount, nNewRowCount - 1);
     other.m_table.forEachNonNullCell([&](const int r, const int c, SzPtrUtf8R s)
     {
@@ -688,12 +832,84 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::importFiles(const QStringL
     if (paths.empty())
         return true;
 
-    for (auto iter = paths.cbegin(), iterEnd = paths.cend(); iter != iterEnd; ++iter)
+    DFG_PROFILE_ZONE("CsvItemModel::importFiles");
+
+    // Files are parsed in parallel to separate tables which are then appended to this table by adopting their string storage.
+    struct ImportItem
+    {
+        ImportItem() : m_nRowCount(0) {}
+        DataTable m_table;
+        std::vector<QString> m_headers;
+        int m_nRowCount;
+    };
+    const size_t nFileCount = static_cast<size_t>(paths.size());
+    std::vector<std::unique_ptr<ImportItem>> items(nFileCount);
+    DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nFileCount, 1, [&](const size_t iBegin, const size_t iEnd)
+    {
+        for (size_t i = iBegin; i < iEnd; ++i)
+        {
+            const QString& sPath = paths[static_cast<int>(i)];
+            const QFileInfo fileInfo(sPath);
+            if (!fileInfo.isFile() || !fileInfo.isReadable())
+                continue;
+            std::unique_ptr<ImportItem> spItem(new ImportItem);
+            spItem->m_table.readFromFile(qStringToFileApi8Bit(sPath), getLoadOptionsForFile(sPath));
+            const auto nColCount = spItem->m_table.colCountByMaxColIndex();
+            spItem->m_headers.reserve(static_cast<size_t>(nColCount));
+            for (int c = 0; c < nColCount; ++c)
+            {
+                SzPtrUtf8R p = spItem->m_table(0, c); // Like in readData(), header is assumed to be on row 0.
+                spItem->m_headers.push_back((p) ? QString::fromUtf8(p.c_str()) : QString());
+            }
+            spItem->m_table.removeRows(0, 1);
+            spItem->m_nRowCount = spItem->m_table.rowCountByMaxRowIndex();
+            items[i] = std::move(spItem);
+        }
+    });
+
+    // Resolving column mapping for all tables before inserting rows.
+    std::vector<std::vector<int>> columnMaps(nFileCount);
+    int nTotalRowCount = 0;
+    for (size_t i = 0; i < nFileCount; ++i)
     {
-        DFG_CLASS_NAME(CsvItemModel) temp;
-        temp.openFile(*iter);
-        mergeAnotherTableToThis(temp);
+        if (!items[i] || items[i]->m_nRowCount < 1)
+            continue;
+        const auto& headers = items[i]->m_headers;
+        auto& columnMap = columnMaps[i];
+        columnMap.resize(headers.size());
+        for (size_t c = 0; c < headers.size(); ++c)
+        {
+            const auto nCurrentColCount = getColumnCount();
+            const auto nCol = findColumnIndexByName(headers[c], nCurrentColCount);
+            if (nCol == nCurrentColCount)
+            {
+                insertColumn(nCurrentColCount);
+                setColumnName(nCol, headers[c]);
+            }
+            columnMap[c] = nCol;
+        }
+        nTotalRowCount += items[i]->m_nRowCount;
     }
+
+    const auto nThisOriginalRowCount = getRowCount();
+    if (nTotalRowCount < 1 || nThisOriginalRowCount >= getRowCountUpperBound())
+        return true;
+    const auto nNewRowCount = (getRowCountUpperBound() - nTotalRowCount > nThisOriginalRowCount) ?
+                nThisOriginalRowCount + nTotalRowCount
+              : getRowCountUpperBound();
+
+    beginInsertRows(QModelIndex(), nThisOriginalRowCount, nNewRowCount - 1);
+    int nRowOffset = nThisOriginalRowCount;
+    for (size_t i = 0; i < nFileCount; ++i)
+    {
+        if (!items[i] || items[i]->m_nRowCount < 1)
+            continue;
+        m_table.appendTableByAdoptingStorage(items[i]->m_table, nRowOffset, columnMaps[i]);
+        nRowOffset += items[i]->m_nRowCount;
+    }
+    m_nRowCount = nNewRowCount;
+    endInsertRows();
+    DFG_PROFILE_COUNTER("CsvItemModel::importFiles rows", nTotalRowCount);
     return true; // TODO: more detailed return value (e.g. that how many were read successfully).
 }
 
@@ -728,6 +944,19 @@ bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::openFile(QString sDbFilePa
             m_table.readFromFile(qStringToFileApi8Bit(sDbFilePath), loadOptions); // TODO: return value
             setFilePathWithoutSignalEmit(std::move(sDbFilePath));
         });
+        if (rv)
+        {
+            // Normalizing to the format that saving uses for the same options, e.g. unknown encoding is saved as UTF-8.
+            const auto readFormat = m_table.readFormat();
+            auto sourceFormat = effectiveSaveFormat(readFormat);
+            sourceFormat.headerWriting(true); // readData() interprets first row as header.
+            // readFormat() doesn't tell whether input had BOM so checking it from the file.
+            sourceFormat.bomWriting(DFG_MODULE_NS(io)::checkBOMFromFile(qStringToFileApi8Bit(m_sFilePath)) != DFG_MODULE_NS(io)::encodingUnknown);
+            // Input with unknown encoding is read as Latin-1 but saved as UTF-8, so raw source bytes are what saving would write only if content is ASCII.
+            if (readFormat.textEncoding() == DFG_MODULE_NS(io)::encodingUnknown && !isAsciiContent())
+                sourceFormat.textEncoding(DFG_MODULE_NS(io)::encodingLatin1);
+            setIncrementalSaveSource(m_sFilePath, sourceFormat);
+        }
 
         return rv;
     }
@@ -775,7 +1004,17 @@ QVariant DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::data(const QModelIndex
         const auto hlCount = m_highlighters.size();
         for(size_t i = 0; i < hlCount; ++i)
         {
-            auto var = m_highlighters[i].data(*this, index, role);
+            const auto& highlighter = m_highlighters[i];
+            if (highlighter.m_nColumn >= 0 && highlighter.m_nColumn != nCol)
+                continue;
+            auto pMatchIndex = highlighterMatchIndex(i);
+            if (pMatchIndex)
+            {
+                if (pMatchIndex->isMatch(nRow, nCol))
+                    return highlighter.m_highlightBrush; // For now supporting only one highlighter per cell.
+                continue;
+            }
+            auto var = highlighter.data(*this, index, role);
             if (var.isValid())
                 return var; // For now supporting only one highlighter per cell.
         }
@@ -799,12 +1038,12 @@ QVariant DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::headerData(int section
         return QVariant(QString("%1").arg(internalRowIndexToVisible(section)));
 }
 
-void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::setDataNoUndo(const int nRow, const int nCol, SzPtrUtf8R pszU8)
+bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::setDataNoUndoNoSignal(const int nRow, const int nCol, SzPtrUtf8R pszU8)
 {
     if (!isValidRow(nRow) || !isValidColumn(nCol))
     {
         DFG_ASSERT(false);
-        return;
+        return false;
     }
 
     // Check whether the new value is different from old to avoid setting modified even if nothing changes.
@@ -812,10 +1051,17 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::setDataNoUndo(const int nR
     if (pExisting && std::strlen(pszU8.c_str()) <= std::strlen(pExisting.c_str()))
     {
         if (std::strcmp(pExisting.c_str(), pszU8.c_str()) == 0) // Identical item? If yes, skip rest to avoid setting modified.
-            return;
+            return false;
     }
 
     setItem(nRow, nCol, pszU8);
+    return true;
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::setDataNoUndo(const int nRow, const int nCol, SzPtrUtf8R pszU8)
+{
+    if (!setDataNoUndoNoSignal(nRow, nCol, pszU8))
+        return;
 
     auto indexItem = index(nRow, nCol);
     Q_EMIT dataChanged(indexItem, indexItem);
@@ -1075,6 +1321,62 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::setHighlighter(HighlightDe
     endResetModel();
 }
 
+auto DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::highlighterMatchIndex(const size_t nHighlighter) const -> const MatchIndex*
+{
+    if (!isValidIndex(m_highlighterMatchIndexes, nHighlighter) || !m_highlighterMatchIndexes[nHighlighter].isBuilt())
+        return nullptr;
+    return &m_highlighterMatchIndexes[nHighlighter];
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::rebuildHighlighterMatchIndexes()
+{
+    m_highlighterMatchIndexes.assign(m_highlighters.size(), MatchIndex());
+    for (size_t i = 0; i < m_highlighters.size(); ++i)
+    {
+        const auto matcher = m_highlighters[i].matcher();
+        // Index has only non-null cells so it can't be used if empty cells match.
+        if (!matcher.hasMatchString() || matcher.isMatchWith(DFG_CLASS_NAME(StringViewUtf8)()))
+            continue;
+        const auto pred = [matcher](const SzPtrUtf8R psz) { return matcher.isMatchWith(DFG_CLASS_NAME(StringViewUtf8)(psz)); };
+        m_highlighterMatchIndexes[i].build(m_table, getRowCount(), getColumnCount(), m_highlighters[i].m_nColumn, pred);
+    }
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::updateHighlighterMatchIndexes(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (m_highlighterMatchIndexes.empty())
+        return;
+    if (!topLeft.isValid() || !bottomRight.isValid())
+    {
+        rebuildHighlighterMatchIndexes();
+        return;
+    }
+    // For big changes rebuilding is simpler and likely faster than updating cell by cell.
+    const auto nCellCount = LinearIndex(bottomRight.row() - topLeft.row() + 1) * LinearIndex(bottomRight.column() - topLeft.column() + 1);
+    if (nCellCount > 1000)
+    {
+        rebuildHighlighterMatchIndexes();
+        return;
+    }
+    for (size_t i = 0; i < m_highlighterMatchIndexes.size(); ++i)
+    {
+        auto& matchIndex = m_highlighterMatchIndexes[i];
+        if (!matchIndex.isBuilt())
+            continue;
+        const auto& highlighter = m_highlighters[i];
+        for (int r = topLeft.row(); r <= bottomRight.row(); ++r)
+        {
+            for (int c = topLeft.column(); c <= bottomRight.column(); ++c)
+            {
+                if (highlighter.m_nColumn >= 0 && highlighter.m_nColumn != c)
+                    continue;
+                const auto psz = m_table(r, c);
+                matchIndex.setMatchStatus(r, c, psz && highlighter.matcher().isMatchWith(DFG_CLASS_NAME(StringViewUtf8)(psz)));
+            }
+        }
+    }
+}
+
 QModelIndexList DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::match(const QModelIndex& start, int role, const QVariant& value, const int hits, const Qt::MatchFlags flags) const
 {
     // match() is not adequate for needed find functionality (e.g. misses backward find, https://bugreports.qt.io/browse/QTBUG-344)
@@ -1170,8 +1472,21 @@ QModelIndex DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::findNextHighlighter
     if (!seedIndex.isValid())
         seedIndex = index(0, 0);
 
-    const auto usedHighlighter = m_highlighters.front();
+    const auto& usedHighlighter = m_highlighters.front();
     const auto advanceStyle = (usedHighlighter.m_nColumn >= 0) ? FindAdvanceStyleRowIncrement : FindAdvanceStyleLinear;
+
+    auto pMatchIndex = highlighterMatchIndex(0);
+    if (pMatchIndex)
+    {
+        int r = seedIndex.row();
+        int c = seedIndex.column();
+        const bool bFound = pMatchIndex->findNext(r, c,
+                                                  (direction == FindDirectionForward) ? MatchIndex::DirectionForward : MatchIndex::DirectionBackward,
+                                                  (advanceStyle == FindAdvanceStyleLinear) ? MatchIndex::AdvanceStyleLinear : MatchIndex::AdvanceStyleRowIncrement);
+        return (bFound) ? index(r, c) : QModelIndex();
+    }
+
+    // Match index is not available, searching cell by cell.
     const auto matcher = usedHighlighter.matcher();
 
     auto searchIndex = nextCellByFinderAdvance(seedIndex, direction, advanceStyle);
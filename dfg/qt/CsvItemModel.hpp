@@ -4,7 +4,9 @@
 #include "../buildConfig.hpp" // To get rid of C4996 "Function call with parameters that may be unsafe" in MSVC.
 #include "qtIncludeHelpers.hpp"
 #include "qtBasic.hpp"
+#include "../cont/IntervalSet.hpp"
 #include "../cont/tableCsv.hpp"
+#include "../cont/tableMatchIndex.hpp"
 #include "../io/textEncodingTypes.hpp"
 #include "StringMatchDefinition.hpp"
 #include "../build/languageFeatureInfo.hpp"
@@ -12,6 +14,7 @@
 DFG_BEGIN_INCLUDE_QT_HEADERS
 #include <QAbstractTableModel>
 #include <QBrush>
+#include <QDateTime>
 #include <QTextStream>
 DFG_END_INCLUDE_QT_HEADERS
 
@@ -89,6 +92,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(SortedSequence)<std::vector<int>> IndexSet;
         typedef DFG_DETAIL_NS::HighlightDefinition HighlightDefinition;
         typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(StringMatchDefinition) StringMatchDefinition;
+        typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableMatchIndex)<int> MatchIndex;
         
         enum ColType
         {
@@ -260,6 +264,11 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         void setDataNoUndo(const int nRow, const int nCol, const QString& str);
         void setDataNoUndo(const int nRow, const int nCol, SzPtrUtf8R pszU8);
 
+        // Sets multiple cells without triggering undo: func is called with setter-function object that has signature setter(int nRow, int nCol, SzPtrUtf8R pszU8).
+        // Instead of signal per cell, emits a single dataChanged-signal covering the bounding rectangle of changed cells after func returns.
+        // Cells whose content does not change are skipped; if nothing changes, no signal is emitted and model is not set modified.
+        template <class Func_T> void batchSetDataNoUndo(Func_T func);
+
         void setColumnName(const int nCol, const QString& sName);
 
         void removeRows(const std::vector<int>& vecIndexesAscSorted);
@@ -287,6 +296,9 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         // Note: Does not check whether the table has actually changed and always sets the model modified.
         template <class Func_T> void batchEditNoUndo(Func_T func);
 
+        // Gives internal table to given function object for read-only access.
+        template <class Func_T> void accessTable(Func_T func) const { func(m_table); }
+
         void setHighlighter(HighlightDefinition hld);
 
         // Finds next match.
@@ -342,6 +354,38 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         template <class OutFile_T, class Stream_T>
         bool saveToFileImpl(const QString& sPath, OutFile_T& outFile, Stream_T& strm, const SaveOptions& options);
 
+        // File from which unmodified rows can be copied when saving. Valid while row and column structure of the model matches the file.
+        class IncrementalSaveSource
+        {
+        public:
+            IncrementalSaveSource(const DFG_CLASS_NAME(CsvFormatDefinition)& format) :
+                m_nSize(-1),
+                m_format(format)
+            {}
+
+            QString m_sPath;
+            qint64 m_nSize;
+            QDateTime m_lastModified; // Size and modification time are used to detect changes made to the file by others.
+            DFG_CLASS_NAME(CsvFormatDefinition) m_format; // headerWriting() tells whether the file has header row and bomWriting() whether it has BOM.
+        };
+
+        // Tries to save by copying unmodified rows from incremental save source and writing only rows modified since it was read or saved.
+        // Return: true if saved successfully. If false, incremental save was not possible or failed and caller should do full save.
+        bool saveToFileIncremental(const QString& sPath, const SaveOptions& options);
+        void setIncrementalSaveSource(const QString& sPath, const DFG_CLASS_NAME(CsvFormatDefinition)& format);
+        void invalidateIncrementalSaveSource();
+        bool isAsciiContent() const; // Returns true if header and cell content have only ASCII characters.
+        void onDataChangedForIncrementalSave(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+
+        // Sets cell content without emitting signals or setting modified. Returns true if content was changed.
+        bool setDataNoUndoNoSignal(const int nRow, const int nCol, SzPtrUtf8R pszU8);
+
+        // Returns match index of given highlighter, or nullptr if index can't be used for the highlighter.
+        // Indexes are built when highlighters or content change so that this is a plain lookup e.g. when called from data().
+        const MatchIndex* highlighterMatchIndex(size_t nHighlighter) const;
+        void rebuildHighlighterMatchIndexes();
+        void updateHighlighterMatchIndexes(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+
     public:
         QUndoStack* m_pUndoStack;
         DataTable m_table;
@@ -356,6 +400,9 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         float m_readTimeInSeconds;
         float m_writeTimeInSeconds;
         std::vector<HighlightDefinition> m_highlighters;
+        std::vector<MatchIndex> m_highlighterMatchIndexes; // Match index for each highlighter, used by highlighting and find.
+        std::unique_ptr<IncrementalSaveSource> m_spIncrementalSaveSource; // Null if incremental save is not available.
+        DFG_MODULE_NS(cont)::DFG_CLASS_NAME(IntervalSet)<int> m_dirtyRows; // Rows modified since m_spIncrementalSaveSource was set.
     }; // class CsvItemModel
 
     template <class Func_T> void DFG_CLASS_NAME(CsvItemModel)::batchEditNoUndo(Func_T func)
@@ -368,4 +415,26 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         setModifiedStatus(true);
     }
 
+    template <class Func_T> void DFG_CLASS_NAME(CsvItemModel)::batchSetDataNoUndo(Func_T func)
+    {
+        int nMinRow = NumericTraits<int>::maxValue;
+        int nMinCol = NumericTraits<int>::maxValue;
+        int nMaxRow = -1;
+        int nMaxCol = -1;
+        const auto setter = [&](const int nRow, const int nCol, SzPtrUtf8R pszU8)
+        {
+            if (!setDataNoUndoNoSignal(nRow, nCol, pszU8))
+                return;
+            nMinRow = Min(nMinRow, nRow);
+            nMinCol = Min(nMinCol, nCol);
+            nMaxRow = Max(nMaxRow, nRow);
+            nMaxCol = Max(nMaxCol, nCol);
+        };
+        func(setter);
+        if (nMaxRow < 0)
+            return;
+        Q_EMIT dataChanged(index(nMinRow, nMinCol), index(nMaxRow, nMaxCol));
+        setModifiedStatus(true);
+    }
+
 } } // module namespace
@@ -11,6 +11,7 @@
 #include "connectHelper.hpp"
 #include "CsvTableViewCompleterDelegate.hpp"
 #include "../time/timerCpu.hpp"
+#include "../time/profiling.hpp"
 #include "../cont/valueArray.hpp"
 #include "TableEditor.hpp"
 
@@ -51,6 +52,8 @@ DFG_END_INCLUDE_QT_HEADERS
 #include "../math.hpp"
 #include "../str/stringLiteralCharToValue.hpp"
 #include "../io/DelimitedTextWriter.hpp"
+#include "../cont/tableDiff.hpp"
+#include <sstream>
 
 using namespace DFG_MODULE_NS(qt);
 
@@ -80,7 +83,8 @@ namespace
         CsvTableViewPropertyId_minimumVisibleColumnWidth,
         CsvTableViewPropertyId_timeFormat,
         CsvTableViewPropertyId_dateFormat,
-        CsvTableViewPropertyId_dateTimeFormat
+        CsvTableViewPropertyId_dateTimeFormat,
+        CsvTableViewPropertyId_undoMemoryLimit // Defines maximum amount of memory (in bytes) used for undo data of cell edits; data beyond this is stored to temporary files.
     };
 
     DFG_QT_DEFINE_OBJECT_PROPERTY_CLASS(CsvTableView)
@@ -104,6 +108,7 @@ namespace
     DFG_QT_DEFINE_OBJECT_PROPERTY("CsvTableView_timeFormat", CsvTableView, CsvTableViewPropertyId_timeFormat, QString, []() { return QString("hh:mm:ss.zzz"); });
     DFG_QT_DEFINE_OBJECT_PROPERTY("CsvTableView_dateFormat", CsvTableView, CsvTableViewPropertyId_dateFormat, QString, []() { return QString("yyyy-MM-dd"); });
     DFG_QT_DEFINE_OBJECT_PROPERTY("CsvTableView_dateTimeFormat", CsvTableView, CsvTableViewPropertyId_dateTimeFormat, QString, []() { return QString("yyyy-MM-dd hh:mm:ss.zzz"); });
+    DFG_QT_DEFINE_OBJECT_PROPERTY("CsvTableView_undoMemoryLimit", CsvTableView, CsvTableViewPropertyId_undoMemoryLimit, DFG_ROOT_NS::uint64, []() { return DFG_ROOT_NS::uint64(512) * 1024 * 1024; });
 
     template <class T>
     QString floatToQString(const T val)
@@ -614,6 +619,16 @@ void DFG_CLASS_NAME(CsvTableView)::clearUndoStack()
         m_spUndoStack->item().clear();
 }
 
+auto DFG_CLASS_NAME(CsvTableView)::undoMemoryBudget() -> std::shared_ptr<UndoMemoryBudget>
+{
+    if (!m_spUndoMemoryBudget)
+    {
+        const auto nLimit = getCsvTableViewProperty<CsvTableViewPropertyId_undoMemoryLimit>(this);
+        m_spUndoMemoryBudget = std::make_shared<UndoMemoryBudget>(static_cast<size_t>(Min(nLimit, static_cast<uint64>(NumericTraits<size_t>::maxValue))));
+    }
+    return m_spUndoMemoryBudget;
+}
+
 void DFG_CLASS_NAME(CsvTableView)::showUndoWindow()
 {
     if (!m_spUndoStack)
@@ -1626,6 +1641,9 @@ bool DFG_CLASS_NAME(CsvTableView)::cut()
 
 bool DFG_CLASS_NAME(CsvTableView)::copy()
 {
+    if (copyRectangularSelectionFast())
+        return true;
+
     auto vViewRows = getRowsOfSelectedItems(nullptr, false);
     auto vRows = getRowsOfSelectedItems(getProxyModelPtr(), false);
     auto pModel = csvModel();
@@ -1676,6 +1694,42 @@ bool DFG_CLASS_NAME(CsvTableView)::copy()
     return true;
 }
 
+bool DFG_CLASS_NAME(CsvTableView)::copyRectangularSelectionFast()
+{
+    // Handles the common case of single rectangular selection range by serializing cells directly from the underlying table
+    // to UTF-8 text instead of going through QString for every cell.
+    auto pModel = csvModel();
+    auto pSelectionModel = selectionModel();
+    if (!pModel || !pSelectionModel)
+        return false;
+    const auto selection = pSelectionModel->selection();
+    if (selection.size() != 1)
+        return false;
+    const auto& range = selection.front();
+    if (!range.isValid())
+        return false;
+
+    auto pProxy = getProxyModelPtr();
+    std::vector<int> vRows;
+    vRows.reserve(static_cast<size_t>(range.height()));
+    for (int r = range.top(); r <= range.bottom(); ++r)
+    {
+        const int nDataRow = (pProxy) ? pProxy->mapToSource(pProxy->index(r, range.left())).row() : r;
+        if (nDataRow < 0)
+            return false;
+        vRows.push_back(nDataRow);
+    }
+    const bool bRowMode = isRowMode();
+    const int nFirstCol = (bRowMode) ? 0 : range.left();
+    const int nEndCol = (bRowMode) ? pModel->getColumnCount() : range.right() + 1;
+    const CsvModel::DataTable::CsvFormatDefinition format('\t', '"', DFG_MODULE_NS(io)::EndOfLineTypeN, DFG_MODULE_NS(io)::encodingUTF8);
+    const auto sUtf8 = pModel->m_table.rowsToDelimitedText(vRows, nFirstCol, nEndCol, format);
+    if (sUtf8.size() > static_cast<size_t>(NumericTraits<int>::maxValue))
+        return false;
+    QApplication::clipboard()->setText(QString::fromUtf8(sUtf8.data(), static_cast<int>(sUtf8.size())));
+    return true;
+}
+
 bool DFG_CLASS_NAME(CsvTableView)::paste()
 {
     return executeAction<DFG_CLASS_NAME(CsvTableViewActionPaste)>(this);
@@ -2126,6 +2180,7 @@ bool DFG_CLASS_NAME(CsvTableView)::generateContent()
 }
 
 #include "../rand.hpp"
+#include "../rand/bulkRand.hpp"
 
 template <class Generator_T>
 void generateForEachInTarget(const TargetType targetType, const DFG_CLASS_NAME(CsvTableView)& view, DFG_CLASS_NAME(CsvItemModel)& rModel, Generator_T generator)
@@ -2168,6 +2223,50 @@ void generateForEachInTarget(const TargetType targetType, const DFG_CLASS_NAME(C
     }
 }
 
+// Fills target with uniformly distributed random values formatted with formatter(value, szBuffer).
+// Values are generated in bulk with counter-based engine; whole table target is filled column-wise with TableSz::setElementsInColumn().
+template <class T, class Formatter_T>
+void generateRandomForEachInTarget(const TargetType targetType, const DFG_CLASS_NAME(CsvTableView)& view, DFG_CLASS_NAME(CsvItemModel)& rModel, const T minVal, const T maxVal, Formatter_T formatter)
+{
+    auto randEng = ::DFG_MODULE_NS(rand)::createPhiloxEngineRandomSeeded();
+    char szBuffer[64];
+    if (targetType == TargetTypeWholeTable)
+    {
+        const auto nRows = rModel.rowCount();
+        const auto nCols = rModel.columnCount();
+        if (nRows < 1 || nCols < 1) // Nothing to add?
+            return;
+        std::vector<T> vals(static_cast<size_t>(nRows));
+        rModel.batchEditNoUndo([&](DFG_CLASS_NAME(CsvItemModel)::DataTable& table)
+        {
+            for (int c = 0; c < nCols; ++c)
+            {
+                // Each column uses its own stream so columns are independent of each other.
+                ::DFG_MODULE_NS(rand)::fillUniformParallel(vals.data(), vals.size(), minVal, maxVal, randEng.seed(), static_cast<uint64>(c));
+                table.setElementsInColumn(c, 0, nRows, [&](const int r)
+                {
+                    formatter(vals[static_cast<size_t>(r)], szBuffer);
+                    return SzPtrUtf8R(szBuffer);
+                });
+            }
+        });
+    }
+    else
+    {
+        // Generating values in batches as needed.
+        std::vector<T> vals(4096);
+        const auto generator = [&](DFG_CLASS_NAME(CsvItemModel)::DataTable& table, int r, int c, size_t nCounter)
+        {
+            const auto nIndex = nCounter % vals.size();
+            if (nIndex == 0)
+                ::DFG_MODULE_NS(rand)::fillUniform(randEng, vals.data(), vals.size(), minVal, maxVal);
+            formatter(vals[nIndex], szBuffer);
+            table.setElement(r, c, SzPtrUtf8R(szBuffer));
+        };
+        generateForEachInTarget(targetType, view, rModel, generator);
+    }
+}
+
 namespace
 {
     // TODO: test
@@ -2232,15 +2331,15 @@ bool DFG_CLASS_NAME(CsvTableView)::generateContentImpl(const DFG_CLASS_NAME(CsvI
             return false;
         const auto minVal = settingsModel.data(settingsModel.index(2, 1)).toString().toLongLong();
         const auto maxVal = settingsModel.data(settingsModel.index(3, 1)).toString().toLongLong();
-        auto randEng = ::DFG_MODULE_NS(rand)::createDefaultRandEngineRandomSeeded();
-        char szBuffer[32];
-        const auto generator = [&](DFG_CLASS_NAME(CsvItemModel)::DataTable& table, int r, int c, size_t)
-                                {
-                                    const auto val = ::DFG_MODULE_NS(rand)::rand(randEng, minVal, maxVal);
-                                    DFG_MODULE_NS(str)::toStr(val, szBuffer);
-                                    table.setElement(r, c, SzPtrUtf8R(szBuffer));
-                                };
-        generateForEachInTarget(target, *this, rModel, generator);
+        if (minVal > maxVal)
+        {
+            QMessageBox::information(nullptr, tr("Invalid parameter"), tr("Minimum value is greater than maximum value, no content generation is done"));
+            return false;
+        }
+        generateRandomForEachInTarget(target, *this, rModel, minVal, maxVal, [](const qlonglong val, char (&szBuffer)[64])
+        {
+            DFG_MODULE_NS(str)::toStr(val, szBuffer);
+        });
         return true;
     }
     else if (genType == GeneratorTypeRandomDoubles)
@@ -2272,15 +2371,10 @@ bool DFG_CLASS_NAME(CsvTableView)::generateContentImpl(const DFG_CLASS_NAME(CsvI
         std::string sFormat(("%" + sPrecision + sFormatType).toLatin1());
         const auto pszFormat = sFormat.c_str();
 
-        auto randEng = ::DFG_MODULE_NS(rand)::createDefaultRandEngineRandomSeeded();
-        char szBuffer[64];
-        const auto generator = [&](DFG_CLASS_NAME(CsvItemModel)::DataTable& table, int r, int c, size_t)
-                                {
-                                    const auto val = ::DFG_MODULE_NS(rand)::rand(randEng, minVal, maxVal);
-                                    DFG_MODULE_NS(str)::toStr(val, szBuffer, pszFormat);
-                                    table.setElement(r, c, SzPtrUtf8R(szBuffer));
-                                };
-        generateForEachInTarget(target, *this, rModel, generator);
+        generateRandomForEachInTarget(target, *this, rModel, minVal, maxVal, [&](const double val, char (&szBuffer)[64])
+        {
+            DFG_MODULE_NS(str)::toStr(val, szBuffer, pszFormat);
+        });
         return true;
     }
     else if (genType == GeneratorTypeFill)
@@ -2322,6 +2416,96 @@ const QAbstractProxyModel* DFG_CLASS_NAME(CsvTableView)::getProxyModelPtr() cons
 }
 
 bool DFG_CLASS_NAME(CsvTableView)::diffWithUnmodified()
+{
+    DFG_PROFILE_ZONE("CsvTableView::diffWithUnmodified");
+    auto dataModelPtr = csvModel();
+    if (!dataModelPtr)
+        return false;
+    const QString sFilePath = dataModelPtr->getFilePath();
+
+    if (!QFileInfo(sFilePath).isReadable())
+        return false;
+
+    // Reading with the format in which the file was read or latest saved (e.g. explicitly given separator or encoding) so that unmodified content parses identically.
+    const DFG_CLASS_NAME(CsvItemModel)::LoadOptions loadOptions(dataModelPtr->m_table.saveFormat());
+    DFG_CLASS_NAME(CsvItemModel) unmodifiedModel;
+    if (!unmodifiedModel.openFile(sFilePath, loadOptions))
+    {
+        QMessageBox::information(this, tr("Unable to diff"), tr("Reading unmodified file '%1' failed -> unable to diff").arg(sFilePath));
+        return false;
+    }
+
+    typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableDiff)<int> TableDiffT;
+    const size_t nMaxPatchLength = 100000; // Maximum number of chars of patch shown in details.
+    TableDiffT diff;
+    std::ostringstream ostrmPatch;
+    unmodifiedModel.accessTable([&](const DFG_CLASS_NAME(CsvItemModel)::DataTable& oldTable)
+    {
+        dataModelPtr->accessTable([&](const DFG_CLASS_NAME(CsvItemModel)::DataTable& newTable)
+        {
+            diff.compute(oldTable, newTable);
+            diff.writeCsvPatch(ostrmPatch, oldTable, newTable);
+        });
+    });
+
+    int nChangedHeaderCount = 0;
+    for (int c = 0, nCount = Max(unmodifiedModel.getColumnCount(), dataModelPtr->getColumnCount()); c < nCount; ++c)
+    {
+        if (unmodifiedModel.getHeaderName(c) != dataModelPtr->getHeaderName(c))
+            ++nChangedHeaderCount;
+    }
+
+    if (diff.isEmpty() && nChangedHeaderCount == 0)
+    {
+        QMessageBox::information(this, tr("Diff with unmodified"), tr("No differences found."));
+        return true;
+    }
+
+    // Selecting changed cells in view: modified cells and whole inserted rows.
+    {
+        QItemSelection selection;
+        const auto nLastCol = Max(0, dataModelPtr->getColumnCount() - 1);
+        for (const auto& change : diff.modifiedCells())
+        {
+            const auto index = dataModelPtr->index(change.nNewRow, change.nCol);
+            selection.select(index, index);
+        }
+        for (const auto& hunk : diff.hunks())
+        {
+            const auto nPairCount = hunk.pairedRowCount();
+            if (hunk.nNewCount > nPairCount)
+                selection.select(dataModelPtr->index(hunk.nNewRow + nPairCount, 0), dataModelPtr->index(hunk.nNewRow + hunk.nNewCount - 1, nLastCol));
+        }
+        auto pProxy = getProxyModelPtr();
+        if (pProxy)
+            selection = pProxy->mapSelectionFromSource(selection);
+        selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+    }
+
+    QMessageBox mb(QMessageBox::Information,
+                   tr("Diff with unmodified"),
+                   tr("Modified rows: %1\nInserted rows: %2\nDeleted rows: %3\nModified cells: %4\nChanged header names: %5\n\nModified cells and inserted rows have been selected.")
+                        .arg(diff.modifiedRowCount())
+                        .arg(diff.insertedRowCount())
+                        .arg(diff.deletedRowCount())
+                        .arg(diff.modifiedCells().size())
+                        .arg(nChangedHeaderCount));
+    auto sPatch = ostrmPatch.str();
+    if (sPatch.size() > nMaxPatchLength)
+    {
+        sPatch.resize(nMaxPatchLength);
+        sPatch += "\n...";
+    }
+    mb.setDetailedText(QString::fromUtf8(sPatch.c_str()));
+    mb.addButton(QMessageBox::Ok);
+    auto pExternalButton = mb.addButton(tr("Open in diff viewer..."), QMessageBox::ActionRole);
+    mb.exec();
+    if (mb.clickedButton() == pExternalButton)
+        return diffWithUnmodifiedInExternalViewer();
+    return true;
+}
+
+bool DFG_CLASS_NAME(CsvTableView)::diffWithUnmodifiedInExternalViewer()
 {
     const char szTempFileNameTemplate[] = "dfgqtCTV"; // static part for temporary filenames.
     auto dataModelPtr = csvModel();
@@ -3043,6 +3227,7 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewBasicSelectionAnalyzer)::anal
         return;
     }
 
+    DFG_PROFILE_ZONE("CsvTableViewBasicSelectionAnalyzer::analyze");
     const auto maxTime = uiPanel->getMaxTimeInSeconds();
     const auto enabled = (!DFG_MODULE_NS(math)::isNan(maxTime) &&  maxTime > 0);
     DFG_MODULE_NS(func)::DFG_CLASS_NAME(MemFuncMinMax)<double> minMaxMf;
@@ -3081,6 +3266,7 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewBasicSelectionAnalyzer)::anal
             });
         }
         const auto elapsedTime = operationTimer.elapsedWallSeconds();
+        DFG_PROFILE_COUNTER("CsvTableViewBasicSelectionAnalyzer::analyze cells", avgMf.callCount() + static_cast<size_t>(nExcluded));
         if (completionStatus == CompletionStatus_started)
             completionStatus = CompletionStatus_completed;
         uiPanel->onEvaluationEnded(elapsedTime, completionStatus);
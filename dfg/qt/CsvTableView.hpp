@@ -26,6 +26,11 @@ namespace DFG_ROOT_NS
     class DFG_CLASS_NAME(CsvFormatDefinition);
 }
 
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(cont)
+{
+    class DFG_CLASS_NAME(CellBlockJournalMemoryBudget);
+}} // module namespace
+
 DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 {
     class DFG_CLASS_NAME(CsvItemModel);
@@ -108,6 +113,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         typedef DFG_CLASS_NAME(CsvTableView) ThisClass;
         typedef DFG_CLASS_NAME(CsvItemModel) CsvModel;
         typedef DFG_CLASS_NAME(StringMatchDefinition) StringMatchDef;
+        typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(CellBlockJournalMemoryBudget) UndoMemoryBudget;
 
         enum ModelIndexType
         {
@@ -125,6 +131,9 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 
         void setExternalUndoStack(QUndoStack* pUndoStack);
 
+        // Returns memory budget shared by undo commands of this view; once exceeded, undo data gets stored to temporary files.
+        std::shared_ptr<UndoMemoryBudget> undoMemoryBudget();
+
         void setModel(QAbstractItemModel* pModel) override;
         CsvModel* csvModel();
         const CsvModel* csvModel() const;
@@ -344,6 +353,12 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 
         bool getProceedConfirmationFromUserIfInModifiedState(const QString& sTranslatedActionDescription);
 
+        // Copies selection to clipboard if it is a single rectangular range. Returns false if selection is not supported and nothing was copied.
+        bool copyRectangularSelectionFast();
+
+        // Saves current table to temporary file and opens it with the unmodified file in external diff viewer defined by property diffProgPath.
+        bool diffWithUnmodifiedInExternalViewer();
+
     public:
         std::unique_ptr<DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TorRef)<QUndoStack>> m_spUndoStack;
         QStringList m_tempFilePathsToRemoveOnExit;
@@ -353,6 +368,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         std::vector<std::shared_ptr<DFG_CLASS_NAME(CsvTableViewSelectionAnalyzer)>> m_selectionAnalyzers;
         std::unique_ptr<QMenu> m_spResizeColumnsMenu;
         bool m_bUndoEnabled;
+        std::shared_ptr<UndoMemoryBudget> m_spUndoMemoryBudget;
     };
 
     template <class Func_T>
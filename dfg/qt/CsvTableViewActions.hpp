@@ -8,8 +8,10 @@ DFG_BEGIN_INCLUDE_QT_HEADERS
 #include <QAbstractProxyModel>
 #include <QApplication>
 #include <QClipboard>
+#include <QMessageBox>
 DFG_END_INCLUDE_QT_HEADERS
 
+#include <functional>
 #include <unordered_map>
 
 #include "../io/DelimitedTextReader.hpp"
@@ -17,6 +19,8 @@ DFG_END_INCLUDE_QT_HEADERS
 #include "qtBasic.hpp"
 #include "tableViewUndoCommands.hpp"
 #include "../cont/table.hpp"
+#include "../cont/tableCsv.hpp"
+#include "../cont/CellBlockJournal.hpp"
 
 DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 {
@@ -63,28 +67,42 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 
     namespace DFG_DETAIL_NS
     {
-        typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableSz)<char, int, DFG_MODULE_NS(io)::encodingUTF8> CellMemory;
+        // Compact storage for cell contents; uses memory budget of the view and stores data to temporary file if budget gets exceeded.
+        typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(CellBlockJournal)<int> CellMemory;
 
         static void storeCells(CellMemory& cellMemory, DFG_CLASS_NAME(CsvTableView)& rView)
         {
-            // TODO: getting selected items as a list can be slow and take huge amount of memory -> improve.
-            const QModelIndexList& selected = rView.getSelectedItemIndexes_dataModel();
             auto pModel = rView.csvModel();
             if (!pModel)
                 return;
-            for (auto iter = selected.begin(); iter != selected.end(); ++iter)
+            // Selection is iterated column by column so cells get stored as compact blocks.
+            rView.forEachCsvModelIndexInSelection([&](const QModelIndex& index, bool& /*bContinue*/)
             {
-                SzPtrUtf8R p = pModel->RawStringPtrAt(iter->row(), iter->column());
-                cellMemory.setElement(iter->row(), iter->column(), (p) ? p : SzPtrUtf8(""));
-            }
+                SzPtrUtf8R p = pModel->RawStringPtrAt(index.row(), index.column());
+                cellMemory.add(index.row(), index.column(), (p) ? p.c_str() : "");
+            });
         }
 
-        static void restoreCells(const CellMemory& cellMemory, DFG_CLASS_NAME(CsvItemModel)& rModel)
+        // Null cells in cellMemory are restored as empty. All cells are set as one batch so that model emits only a single dataChanged-signal.
+        // If cell data can't be read back, failure is shown to user and rCommand is marked obsolete since it can't be undone/redone correctly.
+        static void restoreCells(const CellMemory& cellMemory, DFG_CLASS_NAME(CsvItemModel)& rModel, QUndoCommand& rCommand)
         {
-            cellMemory.forEachNonNullCell([&](const int nRow, const int nCol, SzPtrUtf8R tpsz)
+            bool bSuccess = true;
+            rModel.batchSetDataNoUndo([&](const std::function<void(int, int, SzPtrUtf8R)>& setter)
             {
-                rModel.setDataNoUndo(nRow, nCol, tpsz);
+                bSuccess = cellMemory.forEachCell([&](const int nRow, const int nCol, const char* psz, size_t /*nLength*/)
+                {
+                    setter(nRow, nCol, SzPtrUtf8R((psz) ? psz : ""));
+                });
             });
+            if (bSuccess)
+                return;
+            QMessageBox::information(nullptr,
+                                     QObject::tr("Undo/redo failed"),
+                                     QObject::tr("Failed to read cell data of '%1' from temporary file; table content may be incomplete.").arg(rCommand.text()));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+            rCommand.setObsolete(true);
+#endif
         }
 
     } // namespace DFG_DETAIL_NS
@@ -101,6 +119,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
             m_pView(&rTableView),
             m_pCsvModel(rTableView.csvModel()),
             m_pProxyModel(pProxyModel),
+            m_cellMemory((bRowMode) ? nullptr : rTableView.undoMemoryBudget()),
             m_bRowMode(bRowMode)
         {
             if (!m_pView || !m_pCsvModel)
@@ -170,7 +189,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
             else // cell mode
             {
                 if (m_pCsvModel)
-                    DFG_DETAIL_NS::restoreCells(m_cellMemory, *m_pCsvModel);
+                    DFG_DETAIL_NS::restoreCells(m_cellMemory, *m_pCsvModel, *this);
             }
 
         }
@@ -196,7 +215,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
                 if (!m_pCsvModel)
                     return;
                 const auto pszEmpty = SzPtrUtf8("");
-                m_cellMemory.forEachNonNullCell([=](const int nRow, const int nCol, DFG_CLASS_NAME(Dummy))
+                m_cellMemory.forEachCell([=](const int nRow, const int nCol, const char* /*psz*/, size_t /*nLength*/)
                 {
                     m_pCsvModel->setDataNoUndo(nRow, nCol, pszEmpty);
                 });
@@ -241,7 +260,9 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
     public:
         DFG_CLASS_NAME(CsvTableViewActionPaste)(DFG_CLASS_NAME(CsvTableView)* pView)
             : m_pView(pView),
-              m_nWhere(0)
+              m_nWhere(0),
+              m_cellMemoryUndo((pView) ? pView->undoMemoryBudget() : nullptr),
+              m_cellMemoryRedo((pView) ? pView->undoMemoryBudget() : nullptr)
         {
             m_bRowMode = (m_pView) ? m_pView->isRowMode() : false;
 
@@ -296,18 +317,36 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
                     return;
                 }
 
-                QTextStream strm(&sText, QIODevice::ReadOnly);
-                DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextReader)::read<wchar_t>(strm, '\t', '"', '\n', [&](const size_t nRow, const size_t nCol, const wchar_t* const p, const size_t nSize)
+                // Parsing clipboard content as UTF-8 to a staging table from which cells are stored to cell memories column by column.
+                typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableCsv)<char, int> StagingTable;
+                StagingTable stagingTable;
+                {
+                    const auto utf8Bytes = sText.toUtf8();
+                    sText.clear();
+                    stagingTable.readFromMemory(utf8Bytes.data(), static_cast<size_t>(utf8Bytes.size()),
+                                                StagingTable::CsvFormatDefinition('\t', '"', DFG_MODULE_NS(io)::EndOfLineTypeN, DFG_MODULE_NS(io)::encodingUTF8));
+                }
+                const int nViewRowCount = pViewModel->rowCount();
+                const int nViewColCount = pViewModel->columnCount();
+                stagingTable.forEachFwdColumnIndex([&](const int nCol)
                 {
-                    const auto indexTarget = m_pView->mapToDataModel(pViewModel->index(viewModelIndex.row() + static_cast<int>(nRow),
-                                                                                                       viewModelIndex.column() + static_cast<int>(nCol)));
-                    if (!indexTarget.isValid())
+                    const int nViewCol = viewModelIndex.column() + nCol;
+                    if (nViewCol >= nViewColCount)
                         return;
-                    const auto nTargetRow = indexTarget.row();
-                    const auto nTargetCol = indexTarget.column();
-                    m_cellMemoryUndo.setElement(nTargetRow, nTargetCol, pModel->RawStringPtrAt(nTargetRow, nTargetCol));
-                    const int intSize = (nSize < NumericTraits<int>::maxValue) ? static_cast<int>(nSize) : NumericTraits<int>::maxValue;
-                    m_cellMemoryRedo.setElement(nTargetRow, nTargetCol, SzPtrUtf8R(QString::fromWCharArray(p, intSize).toUtf8().data())); // TODO: Should not need to create a temporary QString for wchar_t -> UTF8 transform.
+                    stagingTable.forEachFwdRowInColumn(nCol, [&](const int nRow, const StagingTable::SzPtrR psz)
+                    {
+                        const int nViewRow = viewModelIndex.row() + nRow;
+                        if (nViewRow >= nViewRowCount)
+                            return;
+                        const auto indexTarget = m_pView->mapToDataModel(pViewModel->index(nViewRow, nViewCol));
+                        if (!indexTarget.isValid())
+                            return;
+                        const auto nTargetRow = indexTarget.row();
+                        const auto nTargetCol = indexTarget.column();
+                        const auto pExisting = pModel->RawStringPtrAt(nTargetRow, nTargetCol);
+                        m_cellMemoryUndo.add(nTargetRow, nTargetCol, (pExisting) ? pExisting.c_str() : nullptr);
+                        m_cellMemoryRedo.add(nTargetRow, nTargetCol, toCharPtr_raw(psz));
+                    });
                 });
 
                 QString sDesc;
@@ -324,7 +363,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
             if (m_bRowMode)
                 pModel->removeRows(m_nWhere, static_cast<int>(m_vecLines.size()));
             else if (pModel) // case: cell mode
-                DFG_DETAIL_NS::restoreCells(m_cellMemoryUndo, *pModel);
+                DFG_DETAIL_NS::restoreCells(m_cellMemoryUndo, *pModel, *this);
         }
         void redo()
         {
@@ -359,7 +398,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
             }
             else
             {
-                DFG_DETAIL_NS::restoreCells(m_cellMemoryRedo, *pModel);
+                DFG_DETAIL_NS::restoreCells(m_cellMemoryRedo, *pModel, *this);
             }
         }
     private:
@@ -0,0 +1,304 @@
+#include "CsvTableViewSortFilterProxyModel.hpp"
+#include "CsvItemModel.hpp"
+#include "../dfgBase.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <algorithm>
+
+namespace
+{
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::ColumnFilterContainer ColumnFilterContainer;
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::FilterCombineMode FilterCombineMode;
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel)::DataTable DataTable;
+
+    const int gnMinRowsPerThread = 20000;
+
+    // Evaluates filters for rows [nRowBegin, nRowEnd[ and writes result to pAccept[0, nRowEnd - nRowBegin[.
+    // If bRefineOnly is true, rows whose pAccept-flag is false are not evaluated and remain rejected.
+    void evaluateRowRange(const DataTable& table,
+                          const int nColCount,
+                          const ColumnFilterContainer& filters,
+                          const FilterCombineMode combineMode,
+                          const int nRowBegin,
+                          const int nRowEnd,
+                          char* pAccept,
+                          const bool bRefineOnly)
+    {
+        typedef DFG_ROOT_NS::DFG_CLASS_NAME(StringViewUtf8) StringViewUtf8;
+        const bool bAndMode = (combineMode == DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::FilterCombineModeAnd);
+        const auto nCount = static_cast<size_t>(nRowEnd - nRowBegin);
+        std::vector<char> prevAccept;
+        if (bRefineOnly)
+            prevAccept.assign(pAccept, pAccept + nCount);
+        const auto isEvaluated = [&](const int r) { return !bRefineOnly || prevAccept[static_cast<size_t>(r - nRowBegin)] != 0; };
+        std::fill(pAccept, pAccept + nCount, (bAndMode) ? 1 : 0);
+
+        std::vector<char> filterMatches(nCount);
+        std::vector<int> presentCellCounts;
+        for (const auto& filter : filters)
+        {
+            const auto& matcher = filter.m_matcher;
+            const bool bMatchesEmpty = matcher.isMatchWith(StringViewUtf8());
+            if (!filter.isAnyColumn())
+            {
+                // Rows that have no cell in the column behave like empty cells.
+                std::fill(filterMatches.begin(), filterMatches.end(), (bMatchesEmpty) ? 1 : 0);
+                table.forEachFwdRowInColumn(filter.m_nColumn, nRowBegin, nRowEnd, [&](const int r, DataTable::SzPtrR psz)
+                {
+                    if (isEvaluated(r))
+                        filterMatches[static_cast<size_t>(r - nRowBegin)] = matcher.isMatchWith(StringViewUtf8(psz));
+                });
+            }
+            else
+            {
+                std::fill(filterMatches.begin(), filterMatches.end(), 0);
+                if (bMatchesEmpty)
+                    presentCellCounts.assign(nCount, 0);
+                for (int c = 0; c < nColCount; ++c)
+                {
+                    table.forEachFwdRowInColumn(c, nRowBegin, nRowEnd, [&](const int r, DataTable::SzPtrR psz)
+                    {
+                        const auto i = static_cast<size_t>(r - nRowBegin);
+                        if (bMatchesEmpty)
+                            ++presentCellCounts[i];
+                        if (!filterMatches[i] && isEvaluated(r) && matcher.isMatchWith(StringViewUtf8(psz)))
+                            filterMatches[i] = 1;
+                    });
+                }
+                if (bMatchesEmpty)
+                {
+                    // Row that has cells missing has empty cells and thus matches.
+                    for (size_t i = 0; i < nCount; ++i)
+                    {
+                        if (presentCellCounts[i] < nColCount)
+                            filterMatches[i] = 1;
+                    }
+                }
+            }
+            for (size_t i = 0; i < nCount; ++i)
+            {
+                if (bAndMode)
+                    pAccept[i] = pAccept[i] && filterMatches[i];
+                else
+                    pAccept[i] = pAccept[i] || filterMatches[i];
+            }
+        }
+        if (bRefineOnly)
+        {
+            for (size_t i = 0; i < nCount; ++i)
+                pAccept[i] = pAccept[i] && prevAccept[i];
+        }
+    }
+
+    // Removes filters with empty match string.
+    ColumnFilterContainer activeFilters(ColumnFilterContainer filters)
+    {
+        typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::ColumnFilter ColumnFilter;
+        filters.erase(std::remove_if(filters.begin(), filters.end(), [](const ColumnFilter& f) { return !f.m_matcher.hasMatchString(); }), filters.end());
+        return filters;
+    }
+} // unnamed namespace
+
+DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)(QObject* pParent)
+    : BaseClass(pParent)
+    , m_combineMode(FilterCombineModeAnd)
+{
+}
+
+DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::~DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)()
+{
+}
+
+auto DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::csvModel() const -> DFG_CLASS_NAME(CsvItemModel)*
+{
+    return qobject_cast<DFG_CLASS_NAME(CsvItemModel)*>(sourceModel());
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::setSourceModel(QAbstractItemModel* pSourceModel)
+{
+    for (const auto& connection : m_sourceConnections)
+        disconnect(connection);
+    m_sourceConnections.clear();
+    m_rowAcceptCache.clear();
+
+    // Connecting before calling base class implementation so that cache gets updated before base class handles the signals,
+    // i.e. when base class filters rows after structural change, it uses the rebuilt cache.
+    if (pSourceModel)
+    {
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::dataChanged, this, &ThisClass::onSourceDataChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::rowsAboutToBeInserted, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::rowsAboutToBeMoved, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::columnsAboutToBeInserted, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::columnsAboutToBeRemoved, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::columnsAboutToBeMoved, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &ThisClass::onSourceStructureAboutToChange));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::rowsInserted, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::rowsRemoved, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::rowsMoved, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::columnsInserted, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::columnsRemoved, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::columnsMoved, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::layoutChanged, this, &ThisClass::onSourceStructureChanged));
+        m_sourceConnections.push_back(connect(pSourceModel, &QAbstractItemModel::modelReset, this, &ThisClass::onSourceModelReset));
+    }
+
+    BaseClass::setSourceModel(pSourceModel);
+
+    if (hasActiveFilters())
+    {
+        rebuildRowAcceptCache(false);
+        invalidateFilter();
+    }
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::setColumnFilters(ColumnFilterContainer filters, const FilterCombineMode combineMode)
+{
+    filters = activeFilters(std::move(filters));
+    const bool bRefine = !m_rowAcceptCache.empty() && isKnownRefinementOfCurrent(filters, combineMode);
+    m_filters = std::move(filters);
+    m_combineMode = combineMode;
+    rebuildRowAcceptCache(bRefine);
+    invalidateFilter();
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::setColumnFilter(StringMatchDef matcher, const int nColumn)
+{
+    ColumnFilterContainer filters;
+    filters.push_back(ColumnFilter(std::move(matcher), nColumn));
+    setColumnFilters(std::move(filters), FilterCombineModeAnd);
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::clearColumnFilters()
+{
+    setColumnFilters(ColumnFilterContainer());
+}
+
+bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::isKnownRefinementOfCurrent(const ColumnFilterContainer& newFilters, const FilterCombineMode newMode) const
+{
+    if (m_filters.empty() || newFilters.size() != m_filters.size() || newMode != m_combineMode)
+        return false;
+    for (size_t i = 0; i < newFilters.size(); ++i)
+    {
+        if (newFilters[i].m_nColumn != m_filters[i].m_nColumn || !newFilters[i].m_matcher.isKnownToMatchSubsetOf(m_filters[i].m_matcher))
+            return false;
+    }
+    return true;
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::invalidateRowAcceptCache()
+{
+    m_rowAcceptCache.clear();
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::rebuildRowAcceptCache(const bool bRefineOnly)
+{
+    auto pCsvModel = csvModel();
+    if (!pCsvModel || !hasActiveFilters())
+    {
+        invalidateRowAcceptCache();
+        return;
+    }
+
+    const auto nRowCount = pCsvModel->getRowCount();
+    const auto nColCount = pCsvModel->getColumnCount();
+    if (!bRefineOnly || m_rowAcceptCache.size() != static_cast<size_t>(nRowCount))
+        m_rowAcceptCache.assign(static_cast<size_t>(nRowCount), 1);
+    if (nRowCount <= 0)
+        return;
+
+    const auto& table = pCsvModel->m_table;
+    auto& pool = DFG_MODULE_NS(thread)::defaultThreadPool();
+    const auto nThreadCount = Max(1, Min(static_cast<int>(pool.threadCount()), nRowCount / gnMinRowsPerThread));
+    const auto nRowsPerThread = nRowCount / nThreadCount;
+
+    // Each chunk gets its own copy of filters since matchers are not guaranteed to be safe to use concurrently.
+    DFG_MODULE_NS(thread)::parallelFor(pool, 0, static_cast<size_t>(nThreadCount), 1, [&](const size_t i0, const size_t i1)
+    {
+        for (size_t i = i0; i < i1; ++i)
+        {
+            const auto nChunk = static_cast<int>(i);
+            const ColumnFilterContainer filters = m_filters;
+            const auto nBegin = nChunk * nRowsPerThread;
+            const auto nEnd = (nChunk + 1 == nThreadCount) ? nRowCount : nBegin + nRowsPerThread;
+            evaluateRowRange(table, nColCount, filters, m_combineMode, nBegin, nEnd, m_rowAcceptCache.data() + nBegin, bRefineOnly);
+        }
+    });
+}
+
+bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::isRowAcceptedUncached(const int nSourceRow) const
+{
+    const bool bAndMode = (m_combineMode == FilterCombineModeAnd);
+    auto pCsvModel = csvModel();
+    auto pSource = sourceModel();
+    if (!pSource)
+        return true;
+    const auto nColCount = pSource->columnCount();
+    const auto isCellMatch = [&](const StringMatchDef& matcher, const int nCol)
+    {
+        if (pCsvModel)
+            return matcher.isMatchWith(DFG_CLASS_NAME(StringViewUtf8)(pCsvModel->m_table(nSourceRow, nCol)));
+        else
+            return matcher.isMatchWith(pSource->data(pSource->index(nSourceRow, nCol)).toString());
+    };
+    for (const auto& filter : m_filters)
+    {
+        bool bMatch = false;
+        if (!filter.isAnyColumn())
+            bMatch = isCellMatch(filter.m_matcher, filter.m_nColumn);
+        else
+        {
+            for (int c = 0; c < nColCount && !bMatch; ++c)
+                bMatch = isCellMatch(filter.m_matcher, c);
+        }
+        if (bAndMode && !bMatch)
+            return false;
+        if (!bAndMode && bMatch)
+            return true;
+    }
+    return bAndMode;
+}
+
+bool DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::filterAcceptsRow(const int nSourceRow, const QModelIndex& sourceParent) const
+{
+    DFG_UNUSED(sourceParent);
+    if (!hasActiveFilters())
+        return true;
+    if (isValidIndex(m_rowAcceptCache, nSourceRow))
+        return m_rowAcceptCache[static_cast<size_t>(nSourceRow)] != 0;
+    return isRowAcceptedUncached(nSourceRow);
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (m_rowAcceptCache.empty() || !topLeft.isValid() || !bottomRight.isValid())
+        return;
+    const auto nFirst = topLeft.row();
+    const auto nLast = bottomRight.row();
+    if (!isValidIndex(m_rowAcceptCache, nFirst) || !isValidIndex(m_rowAcceptCache, nLast))
+    {
+        rebuildRowAcceptCache(false);
+        return;
+    }
+    for (int r = nFirst; r <= nLast; ++r)
+        m_rowAcceptCache[static_cast<size_t>(r)] = isRowAcceptedUncached(r);
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::onSourceStructureAboutToChange()
+{
+    // Row indexes in cache are no longer valid after structural change; uncached evaluation is used until the rebuild in onSourceStructureChanged().
+    invalidateRowAcceptCache();
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::onSourceStructureChanged()
+{
+    // Called before base class handles the change so the filter pass triggered by it uses the rebuilt cache.
+    if (hasActiveFilters())
+        rebuildRowAcceptCache(false);
+}
+
+void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)::onSourceModelReset()
+{
+    if (hasActiveFilters())
+        rebuildRowAcceptCache(false);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../dfgDefs.hpp"
+#include "qtIncludeHelpers.hpp"
+#include "StringMatchDefinition.hpp"
+#include <vector>
+
+DFG_BEGIN_INCLUDE_QT_HEADERS
+    #include <QSortFilterProxyModel>
+DFG_END_INCLUDE_QT_HEADERS
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
+{
+    class DFG_CLASS_NAME(CsvItemModel);
+
+    // Sort/filter proxy for CsvTableView that supports filtering by multiple columns.
+    // When source model is CsvItemModel, filtering is done directly from the underlying table (UTF-8 data, no QString/QVariant per cell)
+    // and row acceptance is precomputed to a cache in parallel row ranges. When new filter is known to accept a subset of
+    // the previous filter (e.g. typing more characters to substring filter), only previously accepted rows are evaluated.
+    class DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel) : public QSortFilterProxyModel
+    {
+        Q_OBJECT
+
+    public:
+        typedef QSortFilterProxyModel BaseClass;
+        typedef DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel) ThisClass;
+        typedef DFG_CLASS_NAME(StringMatchDefinition) StringMatchDef;
+
+        enum FilterCombineMode
+        {
+            FilterCombineModeAnd, // Row is accepted if all filters match.
+            FilterCombineModeOr   // Row is accepted if any filter matches.
+        };
+
+        class ColumnFilter
+        {
+        public:
+            ColumnFilter(StringMatchDef matcher, const int nColumn)
+                : m_matcher(std::move(matcher))
+                , m_nColumn(nColumn)
+            {}
+
+            bool isAnyColumn() const { return m_nColumn < 0; }
+
+            StringMatchDef m_matcher;
+            int m_nColumn; // Negative value means 'any column'.
+        }; // class ColumnFilter
+
+        typedef std::vector<ColumnFilter> ColumnFilterContainer;
+
+        DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)(QObject* pParent = nullptr);
+        ~DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel)() DFG_OVERRIDE_DESTRUCTOR;
+
+        // Sets filters. Filters with empty match string are ignored; if there are no active filters, all rows are accepted.
+        void setColumnFilters(ColumnFilterContainer filters, FilterCombineMode combineMode = FilterCombineModeAnd);
+
+        // Convenience function for setting a single filter.
+        void setColumnFilter(StringMatchDef matcher, int nColumn);
+
+        void clearColumnFilters();
+
+        const ColumnFilterContainer& columnFilters() const { return m_filters; }
+        FilterCombineMode filterCombineMode() const { return m_combineMode; }
+
+        void setSourceModel(QAbstractItemModel* pSourceModel) override;
+
+    protected:
+        bool filterAcceptsRow(int nSourceRow, const QModelIndex& sourceParent) const override;
+
+    private:
+        DFG_CLASS_NAME(CsvItemModel)* csvModel() const;
+
+        // Evaluates given row without using cache.
+        bool isRowAcceptedUncached(int nSourceRow) const;
+
+        // Rebuilds acceptance cache. If bRefineOnly is true, only rows accepted in current cache are evaluated.
+        void rebuildRowAcceptCache(bool bRefineOnly);
+
+        void invalidateRowAcceptCache();
+
+        bool hasActiveFilters() const { return !m_filters.empty(); }
+
+        // Returns true if 'newFilters' is known to accept subset of rows accepted by current filters.
+        bool isKnownRefinementOfCurrent(const ColumnFilterContainer& newFilters, FilterCombineMode newMode) const;
+
+        void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+        void onSourceStructureAboutToChange();
+        void onSourceStructureChanged();
+        void onSourceModelReset();
+
+        ColumnFilterContainer m_filters;
+        FilterCombineMode m_combineMode;
+        std::vector<char> m_rowAcceptCache; // If non-empty, m_rowAcceptCache[r] tells whether source row r is accepted.
+        std::vector<QMetaObject::Connection> m_sourceConnections;
+    }; // class CsvTableViewSortFilterProxyModel
+
+}} // module namespace
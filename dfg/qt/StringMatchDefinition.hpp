@@ -52,31 +52,66 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
             if (!m_sSimpleSubStringMatch.empty())
             {
                 const auto& rawSubString = m_sSimpleSubStringMatch.rawStorage();
-                return rawSubString.size() <= sv.size()
-                       &&
-                       std::search(sv.beginRaw(), sv.endRaw(),
-                                   rawSubString.cbegin(), rawSubString.cend()
-                                    ) != sv.endRaw();
+                if (rawSubString.size() > sv.size())
+                    return false;
+                if (m_caseSensitivity == Qt::CaseSensitive)
+                {
+                    return std::search(sv.beginRaw(), sv.endRaw(),
+                                       rawSubString.cbegin(), rawSubString.cend()
+                                       ) != sv.endRaw();
+                }
+                // Case insensitive search with ASCII-only search string: if input is ASCII as well, ASCII case folding is enough.
+                // Non-ASCII input goes through QString since e.g. Kelvin sign folds to ASCII 'k'.
+                if (std::all_of(sv.beginRaw(), sv.endRaw(), [](const char c) { return static_cast<unsigned char>(c) < 0x80; }))
+                {
+                    return std::search(sv.beginRaw(), sv.endRaw(),
+                                       rawSubString.cbegin(), rawSubString.cend(),
+                                       [](const char a, const char b) { return asciiToLower(a) == b; }
+                                       ) != sv.endRaw();
+                }
             }
-            else
-                return isMatchWith(QString::fromUtf8(sv.dataRaw(), static_cast<int>(sv.length())));
+            return isMatchWith(QString::fromUtf8(sv.dataRaw(), static_cast<int>(sv.length())));
+        }
+
+        // Returns true if it is known that every string matched by 'this' is also matched by 'other',
+        // e.g. when both are substring matches and the search string of 'this' contains the search string of 'other'.
+        // Note: false does not mean that 'this' would match strings that 'other' does not match.
+        bool isKnownToMatchSubsetOf(const DFG_CLASS_NAME(StringMatchDefinition)& other) const
+        {
+            return m_bIsSubStringPattern
+                   && other.m_bIsSubStringPattern
+                   && !other.m_matchString.isEmpty()
+                   && m_caseSensitivity == other.m_caseSensitivity
+                   && m_matchString.contains(other.m_matchString, m_caseSensitivity);
         }
 
+        const QString& matchString() const { return m_matchString; }
+        Qt::CaseSensitivity caseSensitivity() const { return m_caseSensitivity; }
+        QRegExp::PatternSyntax patternSyntax() const { return m_patternSyntax; }
+
     private:
+        static char asciiToLower(const char c)
+        {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
         void initCache()
         {
             m_regExp = QRegExp(m_matchString, m_caseSensitivity, m_patternSyntax);
 
-            const auto isSpecialWildcardChar = [](const QChar& c) { return c == '*' || c == '?' || c == '[' || c == ']'; };
+            const bool bIsWildcardUnix = (m_patternSyntax == QRegExp::WildcardUnix);
+            const auto isSpecialWildcardChar = [&](const QChar& c) { return c == '*' || c == '?' || c == '[' || c == ']' || (bIsWildcardUnix && c == '\\'); };
 
             // TODO: handle other pattern syntaxes as well (e.g. RegExp without special characters could be done with substring matching).
-            const bool bCanDoSubStringMatching = (m_patternSyntax == QRegExp::FixedString)
-                                        ||
-                                        (m_patternSyntax == QRegExp::Wildcard &&
-                                         !std::any_of(m_matchString.cbegin(), m_matchString.cend(), isSpecialWildcardChar));
-            if (bCanDoSubStringMatching)
+            m_bIsSubStringPattern = (m_patternSyntax == QRegExp::FixedString)
+                                    ||
+                                    ((m_patternSyntax == QRegExp::Wildcard || bIsWildcardUnix) &&
+                                     !std::any_of(m_matchString.cbegin(), m_matchString.cend(), isSpecialWildcardChar));
+            const bool bIsAscii = std::all_of(m_matchString.cbegin(), m_matchString.cend(), [](const QChar& c) { return c.unicode() < 0x80; });
+            // Case insensitive utf8 search is implemented with ASCII case folding so it is used only for ASCII search strings.
+            if (m_bIsSubStringPattern && (m_caseSensitivity == Qt::CaseSensitive || bIsAscii))
             {
-                const auto utf8Bytes = m_matchString.toUtf8();
+                const auto utf8Bytes = (m_caseSensitivity == Qt::CaseSensitive) ? m_matchString.toUtf8() : m_matchString.toLower().toUtf8();
                 m_sSimpleSubStringMatch = Utf8String(SzPtrUtf8R(utf8Bytes.cbegin()), SzPtrUtf8R(utf8Bytes.cend()));
             }
             else
@@ -88,7 +123,8 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         Qt::CaseSensitivity m_caseSensitivity;
         QRegExp::PatternSyntax m_patternSyntax;
         QRegExp m_regExp;
-        Utf8String m_sSimpleSubStringMatch; // Stores the utf8-encoded substring to search if applicable. This is an optimization to avoid creating redundant QString-objects.
+        Utf8String m_sSimpleSubStringMatch; // Stores the utf8-encoded substring to search if applicable (lowercase if case insensitive). This is an optimization to avoid creating redundant QString-objects.
+        bool m_bIsSubStringPattern; // True iff matching is equivalent to plain substring search of m_matchString.
     }; // class StringMatchDefinition
 
 }} // Module namespace
@@ -1,6 +1,7 @@
 #include "TableEditor.hpp"
 #include "CsvTableView.hpp"
 #include "CsvItemModel.hpp"
+#include "CsvTableViewSortFilterProxyModel.hpp"
 
 #include "connectHelper.hpp"
 #include "PropertyHelper.hpp"
@@ -724,9 +725,9 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(TableEditor)::onFilterTextChanged(const Q
     if (!m_spFilterPanel)
         return;
 
-    // Setting edit readonly as setFilterRegExp() may change selection which, at the time of writing, launched
+    // Setting edit readonly as setting filter may change selection which, at the time of writing, launched
     // event loop and if user edited the filter text while at it, this function would get called in re-entrant manner
-    // causing a crash in setFilterRegExp().
+    // causing a crash in filter setting.
     auto readOnlyGuard = makeScopedCaller( [&]() { m_spFilterPanel->m_pTextEdit->setReadOnly(true); },
                                            [&]() { m_spFilterPanel->m_pTextEdit->setReadOnly(false); });
 
@@ -735,9 +736,8 @@ void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(TableEditor)::onFilterTextChanged(const Q
     if (!pProxy || !m_spFilterPanel)
         return;
 
-    QRegExp regExp(text, m_spFilterPanel->getCaseSensitivity(), m_spFilterPanel->getPatternSyntax());
-    pProxy->setFilterRegExp(regExp);
-    pProxy->setFilterKeyColumn(m_spFilterPanel->m_pColumnSelector->value());
+    DFG_CLASS_NAME(StringMatchDefinition) matchDef(text, m_spFilterPanel->getCaseSensitivity(), m_spFilterPanel->getPatternSyntax());
+    pProxy->setColumnFilter(matchDef, m_spFilterPanel->m_pColumnSelector->value());
 }
 
 void DFG_MODULE_NS(qt)::DFG_CLASS_NAME(TableEditor)::onFindColumnChanged(const int newCol)
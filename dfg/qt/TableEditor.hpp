@@ -20,7 +20,6 @@ class QItemSelection;
 class QLabel;
 class QLineEdit;
 class QMenu;
-class QSortFilterProxyModel;
 class QToolBar;
 class QSplitter;
 
@@ -28,6 +27,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 {
     class DFG_CLASS_NAME(CsvTableView);
     class DFG_CLASS_NAME(CsvItemModel);
+    class DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel);
 
     namespace DFG_DETAIL_NS
     {
@@ -51,7 +51,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
         typedef QWidget BaseClass;
         typedef DFG_CLASS_NAME(TableEditor) ThisClass;
         typedef DFG_CLASS_NAME(CsvItemModel) ModelClass;
-        typedef QSortFilterProxyModel ProxyModelClass;
+        typedef DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel) ProxyModelClass;
         typedef DFG_CLASS_NAME(CsvTableView) ViewClass;
 
         enum ColumnResizeStyle
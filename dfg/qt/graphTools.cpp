@@ -5,7 +5,11 @@
 #include "../cont/MapVector.hpp"
 
 #include "../func/memFunc.hpp"
+#include "../hash/xxHash64.hpp"
 #include "../str/format_fmt.hpp"
+#include "../dataAnalysis/decimate.hpp"
+#include "../isValidIndex.hpp"
+#include "../numericTypeTools.hpp"
 
 DFG_BEGIN_INCLUDE_QT_HEADERS
     #include <QWidget>
@@ -14,6 +18,10 @@ DFG_BEGIN_INCLUDE_QT_HEADERS
     #include <QComboBox>
     #include <QLabel>
     #include <QSplitter>
+    #include <QEventLoop>
+    #include <QThread>
+    #include <QTimer>
+    #include <QPointer>
 
 #if defined(DFG_ALLOW_QT_CHARTS) && (DFG_ALLOW_QT_CHARTS == 1)
     #include <QtCharts>
@@ -29,6 +37,10 @@ DFG_END_INCLUDE_QT_HEADERS
 #include <QJsonDocument>
 #include <QVariantMap>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 DFG_ROOT_NS_BEGIN { DFG_SUB_NS(qt)
 {
 
@@ -97,6 +109,15 @@ public:
     virtual ~XySeries() {}
     virtual void setOrAppend(const DataSourceIndex, const double, const double) = 0;
     virtual void resize(const DataSourceIndex) = 0;
+
+    // Replaces all points of the series. Default implementation sets points one by one.
+    virtual void setValues(const std::vector<double>& xVals, const std::vector<double>& yVals)
+    {
+        const auto nSize = Min(xVals.size(), yVals.size());
+        for (size_t i = 0; i < nSize; ++i)
+            setOrAppend(i, xVals[i], yVals[i]);
+        resize(nSize);
+    }
 }; // Class XySeries
 
 #if defined(DFG_ALLOW_QT_CHARTS) && (DFG_ALLOW_QT_CHARTS == 1)
@@ -135,6 +156,19 @@ public:
         }
     }
 
+    void setValues(const std::vector<double>& xVals, const std::vector<double>& yVals) override
+    {
+        auto pXySeries = getXySeries();
+        if (!pXySeries)
+            return;
+        const auto nSize = Min(xVals.size(), yVals.size());
+        QVector<QPointF> points;
+        points.reserve(static_cast<int>(nSize));
+        for (size_t i = 0; i < nSize; ++i)
+            points.push_back(QPointF(xVals[i], yVals[i]));
+        pXySeries->replace(points); // Single replace instead of per-point calls that would each trigger series update.
+    }
+
     QXYSeries* getXySeries()
     {
         return qobject_cast<QXYSeries*>(m_spXySeries.data());
@@ -253,6 +287,236 @@ public:
 }; // ChartCanvasQtChart
 #endif // #if defined(DFG_ALLOW_QT_CHARTS) && (DFG_ALLOW_QT_CHARTS == 1)
 
+// Stores parsed values of table selection columns so that on refresh, cells whose text hasn't changed don't need to be parsed again.
+class GraphColumnDataCache
+{
+public:
+    class ColumnData
+    {
+    public:
+        void clear()
+        {
+            m_rows.clear();
+            m_textHashes.clear();
+            m_textLengths.clear();
+            m_values.clear();
+        }
+
+        std::vector<int> m_rows;            // Source row of each entry, ascending after update().
+        std::vector<uint64> m_textHashes;   // 64-bit hash of the text from which value was parsed; text is considered unchanged if both hash and length match.
+        std::vector<int> m_textLengths;     // Length of the text from which value was parsed.
+        std::vector<double> m_values;       // Parsed like QString::toDouble(), i.e. 0 if text couldn't be parsed as a number.
+    }; // class ColumnData
+
+    // Cell texts of table selection. Taken in GUI thread so that parsing can be done in worker thread without accessing the source or its model.
+    class SelectionSnapshot
+    {
+    public:
+        std::vector<int> m_rows;
+        std::vector<DataSourceIndex> m_columns;
+        std::vector<QString> m_texts;
+    }; // class SelectionSnapshot
+
+    typedef DFG_MODULE_NS(cont)::MapVectorSoA<DataSourceIndex, ColumnData> ColumnMap;
+
+    GraphColumnDataCache() :
+        m_nReusedCount(0),
+        m_nParsedCount(0)
+    {}
+
+    // Copies selected cells of source to snapshot. Must be called from the thread that owns the source (i.e. GUI thread).
+    static void takeSnapshot(GraphDataSource& source, SelectionSnapshot& snapshot)
+    {
+        source.forEachElement_fromTableSelection([&](const DataSourceIndex r, const DataSourceIndex c, const QVariant& val)
+        {
+            snapshot.m_rows.push_back(static_cast<int>(r));
+            snapshot.m_columns.push_back(c);
+            snapshot.m_texts.push_back(val.toString());
+        });
+    }
+
+    // Replaces existing content with cells of snapshot taken from source identified by sourceId.
+    // Values of cells whose (row, column, text) matches previous content are not parsed again. Does not access the source so can be called from worker thread.
+    void update(const GraphDataSourceId& sourceId, const SelectionSnapshot& snapshot)
+    {
+        if (sourceId != m_sourceId)
+        {
+            m_columns.clear();
+            m_sourceId = sourceId;
+        }
+        m_nReusedCount = 0;
+        m_nParsedCount = 0;
+        ColumnMap newColumns;
+        newColumns.setSorting(false);
+        DataSourceIndex nCurrentCol = NumericTraits<DataSourceIndex>::maxValue;
+        ColumnData* pNewColumn = nullptr;
+        const ColumnData* pOldColumn = nullptr;
+        size_t nOldCursor = 0;
+        for (size_t i = 0; i < snapshot.m_texts.size(); ++i)
+        {
+            const auto c = snapshot.m_columns[i];
+            if (c != nCurrentCol || !pNewColumn)
+            {
+                nCurrentCol = c;
+                pNewColumn = &newColumns[c];
+                auto iterOld = m_columns.find(c);
+                pOldColumn = (iterOld != m_columns.end()) ? &iterOld->second : nullptr;
+                nOldCursor = 0;
+            }
+            const int nRow = snapshot.m_rows[i];
+            const QString& sVal = snapshot.m_texts[i];
+            const uint64 nHash = DFG_MODULE_NS(hash)::xxHash64(sVal.constData(), static_cast<size_t>(sVal.size()) * sizeof(QChar));
+            const int nLength = sVal.size();
+            double value = 0;
+            bool bReused = false;
+            if (pOldColumn)
+            {
+                // Typically cells come in the same order as in previous update so checking cursor position before doing binary search.
+                const auto& oldRows = pOldColumn->m_rows;
+                if (!isValidIndex(oldRows, nOldCursor) || oldRows[nOldCursor] != nRow)
+                    nOldCursor = static_cast<size_t>(std::lower_bound(oldRows.begin(), oldRows.end(), nRow) - oldRows.begin());
+                if (isValidIndex(oldRows, nOldCursor) && oldRows[nOldCursor] == nRow
+                    && pOldColumn->m_textHashes[nOldCursor] == nHash && pOldColumn->m_textLengths[nOldCursor] == nLength)
+                {
+                    value = pOldColumn->m_values[nOldCursor];
+                    bReused = true;
+                }
+                ++nOldCursor;
+            }
+            if (bReused)
+                ++m_nReusedCount;
+            else
+            {
+                value = sVal.toDouble(); // Non-numeric cells are plotted as 0 like before caching was introduced.
+                ++m_nParsedCount;
+            }
+            pNewColumn->m_rows.push_back(nRow);
+            pNewColumn->m_textHashes.push_back(nHash);
+            pNewColumn->m_textLengths.push_back(nLength);
+            pNewColumn->m_values.push_back(value);
+        }
+
+        // With multiple selection ranges rows may be unordered or even duplicated; making rows ascending and unique (first occurrence is kept).
+        for (auto iter = newColumns.begin(); iter != newColumns.end(); ++iter)
+            sortAndRemoveDuplicateRows(iter->second);
+        newColumns.setSorting(true);
+        m_columns = std::move(newColumns);
+    }
+
+    static void sortAndRemoveDuplicateRows(ColumnData& column)
+    {
+        const auto& rows = column.m_rows;
+        if (std::adjacent_find(rows.begin(), rows.end(), [](const int a, const int b) { return a >= b; }) == rows.end())
+            return; // Already strictly ascending.
+        std::vector<size_t> order(rows.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return rows[a] < rows[b]; });
+        ColumnData sorted;
+        sorted.m_rows.reserve(order.size());
+        sorted.m_textHashes.reserve(order.size());
+        sorted.m_textLengths.reserve(order.size());
+        sorted.m_values.reserve(order.size());
+        for (const auto i : order)
+        {
+            if (!sorted.m_rows.empty() && sorted.m_rows.back() == rows[i])
+                continue;
+            sorted.m_rows.push_back(rows[i]);
+            sorted.m_textHashes.push_back(column.m_textHashes[i]);
+            sorted.m_textLengths.push_back(column.m_textLengths[i]);
+            sorted.m_values.push_back(column.m_values[i]);
+        }
+        column = std::move(sorted);
+    }
+
+    ColumnMap m_columns;
+    GraphDataSourceId m_sourceId;
+    size_t m_nReusedCount; // Number of values taken from previous content in latest update().
+    size_t m_nParsedCount; // Number of values parsed in latest update().
+}; // class GraphColumnDataCache
+
+namespace
+{
+    // Graph points ready to be given to series.
+    class XyGraphData
+    {
+    public:
+        std::vector<double> m_xVals;
+        std::vector<double> m_yVals;
+        DFG_MODULE_NS(func)::MemFuncMinMax<double> m_minMaxX; // Ranges are from all points, not only from those remaining after decimation.
+        DFG_MODULE_NS(func)::MemFuncMinMax<double> m_minMaxY;
+    };
+
+    // Creates xy-points from cached columns: with one column, x is row and y value; with two columns, x and y are taken pairwise from the columns.
+    // Points with non-finite x or y are skipped. If there are more than 2 * nBucketCount points, they are decimated with per-bucket min/max
+    // where buckets are of equal x-width (or index ranges if x is not ordered, see decimateIndexesMinMaxByX()).
+    void createXyGraphData(const GraphColumnDataCache& cache, const size_t nBucketCount, XyGraphData& data)
+    {
+        const auto& columns = cache.m_columns;
+        std::vector<double> xVals;
+        std::vector<double> yVals;
+        const auto addPoint = [&](const double x, const double y)
+        {
+            if (!std::isfinite(x) || !std::isfinite(y))
+                return;
+            data.m_minMaxX(x);
+            data.m_minMaxY(y);
+            xVals.push_back(x);
+            yVals.push_back(y);
+        };
+        if (columns.size() == 1)
+        {
+            const auto& column = columns.frontValue();
+            xVals.reserve(column.m_values.size());
+            yVals.reserve(column.m_values.size());
+            for (size_t i = 0; i < column.m_values.size(); ++i)
+                addPoint(column.m_rows[i], column.m_values[i]);
+        }
+        else if (columns.size() == 2)
+        {
+            const auto& xColumn = columns.frontValue();
+            const auto& yColumn = columns.backValue();
+            const auto nCount = Min(xColumn.m_values.size(), yColumn.m_values.size());
+            xVals.reserve(nCount);
+            yVals.reserve(nCount);
+            for (size_t i = 0; i < nCount; ++i)
+                addPoint(xColumn.m_values[i], yColumn.m_values[i]);
+        }
+
+        const auto indexes = DFG_MODULE_NS(dataAnalysis)::decimateIndexesMinMaxByX(xVals, yVals, nBucketCount);
+        if (indexes.size() == yVals.size())
+        {
+            data.m_xVals = std::move(xVals);
+            data.m_yVals = std::move(yVals);
+            return;
+        }
+        data.m_xVals.resize(indexes.size());
+        data.m_yVals.resize(indexes.size());
+        for (size_t i = 0; i < indexes.size(); ++i)
+        {
+            data.m_xVals[i] = xVals[indexes[i]];
+            data.m_yVals[i] = yVals[indexes[i]];
+        }
+    }
+
+    // Runs func in a worker thread and processes GUI events until it has finished.
+    template <class Func_T>
+    void runInWorkerThreadAndWait(const QString& sThreadName, Func_T func)
+    {
+        QEventLoop eventLoop;
+        QThread workerThread;
+        workerThread.setObjectName(sThreadName); // Sets thread name visible to debugger.
+        QObject::connect(&workerThread, &QThread::started, [&]()
+                {
+                    func();
+                    workerThread.quit();
+                });
+        QObject::connect(&workerThread, &QThread::finished, &eventLoop, &QEventLoop::quit);
+        workerThread.start();
+        eventLoop.exec();
+    }
+} // unnamed namespace
+
 }} // module namespace
 
 DFG_MODULE_NS(qt)::GraphControlPanel::GraphControlPanel(QWidget *pParent) : BaseClass(pParent)
@@ -288,7 +552,10 @@ auto DFG_MODULE_NS(qt)::GraphDisplay::chart() -> ChartCanvas*
     return m_spChartCanvas.get();
 }
 
-DFG_MODULE_NS(qt)::GraphControlAndDisplayWidget::GraphControlAndDisplayWidget()
+DFG_MODULE_NS(qt)::GraphControlAndDisplayWidget::GraphControlAndDisplayWidget() :
+    m_spColumnDataCache(new GraphColumnDataCache),
+    m_bRefreshInProgress(false),
+    m_bRefreshPending(false)
 {
     auto pLayout = new QGridLayout(this);
     auto pSplitter = new QSplitter(Qt::Vertical, this);
@@ -305,10 +572,29 @@ DFG_MODULE_NS(qt)::GraphControlAndDisplayWidget::GraphControlAndDisplayWidget()
 
 void DFG_MODULE_NS(qt)::GraphControlAndDisplayWidget::refresh()
 {
-    // TODO: re-entrancy guard?
-    // TODO: graph filling should be done in worker thread to avoid GUI freezing.
+    if (m_bRefreshInProgress)
+    {
+        // Events are processed while worker thread is running so refresh may get called again, e.g. when selection changes.
+        // Handling it once the current refresh has completed.
+        m_bRefreshPending = true;
+        return;
+    }
+    m_bRefreshInProgress = true;
+    m_bRefreshPending = false;
+
+    // Refresh is done in three phases:
+    //  1. In GUI thread, selected cells are copied from data sources.
+    //  2. In worker thread, copied cells are parsed and decimated; worker does not access data sources, models or this widget.
+    //  3. In GUI thread, graphs are updated if this widget still exists (events were processed during phase 2).
+    struct RefreshJob
+    {
+        GraphDataSourceId m_sourceId;
+        GraphColumnDataCache::SelectionSnapshot m_snapshot;
+        XyGraphData m_graphData;
+    };
+    std::vector<std::unique_ptr<RefreshJob>> jobs;
 
-    // Going through every item in definition entry table and redrawing them.
+    // Going through every item in definition entry table and taking snapshot of their data.
     auto pDefWidget = this->m_spControlPanel->findChild<GraphDefinitionWidget*>();
     if (pDefWidget)
     {
@@ -324,86 +610,74 @@ void DFG_MODULE_NS(qt)::GraphControlAndDisplayWidget::refresh()
                     DFG_ASSERT_IMPLEMENTED(false);
                     return;
                 }
+                std::unique_ptr<RefreshJob> spJob(new RefreshJob);
+                spJob->m_sourceId = source.uniqueId();
+                GraphColumnDataCache::takeSnapshot(source, spJob->m_snapshot);
+                jobs.push_back(std::move(spJob));
+            });
+        });
+    }
 
-                if (!m_spGraphDisplay)
-                {
-                    DFG_ASSERT_WITH_MSG(false, "Internal error, no graph display object");
-                    return;
-                }
-                auto pChart = this->m_spGraphDisplay->chart();
-                if (!pChart)
-                {
-                    DFG_ASSERT_WITH_MSG(false, "Internal error, no chart object available");
-                    return;
-                }
-
-                const auto sourceId = source.uniqueId();
-                auto sTitle = (!sourceId.isEmpty()) ? format_fmt("Data source {}", sourceId.toUtf8().data()) : std::string();
-                pChart->setTitle(SzPtrUtf8(sTitle.c_str()));
+    if (jobs.empty() || !m_spGraphDisplay)
+    {
+        DFG_ASSERT_WITH_MSG(jobs.empty(), "Internal error, no graph display object");
+        m_bRefreshInProgress = false;
+        return;
+    }
 
-                if (!pChart->hasChartObjects())
-                {
-                    pChart->addXySeries();
-                }
-                auto spSeries = pChart->getFirstXySeries();
+    // Decimating to roughly one min/max pair per horizontal pixel.
+    const auto nBucketCount = static_cast<size_t>(Max(100, this->m_spGraphDisplay->width()));
+    auto spCache = this->m_spColumnDataCache; // Copy keeps cache alive even if this widget gets destroyed while waiting.
+    QPointer<GraphControlAndDisplayWidget> spThis(this);
+    runInWorkerThreadAndWait("graphDataExtraction", [&]()
+    {
+        for (auto& spJob : jobs)
+        {
+            spCache->update(spJob->m_sourceId, spJob->m_snapshot);
+            spJob->m_snapshot = GraphColumnDataCache::SelectionSnapshot(); // Releasing memory as it is no longer needed.
+            createXyGraphData(*spCache, nBucketCount, spJob->m_graphData);
+        }
+    });
 
-                if (!spSeries)
-                {
-                    DFG_ASSERT_WITH_MSG(false, "Internal error, unexpected series type");
-                    return;
-                }
+    if (!spThis)
+        return; // Widget was destroyed while worker was running.
 
-                typedef DFG_MODULE_NS(cont)::MapVectorSoA<int, dfg::cont::MapVectorSoA<int, double>> ColumnValues;
-                ColumnValues values;
-                values.setSorting(false);
+    for (const auto& spJob : jobs)
+    {
+        auto pChart = (m_spGraphDisplay) ? this->m_spGraphDisplay->chart() : nullptr;
+        if (!pChart)
+        {
+            DFG_ASSERT_WITH_MSG(false, "Internal error, no chart object available");
+            break;
+        }
 
-                source.forEachElement_fromTableSelection([&](const DataSourceIndex r, const DataSourceIndex c, const QVariant& val)
-                {
-                    int rowAsInt = static_cast<int>(r);
-                    values[c].insert(std::move(rowAsInt), val.toDouble());
-                });
+        const auto& sourceId = spJob->m_sourceId;
+        auto sTitle = (!sourceId.isEmpty()) ? format_fmt("Data source {}", sourceId.toUtf8().data()) : std::string();
+        pChart->setTitle(SzPtrUtf8(sTitle.c_str()));
 
-                DFG_MODULE_NS(func)::MemFuncMinMax<double> minMaxX;
-                DFG_MODULE_NS(func)::MemFuncMinMax<double> minMaxY;
-                DataSourceIndex nGraphSize = 0;
+        if (!pChart->hasChartObjects())
+        {
+            pChart->addXySeries();
+        }
+        auto spSeries = pChart->getFirstXySeries();
 
-                if (values.size() == 1)
-                {
-                    const auto& valueCont = values.begin()->second;
-                    nGraphSize = valueCont.size();
-                    DataSourceIndex i = 0;
-                    for (const auto valPair : valueCont)
-                    {
-                        const auto x = valPair.first;
-                        const auto y = valPair.second;
-                        minMaxX(x);
-                        minMaxY(y);
-                        spSeries->setOrAppend(i++, x, y);
-                    }
-                }
-                else if (values.size() == 2)
-                {
-                    const auto& xValueMap = values.frontValue();
-                    const auto& yValueMap = values.backValue();
-                    nGraphSize = Min(xValueMap.size(), yValueMap.size());
-                    auto xIter = xValueMap.cbegin();
-                    auto yIter = yValueMap.cbegin();
-                    for (DataSourceIndex i = 0; i < nGraphSize; ++i, ++xIter, ++yIter)
-                    {
-                        const auto x = xIter->second;
-                        const auto y = yIter->second;
-                        minMaxX(x);
-                        minMaxY(y);
-                        spSeries->setOrAppend(i, x, y);
-                    }
+        if (!spSeries)
+        {
+            DFG_ASSERT_WITH_MSG(false, "Internal error, unexpected series type");
+            continue;
+        }
 
-                }
-                spSeries->resize(nGraphSize); // Removing excess points (if any)
+        const auto& graphData = spJob->m_graphData;
+        spSeries->setValues(graphData.m_xVals, graphData.m_yVals);
 
-                pChart->setAxisForSeries(spSeries.get(), minMaxX.minValue(), minMaxX.maxValue(), minMaxY.minValue(), minMaxY.maxValue());
-            });
-        });
+        const auto& minMaxX = graphData.m_minMaxX;
+        const auto& minMaxY = graphData.m_minMaxY;
+        pChart->setAxisForSeries(spSeries.get(), minMaxX.minValue(), minMaxX.maxValue(), minMaxY.minValue(), minMaxY.maxValue());
     }
+
+    m_bRefreshInProgress = false;
+    if (m_bRefreshPending)
+        QTimer::singleShot(0, this, &GraphControlAndDisplayWidget::refresh);
 }
 
 void DFG_MODULE_NS(qt)::GraphControlAndDisplayWidget::addDataSource(std::unique_ptr<GraphDataSource> spSource)
@@ -21,6 +21,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(qt)
 typedef QString GraphDataSourceId;
 typedef std::size_t DataSourceIndex;
 class ChartCanvas;
+class GraphColumnDataCache;
 
 enum GraphDataSourceType
 {
@@ -96,6 +97,8 @@ public:
 
     GraphControlAndDisplayWidget();
 
+    // Reads data from data sources and updates graphs. Selected cells are copied in GUI thread after which parsing and decimation
+    // to display resolution are done in a worker thread while GUI events are processed. If called while refresh is in progress, a new refresh is done once the current one completes.
     void refresh();
 
     void addDataSource(std::unique_ptr<GraphDataSource> spSource);
@@ -110,6 +113,9 @@ public:
     QObjectStorage<GraphControlPanel> m_spControlPanel;
     QObjectStorage<GraphDisplay> m_spGraphDisplay;
     DataSourceContainer m_dataSources;
+    std::shared_ptr<GraphColumnDataCache> m_spColumnDataCache; // Parsed values from previous refresh, used to avoid re-parsing unchanged cells. shared_ptr as the type is incomplete here.
+    bool m_bRefreshInProgress;
+    bool m_bRefreshPending;
 
 }; // Class GraphControlAndDisplayWidget
 
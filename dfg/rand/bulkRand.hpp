@@ -0,0 +1,271 @@
+#pragma once
+
+/*
+bulkRand.hpp
+
+Random number generation for large amounts of values:
+    -PhiloxEngine: counter-based engine (Philox4x32-10) whose output is a pure function of (seed, stream, position). This makes it possible
+     to give each thread or block its own reproducible stream without sharing state and to jump to any position in constant time.
+    -fillUniform(): fills array with uniformly distributed integers or doubles; raw bits are generated in batches and converted
+     with branch-free arithmetic (apart from the rare rejection in integer case) so that loops are friendly for auto-vectorization.
+    -fillUniformParallel(): parallel version whose result depends only on (seed, stream), not on thread count.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgAssert.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../thread/ThreadPool.hpp"
+#include <limits>
+#include <random>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+#if !defined(_MSC_VER) || (_MSC_VER >= 1900) // constexpr is available starting from VC2015
+    #define DFG_ZIMPL_BULKRAND_CONSTEXPR constexpr
+#else
+    #define DFG_ZIMPL_BULKRAND_CONSTEXPR
+#endif
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(rand) {
+
+namespace DFG_DETAIL_NS
+{
+    inline void mulHiLo32(const uint32 a, const uint32 b, uint32& rHi, uint32& rLo)
+    {
+        const uint64 n = static_cast<uint64>(a) * b;
+        rHi = static_cast<uint32>(n >> 32);
+        rLo = static_cast<uint32>(n);
+    }
+
+    // Returns high 64 bits of 128-bit product a * b and stores low 64 bits to rLo.
+    inline uint64 mulHi64(const uint64 a, const uint64 b, uint64& rLo)
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 n = static_cast<unsigned __int128>(a) * b;
+        rLo = static_cast<uint64>(n);
+        return static_cast<uint64>(n >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64 nHi;
+        rLo = _umul128(a, b, &nHi);
+        return nHi;
+#else
+        const uint64 aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+        const uint64 bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+        const uint64 ll = aLo * bLo;
+        const uint64 lh = aLo * bHi;
+        const uint64 hl = aHi * bLo;
+        const uint64 hh = aHi * bHi;
+        const uint64 mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+        rLo = (mid << 32) | (ll & 0xFFFFFFFFu);
+        return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+    }
+
+    // Maps 64 random bits to double in [0, 1).
+    inline double bitsToUnitDouble(const uint64 n)
+    {
+        return static_cast<double>(static_cast<int64>(n >> 11)) * (1.0 / 9007199254740992.0); // 2^-53
+    }
+
+    const size_t gnBulkRandBatchSize = 256;
+    const size_t gnBulkRandParallelChunkSize = 65536;
+    // Position offset between chunks in fillUniformParallel(); leaves room for integer rejections.
+    const uint64 gnBulkRandChunkPositionStride = uint64(1) << 40;
+} // namespace DFG_DETAIL_NS
+
+// Counter-based random engine implementing Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011).
+// Key is given by seed and counter consists of position (64 bits) and stream id (64 bits); each counter value gives two 64-bit outputs.
+// Satisfies requirements of uniform random bit generator, so can be used with std distributions.
+class DFG_CLASS_NAME(PhiloxEngine)
+{
+public:
+    typedef uint64 result_type;
+
+    DFG_CLASS_NAME(PhiloxEngine)(const uint64 nSeed = 0, const uint64 nStream = 0) :
+        m_nSeed(nSeed),
+        m_nStream(nStream),
+        m_nPosition(0)
+    {
+    }
+
+    static DFG_ZIMPL_BULKRAND_CONSTEXPR result_type (min)() { return 0; }
+    static DFG_ZIMPL_BULKRAND_CONSTEXPR result_type (max)() { return (std::numeric_limits<result_type>::max)(); }
+
+    result_type operator()()
+    {
+        uint64 block[2];
+        generateBlock(m_nPosition / 2, block);
+        return block[m_nPosition++ % 2];
+    }
+
+    void discard(const uint64 nCount) { m_nPosition += nCount; }
+
+    // Sets position in the stream as number of values from the beginning.
+    void seek(const uint64 nPosition) { m_nPosition = nPosition; }
+
+    uint64 position() const { return m_nPosition; }
+    uint64 seed() const     { return m_nSeed; }
+    uint64 stream() const   { return m_nStream; }
+
+    // Computes values at positions [2 * nBlock, 2 * nBlock + 2[ without modifying state.
+    void generateBlock(const uint64 nBlock, uint64 out[2]) const
+    {
+        uint32 ctr[4] = { static_cast<uint32>(nBlock), static_cast<uint32>(nBlock >> 32), static_cast<uint32>(m_nStream), static_cast<uint32>(m_nStream >> 32) };
+        uint32 key[2] = { static_cast<uint32>(m_nSeed), static_cast<uint32>(m_nSeed >> 32) };
+        philox4x32_10(ctr, key);
+        out[0] = (static_cast<uint64>(ctr[1]) << 32) | ctr[0];
+        out[1] = (static_cast<uint64>(ctr[3]) << 32) | ctr[2];
+    }
+
+    // Fills [p, p + nCount[ with raw values and advances position accordingly.
+    void generate(uint64* p, size_t nCount)
+    {
+        uint64 block[2];
+        if (nCount > 0 && m_nPosition % 2 != 0)
+        {
+            *p++ = (*this)();
+            --nCount;
+        }
+        uint64 nBlock = m_nPosition / 2;
+        for (; nCount >= 2; nCount -= 2, p += 2, ++nBlock)
+            generateBlock(nBlock, p);
+        m_nPosition = 2 * nBlock;
+        if (nCount > 0)
+        {
+            generateBlock(nBlock, block);
+            *p = block[0];
+            ++m_nPosition;
+        }
+    }
+
+    // Applies the Philox4x32 bijection with 10 rounds to ctr.
+    static void philox4x32_10(uint32 ctr[4], uint32 key[2])
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            if (i > 0)
+            {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint32 hi0, lo0, hi1, lo1;
+            DFG_DETAIL_NS::mulHiLo32(0xD2511F53u, ctr[0], hi0, lo0);
+            DFG_DETAIL_NS::mulHiLo32(0xCD9E8D57u, ctr[2], hi1, lo1);
+            const uint32 c0 = hi1 ^ ctr[1] ^ key[0];
+            const uint32 c2 = hi0 ^ ctr[3] ^ key[1];
+            ctr[0] = c0;
+            ctr[1] = lo1;
+            ctr[2] = c2;
+            ctr[3] = lo0;
+        }
+    }
+
+private:
+    uint64 m_nSeed;
+    uint64 m_nStream;
+    uint64 m_nPosition;
+}; // class PhiloxEngine
+
+// Returns randomly seeded PhiloxEngine for given stream.
+inline DFG_CLASS_NAME(PhiloxEngine) createPhiloxEngineRandomSeeded(const uint64 nStream = 0)
+{
+    std::random_device rd;
+    const uint64 nSeed = (static_cast<uint64>(rd()) << 32) ^ rd();
+    return DFG_CLASS_NAME(PhiloxEngine)(nSeed, nStream);
+}
+
+// Fills [p, p + nCount[ with uniformly distributed doubles from [minVal, maxVal[ (if minVal == maxVal, all values equal minVal).
+// Engine_T must provide generate(uint64* p, size_t nCount) like PhiloxEngine.
+template <class Engine_T>
+void fillUniform(Engine_T& eng, double* p, const size_t nCount, const double minVal, const double maxVal)
+{
+    DFG_ASSERT_UB(minVal <= maxVal);
+    const double range = maxVal - minVal;
+    uint64 bits[DFG_DETAIL_NS::gnBulkRandBatchSize];
+    for (size_t i = 0; i < nCount; i += DFG_DETAIL_NS::gnBulkRandBatchSize)
+    {
+        const size_t nBatch = Min(DFG_DETAIL_NS::gnBulkRandBatchSize, nCount - i);
+        eng.generate(bits, nBatch);
+        double* const pDest = p + i;
+        for (size_t j = 0; j < nBatch; ++j)
+            pDest[j] = minVal + range * DFG_DETAIL_NS::bitsToUnitDouble(bits[j]);
+        // Rounding in minVal + range * u may give maxVal; map those (rare) cases back to range.
+        for (size_t j = 0; j < nBatch; ++j)
+        {
+            if (pDest[j] >= maxVal && range > 0)
+                pDest[j] = minVal;
+        }
+    }
+}
+
+// Fills [p, p + nCount[ with uniformly distributed integers from closed range [minVal, maxVal].
+// Uses multiply-shift mapping with rejection (Lemire, "Fast random integer generation in an interval", 2019) so result is unbiased.
+template <class Engine_T, class Int_T>
+typename std::enable_if<std::is_integral<Int_T>::value, void>::type fillUniform(Engine_T& eng, Int_T* p, const size_t nCount, const Int_T minVal, const Int_T maxVal)
+{
+    DFG_ASSERT_UB(minVal <= maxVal);
+    typedef typename std::make_unsigned<Int_T>::type UnsignedT;
+    // Range size - 1 fits in UnsignedT; computing it through uint64 handles also full ranges of signed types.
+    const uint64 nRangeMinusOne = static_cast<uint64>(static_cast<UnsignedT>(static_cast<UnsignedT>(maxVal) - static_cast<UnsignedT>(minVal)));
+    uint64 bits[DFG_DETAIL_NS::gnBulkRandBatchSize];
+    if (nRangeMinusOne == (std::numeric_limits<uint64>::max)())
+    {
+        for (size_t i = 0; i < nCount; i += DFG_DETAIL_NS::gnBulkRandBatchSize)
+        {
+            const size_t nBatch = Min(DFG_DETAIL_NS::gnBulkRandBatchSize, nCount - i);
+            eng.generate(bits, nBatch);
+            for (size_t j = 0; j < nBatch; ++j)
+                p[i + j] = static_cast<Int_T>(bits[j]);
+        }
+        return;
+    }
+    const uint64 nRange = nRangeMinusOne + 1;
+    const uint64 nThreshold = (0 - nRange) % nRange; // = 2^64 mod nRange
+    for (size_t i = 0; i < nCount; i += DFG_DETAIL_NS::gnBulkRandBatchSize)
+    {
+        const size_t nBatch = Min(DFG_DETAIL_NS::gnBulkRandBatchSize, nCount - i);
+        eng.generate(bits, nBatch);
+        Int_T* const pDest = p + i;
+        for (size_t j = 0; j < nBatch; ++j)
+        {
+            uint64 nLow;
+            uint64 nHigh = DFG_DETAIL_NS::mulHi64(bits[j], nRange, nLow);
+            while (nLow < nThreshold) // Rejection
+            {
+                uint64 nNew;
+                eng.generate(&nNew, 1);
+                nHigh = DFG_DETAIL_NS::mulHi64(nNew, nRange, nLow);
+            }
+            pDest[j] = static_cast<Int_T>(static_cast<UnsignedT>(static_cast<UnsignedT>(minVal) + static_cast<UnsignedT>(nHigh)));
+        }
+    }
+}
+
+// Parallel version of fillUniform() using PhiloxEngine. Values are generated in fixed size chunks each of which uses its own part of the stream,
+// so the result is determined by (nSeed, nStream) and does not depend on nMaxThreadCount. Note that result differs from that of serial fillUniform().
+// Chunks are processed in thread::defaultThreadPool(); nMaxThreadCount limits the number of concurrently processed chunks (0 = no limit).
+template <class T>
+void fillUniformParallel(T* p, const size_t nCount, const T minVal, const T maxVal, const uint64 nSeed, const uint64 nStream = 0, const size_t nMaxThreadCount = 0)
+{
+    const size_t nChunkSize = DFG_DETAIL_NS::gnBulkRandParallelChunkSize;
+    const size_t nChunkCount = (nCount + nChunkSize - 1) / nChunkSize;
+    // Chunks are divided into nPieceCount contiguous pieces that are run as separate tasks.
+    const size_t nPieceCount = (nMaxThreadCount == 0) ? nChunkCount : Min(nMaxThreadCount, nChunkCount);
+    DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nPieceCount, 1, [&](const size_t iPieceBegin, const size_t iPieceEnd)
+    {
+        const size_t nChunkEnd = iPieceEnd * nChunkCount / nPieceCount;
+        for (size_t nChunk = iPieceBegin * nChunkCount / nPieceCount; nChunk < nChunkEnd; ++nChunk)
+        {
+            const size_t iBegin = nChunk * nChunkSize;
+            DFG_CLASS_NAME(PhiloxEngine) eng(nSeed, nStream);
+            eng.seek(static_cast<uint64>(nChunk) * DFG_DETAIL_NS::gnBulkRandChunkPositionStride);
+            fillUniform(eng, p + iBegin, Min(nCount, iBegin + nChunkSize) - iBegin, minVal, maxVal);
+        }
+    });
+}
+
+}} // module rand
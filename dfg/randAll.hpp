@@ -1,3 +1,4 @@
 #pragma once
 
 #include "rand.hpp"
+#include "rand/bulkRand.hpp"
@@ -0,0 +1,413 @@
+#pragma once
+
+/*
+ThreadPool.hpp
+
+Work-stealing thread pool with task groups, parallel for and parallel reduce over index ranges.
+
+    -Each worker has its own task deque: tasks submitted from a worker are pushed to the back of its deque and popped from the back (LIFO),
+     idle workers steal from the front of others' deques (FIFO), so that large pieces of recursively split work get stolen first.
+     Tasks submitted from non-worker threads go to a shared queue.
+    -TaskGroup::wait() executes pending tasks in the waiting thread, so waiting from within a task (nested parallelism) doesn't deadlock
+     and calling thread also contributes to the work.
+    -Cancellation is cooperative: CancellationToken can be cancelled at any time, tasks of a cancelled TaskGroup that haven't started are skipped
+     and running code can poll isCancelled().
+    -defaultThreadPool() returns a process-wide pool that is meant to be shared by different parts of the library to avoid oversubscription.
+
+Example:
+    DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, vals.size(), 1000, [&](const size_t iBegin, const size_t iEnd)
+    {
+        for (size_t i = iBegin; i < iEnd; ++i)
+            vals[i] = f(vals[i]);
+    });
+
+Note: tasks must not block waiting for other tasks by other means than TaskGroup::wait(), e.g. with a plain condition variable, since
+      the task it waits for might be queued behind the waiting task on the same worker.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgAssert.hpp"
+#include "setThreadName.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(thread) {
+
+// Shared cancellation flag: copies refer to the same state.
+class DFG_CLASS_NAME(CancellationToken)
+{
+public:
+    DFG_CLASS_NAME(CancellationToken)() :
+        m_spCancelled(std::make_shared<std::atomic<bool>>(false))
+    {}
+
+    void cancel() const         { m_spCancelled->store(true); }
+    bool isCancelled() const    { return m_spCancelled->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_spCancelled;
+}; // class CancellationToken
+
+class DFG_CLASS_NAME(ThreadPool)
+{
+public:
+    typedef std::function<void ()> TaskT;
+
+    // Creates pool with nThreadCount worker threads (0 = std::thread::hardware_concurrency()). Worker threads are named
+    // as <sThreadNamePrefix><index> where setThreadName() is available.
+    explicit DFG_CLASS_NAME(ThreadPool)(size_t nThreadCount = 0, std::string sThreadNamePrefix = "dfgPool") :
+        m_nPendingTaskCount(0),
+        m_nStartedWorkerCount(0),
+        m_bStop(false)
+    {
+        if (nThreadCount == 0)
+            nThreadCount = Max(1u, std::thread::hardware_concurrency());
+        m_workerQueues.reserve(nThreadCount);
+        for (size_t i = 0; i < nThreadCount; ++i)
+            m_workerQueues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue));
+        m_workerIds.resize(nThreadCount);
+        m_threads.reserve(nThreadCount);
+        for (size_t i = 0; i < nThreadCount; ++i)
+            m_threads.push_back(std::thread(&DFG_CLASS_NAME(ThreadPool)::privWorkerMain, this, i, sThreadNamePrefix + std::to_string(i)));
+        // Waiting until all workers have registered their ids so that m_workerIds can be read without locking.
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeUp.wait(lock, [&]() { return m_nStartedWorkerCount == m_threads.size(); });
+    }
+
+    // Executes all pending tasks and joins worker threads.
+    ~DFG_CLASS_NAME(ThreadPool)()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_bStop = true;
+        }
+        m_wakeUp.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    size_t threadCount() const { return m_threads.size(); }
+
+    // Queues task for execution. Exceptions must not escape from the task (use TaskGroup for exception propagation).
+    void submit(TaskT task)
+    {
+        ++m_nPendingTaskCount; // Incremented before pushing so that the counter never goes below the actual number of queued tasks.
+        const auto nWorker = currentWorkerIndex();
+        auto& queue = (nWorker < m_workerQueues.size()) ? *m_workerQueues[nWorker] : m_sharedQueue;
+        {
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            queue.m_tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_wakeUp.notify_one();
+    }
+
+    // Executes one pending task in the calling thread if there is any. Returns true if a task was executed.
+    bool tryRunPendingTask()
+    {
+        TaskT task;
+        if (!privPopTask(currentWorkerIndex(), task))
+            return false;
+        task();
+        return true;
+    }
+
+    // Returns index of calling thread in this pool or threadCount() if calling thread is not a worker of this pool.
+    size_t currentWorkerIndex() const
+    {
+        const auto id = std::this_thread::get_id();
+        for (size_t i = 0, nCount = m_workerIds.size(); i < nCount; ++i)
+        {
+            if (m_workerIds[i] == id)
+                return i;
+        }
+        return m_workerIds.size();
+    }
+
+    bool isWorkerThread() const { return currentWorkerIndex() < threadCount(); }
+
+    // Returns true if there are queued tasks that haven't been started.
+    bool hasPendingTasks() const { return m_nPendingTaskCount.load() != 0; }
+
+private:
+    struct TaskQueue
+    {
+        std::mutex m_mutex;
+        std::deque<TaskT> m_tasks;
+    };
+
+    // Tries to get task: first from back of own queue, then from the shared queue and finally steals from front of other workers' queues.
+    bool privPopTask(const size_t nWorker, TaskT& task)
+    {
+        if (m_nPendingTaskCount.load() == 0)
+            return false;
+        const auto tryPop = [&](TaskQueue& queue, const bool bBack) -> bool
+        {
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            if (queue.m_tasks.empty())
+                return false;
+            if (bBack)
+            {
+                task = std::move(queue.m_tasks.back());
+                queue.m_tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.m_tasks.front());
+                queue.m_tasks.pop_front();
+            }
+            --m_nPendingTaskCount;
+            return true;
+        };
+        const size_t nWorkerCount = m_workerQueues.size();
+        if (nWorker < nWorkerCount && tryPop(*m_workerQueues[nWorker], true))
+            return true;
+        if (tryPop(m_sharedQueue, false))
+            return true;
+        // Stealing, starting from the next worker to spread victims.
+        for (size_t i = 1; i <= nWorkerCount; ++i)
+        {
+            const size_t nVictim = (nWorker + i) % nWorkerCount;
+            if (nVictim != nWorker && tryPop(*m_workerQueues[nVictim], false))
+                return true;
+        }
+        return false;
+    }
+
+    void privWorkerMain(const size_t nIndex, const std::string sName)
+    {
+#if DFG_THREAD_SET_THREAD_NAME_AVAILABLE
+        setThreadName(sName.c_str());
+#else
+        DFG_UNUSED(sName);
+#endif
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_workerIds[nIndex] = std::this_thread::get_id();
+            ++m_nStartedWorkerCount;
+        }
+        m_wakeUp.notify_all();
+
+        TaskT task;
+        for (;;)
+        {
+            if (privPopTask(nIndex, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.wait(lock, [&]() { return m_bStop || m_nPendingTaskCount.load() != 0; });
+            if (m_bStop && m_nPendingTaskCount.load() == 0)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<TaskQueue>> m_workerQueues;
+    TaskQueue m_sharedQueue;
+    std::vector<std::thread> m_threads;
+    std::vector<std::thread::id> m_workerIds;
+    std::atomic<size_t> m_nPendingTaskCount;
+    size_t m_nStartedWorkerCount;
+    bool m_bStop;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+
+    DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(ThreadPool));
+}; // class ThreadPool
+
+// Returns process-wide pool with std::thread::hardware_concurrency() workers, created on first call.
+inline DFG_CLASS_NAME(ThreadPool)& defaultThreadPool()
+{
+    static DFG_CLASS_NAME(ThreadPool) pool;
+    return pool;
+}
+
+// Set of tasks run in a ThreadPool that can be waited for together.
+// If a task throws, the group gets cancelled and the first exception is rethrown from wait().
+// Destructor waits for unfinished tasks (but doesn't rethrow).
+class DFG_CLASS_NAME(TaskGroup)
+{
+public:
+    explicit DFG_CLASS_NAME(TaskGroup)(DFG_CLASS_NAME(ThreadPool)& pool, DFG_CLASS_NAME(CancellationToken) cancellationToken = DFG_CLASS_NAME(CancellationToken)()) :
+        m_pool(pool),
+        m_cancellationToken(std::move(cancellationToken)),
+        m_nUnfinishedCount(0)
+    {}
+
+    ~DFG_CLASS_NAME(TaskGroup)()
+    {
+        privWait();
+    }
+
+    // Queues func() to be run in the pool. If group is cancelled before the task starts, func is not called.
+    template <class Func_T>
+    void run(Func_T func)
+    {
+        ++m_nUnfinishedCount;
+        m_pool.submit([this, func]()
+        {
+            if (!m_cancellationToken.isCancelled())
+            {
+                try
+                {
+                    func();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_spException)
+                        m_spException = std::current_exception();
+                    m_cancellationToken.cancel();
+                }
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_nUnfinishedCount == 0)
+                m_stateChanged.notify_all();
+        });
+        // Waking up waiters so that they can help with the new task.
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_stateChanged.notify_all();
+    }
+
+    // Waits until all tasks have finished, executing pending tasks of the pool in the calling thread while waiting.
+    // Rethrows the first exception thrown by a task.
+    void wait()
+    {
+        privWait();
+        std::exception_ptr spException;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(spException, m_spException);
+        }
+        if (spException)
+            std::rethrow_exception(spException);
+    }
+
+    void cancel()               { m_cancellationToken.cancel(); }
+    bool isCancelled() const    { return m_cancellationToken.isCancelled(); }
+    const DFG_CLASS_NAME(CancellationToken)& cancellationToken() const { return m_cancellationToken; }
+    DFG_CLASS_NAME(ThreadPool)& pool() { return m_pool; }
+
+private:
+    void privWait()
+    {
+        while (m_nUnfinishedCount.load() != 0)
+        {
+            if (m_pool.tryRunPendingTask())
+                continue;
+            // Nothing to help with: remaining tasks are running in other threads. Sleeping until the last task finishes or a task of this group
+            // queues new work (e.g. a parallelFor split); tasks queued by other groups are run by the threads waiting for those groups.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stateChanged.wait(lock, [&]() { return m_nUnfinishedCount.load() == 0 || m_pool.hasPendingTasks(); });
+        }
+        // Synchronizing with the last finishing task so that it has released the mutex before this object can get destroyed.
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+
+    DFG_CLASS_NAME(ThreadPool)& m_pool;
+    DFG_CLASS_NAME(CancellationToken) m_cancellationToken;
+    std::atomic<size_t> m_nUnfinishedCount;
+    std::mutex m_mutex;
+    std::condition_variable m_stateChanged; // Notified when the last task finishes and when a task is queued.
+    std::exception_ptr m_spException;
+
+    DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(TaskGroup));
+}; // class TaskGroup
+
+namespace DFG_DETAIL_NS
+{
+    // Returns grain size used when caller gives 0: about 8 pieces per thread to leave room for load balancing.
+    inline size_t autoGrainSize(const DFG_CLASS_NAME(ThreadPool)& pool, const size_t nSize)
+    {
+        return Max(size_t(1), nSize / (8 * Max(size_t(1), pool.threadCount())));
+    }
+
+    // Splits [iBegin, iEnd[ recursively in halves: upper halves are given to the group (to be stolen by idle workers), lower half is processed in
+    // the current thread when it is no larger than grain size.
+    template <class Func_T>
+    void parallelForSplit(DFG_CLASS_NAME(TaskGroup)& group, const size_t iBegin, size_t iEnd, const size_t nGrainSize, Func_T& func)
+    {
+        while (iEnd - iBegin > nGrainSize)
+        {
+            const size_t iMid = iBegin + (iEnd - iBegin) / 2;
+            group.run([&group, &func, iMid, iEnd, nGrainSize]() { parallelForSplit(group, iMid, iEnd, nGrainSize, func); });
+            iEnd = iMid;
+        }
+        if (!group.isCancelled())
+            func(iBegin, iEnd);
+    }
+} // namespace DFG_DETAIL_NS
+
+// Calls func(i0, i1) for disjoint subranges covering [iBegin, iEnd[, each at most nGrainSize long (0 = automatic), in pool threads and in the calling thread.
+// Returns when all subranges have been processed or skipped due to cancellation; exception from func is rethrown.
+template <class Func_T>
+void parallelFor(DFG_CLASS_NAME(ThreadPool)& pool, const size_t iBegin, const size_t iEnd, size_t nGrainSize, Func_T&& func,
+                 DFG_CLASS_NAME(CancellationToken) cancellationToken = DFG_CLASS_NAME(CancellationToken)())
+{
+    if (iBegin >= iEnd)
+        return;
+    if (nGrainSize == 0)
+        nGrainSize = DFG_DETAIL_NS::autoGrainSize(pool, iEnd - iBegin);
+    if (iEnd - iBegin <= nGrainSize)
+    {
+        if (!cancellationToken.isCancelled())
+            func(iBegin, iEnd);
+        return;
+    }
+    DFG_CLASS_NAME(TaskGroup) group(pool, std::move(cancellationToken));
+    try
+    {
+        DFG_DETAIL_NS::parallelForSplit(group, iBegin, iEnd, nGrainSize, func);
+    }
+    catch (...)
+    {
+        group.cancel(); // Destructor waits for the already queued tasks.
+        throw;
+    }
+    group.wait();
+}
+
+// Computes combine(...combine(reduceRange(i0, i1), reduceRange(i1, i2))...) over chunks [iBegin + k * nGrainSize, ...[ of [iBegin, iEnd[ in parallel.
+// Partial results are combined pairwise in chunk order so for given grain size the result is deterministic regardless of the number of threads
+// (note that with nGrainSize = 0 the grain size depends on pool size). combine() must be associative; returns 'identity' for empty range.
+// If cancelled, skipped chunks contribute 'identity'.
+template <class T, class ReduceRange_T, class Combine_T>
+T parallelReduce(DFG_CLASS_NAME(ThreadPool)& pool, const size_t iBegin, const size_t iEnd, size_t nGrainSize, const T& identity, ReduceRange_T&& reduceRange, Combine_T&& combine,
+                 DFG_CLASS_NAME(CancellationToken) cancellationToken = DFG_CLASS_NAME(CancellationToken)())
+{
+    if (iBegin >= iEnd)
+        return identity;
+    if (nGrainSize == 0)
+        nGrainSize = DFG_DETAIL_NS::autoGrainSize(pool, iEnd - iBegin);
+    const size_t nSize = iEnd - iBegin;
+    const size_t nChunkCount = (nSize + nGrainSize - 1) / nGrainSize;
+    std::vector<T> partials(nChunkCount, identity);
+    parallelFor(pool, 0, nChunkCount, 1, [&](const size_t c0, const size_t c1)
+    {
+        for (size_t c = c0; c < c1; ++c)
+            partials[c] = reduceRange(iBegin + c * nGrainSize, iBegin + Min(nSize, (c + 1) * nGrainSize));
+    }, std::move(cancellationToken));
+    for (size_t nCount = nChunkCount; nCount > 1; nCount = (nCount + 1) / 2)
+    {
+        for (size_t i = 0; 2 * i < nCount; ++i)
+            partials[i] = (2 * i + 1 < nCount) ? combine(partials[2 * i], partials[2 * i + 1]) : partials[2 * i];
+    }
+    return partials[0];
+}
+
+}} // module namespace
@@ -46,4 +46,17 @@ void DFG_MODULE_NS(thread)::setThreadName(const char* pszThreadName)
     setThreadName(GetCurrentThreadId(), pszThreadName);
 }
 
+#elif defined(__linux__)
+#include <pthread.h>
+#include <cstring>
+
+void DFG_MODULE_NS(thread)::setThreadName(const char* pszThreadName)
+{
+    // pthread_setname_np() fails if name is longer than 15 characters so truncating.
+    char szName[16] = "";
+    if (pszThreadName)
+        std::strncpy(szName, pszThreadName, sizeof(szName) - 1);
+    pthread_setname_np(pthread_self(), szName);
+}
+
 #endif // _MSC_VER
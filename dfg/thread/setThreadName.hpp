@@ -9,6 +9,12 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(thread) {
     // Note: Thread name is only for debugger visualization, there's no name in thread objects. (http://stackoverflow.com/questions/9366722/how-to-get-the-name-of-a-win32-thread)
     void setThreadName(const char* pszThreadName);
     void setThreadName(unsigned long threadId, const char* pszThreadName);
+    #define DFG_THREAD_SET_THREAD_NAME_AVAILABLE 1
+#elif defined(__linux__)
+    // Sets name of the calling thread (visible e.g. in debuggers, top -H and /proc/<pid>/task/<tid>/comm).
+    // Note: Linux limits thread names to 15 characters, longer names are truncated.
+    void setThreadName(const char* pszThreadName);
+    #define DFG_THREAD_SET_THREAD_NAME_AVAILABLE 1
 #else
     // setThreadName() is not available in current environment.
 #endif
@@ -1,3 +1,4 @@
 #pragma once
 
 #include "thread/setThreadName.hpp"
+#include "thread/ThreadPool.hpp"
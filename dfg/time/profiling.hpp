@@ -0,0 +1,465 @@
+#pragma once
+
+/*
+profiling.hpp
+
+Lightweight instrumentation for finding out where time goes without external profiler.
+    -DFG_PROFILE_ZONE("name") creates RAII zone that records begin time and duration of the enclosing scope.
+    -DFG_PROFILE_COUNTER("name", value) records a value, e.g. number of bytes, rows or cells processed.
+    -Events are stored in per-thread buffers: writing is lock-free and wait-free for the writing thread (memory is allocated in chunks when needed),
+     other threads can read published events concurrently.
+    -Collected events can be exported as Chrome trace JSON (viewable e.g. in chrome://tracing or https://ui.perfetto.dev) or as a summary table.
+
+Profiling is compiled out by default: the macros expand to nothing and the classes below are not defined. To enable it, define
+DFG_BUILD_OPT_USE_PROFILING_OVERRIDE to 1 (requires thread_local support, i.e. not available e.g. in MSVC versions older than 2015).
+When compiled in, collection is still disabled by default at runtime (Profiler::setEnabled()); when disabled, a zone costs one atomic load.
+
+Note: Names must be string literals or otherwise have static storage duration since only the pointer is stored.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../build/languageFeatureInfo.hpp"
+
+#define DFG_BUILD_OPT_USE_PROFILING_DEFAULT 0
+#if !DFG_LANGFEAT_THREAD_LOCAL
+    #define DFG_BUILD_OPT_USE_PROFILING 0 // Implementation requires thread_local
+#elif defined(DFG_BUILD_OPT_USE_PROFILING_OVERRIDE)
+    #define DFG_BUILD_OPT_USE_PROFILING DFG_BUILD_OPT_USE_PROFILING_OVERRIDE
+#else
+    #define DFG_BUILD_OPT_USE_PROFILING DFG_BUILD_OPT_USE_PROFILING_DEFAULT
+#endif
+
+#if DFG_BUILD_OPT_USE_PROFILING
+
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "timerCpu.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(time) {
+
+enum ProfileEventType
+{
+    ProfileEventTypeZone,   // nValue is duration in nanoseconds
+    ProfileEventTypeCounter // nValue is counter value
+};
+
+struct ProfileEvent
+{
+    const char* m_pszName;
+    int64 m_nTimeNs; // Begin time for zones, time of record for counters; relative to Profiler epoch.
+    int64 m_nValue;
+    ProfileEventType m_type;
+};
+
+// Summary of all events with the same name and type.
+struct ProfileSummaryItem
+{
+    std::string m_sName;
+    ProfileEventType m_type;
+    uint64 m_nCount;
+    int64 m_nTotal; // Total duration in nanoseconds for zones, sum of values for counters.
+    int64 m_nMin;
+    int64 m_nMax;
+};
+
+namespace DFG_DETAIL_NS
+{
+    // Event buffer of a single thread. Only the owning thread writes, any thread may read events [0, publishedCount()[.
+    class ProfileThreadEventBuffer
+    {
+    public:
+        static const size_t s_nChunkSize = 4096;
+        static const size_t s_nMaxChunkCount = 4096; // Maximum of about 16M events per thread, events beyond that are dropped.
+
+        ProfileThreadEventBuffer(const uint32 nThreadIndex) :
+            m_chunks(new std::atomic<ProfileEvent*>[s_nMaxChunkCount]),
+            m_nPublishedCount(0),
+            m_nReadBegin(0),
+            m_nDroppedCount(0),
+            m_nThreadIndex(nThreadIndex),
+            m_bRetired(false)
+        {
+            for (size_t i = 0; i < s_nMaxChunkCount; ++i)
+                m_chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~ProfileThreadEventBuffer()
+        {
+            for (size_t i = 0; i < s_nMaxChunkCount; ++i)
+                delete[] m_chunks[i].load(std::memory_order_relaxed);
+        }
+
+        // May be called only from the owning thread.
+        void push(const ProfileEvent& event)
+        {
+            const size_t n = m_nPublishedCount.load(std::memory_order_relaxed);
+            const size_t nChunk = n / s_nChunkSize;
+            if (nChunk >= s_nMaxChunkCount)
+            {
+                m_nDroppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            auto pChunk = m_chunks[nChunk].load(std::memory_order_relaxed);
+            if (!pChunk)
+            {
+                pChunk = new ProfileEvent[s_nChunkSize];
+                m_chunks[nChunk].store(pChunk, std::memory_order_release);
+            }
+            pChunk[n % s_nChunkSize] = event;
+            m_nPublishedCount.store(n + 1, std::memory_order_release);
+        }
+
+        template <class Func_T>
+        void forEachEvent(Func_T&& func) const
+        {
+            const size_t nEnd = m_nPublishedCount.load(std::memory_order_acquire);
+            for (size_t i = m_nReadBegin.load(std::memory_order_relaxed); i < nEnd; ++i)
+                func(m_chunks[i / s_nChunkSize].load(std::memory_order_acquire)[i % s_nChunkSize]);
+        }
+
+        // Hides events published so far from readers; memory is not released.
+        void clear()
+        {
+            m_nReadBegin.store(m_nPublishedCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+            m_nDroppedCount.store(0, std::memory_order_relaxed);
+        }
+
+        bool hasUnreadEvents() const { return m_nReadBegin.load(std::memory_order_relaxed) != m_nPublishedCount.load(std::memory_order_acquire); }
+
+        uint64 droppedCount() const { return m_nDroppedCount.load(std::memory_order_relaxed); }
+        uint32 threadIndex() const  { return m_nThreadIndex; }
+
+        // Retired flag tells that the owning thread has ended; accessed only under Profiler mutex.
+        bool isRetired() const  { return m_bRetired; }
+        void setRetired()       { m_bRetired = true; }
+
+        std::string threadName() const
+        {
+            std::lock_guard<std::mutex> lock(m_nameMutex);
+            return (!m_sThreadName.empty()) ? m_sThreadName : "Thread " + std::to_string(m_nThreadIndex);
+        }
+
+        void threadName(std::string sName)
+        {
+            std::lock_guard<std::mutex> lock(m_nameMutex);
+            m_sThreadName = std::move(sName);
+        }
+
+    private:
+        std::unique_ptr<std::atomic<ProfileEvent*>[]> m_chunks;
+        std::atomic<size_t> m_nPublishedCount;
+        std::atomic<size_t> m_nReadBegin;
+        std::atomic<uint64> m_nDroppedCount;
+        uint32 m_nThreadIndex;
+        mutable std::mutex m_nameMutex;
+        std::string m_sThreadName;
+        bool m_bRetired;
+
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(ProfileThreadEventBuffer);
+    }; // class ProfileThreadEventBuffer
+
+    inline void appendJsonEscaped(std::string& s, const char* psz)
+    {
+        for (; *psz != '\0'; ++psz)
+        {
+            const char c = *psz;
+            if (c == '"' || c == '\\')
+            {
+                s.push_back('\\');
+                s.push_back(c);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char szBuffer[8];
+                std::snprintf(szBuffer, sizeof(szBuffer), "\\u%04x", static_cast<unsigned int>(c));
+                s += szBuffer;
+            }
+            else
+                s.push_back(c);
+        }
+    }
+} // namespace DFG_DETAIL_NS
+
+// Process-wide event collector.
+class DFG_CLASS_NAME(Profiler)
+{
+public:
+    typedef DFG_CLASS_NAME(TimerCpu)::ClockType ClockType;
+
+    static DFG_CLASS_NAME(Profiler)& instance()
+    {
+        static DFG_CLASS_NAME(Profiler) profiler;
+        return profiler;
+    }
+
+    static void setEnabled(const bool bEnabled) { enabledFlag().store(bEnabled); }
+    static bool isEnabled()                     { return enabledFlag().load(std::memory_order_relaxed); }
+
+    // Returns nanoseconds since profiler epoch.
+    int64 nowNs() const
+    {
+        return static_cast<int64>(std::chrono::duration_cast<std::chrono::nanoseconds>(ClockType::now() - m_epoch).count());
+    }
+
+    void addEvent(const ProfileEvent& event)
+    {
+        currentThreadBuffer().push(event);
+    }
+
+    // Sets name of the calling thread as shown in exported trace.
+    void setCurrentThreadName(std::string sName)
+    {
+        currentThreadBuffer().threadName(std::move(sName));
+    }
+
+    // Discards events collected so far. Buffers of ended threads are released.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& spBuffer : m_threadBuffers)
+            spBuffer->clear();
+        m_threadBuffers.erase(std::remove_if(m_threadBuffers.begin(), m_threadBuffers.end(), [](const std::shared_ptr<DFG_DETAIL_NS::ProfileThreadEventBuffer>& sp)
+        {
+            return sp->isRetired();
+        }), m_threadBuffers.end());
+    }
+
+    // Returns the number of events that were not recorded because of full buffer.
+    uint64 droppedEventCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64 nCount = 0;
+        for (const auto& spBuffer : m_threadBuffers)
+            nCount += spBuffer->droppedCount();
+        return nCount;
+    }
+
+    // Calls func(threadIndex, const ProfileEvent&) for every collected event.
+    template <class Func_T>
+    void forEachEvent(Func_T&& func) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& spBuffer : m_threadBuffers)
+        {
+            const auto nThread = spBuffer->threadIndex();
+            spBuffer->forEachEvent([&](const ProfileEvent& event) { func(nThread, event); });
+        }
+    }
+
+    // Returns collected events in Chrome trace event format (JSON object with "traceEvents" array): zones as complete events ("ph":"X"),
+    // counters as counter events ("ph":"C") and thread names as metadata.
+    std::string chromeTraceJson() const
+    {
+        std::string s = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool bFirst = true;
+        char szBuffer[128];
+        const auto beginEvent = [&]() { if (!bFirst) s += ",\n"; else s += "\n"; bFirst = false; };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& spBuffer : m_threadBuffers)
+            {
+                beginEvent();
+                std::snprintf(szBuffer, sizeof(szBuffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", static_cast<unsigned int>(spBuffer->threadIndex()));
+                s += szBuffer;
+                DFG_DETAIL_NS::appendJsonEscaped(s, spBuffer->threadName().c_str());
+                s += "\"}}";
+            }
+        }
+        forEachEvent([&](const uint32 nThread, const ProfileEvent& event)
+        {
+            beginEvent();
+            s += "{\"name\":\"";
+            DFG_DETAIL_NS::appendJsonEscaped(s, event.m_pszName);
+            if (event.m_type == ProfileEventTypeZone)
+                std::snprintf(szBuffer, sizeof(szBuffer), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", static_cast<unsigned int>(nThread), event.m_nTimeNs / 1000.0, event.m_nValue / 1000.0);
+            else
+                std::snprintf(szBuffer, sizeof(szBuffer), "\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}", static_cast<unsigned int>(nThread), event.m_nTimeNs / 1000.0, static_cast<long long>(event.m_nValue));
+            s += szBuffer;
+        });
+        s += "\n]}\n";
+        return s;
+    }
+
+    // Returns events aggregated by name and type: zones sorted by descending total time followed by counters sorted by name.
+    std::vector<ProfileSummaryItem> summary() const
+    {
+        std::map<std::pair<int, std::string>, ProfileSummaryItem> items;
+        forEachEvent([&](const uint32, const ProfileEvent& event)
+        {
+            auto iter = items.find(std::make_pair(static_cast<int>(event.m_type), std::string(event.m_pszName)));
+            if (iter == items.end())
+            {
+                ProfileSummaryItem item = { event.m_pszName, event.m_type, 0, 0, event.m_nValue, event.m_nValue };
+                iter = items.insert(std::make_pair(std::make_pair(static_cast<int>(event.m_type), item.m_sName), item)).first;
+            }
+            auto& item = iter->second;
+            ++item.m_nCount;
+            item.m_nTotal += event.m_nValue;
+            item.m_nMin = Min(item.m_nMin, event.m_nValue);
+            item.m_nMax = Max(item.m_nMax, event.m_nValue);
+        });
+        std::vector<ProfileSummaryItem> rv;
+        rv.reserve(items.size());
+        for (const auto& kv : items)
+            rv.push_back(kv.second);
+        std::stable_sort(rv.begin(), rv.end(), [](const ProfileSummaryItem& a, const ProfileSummaryItem& b)
+        {
+            if (a.m_type != b.m_type)
+                return a.m_type == ProfileEventTypeZone;
+            return a.m_type == ProfileEventTypeZone && a.m_nTotal > b.m_nTotal;
+        });
+        return rv;
+    }
+
+    // Returns summary() as human readable text table.
+    std::string summaryTable() const
+    {
+        const auto items = summary();
+        std::string s;
+        char szBuffer[256];
+        std::snprintf(szBuffer, sizeof(szBuffer), "%-40s %10s %14s %14s %14s %14s\n", "Zone", "Count", "Total [ms]", "Mean [ms]", "Min [ms]", "Max [ms]");
+        s += szBuffer;
+        for (const auto& item : items)
+        {
+            if (item.m_type != ProfileEventTypeZone)
+                continue;
+            std::snprintf(szBuffer, sizeof(szBuffer), "%-40s %10llu %14.3f %14.3f %14.3f %14.3f\n", item.m_sName.c_str(), static_cast<unsigned long long>(item.m_nCount),
+                         item.m_nTotal / 1e6, item.m_nTotal / 1e6 / static_cast<double>(item.m_nCount), item.m_nMin / 1e6, item.m_nMax / 1e6);
+            s += szBuffer;
+        }
+        std::snprintf(szBuffer, sizeof(szBuffer), "%-40s %10s %14s %14s %14s %14s\n", "Counter", "Count", "Sum", "Mean", "Min", "Max");
+        s += szBuffer;
+        for (const auto& item : items)
+        {
+            if (item.m_type != ProfileEventTypeCounter)
+                continue;
+            std::snprintf(szBuffer, sizeof(szBuffer), "%-40s %10llu %14lld %14.1f %14lld %14lld\n", item.m_sName.c_str(), static_cast<unsigned long long>(item.m_nCount),
+                         static_cast<long long>(item.m_nTotal), item.m_nTotal / static_cast<double>(item.m_nCount), static_cast<long long>(item.m_nMin), static_cast<long long>(item.m_nMax));
+            s += szBuffer;
+        }
+        return s;
+    }
+
+private:
+    DFG_CLASS_NAME(Profiler)() :
+        m_epoch(ClockType::now()),
+        m_nNextThreadIndex(0)
+    {}
+
+    static std::atomic<bool>& enabledFlag()
+    {
+        static std::atomic<bool> bEnabled(false);
+        return bEnabled;
+    }
+
+    // Per-thread handle to buffer; retires the buffer when the thread ends.
+    class ThreadBufferHandle
+    {
+    public:
+        ThreadBufferHandle() :
+            m_pBuffer(nullptr)
+        {}
+
+        ~ThreadBufferHandle()
+        {
+            if (m_pBuffer)
+                DFG_CLASS_NAME(Profiler)::instance().retireThreadBuffer(m_pBuffer);
+        }
+
+        DFG_DETAIL_NS::ProfileThreadEventBuffer* m_pBuffer;
+
+        DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(ThreadBufferHandle);
+    };
+
+    DFG_DETAIL_NS::ProfileThreadEventBuffer& currentThreadBuffer()
+    {
+        // Buffers are owned by the profiler so that events remain available after thread has ended; buffer of ended thread is released
+        // immediately if it has no unread events and otherwise on next clear().
+        static thread_local ThreadBufferHandle tlBufferHandle;
+        if (!tlBufferHandle.m_pBuffer)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_threadBuffers.push_back(std::make_shared<DFG_DETAIL_NS::ProfileThreadEventBuffer>(m_nNextThreadIndex++));
+            tlBufferHandle.m_pBuffer = m_threadBuffers.back().get();
+        }
+        return *tlBufferHandle.m_pBuffer;
+    }
+
+    void retireThreadBuffer(DFG_DETAIL_NS::ProfileThreadEventBuffer* pBuffer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto iter = std::find_if(m_threadBuffers.begin(), m_threadBuffers.end(), [=](const std::shared_ptr<DFG_DETAIL_NS::ProfileThreadEventBuffer>& sp)
+        {
+            return sp.get() == pBuffer;
+        });
+        if (iter == m_threadBuffers.end())
+            return;
+        if ((*iter)->hasUnreadEvents())
+            (*iter)->setRetired();
+        else
+            m_threadBuffers.erase(iter);
+    }
+
+    ClockType::time_point m_epoch;
+    mutable std::mutex m_mutex; // Guards m_threadBuffers and m_nNextThreadIndex
+    std::vector<std::shared_ptr<DFG_DETAIL_NS::ProfileThreadEventBuffer>> m_threadBuffers;
+    uint32 m_nNextThreadIndex;
+
+    DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(Profiler));
+}; // class Profiler
+
+// RAII zone: records a zone event covering the lifetime of the object if profiling is enabled at construction.
+class DFG_CLASS_NAME(ProfileZone)
+{
+public:
+    explicit DFG_CLASS_NAME(ProfileZone)(const char* const pszName) :
+        m_pszName(DFG_CLASS_NAME(Profiler)::isEnabled() ? pszName : nullptr),
+        m_nBeginNs((m_pszName) ? DFG_CLASS_NAME(Profiler)::instance().nowNs() : 0)
+    {}
+
+    ~DFG_CLASS_NAME(ProfileZone)()
+    {
+        if (!m_pszName)
+            return;
+        auto& profiler = DFG_CLASS_NAME(Profiler)::instance();
+        const ProfileEvent event = { m_pszName, m_nBeginNs, profiler.nowNs() - m_nBeginNs, ProfileEventTypeZone };
+        profiler.addEvent(event);
+    }
+
+private:
+    const char* m_pszName;
+    int64 m_nBeginNs;
+
+    DFG_HIDE_COPY_CONSTRUCTOR_AND_COPY_ASSIGNMENT(DFG_CLASS_NAME(ProfileZone));
+};
+
+// Records counter value if profiling is enabled.
+inline void profileCounter(const char* const pszName, const int64 nValue)
+{
+    if (!DFG_CLASS_NAME(Profiler)::isEnabled())
+        return;
+    auto& profiler = DFG_CLASS_NAME(Profiler)::instance();
+    const ProfileEvent event = { pszName, profiler.nowNs(), nValue, ProfileEventTypeCounter };
+    profiler.addEvent(event);
+}
+
+}} // module time
+
+#define DFG_ZIMPL_PROFILE_CONCAT_IMPL(A, B) A##B
+#define DFG_ZIMPL_PROFILE_CONCAT(A, B) DFG_ZIMPL_PROFILE_CONCAT_IMPL(A, B)
+
+    #define DFG_PROFILE_ZONE(NAME) ::DFG_ROOT_NS::DFG_SUB_NS_NAME(time)::DFG_CLASS_NAME(ProfileZone) DFG_ZIMPL_PROFILE_CONCAT(dfgProfileZone_, __LINE__)(NAME)
+    // VALUE is evaluated only if profiling is enabled.
+    #define DFG_PROFILE_COUNTER(NAME, VALUE) do { if (::DFG_ROOT_NS::DFG_SUB_NS_NAME(time)::DFG_CLASS_NAME(Profiler)::isEnabled()) ::DFG_ROOT_NS::DFG_SUB_NS_NAME(time)::profileCounter(NAME, static_cast< ::DFG_ROOT_NS::int64>(VALUE)); } while (false)
+#else // Case: profiling not in use
+    #define DFG_PROFILE_ZONE(NAME)
+    #define DFG_PROFILE_COUNTER(NAME, VALUE)
+#endif // DFG_BUILD_OPT_USE_PROFILING
@@ -0,0 +1,801 @@
+#pragma once
+
+/*
+timestampFormat.hpp
+
+Format-compiled timestamp parsing and formatting.
+    -TimestampFormat compiles format string once into a sequence of field operations. If all fields have fixed width
+     (e.g. "yyyy-MM-dd hh:mm:ss.zzz"), format also gets a layout template with which parsing validates all characters in a single
+     branch-free loop and reads fields from precomputed offsets.
+    -Parsing works on string views and does no allocations.
+    -Bulk functions convert ranges of strings or a table column to an int64 epoch array.
+    -Epoch conversion fails instead of overflowing if the time is not representable as int64 in the requested unit (e.g. after year 2262 with nanoseconds).
+
+Format syntax (close to that of QDateTime):
+    yyyy    4-digit year; formatting fails for years outside [0, 9999]
+    M, MM   month (1-2 digits / exactly 2 digits)
+    d, dd   day
+    h, hh   hour (0-23), H and HH are synonyms
+    m, mm   minute
+    s, ss   second
+    z...z   fraction of second with exactly as many digits as there are z's (1-9), e.g. zzz = milliseconds
+    f       optional fraction of second: '.' or ',' followed by 1 or more digits (digits beyond nanoseconds are ignored). Formatting writes nothing.
+    t       UTC offset: 'Z', +hh, +hhmm or +hh:mm (or with '-'). Formatting writes 'Z' for zero offset, +hh:mm otherwise and nothing if offset is not set.
+    '...'   quoted literal text, '' gives single quote.
+    Any other character is a literal.
+
+TimestampFormat::iso8601() returns a format that accepts ISO 8601 extended format with optional parts: YYYY-MM-DD[(T| )hh:mm[:ss[(.|,)f...]]][Z|+hh[:mm]|-hh[:mm]]
+Common fixed width shapes of it (date only, seconds or milliseconds precision, optionally with 'Z') are parsed with the fixed width layout.
+*/
+
+#include "../dfgDefs.hpp"
+#include "../dfgAssert.hpp"
+#include "../dfgBase.hpp"
+#include "../dfgBaseTypedefs.hpp"
+#include "../ReadOnlySzParam.hpp"
+#include "../SzPtr.hpp"
+#include "../thread/ThreadPool.hpp"
+#include "DateTime.hpp"
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if DFG_LANGFEAT_CHRONO_11
+
+DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(time) {
+
+enum EpochUnit
+{
+    EpochUnitSecond,
+    EpochUnitMillisecond,
+    EpochUnitMicrosecond,
+    EpochUnitNanosecond
+};
+
+namespace DFG_DETAIL_NS
+{
+    // Returns number of days since 1970-01-01 for given proleptic Gregorian date (algorithm by Howard Hinnant, "chrono-Compatible Low-Level Date Algorithms").
+    inline int64 daysFromCivil(int64 y, const int m, const int d)
+    {
+        y -= (m <= 2) ? 1 : 0;
+        const int64 era = ((y >= 0) ? y : y - 399) / 400;
+        const int64 yoe = y - era * 400;                                   // [0, 399]
+        const int64 doy = (153 * (m + ((m > 2) ? -3 : 9)) + 2) / 5 + d - 1; // [0, 365]
+        const int64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           // [0, 146096]
+        return era * 146097 + doe - 719468;
+    }
+
+    // Inverse of daysFromCivil().
+    inline void civilFromDays(int64 z, int32& rYear, int32& rMonth, int32& rDay)
+    {
+        z += 719468;
+        const int64 era = ((z >= 0) ? z : z - 146096) / 146097;
+        const int64 doe = z - era * 146097;
+        const int64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64 mp = (5 * doy + 2) / 153;
+        rDay = static_cast<int32>(doy - (153 * mp + 2) / 5 + 1);
+        rMonth = static_cast<int32>((mp < 10) ? mp + 3 : mp - 9);
+        rYear = static_cast<int32>(yoe + era * 400 + ((rMonth <= 2) ? 1 : 0));
+    }
+
+    inline bool isLeapYear(const int32 y)
+    {
+        return (y % 4 == 0) && (y % 100 != 0 || y % 400 == 0);
+    }
+
+    inline int32 daysInMonth(const int32 y, const int32 m)
+    {
+        static const int8 days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return (m == 2 && isLeapYear(y)) ? 29 : days[m - 1];
+    }
+
+    inline int64 epochUnitsPerSecond(const EpochUnit unit)
+    {
+        static const int64 units[4] = { 1, 1000, 1000000, 1000000000 };
+        return units[unit];
+    }
+
+    inline bool isDigit(const char c)
+    {
+        return static_cast<unsigned char>(c - '0') <= 9;
+    }
+
+    // Reads exactly nCount digits from p. Return: false if there are non-digits.
+    inline bool readFixedDigits(const char* p, const size_t nCount, int32& rVal)
+    {
+        int32 n = 0;
+        for (size_t i = 0; i < nCount; ++i)
+        {
+            if (!isDigit(p[i]))
+                return false;
+            n = 10 * n + (p[i] - '0');
+        }
+        rVal = n;
+        return true;
+    }
+
+    // Writes nVal as zero padded decimal of nWidth digits (nWidth == 0 means no padding).
+    inline char* writeDigits(char* p, int32 nVal, const size_t nWidth)
+    {
+        char buffer[12];
+        size_t n = 0;
+        do
+        {
+            buffer[n++] = static_cast<char>('0' + nVal % 10);
+            nVal /= 10;
+        } while (nVal != 0);
+        for (; n < nWidth; ++n)
+            buffer[n] = '0';
+        while (n > 0)
+            *p++ = buffer[--n];
+        return p;
+    }
+
+    const int32 gnPow10[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+    enum TimestampField
+    {
+        TimestampFieldYear,
+        TimestampFieldMonth,
+        TimestampFieldDay,
+        TimestampFieldHour,
+        TimestampFieldMinute,
+        TimestampFieldSecond,
+        TimestampFieldNanosecond,
+        TimestampFieldCount
+    };
+
+    enum TimestampOpType
+    {
+        TimestampOpLiteral,
+        TimestampOpDigits,           // Field with m_nWidth digits, or 1-2 digits if m_nWidth == 0
+        TimestampOpFraction,         // Exactly m_nWidth fraction digits
+        TimestampOpOptionalFraction,
+        TimestampOpUtcOffset
+    };
+
+    struct TimestampOp
+    {
+        TimestampOpType m_type;
+        TimestampField m_field;
+        uint8 m_nWidth;
+        char m_cLiteral;
+    };
+} // namespace DFG_DETAIL_NS
+
+// Broken-down timestamp.
+struct DFG_CLASS_NAME(TimestampFields)
+{
+    DFG_CLASS_NAME(TimestampFields)() :
+        m_year(1970), m_month(1), m_day(1), m_hour(0), m_minute(0), m_second(0), m_nanosecond(0)
+    {}
+
+    // Computes time since 1970-01-01T00:00:00Z to rEpoch. If m_utcOffset is not set, defaultOffset is used and if that is not set either, fields are interpreted as UTC.
+    // Return: false if time is not representable as int64 in given unit (e.g. outside years 1677-2262 with nanoseconds), in which case rEpoch is not modified.
+    bool toEpoch(const EpochUnit unit, int64& rEpoch, const DFG_CLASS_NAME(UtcOffsetInfo)& defaultOffset = DFG_CLASS_NAME(UtcOffsetInfo)()) const
+    {
+        const int32 nOffset = (m_utcOffset.isSet()) ? m_utcOffset.offsetInSeconds() : defaultOffset.offsetInSeconds();
+        // Can't overflow with int32 year.
+        const int64 nSeconds = DFG_DETAIL_NS::daysFromCivil(m_year, m_month, m_day) * 86400 + int64(m_hour) * 3600 + int64(m_minute) * 60 + m_second - nOffset;
+        const int64 nUnitsPerSecond = DFG_DETAIL_NS::epochUnitsPerSecond(unit);
+        const int64 nSubUnits = m_nanosecond / (1000000000 / nUnitsPerSecond); // In range [0, nUnitsPerSecond[ for valid fields.
+        // Lower limit is conservative: int64_min / nUnitsPerSecond rounds towards zero so at most the last partial second before int64_min gets rejected.
+        if (nSeconds > (int64_max - nSubUnits) / nUnitsPerSecond || nSeconds < int64_min / nUnitsPerSecond)
+            return false;
+        rEpoch = nSeconds * nUnitsPerSecond + nSubUnits;
+        return true;
+    }
+
+    // Convenience overload that returns epoch time directly; returns nInvalidValue if time is not representable.
+    int64 toEpoch(const EpochUnit unit, const DFG_CLASS_NAME(UtcOffsetInfo)& defaultOffset = DFG_CLASS_NAME(UtcOffsetInfo)(), const int64 nInvalidValue = int64_min) const
+    {
+        int64 nEpoch = nInvalidValue;
+        toEpoch(unit, nEpoch, defaultOffset);
+        return nEpoch;
+    }
+
+    // Sets fields from epoch time so that they present local time of given UTC offset (UTC if offset is not set).
+    static DFG_CLASS_NAME(TimestampFields) fromEpoch(const int64 nEpoch, const EpochUnit unit, const DFG_CLASS_NAME(UtcOffsetInfo)& utcOffset = DFG_CLASS_NAME(UtcOffsetInfo)())
+    {
+        const int64 nUnitsPerSecond = DFG_DETAIL_NS::epochUnitsPerSecond(unit);
+        int64 nSeconds = nEpoch / nUnitsPerSecond;
+        int64 nSubUnits = nEpoch % nUnitsPerSecond;
+        if (nSubUnits < 0)
+        {
+            nSubUnits += nUnitsPerSecond;
+            --nSeconds;
+        }
+        nSeconds += utcOffset.offsetInSeconds();
+        int64 nDays = nSeconds / 86400;
+        int64 nSecOfDay = nSeconds % 86400;
+        if (nSecOfDay < 0)
+        {
+            nSecOfDay += 86400;
+            --nDays;
+        }
+        DFG_CLASS_NAME(TimestampFields) fields;
+        DFG_DETAIL_NS::civilFromDays(nDays, fields.m_year, fields.m_month, fields.m_day);
+        fields.m_hour = static_cast<int32>(nSecOfDay / 3600);
+        fields.m_minute = static_cast<int32>((nSecOfDay % 3600) / 60);
+        fields.m_second = static_cast<int32>(nSecOfDay % 60);
+        fields.m_nanosecond = static_cast<int32>(nSubUnits * (1000000000 / nUnitsPerSecond));
+        fields.m_utcOffset = utcOffset;
+        return fields;
+    }
+
+    DFG_CLASS_NAME(DateTime) toDateTime() const
+    {
+        return DFG_CLASS_NAME(DateTime)(m_year, m_month, m_day, m_hour, m_minute, m_second, m_nanosecond / 1000000, m_utcOffset);
+    }
+
+    static DFG_CLASS_NAME(TimestampFields) fromDateTime(const DFG_CLASS_NAME(DateTime)& dt)
+    {
+        DFG_CLASS_NAME(TimestampFields) fields;
+        fields.m_year = dt.year();
+        fields.m_month = dt.month();
+        fields.m_day = dt.day();
+        fields.m_hour = dt.hour();
+        fields.m_minute = dt.minute();
+        fields.m_second = dt.second();
+        fields.m_nanosecond = 1000000 * static_cast<int32>(dt.millisecond());
+        fields.m_utcOffset = dt.utcOffsetInfo();
+        return fields;
+    }
+
+    // Return: true if fields present a valid date and time of day.
+    bool isValid() const
+    {
+        return m_month >= 1 && m_month <= 12 &&
+               m_day >= 1 && m_day <= DFG_DETAIL_NS::daysInMonth(m_year, m_month) &&
+               m_hour >= 0 && m_hour <= 23 &&
+               m_minute >= 0 && m_minute <= 59 &&
+               m_second >= 0 && m_second <= 59 &&
+               m_nanosecond >= 0 && m_nanosecond <= 999999999;
+    }
+
+    int32 m_year;
+    int32 m_month;      // In range 1-12
+    int32 m_day;        // In range 1-31
+    int32 m_hour;
+    int32 m_minute;
+    int32 m_second;
+    int32 m_nanosecond;
+    DFG_CLASS_NAME(UtcOffsetInfo) m_utcOffset; // Not set if timestamp had no offset information.
+}; // struct TimestampFields
+
+class DFG_CLASS_NAME(TimestampFormat)
+{
+public:
+    typedef DFG_DETAIL_NS::TimestampOp Op;
+
+    // Compiles format; use isValid() to check whether format was accepted.
+    explicit DFG_CLASS_NAME(TimestampFormat)(const DFG_CLASS_NAME(StringViewC)& svFormat) :
+        m_bValid(false),
+        m_bIso8601(false)
+    {
+        m_bValid = compile(svFormat);
+        if (m_bValid)
+            createFixedWidthLayout(m_ops, m_fixedLayout);
+    }
+
+    static DFG_CLASS_NAME(TimestampFormat) iso8601()
+    {
+        DFG_CLASS_NAME(TimestampFormat) format("yyyy-MM-dd'T'hh:mm:ssft");
+        format.m_bIso8601 = true;
+        // Fixed width shapes that are tried before the generic ISO 8601 parser; trailing 'Z' is handled separately in parse().
+        const char* const shapes[] = { "yyyy-MM-dd'T'hh:mm:ss", "yyyy-MM-dd hh:mm:ss", "yyyy-MM-dd'T'hh:mm:ss.zzz", "yyyy-MM-dd hh:mm:ss.zzz", "yyyy-MM-dd" };
+        for (const auto pszShape : shapes)
+            format.m_isoFixedLayouts.push_back(DFG_CLASS_NAME(TimestampFormat)(pszShape).m_fixedLayout);
+        return format;
+    }
+
+    bool isValid() const { return m_bValid; }
+
+    // Returns the length of every string matching this format, 0 if format is not fixed width.
+    size_t fixedWidth() const { return m_fixedLayout.m_nWidth; }
+
+    // Parses timestamp from sv. Return: true if sv matches the format and presents a valid timestamp, false otherwise (in which case rFields has unspecified content).
+    bool parse(const DFG_CLASS_NAME(StringViewC)& sv, DFG_CLASS_NAME(TimestampFields)& rFields) const
+    {
+        if (!m_bValid)
+            return false;
+        rFields = DFG_CLASS_NAME(TimestampFields)();
+        bool bOk;
+        if (m_bIso8601)
+            bOk = parseIso8601FixedShape(sv.beginRaw(), sv.length(), rFields) || parseIso8601(sv.beginRaw(), sv.endRaw(), rFields);
+        else if (m_fixedLayout.m_nWidth != 0)
+            bOk = parseFixedWidth(m_fixedLayout, sv.beginRaw(), sv.length(), rFields);
+        else
+            bOk = parseGeneric(sv.beginRaw(), sv.endRaw(), rFields);
+        return bOk && rFields.isValid();
+    }
+
+    // Parses timestamp and converts it to epoch time. Return: true if successful, false otherwise in which case rEpoch is not modified.
+    bool parseToEpoch(const DFG_CLASS_NAME(StringViewC)& sv, int64& rEpoch, const EpochUnit unit = EpochUnitMillisecond, const DFG_CLASS_NAME(UtcOffsetInfo)& defaultOffset = DFG_CLASS_NAME(UtcOffsetInfo)()) const
+    {
+        DFG_CLASS_NAME(TimestampFields) fields;
+        return parse(sv, fields) && fields.toEpoch(unit, rEpoch, defaultOffset);
+    }
+
+    // Parses every item in range [iterBegin, iterEnd[ (items must be convertible to StringViewC) and writes epoch values to pOut; unparseable items are written as nInvalidValue.
+    // Return: number of successfully parsed items.
+    template <class Iter_T>
+    size_t parseToEpochBulk(Iter_T iterBegin, const Iter_T iterEnd, int64* pOut, const EpochUnit unit = EpochUnitMillisecond, const int64 nInvalidValue = int64_min,
+                            const DFG_CLASS_NAME(UtcOffsetInfo)& defaultOffset = DFG_CLASS_NAME(UtcOffsetInfo)()) const
+    {
+        size_t nSuccessCount = 0;
+        for (; iterBegin != iterEnd; ++iterBegin, ++pOut)
+        {
+            if (parseToEpoch(DFG_CLASS_NAME(StringViewC)(*iterBegin), *pOut, unit, defaultOffset))
+                ++nSuccessCount;
+            else
+                *pOut = nInvalidValue;
+        }
+        return nSuccessCount;
+    }
+
+    // Writes formatted timestamp to pBuffer, which is always null terminated if nBufferSize > 0.
+    // Return: length of formatted string or 0 if buffer was too small, format invalid or fields not representable (e.g. year outside [0, 9999]).
+    size_t format(const DFG_CLASS_NAME(TimestampFields)& fields, char* const pBuffer, const size_t nBufferSize) const
+    {
+        char szTemp[128];
+        char* p = nullptr;
+        if (m_bValid)
+            p = (m_bIso8601) ? formatIso8601(fields, szTemp) : formatGeneric(fields, szTemp);
+        const size_t nLength = (p) ? static_cast<size_t>(p - szTemp) : 0;
+        if (nBufferSize == 0)
+            return 0;
+        if (nLength >= nBufferSize)
+        {
+            pBuffer[0] = '\0';
+            return 0;
+        }
+        std::memcpy(pBuffer, szTemp, nLength);
+        pBuffer[nLength] = '\0';
+        return nLength;
+    }
+
+    std::string format(const DFG_CLASS_NAME(TimestampFields)& fields) const
+    {
+        char szBuffer[128];
+        const auto nLength = format(fields, szBuffer, sizeof(szBuffer));
+        return std::string(szBuffer, nLength);
+    }
+
+    // Formats epoch time as local time of given offset.
+    std::string formatEpoch(const int64 nEpoch, const EpochUnit unit = EpochUnitMillisecond, const DFG_CLASS_NAME(UtcOffsetInfo)& utcOffset = DFG_CLASS_NAME(UtcOffsetInfo)()) const
+    {
+        return format(DFG_CLASS_NAME(TimestampFields)::fromEpoch(nEpoch, unit, utcOffset));
+    }
+
+private:
+    struct FixedField
+    {
+        size_t m_nOffset;
+        size_t m_nWidth;
+        DFG_DETAIL_NS::TimestampField m_field;
+    };
+
+    // Fixed width layout: characters are validated against m_chars/m_isDigit and fields are read from precomputed offsets.
+    struct FixedWidthLayout
+    {
+        FixedWidthLayout() : m_nWidth(0) {}
+
+        size_t m_nWidth; // 0 if format is not fixed width.
+        std::string m_chars;
+        std::vector<uint8> m_isDigit;
+        std::vector<FixedField> m_fields;
+    };
+
+    void addOp(const DFG_DETAIL_NS::TimestampOpType type, const DFG_DETAIL_NS::TimestampField field, const size_t nWidth, const char c = '\0')
+    {
+        const Op op = { type, field, static_cast<uint8>(nWidth), c };
+        m_ops.push_back(op);
+    }
+
+    bool compile(const DFG_CLASS_NAME(StringViewC)& svFormat)
+    {
+        using namespace DFG_DETAIL_NS;
+        const char* p = svFormat.beginRaw();
+        const char* const pEnd = svFormat.endRaw();
+        while (p != pEnd)
+        {
+            const char c = *p;
+            size_t nRun = 1;
+            while (p + nRun != pEnd && p[nRun] == c)
+                ++nRun;
+            const auto addDigitField = [&](const TimestampField field) -> bool
+            {
+                if (nRun > 2)
+                    return false;
+                addOp(TimestampOpDigits, field, (nRun == 2) ? 2 : 0);
+                return true;
+            };
+            bool bOk = true;
+            switch (c)
+            {
+                case 'y': bOk = (nRun == 4); addOp(TimestampOpDigits, TimestampFieldYear, 4); break;
+                case 'M': bOk = addDigitField(TimestampFieldMonth); break;
+                case 'd': bOk = addDigitField(TimestampFieldDay); break;
+                case 'h': // Fall through
+                case 'H': bOk = addDigitField(TimestampFieldHour); break;
+                case 'm': bOk = addDigitField(TimestampFieldMinute); break;
+                case 's': bOk = addDigitField(TimestampFieldSecond); break;
+                case 'z': bOk = (nRun <= 9); addOp(TimestampOpFraction, TimestampFieldNanosecond, nRun); break;
+                case 'f': nRun = 1; addOp(TimestampOpOptionalFraction, TimestampFieldNanosecond, 0); break;
+                case 't': nRun = 1; addOp(TimestampOpUtcOffset, TimestampFieldCount, 0); break;
+                case '\'':
+                {
+                    if (nRun >= 2) // '' -> literal quote
+                    {
+                        nRun = 2;
+                        addOp(TimestampOpLiteral, TimestampFieldCount, 1, '\'');
+                        break;
+                    }
+                    const char* pQuoteEnd = p + 1;
+                    while (pQuoteEnd != pEnd && *pQuoteEnd != '\'')
+                        ++pQuoteEnd;
+                    if (pQuoteEnd == pEnd)
+                        return false; // Unterminated quote
+                    for (const char* pLit = p + 1; pLit != pQuoteEnd; ++pLit)
+                        addOp(TimestampOpLiteral, TimestampFieldCount, 1, *pLit);
+                    nRun = static_cast<size_t>(pQuoteEnd - p) + 1;
+                    break;
+                }
+                default:
+                    nRun = 1;
+                    addOp(TimestampOpLiteral, TimestampFieldCount, 1, c);
+                    break;
+            }
+            if (!bOk)
+                return false;
+            p += nRun;
+        }
+        return !m_ops.empty();
+    }
+
+    // Creates layout to rLayout if all ops have fixed width, otherwise leaves rLayout untouched.
+    static void createFixedWidthLayout(const std::vector<Op>& ops, FixedWidthLayout& rLayout)
+    {
+        using namespace DFG_DETAIL_NS;
+        for (const auto& op : ops)
+        {
+            if (op.m_type == TimestampOpOptionalFraction || op.m_type == TimestampOpUtcOffset || (op.m_type == TimestampOpDigits && op.m_nWidth == 0))
+                return;
+        }
+        size_t nOffset = 0;
+        for (const auto& op : ops)
+        {
+            if (op.m_type == TimestampOpLiteral)
+            {
+                rLayout.m_chars.push_back(op.m_cLiteral);
+                rLayout.m_isDigit.push_back(0);
+            }
+            else
+            {
+                rLayout.m_chars.append(op.m_nWidth, '0');
+                rLayout.m_isDigit.insert(rLayout.m_isDigit.end(), op.m_nWidth, 1);
+                const FixedField field = { nOffset, op.m_nWidth, op.m_field };
+                rLayout.m_fields.push_back(field);
+            }
+            nOffset += op.m_nWidth;
+        }
+        rLayout.m_nWidth = nOffset;
+    }
+
+    static void setField(DFG_CLASS_NAME(TimestampFields)& rFields, const DFG_DETAIL_NS::TimestampField field, const int32 nVal, const size_t nWidth)
+    {
+        using namespace DFG_DETAIL_NS;
+        switch (field)
+        {
+            case TimestampFieldYear:       rFields.m_year = nVal; break;
+            case TimestampFieldMonth:      rFields.m_month = nVal; break;
+            case TimestampFieldDay:        rFields.m_day = nVal; break;
+            case TimestampFieldHour:       rFields.m_hour = nVal; break;
+            case TimestampFieldMinute:     rFields.m_minute = nVal; break;
+            case TimestampFieldSecond:     rFields.m_second = nVal; break;
+            case TimestampFieldNanosecond: rFields.m_nanosecond = nVal * gnPow10[9 - nWidth]; break;
+            default: break;
+        }
+    }
+
+    // Return: false if p doesn't match the layout, in which case rFields is not modified.
+    static bool parseFixedWidth(const FixedWidthLayout& layout, const char* const p, const size_t nLength, DFG_CLASS_NAME(TimestampFields)& rFields)
+    {
+        if (nLength != layout.m_nWidth || nLength == 0)
+            return false;
+        // Validates all characters without branches: digit positions must have digits and others must match the layout.
+        unsigned int nBad = 0;
+        for (size_t i = 0; i < nLength; ++i)
+        {
+            const unsigned int bDigit = layout.m_isDigit[i];
+            const unsigned int bNotDigit = static_cast<unsigned char>(p[i] - '0') > 9;
+            const unsigned int bNotLiteral = p[i] != layout.m_chars[i];
+            nBad |= (bDigit & bNotDigit) | ((1 - bDigit) & bNotLiteral);
+        }
+        if (nBad != 0)
+            return false;
+        for (const auto& field : layout.m_fields)
+        {
+            int32 nVal = 0;
+            for (size_t i = 0; i < field.m_nWidth; ++i)
+                nVal = 10 * nVal + (p[field.m_nOffset + i] - '0');
+            setField(rFields, field.m_field, nVal, field.m_nWidth);
+        }
+        return true;
+    }
+
+    // Parses optional fraction part ('.' or ',' followed by digits) from p. Return: false if there was separator without digits.
+    static bool parseOptionalFraction(const char*& p, const char* const pEnd, DFG_CLASS_NAME(TimestampFields)& rFields)
+    {
+        using namespace DFG_DETAIL_NS;
+        if (p == pEnd || (*p != '.' && *p != ','))
+            return true;
+        ++p;
+        int32 nVal = 0;
+        size_t nDigits = 0;
+        for (; p != pEnd && isDigit(*p); ++p, ++nDigits)
+        {
+            if (nDigits < 9)
+                nVal = 10 * nVal + (*p - '0');
+        }
+        if (nDigits == 0)
+            return false;
+        rFields.m_nanosecond = nVal * gnPow10[9 - Min(nDigits, size_t(9))];
+        return true;
+    }
+
+    static bool parseUtcOffset(const char*& p, const char* const pEnd, DFG_CLASS_NAME(TimestampFields)& rFields)
+    {
+        using namespace DFG_DETAIL_NS;
+        if (p == pEnd)
+            return false;
+        if (*p == 'Z')
+        {
+            ++p;
+            rFields.m_utcOffset.setOffsetInSeconds(0);
+            return true;
+        }
+        if (*p != '+' && *p != '-')
+            return false;
+        const int32 nSign = (*p == '-') ? -1 : 1;
+        ++p;
+        int32 nHours = 0, nMinutes = 0;
+        if (pEnd - p < 2 || !readFixedDigits(p, 2, nHours))
+            return false;
+        p += 2;
+        if (p != pEnd && *p == ':')
+        {
+            ++p;
+            if (pEnd - p < 2 || !readFixedDigits(p, 2, nMinutes))
+                return false;
+            p += 2;
+        }
+        else if (pEnd - p >= 2 && isDigit(p[0]) && isDigit(p[1]))
+        {
+            readFixedDigits(p, 2, nMinutes);
+            p += 2;
+        }
+        if (nHours > 23 || nMinutes > 59)
+            return false;
+        rFields.m_utcOffset.setOffsetInSeconds(nSign * (3600 * nHours + 60 * nMinutes));
+        return true;
+    }
+
+    bool parseGeneric(const char* p, const char* const pEnd, DFG_CLASS_NAME(TimestampFields)& rFields) const
+    {
+        using namespace DFG_DETAIL_NS;
+        for (const auto& op : m_ops)
+        {
+            switch (op.m_type)
+            {
+                case TimestampOpLiteral:
+                    if (p == pEnd || *p != op.m_cLiteral)
+                        return false;
+                    ++p;
+                    break;
+                case TimestampOpDigits:
+                case TimestampOpFraction:
+                {
+                    size_t nWidth = op.m_nWidth;
+                    if (nWidth == 0) // 1 or 2 digits
+                        nWidth = (pEnd - p >= 2 && isDigit(p[1])) ? 2 : 1;
+                    int32 nVal;
+                    if (static_cast<size_t>(pEnd - p) < nWidth || !readFixedDigits(p, nWidth, nVal))
+                        return false;
+                    setField(rFields, op.m_field, nVal, nWidth);
+                    p += nWidth;
+                    break;
+                }
+                case TimestampOpOptionalFraction:
+                    if (!parseOptionalFraction(p, pEnd, rFields))
+                        return false;
+                    break;
+                case TimestampOpUtcOffset:
+                    if (!parseUtcOffset(p, pEnd, rFields))
+                        return false;
+                    break;
+            }
+        }
+        return p == pEnd;
+    }
+
+    // Parses ISO 8601 timestamps that have one of the fixed width shapes optionally followed by 'Z'.
+    // Return: false if there was no matching shape, in which case rFields is not modified.
+    bool parseIso8601FixedShape(const char* const p, size_t nLength, DFG_CLASS_NAME(TimestampFields)& rFields) const
+    {
+        const bool bUtc = (nLength > 0 && p[nLength - 1] == 'Z');
+        if (bUtc)
+            --nLength;
+        for (const auto& layout : m_isoFixedLayouts)
+        {
+            if (parseFixedWidth(layout, p, nLength, rFields))
+            {
+                if (bUtc)
+                    rFields.m_utcOffset.setOffsetInSeconds(0);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool parseIso8601(const char* p, const char* const pEnd, DFG_CLASS_NAME(TimestampFields)& rFields)
+    {
+        using namespace DFG_DETAIL_NS;
+        const auto nLength = pEnd - p;
+        // Date part
+        if (nLength < 10 || p[4] != '-' || p[7] != '-' ||
+            !readFixedDigits(p, 4, rFields.m_year) || !readFixedDigits(p + 5, 2, rFields.m_month) || !readFixedDigits(p + 8, 2, rFields.m_day))
+        {
+            return false;
+        }
+        p += 10;
+        if (p == pEnd)
+            return true;
+        // Time part: (T| )hh:mm[:ss[fraction]]
+        if (*p == 'T' || *p == ' ')
+        {
+            if (pEnd - p < 6 || p[3] != ':' || !readFixedDigits(p + 1, 2, rFields.m_hour) || !readFixedDigits(p + 4, 2, rFields.m_minute))
+                return false;
+            p += 6;
+            if (p != pEnd && *p == ':')
+            {
+                if (pEnd - p < 3 || !readFixedDigits(p + 1, 2, rFields.m_second))
+                    return false;
+                p += 3;
+                if (!parseOptionalFraction(p, pEnd, rFields))
+                    return false;
+            }
+        }
+        if (p == pEnd)
+            return true;
+        return parseUtcOffset(p, pEnd, rFields) && p == pEnd;
+    }
+
+    static char* formatUtcOffset(const DFG_CLASS_NAME(UtcOffsetInfo)& offset, char* p)
+    {
+        if (!offset.isSet())
+            return p;
+        const int32 nOffset = offset.offsetInSeconds();
+        if (nOffset == 0)
+        {
+            *p++ = 'Z';
+            return p;
+        }
+        *p++ = (nOffset < 0) ? '-' : '+';
+        const int32 nAbs = (nOffset < 0) ? -nOffset : nOffset;
+        p = DFG_DETAIL_NS::writeDigits(p, nAbs / 3600, 2);
+        *p++ = ':';
+        return DFG_DETAIL_NS::writeDigits(p, (nAbs % 3600) / 60, 2);
+    }
+
+    // Return: true if year can be written with 4 digits.
+    static bool isFormattableYear(const int32 nYear)
+    {
+        return nYear >= 0 && nYear <= 9999;
+    }
+
+    // Return: end of written string or nullptr if fields can't be formatted.
+    char* formatGeneric(const DFG_CLASS_NAME(TimestampFields)& fields, char* p) const
+    {
+        using namespace DFG_DETAIL_NS;
+        if (!isFormattableYear(fields.m_year))
+            return nullptr;
+        for (const auto& op : m_ops)
+        {
+            switch (op.m_type)
+            {
+                case TimestampOpLiteral: *p++ = op.m_cLiteral; break;
+                case TimestampOpDigits:
+                {
+                    int32 nVal = 0;
+                    switch (op.m_field)
+                    {
+                        case TimestampFieldYear:   nVal = fields.m_year; break;
+                        case TimestampFieldMonth:  nVal = fields.m_month; break;
+                        case TimestampFieldDay:    nVal = fields.m_day; break;
+                        case TimestampFieldHour:   nVal = fields.m_hour; break;
+                        case TimestampFieldMinute: nVal = fields.m_minute; break;
+                        case TimestampFieldSecond: nVal = fields.m_second; break;
+                        default: break;
+                    }
+                    p = writeDigits(p, nVal, op.m_nWidth);
+                    break;
+                }
+                case TimestampOpFraction: p = writeDigits(p, fields.m_nanosecond / gnPow10[9 - op.m_nWidth], op.m_nWidth); break;
+                case TimestampOpOptionalFraction: break;
+                case TimestampOpUtcOffset: p = formatUtcOffset(fields.m_utcOffset, p); break;
+            }
+        }
+        return p;
+    }
+
+    // Writes YYYY-MM-DDThh:mm:ss[.fff|.ffffff|.fffffffff][offset]. Return: end of written string or nullptr if fields can't be formatted.
+    static char* formatIso8601(const DFG_CLASS_NAME(TimestampFields)& fields, char* p)
+    {
+        using namespace DFG_DETAIL_NS;
+        if (!isFormattableYear(fields.m_year))
+            return nullptr;
+        p = writeDigits(p, fields.m_year, 4);           *p++ = '-';
+        p = writeDigits(p, fields.m_month, 2);          *p++ = '-';
+        p = writeDigits(p, fields.m_day, 2);            *p++ = 'T';
+        p = writeDigits(p, fields.m_hour, 2);           *p++ = ':';
+        p = writeDigits(p, fields.m_minute, 2);         *p++ = ':';
+        p = writeDigits(p, fields.m_second, 2);
+        if (fields.m_nanosecond != 0)
+        {
+            *p++ = '.';
+            if (fields.m_nanosecond % 1000000 == 0)
+                p = writeDigits(p, fields.m_nanosecond / 1000000, 3);
+            else if (fields.m_nanosecond % 1000 == 0)
+                p = writeDigits(p, fields.m_nanosecond / 1000, 6);
+            else
+                p = writeDigits(p, fields.m_nanosecond, 9);
+        }
+        return formatUtcOffset(fields.m_utcOffset, p);
+    }
+
+    bool m_bValid;
+    bool m_bIso8601;
+    std::vector<Op> m_ops;
+    FixedWidthLayout m_fixedLayout; // Empty if format is not fixed width.
+    std::vector<FixedWidthLayout> m_isoFixedLayouts; // Used only by iso8601() format.
+}; // class TimestampFormat
+
+// Parses timestamps in column nCol of a TableSz/TableCsv and returns epoch values for rows [0, table.rowCountByMaxRowIndex()[;
+// missing or unparseable cells are given nInvalidValue. Rows are processed in parallel chunks in thread::defaultThreadPool();
+// nMaxThreadCount limits the number of concurrently processed chunks (0 = no limit).
+template <class Table_T>
+std::vector<int64> timestampColumnToEpoch(const Table_T& table, const decltype(std::declval<const Table_T&>().rowCountByMaxRowIndex()) nCol, const DFG_CLASS_NAME(TimestampFormat)& format,
+                                          const EpochUnit unit = EpochUnitMillisecond,
+                                          const int64 nInvalidValue = int64_min,
+                                          const DFG_CLASS_NAME(UtcOffsetInfo)& defaultOffset = DFG_CLASS_NAME(UtcOffsetInfo)(),
+                                          const size_t nMaxThreadCount = 0,
+                                          const size_t nRowsPerChunk = 8192)
+{
+    typedef decltype(table.rowCountByMaxRowIndex()) IndexT;
+    const size_t nRowCount = static_cast<size_t>(table.rowCountByMaxRowIndex());
+    std::vector<int64> epochs(nRowCount, nInvalidValue);
+    const size_t nChunkSize = Max(size_t(1), nRowsPerChunk);
+    const size_t nChunkCount = (nRowCount + nChunkSize - 1) / nChunkSize;
+    // Chunks are divided into nPieceCount contiguous pieces that are run as separate tasks.
+    const size_t nPieceCount = (nMaxThreadCount == 0) ? nChunkCount : Min(nMaxThreadCount, nChunkCount);
+    DFG_MODULE_NS(thread)::parallelFor(DFG_MODULE_NS(thread)::defaultThreadPool(), 0, nPieceCount, 1, [&](const size_t iPieceBegin, const size_t iPieceEnd)
+    {
+        const size_t iBegin = (iPieceBegin * nChunkCount / nPieceCount) * nChunkSize;
+        const size_t iEnd = Min(nRowCount, (iPieceEnd * nChunkCount / nPieceCount) * nChunkSize);
+        table.forEachFwdRowInColumn(nCol, static_cast<IndexT>(iBegin), static_cast<IndexT>(iEnd), [&](const IndexT nRow, const typename Table_T::SzPtrR psz)
+        {
+            const char* const pszRaw = toCharPtr_raw(psz);
+            if (pszRaw)
+                format.parseToEpoch(DFG_CLASS_NAME(StringViewC)(pszRaw), epochs[static_cast<size_t>(nRow)], unit, defaultOffset);
+        });
+    });
+    return epochs;
+}
+
+}} // module time
+
+#endif // DFG_LANGFEAT_CHRONO_11
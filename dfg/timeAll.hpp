@@ -2,3 +2,5 @@
 
 #include "time.hpp"
 #include "time/timerCpu.hpp"
+#include "time/profiling.hpp"
+#include "time/timestampFormat.hpp"
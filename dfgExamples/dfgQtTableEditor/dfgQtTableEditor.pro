@@ -116,7 +116,9 @@ SOURCES += \
         $$_PRO_FILE_PWD_/../../dfg/qt/QtApplication.cpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/TableEditor.cpp \
         $$_PRO_FILE_PWD_/../../dfg/os/memoryMappedFile.cpp \
+        $$_PRO_FILE_PWD_/../../dfg/thread/setThreadName.cpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/CsvTableViewCompleterDelegate.cpp \
+        $$_PRO_FILE_PWD_/../../dfg/qt/CsvTableViewSortFilterProxyModel.cpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/graphTools.cpp
 
 HEADERS += $$_PRO_FILE_PWD_/../../dfg/qt/CsvItemModel.hpp \
@@ -126,6 +128,7 @@ HEADERS += $$_PRO_FILE_PWD_/../../dfg/qt/CsvItemModel.hpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/TableEditor.hpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/PropertyHelper.hpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/CsvTableViewCompleterDelegate.hpp \
+        $$_PRO_FILE_PWD_/../../dfg/qt/CsvTableViewSortFilterProxyModel.hpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/StringMatchDefinition.hpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/tableViewUndoCommands.hpp \
         $$_PRO_FILE_PWD_/../../dfg/qt/widgetHelpers.hpp \
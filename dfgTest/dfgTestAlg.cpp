@@ -4,6 +4,7 @@
 #include <dfg/alg/sortMultiple.hpp>
 #include <dfg/alg/rank.hpp>
 #include <dfg/alg/sortSingleItem.hpp>
+#include <dfg/alg/sortParallel.hpp>
 #include <vector>
 #include <list>
 #include <map>
@@ -606,6 +607,34 @@ TEST(dfgAlg, findNearest)
     }
 }
 
+TEST(dfgAlg, stableSortParallel)
+{
+    using namespace DFG_MODULE_NS(alg);
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    auto distrEng = DFG_MODULE_NS(rand)::makeDistributionEngineUniform(&randEng, 0, 100);
+    typedef std::pair<int, int> PairT;
+    const auto pred = [](const PairT& a, const PairT& b) { return a.first < b.first; };
+    for (const size_t nThreadCount : { 1, 2, 3, 4, 7 })
+    {
+        std::vector<PairT> v;
+        for (int i = 0; i < 1000; ++i)
+            v.push_back(PairT(distrEng(), i)); // Second member is input order so that stability can be checked.
+        auto vExpected = v;
+        std::stable_sort(vExpected.begin(), vExpected.end(), pred);
+        stableSortParallel(v.begin(), v.end(), pred, nThreadCount, 10);
+        EXPECT_EQ(vExpected, v);
+    }
+
+    // Empty and default predicate
+    {
+        std::vector<int> v;
+        stableSortParallel(v.begin(), v.end());
+        v = { 3, 1, 2 };
+        stableSortParallel(v.begin(), v.end());
+        EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), v);
+    }
+}
+
 TEST(dfgAlg, sortSingleItem)
 {
     using namespace DFG_MODULE_NS(alg);
@@ -5,18 +5,35 @@
 #include <string>
 #include <deque>
 #include <list>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <dfg/ptrToContiguousMemory.hpp>
 #include <dfg/dfgBase.hpp>
 #include <dfg/ReadOnlySzParam.hpp>
 #include <dfg/cont/interleavedXsortedTwoChannelWrapper.hpp>
 #include <dfg/cont/valueArray.hpp>
+#include <dfg/cont/CellBlockJournal.hpp>
 #include <dfg/cont/CsvConfig.hpp>
+#include <dfg/cont/CsvConfigCompiled.hpp>
+#include <dfg/cont/EytzingerSearchIndex.hpp>
+#include <dfg/cont/FlatHashMap.hpp>
+#include <dfg/cont/IntervalSet.hpp>
 #include <dfg/cont/MapVector.hpp>
+#include <dfg/cont/OrderStatisticsMultiset.hpp>
 #include <dfg/cont/ViewableSharedPtr.hpp>
 #include <dfg/cont/SetVector.hpp>
 #include <dfg/cont/SortedSequence.hpp>
 #include <dfg/cont/tableCsv.hpp>
+#include <dfg/cont/tableCsvIncrementalWrite.hpp>
+#include <dfg/cont/tableDiff.hpp>
+#include <dfg/cont/tableMatchIndex.hpp>
+#include <dfg/cont/tableSnapshot.hpp>
 #include <dfg/cont/TorRef.hpp>
 #include <dfg/cont/TrivialPair.hpp>
 #include <dfg/cont/UniqueResourceHolder.hpp>
@@ -27,6 +44,7 @@
 #include <dfg/iter/szIterator.hpp>
 #include <dfg/cont/contAlg.hpp>
 #include <dfg/io/cstdio.hpp>
+#include <dfg/os/removeFile.hpp>
 #include <dfg/time/timerCpu.hpp>
 
 TEST(dfgCont, makeVector)
@@ -132,6 +150,76 @@ TEST(dfgCont, table)
 
 }
 
+TEST(dfgCont, table_rowAccess)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(cont);
+
+    // Random operations compared against vector of rows.
+    DFG_CLASS_NAME(Table)<int> table;
+    std::vector<std::vector<int>> expected;
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    auto rowDistr = DFG_MODULE_NS(rand)::makeDistributionEngineUniform(&randEng, 0, 30);
+    auto colDistr = DFG_MODULE_NS(rand)::makeDistributionEngineUniform(&randEng, 0, 10);
+    for (int i = 0; i < 2000; ++i)
+    {
+        const auto nRow = static_cast<size_t>(rowDistr());
+        if (nRow >= expected.size())
+            expected.resize(nRow + 1);
+        if (i % 2 == 0)
+        {
+            table.pushBackOnRow(nRow, i);
+            expected[nRow].push_back(i);
+        }
+        else
+        {
+            const auto nCol = static_cast<size_t>(colDistr());
+            table.setElement(nRow, nCol, i);
+            if (nCol >= expected[nRow].size())
+                expected[nRow].resize(nCol + 1, 0);
+            expected[nRow][nCol] = i;
+        }
+    }
+    ASSERT_EQ(expected.size(), table.getRowCount());
+    size_t nCellCount = 0;
+    for (size_t r = 0; r < expected.size(); ++r)
+    {
+        ASSERT_EQ(expected[r].size(), table.getColumnCountOnRow(r));
+        for (size_t c = 0; c < expected[r].size(); ++c)
+            EXPECT_EQ(expected[r][c], table(r, c));
+        const auto rowRange = table.rowRange(r);
+        EXPECT_TRUE(std::equal(expected[r].begin(), expected[r].end(), rowRange.begin()));
+        EXPECT_EQ(expected[r].size(), rowRange.size());
+        nCellCount += expected[r].size();
+    }
+    EXPECT_EQ(nCellCount, table.getCellCount());
+    EXPECT_TRUE(table.rowRange(expected.size()).empty());
+
+    size_t nRowCounter = 0;
+    table.forEachRow([&](const size_t nRow, DFG_CLASS_NAME(Table)<int>::ConstRowRange range)
+    {
+        EXPECT_EQ(nRowCounter++, nRow);
+        EXPECT_TRUE(std::equal(expected[nRow].begin(), expected[nRow].end(), range.begin()));
+    });
+    EXPECT_EQ(expected.size(), nRowCounter);
+
+    // setElements() and clear()
+    table.setElements(std::vector<int>({ 1, 2, 3, 4, 5 }), 2);
+    EXPECT_EQ(3, table.getRowCount());
+    EXPECT_EQ(4, table(1, 1));
+    EXPECT_EQ(5, table(2, 0));
+    table.clear();
+    EXPECT_EQ(0, table.getRowCount());
+    table.pushBackOnRow(1, 10);
+    EXPECT_EQ(10, table(1, 0));
+
+    // Moved from table is usable.
+    auto table2 = std::move(table);
+    table.pushBackOnRow(0, 1);
+    EXPECT_EQ(1, table(0, 0));
+    EXPECT_EQ(10, table2(1, 0));
+}
+
 TEST(dfgCont, TableSzUntypedInterface)
 {
     using namespace DFG_ROOT_NS;
@@ -447,6 +535,302 @@ TEST(dfgCont, TableSz_forEachFwdColumnIndex)
     }
 }
 
+TEST(dfgCont, TableSz_forEachFwdRowInColumnWithRowRange)
+{
+    using namespace DFG_MODULE_NS(cont);
+    DFG_CLASS_NAME(TableSz)<char> table;
+    table.setElement(0, 0, "a");
+    table.setElement(2, 0, "b");
+    table.setElement(3, 0, "c");
+    table.setElement(7, 0, "d");
+    table.setElement(1, 1, "e");
+
+    std::string s;
+    std::vector<size_t> rows;
+    const auto collector = [&](size_t nRow, const char* psz) { rows.push_back(nRow); s += psz; };
+    table.forEachFwdRowInColumn(0, 1, 7, collector);
+    EXPECT_EQ("bc", s);
+    EXPECT_EQ(std::vector<size_t>({ 2, 3 }), rows);
+
+    s.clear();
+    rows.clear();
+    table.forEachFwdRowInColumn(0, 0, 100, collector);
+    EXPECT_EQ("abcd", s);
+
+    s.clear();
+    table.forEachFwdRowInColumn(0, 4, 7, collector); // Range without any items
+    table.forEachFwdRowInColumn(0, 3, 3, collector); // Empty range
+    table.forEachFwdRowInColumn(0, 5, 2, collector); // Invalid range
+    table.forEachFwdRowInColumn(5, 0, 10, collector); // Invalid column
+    EXPECT_TRUE(s.empty());
+
+    table.forEachFwdRowInColumn(1, 0, 2, collector);
+    EXPECT_EQ("e", s);
+}
+
+TEST(dfgCont, TableMatchIndex)
+{
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(TableSz)<char, int> TableT;
+    typedef DFG_CLASS_NAME(TableMatchIndex)<int> MatchIndexT;
+    TableT table;
+    // a   xa  b
+    // ax  b
+    //     c   xx
+    table.setElement(0, 0, "a");
+    table.setElement(0, 1, "xa");
+    table.setElement(0, 2, "b");
+    table.setElement(1, 0, "ax");
+    table.setElement(1, 1, "b");
+    table.setElement(2, 1, "c");
+    table.setElement(2, 2, "xx");
+
+    const auto containsX = [](const char* psz) { return std::strchr(psz, 'x') != nullptr; };
+
+    MatchIndexT index;
+    EXPECT_FALSE(index.isBuilt());
+    index.build(table, 3, 3, -1, containsX);
+    EXPECT_TRUE(index.isBuilt());
+    EXPECT_EQ(3, index.matchCount());
+    EXPECT_TRUE(index.isMatch(0, 1));
+    EXPECT_TRUE(index.isMatch(1, 0));
+    EXPECT_TRUE(index.isMatch(2, 2));
+    EXPECT_FALSE(index.isMatch(0, 0));
+    EXPECT_FALSE(index.isMatch(5, 5));
+
+    // Linear forward and backward with wrapping.
+    {
+        int r = 0, c = 0;
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(0, r); EXPECT_EQ(1, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(1, r); EXPECT_EQ(0, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(2, r); EXPECT_EQ(2, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(0, r); EXPECT_EQ(1, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(2, r); EXPECT_EQ(2, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(1, r); EXPECT_EQ(0, c);
+        r = 1; c = 1;
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(1, r); EXPECT_EQ(0, c);
+    }
+
+    // Row increment style: column-major order with wrapping, search continues after the seed column.
+    {
+        int r = 0, c = 0;
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(1, r); EXPECT_EQ(0, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(0, r); EXPECT_EQ(1, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(2, r); EXPECT_EQ(2, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(1, r); EXPECT_EQ(0, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(2, r); EXPECT_EQ(2, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(0, r); EXPECT_EQ(1, c);
+        r = 2; c = 1;
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(0, r); EXPECT_EQ(1, c);
+    }
+
+    // Single column index and updating
+    {
+        index.build(table, 3, 3, 1, containsX);
+        EXPECT_EQ(1, index.matchCount());
+        EXPECT_EQ(1, index.matchCountInColumn(1));
+        index.setMatchStatus(2, 1, true);
+        index.setMatchStatus(2, 1, true);
+        index.setMatchStatus(0, 1, false);
+        EXPECT_EQ(std::vector<int>({ 2 }), index.matchingRowsInColumn(1));
+        int r = 0, c = 0;
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleLinear));
+        EXPECT_EQ(2, r); EXPECT_EQ(1, c);
+        // Only match is the seed itself -> no match.
+        EXPECT_FALSE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(2, r); EXPECT_EQ(1, c);
+        // Wrapping within the only column that has matches.
+        index.setMatchStatus(0, 1, true);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(0, r); EXPECT_EQ(1, c);
+        EXPECT_TRUE(index.findNext(r, c, MatchIndexT::DirectionBackward, MatchIndexT::AdvanceStyleRowIncrement));
+        EXPECT_EQ(2, r); EXPECT_EQ(1, c);
+        index.clear();
+        EXPECT_FALSE(index.isBuilt());
+        EXPECT_FALSE(index.findNext(r, c, MatchIndexT::DirectionForward, MatchIndexT::AdvanceStyleLinear));
+    }
+
+    // Multithreaded build with results compared to sequential build.
+    {
+        TableT bigTable;
+        const int nRowCount = 5 * MatchIndexT::s_nMinRowsPerThread + 123;
+        for (int r = 0; r < nRowCount; ++r)
+        {
+            if (r % 3 != 0)
+                bigTable.setElement(r, r % 2, (r % 7 == 0) ? "x" : "a");
+        }
+        MatchIndexT singleThreaded;
+        MatchIndexT multiThreaded;
+        singleThreaded.build(bigTable, nRowCount, 2, -1, containsX, 1);
+        multiThreaded.build(bigTable, nRowCount, 2, -1, containsX, 4);
+        EXPECT_EQ(singleThreaded.matchingRowsInColumn(0), multiThreaded.matchingRowsInColumn(0));
+        EXPECT_EQ(singleThreaded.matchingRowsInColumn(1), multiThreaded.matchingRowsInColumn(1));
+        size_t nExpectedCount = 0;
+        for (int r = 0; r < nRowCount; ++r)
+            nExpectedCount += (r % 3 != 0 && r % 7 == 0);
+        EXPECT_EQ(nExpectedCount, multiThreaded.matchCount());
+    }
+}
+
+TEST(dfgCont, TableDiff)
+{
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(TableSz)<char, int> TableT;
+    typedef DFG_CLASS_NAME(TableDiff)<int> DiffT;
+
+    // Old:     New:
+    // a  1     a  1
+    // b  2     b  20   (modified)
+    // c  3     c  3
+    // d  4     x  4    (modified)
+    // e  5     e  5
+    //          f  "6,"  (inserted)
+    TableT oldTable;
+    TableT newTable;
+    const char* oldRows[][2] = { { "a", "1" }, { "b", "2" }, { "c", "3" }, { "d", "4" }, { "e", "5" } };
+    const char* newRows[][2] = { { "a", "1" }, { "b", "20" }, { "c", "3" }, { "x", "4" }, { "e", "5" }, { "f", "6," } };
+    for (int r = 0; r < 5; ++r)
+        for (int c = 0; c < 2; ++c)
+            oldTable.setElement(r, c, oldRows[r][c]);
+    for (int r = 0; r < 6; ++r)
+        for (int c = 0; c < 2; ++c)
+            newTable.setElement(r, c, newRows[r][c]);
+
+    DiffT diff;
+    diff.compute(oldTable, newTable);
+    ASSERT_EQ(3, diff.hunks().size());
+    EXPECT_EQ(1, diff.hunks()[0].nOldRow); EXPECT_EQ(1, diff.hunks()[0].nOldCount); EXPECT_EQ(1, diff.hunks()[0].nNewRow); EXPECT_EQ(1, diff.hunks()[0].nNewCount);
+    EXPECT_EQ(3, diff.hunks()[1].nOldRow); EXPECT_EQ(1, diff.hunks()[1].nOldCount); EXPECT_EQ(3, diff.hunks()[1].nNewRow); EXPECT_EQ(1, diff.hunks()[1].nNewCount);
+    EXPECT_EQ(5, diff.hunks()[2].nOldRow); EXPECT_EQ(0, diff.hunks()[2].nOldCount); EXPECT_EQ(5, diff.hunks()[2].nNewRow); EXPECT_EQ(1, diff.hunks()[2].nNewCount);
+    EXPECT_EQ(2, diff.modifiedRowCount());
+    EXPECT_EQ(1, diff.insertedRowCount());
+    EXPECT_EQ(0, diff.deletedRowCount());
+    ASSERT_EQ(2, diff.modifiedCells().size());
+    EXPECT_EQ(1, diff.modifiedCells()[0].nNewRow); EXPECT_EQ(1, diff.modifiedCells()[0].nCol);
+    EXPECT_EQ(3, diff.modifiedCells()[1].nNewRow); EXPECT_EQ(0, diff.modifiedCells()[1].nCol);
+
+    EXPECT_EQ(DiffT::RowStatusUnchanged, diff.newRowStatus(0));
+    EXPECT_EQ(DiffT::RowStatusModified, diff.newRowStatus(1));
+    EXPECT_EQ(DiffT::RowStatusUnchanged, diff.newRowStatus(2));
+    EXPECT_EQ(DiffT::RowStatusInserted, diff.newRowStatus(5));
+    EXPECT_FALSE(diff.isNewCellChanged(1, 0));
+    EXPECT_TRUE(diff.isNewCellChanged(1, 1));
+    EXPECT_TRUE(diff.isNewCellChanged(3, 0));
+    EXPECT_TRUE(diff.isNewCellChanged(5, 0));
+    EXPECT_FALSE(diff.isNewCellChanged(4, 1));
+    EXPECT_EQ(2, diff.oldRowOfNewRow(2));
+    EXPECT_EQ(3, diff.oldRowOfNewRow(3));
+    EXPECT_EQ(-1, diff.oldRowOfNewRow(5));
+
+    std::ostringstream ostrm;
+    diff.writeCsvPatch(ostrm, oldTable, newTable);
+    EXPECT_EQ("@@,1,1,1,1\n-,b,2\n+,b,20\n@@,3,1,3,1\n-,d,4\n+,x,4\n@@,5,0,5,1\n+,f,\"6,\"\n", ostrm.str());
+
+    // Equal tables
+    diff.compute(oldTable, oldTable);
+    EXPECT_TRUE(diff.isEmpty());
+
+    // Null and empty cells differ; deletion from the middle.
+    {
+        TableT t0;
+        TableT t1;
+        t0.setElement(0, 0, "a"); t0.setElement(1, 0, ""); t0.setElement(1, 1, "b"); t0.setElement(2, 0, "c");
+        t1.setElement(0, 0, "a"); t1.setElement(1, 1, "b");                          t1.setElement(2, 0, "c");
+        diff.compute(t0, t1);
+        ASSERT_EQ(1, diff.modifiedCells().size());
+        EXPECT_EQ(0, diff.modifiedCells()[0].nCol);
+
+        TableT t2;
+        t2.setElement(0, 0, "a"); t2.setElement(1, 0, "c");
+        diff.compute(t0, t2);
+        ASSERT_EQ(1, diff.hunks().size());
+        EXPECT_EQ(1, diff.hunks()[0].nOldRow); EXPECT_EQ(1, diff.hunks()[0].nOldCount); EXPECT_EQ(0, diff.hunks()[0].nNewCount);
+        EXPECT_EQ(1, diff.deletedRowCount());
+        EXPECT_EQ(2, diff.oldRowOfNewRow(1));
+    }
+
+    // Random edits: unchanged rows between hunks must match and result must not depend on thread count.
+    // Row count is more than two row hash chunks so that hashing is actually done in parallel.
+    {
+        auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+        randEng.seed(12345);
+        const auto randInt = [&](const int nMin, const int nMax) { return DFG_MODULE_NS(rand)::rand(randEng, nMin, nMax); };
+        std::vector<std::string> oldContent;
+        const int nRowCount = 2 * static_cast<int>(DFG_MODULE_NS(cont)::DFG_DETAIL_NS::gnTableDiffRowHashChunkSize) + 1000;
+        for (int r = 0; r < nRowCount; ++r)
+            oldContent.push_back(std::to_string(randInt(0, 2000))); // Has duplicates
+        std::vector<std::string> newContent;
+        for (size_t i = 0; i < oldContent.size(); ++i)
+        {
+            const int nOp = randInt(0, 99);
+            if (nOp < 3) // Delete
+                continue;
+            if (nOp < 6) // Insert
+                newContent.push_back("new" + std::to_string(randInt(0, 100)));
+            if (nOp < 9) // Modify
+                newContent.push_back(oldContent[i] + "m");
+            else
+                newContent.push_back(oldContent[i]);
+        }
+        TableT tOld;
+        TableT tNew;
+        for (size_t r = 0; r < oldContent.size(); ++r)
+        {
+            tOld.setElement(r, 0, oldContent[r]);
+            tOld.setElement(r, 1, "x");
+        }
+        for (size_t r = 0; r < newContent.size(); ++r)
+        {
+            tNew.setElement(r, 0, newContent[r]);
+            tNew.setElement(r, 1, "x");
+        }
+        EXPECT_EQ(tableRowHashes<int>(tOld, static_cast<int>(oldContent.size()), 2, 1), tableRowHashes<int>(tOld, static_cast<int>(oldContent.size()), 2, 4));
+        EXPECT_EQ(tableRowHashes<int>(tNew, static_cast<int>(newContent.size()), 2, 1), tableRowHashes<int>(tNew, static_cast<int>(newContent.size()), 2, 0));
+        DiffT diff1;
+        DiffT diff4;
+        diff1.compute(tOld, tNew, 1);
+        diff4.compute(tOld, tNew, 4);
+        ASSERT_EQ(diff1.hunks().size(), diff4.hunks().size());
+        EXPECT_EQ(diff1.modifiedCells().size(), diff4.modifiedCells().size());
+        EXPECT_LT(diff1.hunks().size(), oldContent.size() / 5);
+
+        int nOld = 0;
+        int nNew = 0;
+        const auto checkEqualUntil = [&](const int nOldEnd, const int nNewEnd)
+        {
+            EXPECT_EQ(nOldEnd - nOld, nNewEnd - nNew);
+            for (; nOld < nOldEnd && nNew < nNewEnd; ++nOld, ++nNew)
+                EXPECT_EQ(oldContent[nOld], newContent[nNew]);
+        };
+        for (const auto& hunk : diff1.hunks())
+        {
+            checkEqualUntil(hunk.nOldRow, hunk.nNewRow);
+            nOld += hunk.nOldCount;
+            nNew += hunk.nNewCount;
+        }
+        checkEqualUntil(static_cast<int>(oldContent.size()), static_cast<int>(newContent.size()));
+        for (const auto& change : diff1.modifiedCells())
+        {
+            EXPECT_EQ(0, change.nCol);
+            EXPECT_NE(oldContent[change.nOldRow], newContent[change.nNewRow]);
+        }
+    }
+}
+
 TEST(dfgCont, TableSz_forEachNonNullCell)
 {
     using namespace DFG_MODULE_NS(cont);
@@ -465,6 +849,111 @@ TEST(dfgCont, TableSz_forEachNonNullCell)
     }
 }
 
+TEST(dfgCont, TableSz_setElementsInColumn)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(cont);
+
+    DFG_CLASS_NAME(TableSz)<char> table;
+    table.setBlockSize(64);
+    char szBuffer[32];
+    const auto generator = [&](const int i) { DFG_MODULE_NS(str)::toStr(i, szBuffer); return szBuffer; };
+
+    // Appending to empty column
+    EXPECT_EQ(1000, table.setElementsInColumn(2, 0, 1000, generator));
+    EXPECT_EQ(1000, table.rowCountByMaxRowIndex());
+    EXPECT_EQ(3, table.colCountByMaxColIndex());
+    EXPECT_STREQ("0", table(0, 2));
+    EXPECT_STREQ("999", table(999, 2));
+    EXPECT_EQ(nullptr, table(0, 0));
+
+    // Overwriting and inserting to the middle
+    table.eraseCell(500, 2);
+    EXPECT_EQ(3, table.setElementsInColumn(2, 499, 3, [](const int i) { return (i == 1) ? "" : "a"; }));
+    EXPECT_STREQ("498", table(498, 2));
+    EXPECT_STREQ("a", table(499, 2));
+    EXPECT_STREQ("", table(500, 2));
+    EXPECT_STREQ("a", table(501, 2));
+    EXPECT_STREQ("502", table(502, 2));
+
+    // Result equals to setElement() loop.
+    DFG_CLASS_NAME(TableSz)<char> table2;
+    table2.setBlockSize(64);
+    for (int i = 0; i < 1000; ++i)
+        table2.setElement(i, 2, generator(i));
+    table2.setElement(499, 2, "a");
+    table2.setElement(500, 2, "");
+    table2.setElement(501, 2, "a");
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_STREQ(table2(i, 2), table(i, 2));
+
+    // Items longer than block size are skipped when block size is fixed.
+    table.setAllowBlockSizeExceptions(false);
+    EXPECT_EQ(1, table.setElementsInColumn(0, 0, 2, [](const int i) { return (i == 0) ? "abc" : "01234567890123456789012345678901234567890123456789012345678901234567890123456789"; }));
+    EXPECT_EQ(0, table.setElementsInColumn(0, 5, 0, generator));
+}
+
+TEST(dfgCont, TableSz_appendTableByAdoptingStorage)
+{
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(TableSz)<char, int> TableT;
+    TableT table;
+    table.setElement(0, 0, "a");
+    table.setElement(1, 1, "b");
+
+    TableT other;
+    other.setBlockSize(4);
+    other.setElement(0, 0, "c");
+    other.setElement(0, 1, "");
+    other.setElement(1, 0, "long_item");
+    other.setElement(2, 2, "d");
+    const auto pLongItem = other(1, 0);
+
+    EXPECT_FALSE(table.appendTableByAdoptingStorage(table, 2));
+    EXPECT_FALSE(table.appendTableByAdoptingStorage(other, 2, std::vector<int>(2, 0))); // Too small column map
+    EXPECT_FALSE(table.appendTableByAdoptingStorage(other, 2, std::vector<int>(3, -1))); // Invalid column map
+    EXPECT_EQ(3, other.rowCountByMaxRowIndex());
+
+    // Columns: 0 -> 1, 1 -> 0, 2 -> 3
+    std::vector<int> columnMap;
+    columnMap.push_back(1);
+    columnMap.push_back(0);
+    columnMap.push_back(3);
+    EXPECT_TRUE(table.appendTableByAdoptingStorage(other, 2, columnMap));
+    EXPECT_EQ(0, other.cellCountNonEmpty());
+    EXPECT_EQ(0, other.rowCountByMaxRowIndex());
+
+    EXPECT_EQ(5, table.rowCountByMaxRowIndex());
+    EXPECT_EQ(4, table.colCountByMaxColIndex());
+    EXPECT_STREQ("a", table(0, 0));
+    EXPECT_STREQ("b", table(1, 1));
+    EXPECT_STREQ("c", table(2, 1));
+    EXPECT_STREQ("", table(2, 0));
+    EXPECT_EQ(&table.m_emptyString, table(2, 0)); // Shared empty item must refer to that of the destination.
+    EXPECT_EQ(pLongItem, table(3, 1)); // String is not copied.
+    EXPECT_STREQ("d", table(4, 3));
+    EXPECT_EQ(nullptr, table(4, 0));
+
+    // Adding new strings after adoption doesn't affect adopted ones.
+    table.setElement(5, 1, "e");
+    table.setElement(6, 3, "f");
+    EXPECT_STREQ("long_item", table(3, 1));
+    EXPECT_STREQ("d", table(4, 3));
+
+    // Merging to existing rows overwrites items at the same position.
+    TableT other2;
+    other2.setElement(0, 0, "x");
+    other2.setElement(2, 0, "y");
+    EXPECT_TRUE(table.appendTableByAdoptingStorage(other2, 5));
+    EXPECT_STREQ("x", table(5, 0));
+    EXPECT_STREQ("e", table(5, 1));
+    EXPECT_STREQ("y", table(7, 0));
+    EXPECT_EQ(8, table.rowCountByMaxRowIndex());
+    // Adopted table remains usable.
+    other2.setElement(0, 0, "z");
+    EXPECT_STREQ("z", other2(0, 0));
+}
+
 TEST(dfgCont, TableSz_removeRows)
 {
     using namespace DFG_MODULE_NS(cont);
@@ -811,6 +1300,173 @@ TEST(dfgCont, ViewableSharedPtr)
     EXPECT_EQ(pData, spCopy.get());
 }
 
+TEST(dfgCont, ViewableSharedPtrReadMostly)
+{
+    using namespace DFG_MODULE_NS(cont);
+
+    int resetNotifier0 = 0;
+    int resetNotifier1 = 0;
+
+    DFG_CLASS_NAME(ViewableSharedPtrReadMostly)<const int> sp(std::make_shared<int>(1));
+    EXPECT_EQ(1, sp.version());
+    auto spViewer0 = sp.createViewer();
+    auto spViewer1 = sp.createViewer();
+    sp.addResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId)(spViewer0.get()), [&](DFG_CLASS_NAME(SourceResetParam))
+    {
+        ++resetNotifier0;
+        // Notifier is called without read path lock so viewing from notifier must work.
+        EXPECT_EQ(sp.sharedPtrCopy(), spViewer0->view());
+    });
+    sp.addResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId)(spViewer1.get()), [&](DFG_CLASS_NAME(SourceResetParam)) { ++resetNotifier1; });
+
+    EXPECT_EQ(1, *spViewer0->view());
+    EXPECT_EQ(1, *spViewer1->viewCached());
+    EXPECT_EQ(0, resetNotifier0);
+
+    sp.reset(std::make_shared<int>(2));
+    EXPECT_EQ(2, sp.version());
+    EXPECT_EQ(2, *spViewer0->view());
+    EXPECT_EQ(2, *spViewer1->viewCached());
+    EXPECT_EQ(1, resetNotifier0);
+    EXPECT_EQ(1, resetNotifier1);
+
+    // Cached snapshot keeps object alive until revalidated or released.
+    {
+        std::weak_ptr<const int> wp = spViewer1->viewCached();
+        sp.reset(std::make_shared<int>(3));
+        EXPECT_FALSE(wp.expired());
+        EXPECT_EQ(3, *spViewer1->viewCached());
+        EXPECT_TRUE(wp.expired());
+        spViewer1->releaseCached();
+        EXPECT_EQ(nullptr, spViewer1->m_spCached.get());
+        EXPECT_EQ(3, *spViewer1->viewCached());
+    }
+
+    // Notifier is not owned by the viewer, so it must be removed explicitly before the objects it refers to get destroyed.
+    sp.removeResetNotifier(DFG_CLASS_NAME(SourceResetNotifierId)(spViewer0.get()));
+    spViewer0.reset();
+    sp.reset(std::make_shared<int>(4));
+    EXPECT_EQ(2, resetNotifier0);
+    EXPECT_EQ(3, resetNotifier1);
+    auto spCopy = sp.sharedPtrCopy();
+    sp.reset();
+    EXPECT_EQ(4, resetNotifier1);
+    EXPECT_EQ(nullptr, spViewer1->view().get());
+    EXPECT_EQ(nullptr, spViewer1->viewCached().get());
+    EXPECT_EQ(1, spCopy.use_count());
+    EXPECT_FALSE(sp);
+
+    // Concurrent readers with a writer: every reader must see non-decreasing values.
+    {
+        DFG_CLASS_NAME(ViewableSharedPtrReadMostly)<const int> spConcurrent(std::make_shared<int>(0));
+        std::atomic<bool> bDone(false);
+        std::atomic<int> nErrorCount(0);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.push_back(std::thread([&]()
+            {
+                auto spViewer = spConcurrent.createViewer();
+                int nPrev = 0;
+                while (!bDone.load())
+                {
+                    const auto& spCached = spViewer->viewCached();
+                    if (!spCached || *spCached < nPrev)
+                        ++nErrorCount;
+                    else
+                        nPrev = *spCached;
+                }
+            }));
+        }
+        for (int i = 1; i <= 1000; ++i)
+            spConcurrent.reset(std::make_shared<int>(i));
+        bDone = true;
+        for (auto& thread : readers)
+            thread.join();
+        EXPECT_EQ(0, nErrorCount.load());
+        EXPECT_EQ(1001, spConcurrent.version());
+    }
+
+    // Concurrent writers: after resets have finished, object in owner and the one seen by viewers must be the same.
+    {
+        DFG_CLASS_NAME(ViewableSharedPtrReadMostly)<const int> spConcurrent(std::make_shared<int>(0));
+        auto spViewer = spConcurrent.createViewer();
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t)
+        {
+            writers.push_back(std::thread([&, t]()
+            {
+                for (int i = 0; i < 500; ++i)
+                    spConcurrent.reset(std::make_shared<int>(t * 1000 + i));
+            }));
+        }
+        for (auto& thread : writers)
+            thread.join();
+        EXPECT_EQ(2001, spConcurrent.version());
+        EXPECT_EQ(spConcurrent.sharedPtrCopy(), spViewer->view());
+    }
+}
+
+namespace
+{
+    // Runs nThreadCount readers that view the object nViewsPerThread times while writer resets it periodically; returns elapsed wall time.
+    template <class ViewableSharedPtr_T, class ViewFunc_T>
+    double viewableSharedPtrContentionBenchmark(const size_t nThreadCount, const size_t nViewsPerThread, ViewFunc_T viewFunc)
+    {
+        ViewableSharedPtr_T sp(std::make_shared<int>(1));
+        std::atomic<size_t> nActiveReaders(nThreadCount);
+        std::atomic<int64_t> nSum(0);
+        DFG_MODULE_NS(time)::DFG_CLASS_NAME(TimerCpu) timer;
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < nThreadCount; ++t)
+        {
+            readers.push_back(std::thread([&]()
+            {
+                auto spViewer = sp.createViewer();
+                int64_t nLocalSum = 0;
+                for (size_t i = 0; i < nViewsPerThread; ++i)
+                    nLocalSum += viewFunc(*spViewer);
+                nSum += nLocalSum;
+                --nActiveReaders;
+            }));
+        }
+        for (int i = 2; nActiveReaders.load() > 0; ++i)
+        {
+            sp.reset(std::make_shared<int>(i));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (auto& thread : readers)
+            thread.join();
+        EXPECT_LT(0, nSum.load());
+        return timer.elapsedWallSeconds();
+    }
+}
+
+/* Contention benchmark of ViewableSharedPtr variants with 1 - 64 reader threads.
+*/
+TEST(dfgCont, ViewableSharedPtrPerformance)
+{
+#if DFGTEST_ENABLE_BENCHMARKS == 0
+    DFGTEST_MESSAGE("ViewableSharedPtrPerformance skipped due to build settings");
+#else
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(ViewableSharedPtr)<const int> MutexVsp;
+    typedef DFG_CLASS_NAME(ViewableSharedPtrReadMostly)<const int> ReadMostlyVsp;
+    const size_t nViewsPerThread = 200000;
+    for (size_t nThreadCount = 1; nThreadCount <= 64; nThreadCount *= 2)
+    {
+        const auto timeMutex = viewableSharedPtrContentionBenchmark<MutexVsp>(nThreadCount, nViewsPerThread,
+            [](DFG_CLASS_NAME(ViewableSharedPtrViewer)<const int>& viewer) { return *viewer.view(); });
+        const auto timeAtomic = viewableSharedPtrContentionBenchmark<ReadMostlyVsp>(nThreadCount, nViewsPerThread,
+            [](DFG_CLASS_NAME(ViewableSharedPtrReadMostlyViewer)<const int>& viewer) { return *viewer.view(); });
+        const auto timeCached = viewableSharedPtrContentionBenchmark<ReadMostlyVsp>(nThreadCount, nViewsPerThread,
+            [](DFG_CLASS_NAME(ViewableSharedPtrReadMostlyViewer)<const int>& viewer) { return *viewer.viewCached(); });
+        DFGTEST_MESSAGE("ViewableSharedPtrPerformance: " << nThreadCount << " reader(s), " << nViewsPerThread << " views per thread: mutex "
+                        << timeMutex << " s, atomic " << timeAtomic << " s, cached " << timeCached << " s");
+    }
+#endif // DFGTEST_ENABLE_BENCHMARKS
+}
+
 #endif // DFG_LANGFEAT_MUTEX_11
 
 namespace
@@ -1159,6 +1815,262 @@ TEST(dfgCont, TableCsv_memStreamTypes)
     EXPECT_EQ(bytesStd, bytesBasicOmc);
 }
 
+TEST(dfgCont, TableCsv_rowsToDelimitedText)
+{
+    using namespace DFG_ROOT_NS;
+    typedef DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableCsv)<char, int> TableT;
+    const TableT::CsvFormatDefinition format('\t', '"', DFG_MODULE_NS(io)::EndOfLineTypeN, DFG_MODULE_NS(io)::encodingUTF8);
+
+    // Basic test with enclosing, missing cells and non-sorted rows.
+    {
+        TableT table;
+        table.setElement(0, 0, DFG_UTF8("a"));
+        table.setElement(0, 1, DFG_UTF8("b\tc"));
+        table.setElement(0, 2, DFG_UTF8("d"));
+        table.setElement(1, 1, DFG_UTF8("e\"f"));
+        table.setElement(2, 0, DFG_UTF8("g\nh"));
+        table.setElement(2, 2, DFG_UTF8("i"));
+        const std::vector<int> rows = { 2, 0, 1 };
+        EXPECT_EQ("\"g\nh\"\t\ti\na\t\"b\tc\"\td\n\t\"e\"\"f\"\t\n", table.rowsToDelimitedText(rows, 0, 3, format));
+        EXPECT_EQ("\"b\tc\"\n\"e\"\"f\"\n", table.rowsToDelimitedText(std::vector<int>({ 0, 1 }), 1, 2, format));
+        EXPECT_EQ("", table.rowsToDelimitedText(std::vector<int>(), 0, 3, format));
+    }
+
+    // Testing that parallel and single threaded output is identical.
+    {
+        TableT table;
+        const int nRowCount = 50000;
+        for (int r = 0; r < nRowCount; ++r)
+        {
+            table.setElement(r, 0, SzPtrUtf8(std::to_string(r).c_str()));
+            if (r % 3 == 0)
+                table.setElement(r, 1, DFG_UTF8("x,y"));
+        }
+        std::vector<int> rows(nRowCount);
+        for (int r = 0; r < nRowCount; ++r)
+            rows[r] = nRowCount - 1 - r;
+        const auto sSingle = table.rowsToDelimitedText(rows, 0, 2, format, 1);
+        const auto sParallel = table.rowsToDelimitedText(rows, 0, 2, format, 4);
+        EXPECT_EQ(sSingle, sParallel);
+        EXPECT_EQ(0, sSingle.find("49999\t\n49998\tx,y\n"));
+        EXPECT_EQ(sSingle.size() - 6, sSingle.rfind("0\tx,y\n"));
+    }
+}
+
+TEST(dfgCont, TableCsv_writeToFileIncremental)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(TableCsv)<char, int> TableT;
+    typedef DFG_MODULE_NS(io)::DFG_CLASS_NAME(OfStream) OfStream;
+    const char szSourcePath[] = "testfiles/generated/incrementalWriteSource.csv";
+    const char szOutputPath[] = "testfiles/generated/incrementalWriteOutput.csv";
+
+    // delimitedTextRowOffsets()
+    {
+        std::vector<size_t> offsets;
+        const char szData[] = "a,\"b\n\"\"c\",d\ne";
+        EXPECT_TRUE(delimitedTextRowOffsets(szData, DFG_COUNTOF_SZ(szData), ',', '"', '\n', offsets));
+        EXPECT_EQ(std::vector<size_t>({ 0, 12, 13 }), offsets);
+        EXPECT_TRUE(delimitedTextRowOffsets(szData, DFG_COUNTOF_SZ(szData), ',', DFG_MODULE_NS(io)::DFG_CLASS_NAME(DelimitedTextReader)::s_nMetaCharNone, '\n', offsets));
+        EXPECT_EQ(std::vector<size_t>({ 0, 5, 12, 13 }), offsets);
+        EXPECT_TRUE(delimitedTextRowOffsets("a\"b\nc", 5, ',', '"', '\n', offsets)); // Enclosing char within naked cell is a normal char.
+        EXPECT_EQ(std::vector<size_t>({ 0, 4, 5 }), offsets);
+        EXPECT_TRUE(delimitedTextRowOffsets("", 0, ',', '"', '\n', offsets));
+        EXPECT_EQ(std::vector<size_t>({ 0 }), offsets);
+        EXPECT_FALSE(delimitedTextRowOffsets("a, \"b\"\n", 7, ',', '"', '\n', offsets)); // Ambiguous: depends on whitespace skipping.
+        EXPECT_FALSE(delimitedTextRowOffsets("a,\"b\n", 5, ',', '"', '\n', offsets)); // Unclosed enclosed cell.
+    }
+
+    TableT::CsvFormatDefinition format(',', '"', DFG_MODULE_NS(io)::EndOfLineTypeN, DFG_MODULE_NS(io)::encodingUTF8);
+    format.bomWriting(false);
+
+    // Basic test: modifying rows in the middle and at the end.
+    {
+        const char szSource[] = "a,b\n\"c\nd\",e\nf,g\nh,i";
+        OfStream::dumpBytesToFile_overwriting(szSourcePath, szSource, DFG_COUNTOF_SZ(szSource));
+        TableT table;
+        table.readFromFile(szSourcePath, format);
+        ASSERT_EQ(4, table.rowCountByMaxRowIndex());
+        table.setElement(2, 1, DFG_UTF8("X,Y"));
+        table.setElement(3, 0, DFG_UTF8("z"));
+        DFG_CLASS_NAME(IntervalSet)<int> dirtyRows;
+        dirtyRows.insert(2);
+        dirtyRows.insert(3);
+        ASSERT_TRUE(writeToFileIncremental(table, szSourcePath, szOutputPath, format, dirtyRows));
+        EXPECT_EQ("a,b\n\"c\nd\",e\nf,\"X,Y\"\nz,i", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szOutputPath));
+        TableT table2;
+        table2.readFromFile(szOutputPath, format);
+        EXPECT_TRUE(table.isContentAndSizesIdenticalWith(table2));
+
+        // Without dirty rows output should be identical to source.
+        ASSERT_TRUE(writeToFileIncremental(table, szSourcePath, szOutputPath, format, DFG_CLASS_NAME(IntervalSet)<int>()));
+        EXPECT_EQ(szSource, DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szOutputPath));
+
+        // Changing row structure should be detected.
+        table.setElement(4, 0, DFG_UTF8("new row"));
+        EXPECT_FALSE(writeToFileIncremental(table, szSourcePath, szOutputPath, format, dirtyRows));
+    }
+
+    // Header offset, BOM and \r\n
+    {
+        const char szSource[] = "\xEF\xBB\xBFh0,h1\r\na,b\r\nc,d\r\n";
+        OfStream::dumpBytesToFile_overwriting(szSourcePath, szSource, DFG_COUNTOF_SZ(szSource));
+        auto formatRn = format;
+        formatRn.eolType(DFG_MODULE_NS(io)::EndOfLineTypeRN);
+        TableT table;
+        table.readFromFile(szSourcePath, formatRn);
+        table.removeRows(0, 1); // Removing header row.
+        table.setElement(0, 0, DFG_UTF8("x"));
+        DFG_CLASS_NAME(IntervalSet)<int> dirtyRows;
+        dirtyRows.insert(0);
+        EXPECT_FALSE(writeToFileIncremental(table, szSourcePath, szOutputPath, formatRn, dirtyRows, 1)); // Should fail since source has BOM but format doesn't.
+        formatRn.bomWriting(true);
+        ASSERT_TRUE(writeToFileIncremental(table, szSourcePath, szOutputPath, formatRn, dirtyRows, 1));
+        EXPECT_EQ("\xEF\xBB\xBFh0,h1\r\nx,b\r\nc,d\r\n", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szOutputPath));
+    }
+}
+
+TEST(dfgCont, TableCsv_snapshot)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(TableCsv)<char, int> TableT;
+    typedef DFG_MODULE_NS(io)::DFG_CLASS_NAME(OfStream) OfStream;
+    const char szSourcePath[] = "testfiles/generated/tableSnapshotSource.csv";
+    const std::string sSnapshotPath = tableSnapshotPathFromSourcePath(std::string(szSourcePath));
+    DFG_MODULE_NS(os)::removeFile(sSnapshotPath.c_str());
+
+    const char szSource[] = "a;b;c\n\"d;\ne\";;f\n;\xc3\xa4;\n\ng;h;i";
+    OfStream::dumpBytesToFile_overwriting(szSourcePath, szSource, DFG_COUNTOF_SZ(szSource));
+
+    // First read parses the file and writes snapshot, second read uses the snapshot.
+    TableT tableParsed;
+    EXPECT_FALSE(readFromFileUsingSnapshot(tableParsed, szSourcePath));
+    ASSERT_EQ(5, tableParsed.rowCountByMaxRowIndex());
+    {
+        TableT table;
+        EXPECT_TRUE(readFromFileUsingSnapshot(table, szSourcePath));
+        EXPECT_TRUE(table.isContentAndSizesIdenticalWith(tableParsed));
+        EXPECT_EQ(';', table.readFormat().separatorChar());
+        EXPECT_EQ(tableParsed.readFormat().textEncoding(), table.readFormat().textEncoding());
+        EXPECT_EQ(tableParsed.readFormat().eolType(), table.readFormat().eolType());
+        EXPECT_EQ(';', table.saveFormat().separatorChar());
+        EXPECT_STREQ("d;\ne", toCharPtr_raw(table(1, 0)));
+        EXPECT_STREQ(toCharPtr_raw(tableParsed(2, 1)), toCharPtr_raw(table(2, 1)));
+
+        // Table loaded from snapshot should be modifiable.
+        table.setElement(0, 0, DFG_UTF8("modified"));
+        table.setElement(5, 3, DFG_UTF8("new"));
+        EXPECT_STREQ("modified", toCharPtr_raw(table(0, 0)));
+        EXPECT_STREQ("new", toCharPtr_raw(table(5, 3)));
+        EXPECT_STREQ("b", toCharPtr_raw(table(0, 1)));
+
+        // Checking only size and modification time.
+        TableT table2;
+        EXPECT_TRUE(readFromFileUsingSnapshot(table2, szSourcePath, TableSnapshotSourceCheckSizeAndTime));
+        EXPECT_TRUE(table2.isContentAndSizesIdenticalWith(tableParsed));
+    }
+
+    // Snapshot is not used if requested read format differs.
+    {
+        TableT table;
+        const TableT::CsvFormatDefinition format(',', '"', DFG_MODULE_NS(io)::EndOfLineTypeN, DFG_MODULE_NS(io)::encodingUTF8);
+        EXPECT_FALSE(readFromFileUsingSnapshot(table, szSourcePath, format));
+        EXPECT_EQ(',', table.readFormat().separatorChar());
+        EXPECT_STREQ("a;b;c", toCharPtr_raw(table(0, 0)));
+        EXPECT_TRUE(readFromFileUsingSnapshot(table, szSourcePath, format));
+        EXPECT_STREQ("a;b;c", toCharPtr_raw(table(0, 0)));
+    }
+
+    // Key mismatch
+    {
+        TableSnapshotSourceKey key;
+        ASSERT_TRUE(key.setFromFile(szSourcePath, true));
+        EXPECT_EQ(DFG_COUNTOF_SZ(szSource), key.m_nSourceSize);
+        ASSERT_TRUE(writeTableSnapshot(tableParsed, sSnapshotPath, key));
+        TableT table;
+        table.setElement(0, 0, DFG_UTF8("old"));
+        auto keyOther = key;
+        keyOther.m_nSourceHash++;
+        EXPECT_FALSE(readTableSnapshot(table, sSnapshotPath, keyOther));
+        keyOther = key;
+        keyOther.m_nSourceModificationTime++;
+        EXPECT_FALSE(readTableSnapshot(table, sSnapshotPath, keyOther));
+        keyOther = key;
+        keyOther.m_nReadOptionsHash++;
+        EXPECT_FALSE(readTableSnapshot(table, sSnapshotPath, keyOther));
+        EXPECT_STREQ("old", toCharPtr_raw(table(0, 0))); // Table should not be modified if snapshot is not used.
+        keyOther = key;
+        keyOther.m_nSourceHash = 0;
+        keyOther.m_bHasSourceHash = false; // Hash is not compared if expected key doesn't have it.
+        EXPECT_TRUE(readTableSnapshot(table, sSnapshotPath, keyOther));
+        EXPECT_TRUE(table.isContentAndSizesIdenticalWith(tableParsed));
+    }
+
+    // Changed source should be detected.
+    {
+        const char szSourceChanged[] = "a;b;X\n\"d;\ne\";;f\n;\xc3\xa4;\n\ng;h;i";
+        OfStream::dumpBytesToFile_overwriting(szSourcePath, szSourceChanged, DFG_COUNTOF_SZ(szSourceChanged));
+        TableT table;
+        EXPECT_FALSE(readFromFileUsingSnapshot(table, szSourcePath));
+        EXPECT_STREQ("X", toCharPtr_raw(table(0, 2)));
+        TableT table2;
+        EXPECT_TRUE(readFromFileUsingSnapshot(table2, szSourcePath));
+        EXPECT_STREQ("X", toCharPtr_raw(table2(0, 2)));
+    }
+
+    // Truncated snapshot should be rejected.
+    {
+        auto bytes = DFG_MODULE_NS(io)::fileToByteContainer<std::string>(sSnapshotPath);
+        ASSERT_GT(bytes.size(), 8u);
+        bytes.resize(bytes.size() - 8);
+        OfStream::dumpBytesToFile_overwriting(sSnapshotPath, bytes.data(), bytes.size());
+        TableT table;
+        EXPECT_FALSE(readFromFileUsingSnapshot(table, szSourcePath));
+        EXPECT_STREQ("X", toCharPtr_raw(table(0, 2)));
+    }
+
+    // Larger table with null cells, empty columns and content from multiple storage blocks.
+    {
+        TableT table;
+        table.setBlockSize(64);
+        for (int r = 0; r < 1000; ++r)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                if ((r + c) % 3 != 0)
+                    table.setElement(r, c, SzPtrUtf8(std::to_string(r * 10 + c).c_str()));
+            }
+        }
+        table.setElement(0, 6, DFG_UTF8(""));
+        table.swapCellContentInColumn(table.m_colToRows[1], 1, 3000); // Leaves null pointer item at (1, 1).
+        ASSERT_TRUE(writeTableSnapshot(table, sSnapshotPath, TableSnapshotSourceKey()));
+        TableT table2;
+        ASSERT_TRUE(readTableSnapshot(table2, sSnapshotPath, TableSnapshotSourceKey()));
+        ASSERT_EQ(table.rowCountByMaxRowIndex(), table2.rowCountByMaxRowIndex());
+        ASSERT_EQ(table.colCountByMaxColIndex(), table2.colCountByMaxColIndex());
+        for (int c = 0; c < table.colCountByMaxColIndex(); ++c)
+        {
+            ASSERT_EQ(table.m_colToRows[c].size(), table2.m_colToRows[c].size());
+            for (size_t i = 0; i < table.m_colToRows[c].size(); ++i)
+            {
+                const auto& item = table.m_colToRows[c][i];
+                const auto& item2 = table2.m_colToRows[c][i];
+                EXPECT_EQ(item.first, item2.first);
+                EXPECT_EQ(item.second == nullptr, item2.second == nullptr);
+                if (item.second && item2.second)
+                {
+                    EXPECT_STREQ(item.second, item2.second);
+                }
+            }
+        }
+        EXPECT_EQ(&table2.m_emptyString, table2.m_colToRows[6][0].second);
+        EXPECT_EQ(nullptr, table2.m_colToRows[1][1].second);
+        EXPECT_STREQ("11", toCharPtr_raw(table2(3000, 1)));
+    }
+}
+
 TEST(dfgCont, SortedSequence)
 {
     using namespace DFG_MODULE_NS(cont);
@@ -1713,6 +2625,296 @@ TEST(dfgCont, SetVector)
     }
 }
 
+TEST(dfgCont, EytzingerSearchIndex)
+{
+    using namespace DFG_MODULE_NS(cont);
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    auto distrEng = DFG_MODULE_NS(rand)::makeDistributionEngineUniform(&randEng, -50, 50);
+    const auto identity = [](const int i) { return i; };
+    for (size_t nSize = 0; nSize < 130; ++nSize)
+    {
+        std::vector<int> keys;
+        for (size_t i = 0; i < nSize; ++i)
+            keys.push_back(distrEng());
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        DFG_CLASS_NAME(EytzingerSearchIndex)<int> index(keys.begin(), keys.end(), identity);
+        ASSERT_EQ(keys.size(), index.size());
+        for (int key = -52; key <= 52; ++key)
+        {
+            const auto nExpected = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+            EXPECT_EQ(nExpected, index.lowerBound(key));
+        }
+    }
+
+    // Non-random access source
+    {
+        const std::list<int> keys = { 1, 3, 5, 7 };
+        DFG_CLASS_NAME(EytzingerSearchIndex)<int> index(keys.begin(), keys.end(), identity);
+        EXPECT_EQ(0, index.lowerBound(0));
+        EXPECT_EQ(1, index.lowerBound(2));
+        EXPECT_EQ(3, index.lowerBound(7));
+        EXPECT_EQ(4, index.lowerBound(8));
+    }
+}
+
+namespace
+{
+    template <class Map_T>
+    void testFrozenMap()
+    {
+        Map_T m;
+        for (int i = 0; i < 1000; ++i)
+            m[(i * 7919) % 1000] = 2 * ((i * 7919) % 1000);
+        EXPECT_FALSE(m.isFrozen());
+        m.freeze();
+        EXPECT_TRUE(m.isFrozen());
+        EXPECT_TRUE(m.isSorted());
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto iter = m.find(i);
+            ASSERT_TRUE(iter != m.end());
+            EXPECT_EQ(i, iter->first);
+            EXPECT_EQ(2 * i, iter->second);
+        }
+        EXPECT_TRUE(m.find(-1) == m.end());
+        EXPECT_TRUE(m.find(1000) == m.end());
+
+        // Copy shares the index
+        const auto mCopy = m;
+        EXPECT_TRUE(mCopy.isFrozen());
+        EXPECT_TRUE(mCopy.find(500) != mCopy.end());
+
+        // Modifications unfreeze
+        m.insert(1000, 2000);
+        EXPECT_FALSE(m.isFrozen());
+        EXPECT_EQ(2000, m.find(1000)->second);
+        m.freeze();
+        m.erase(m.find(0));
+        EXPECT_FALSE(m.isFrozen());
+        EXPECT_TRUE(m.find(0) == m.end());
+        m.freeze();
+        m.setSorting(false);
+        EXPECT_FALSE(m.isFrozen());
+        m.freeze();
+        m.clear();
+        EXPECT_FALSE(m.isFrozen());
+
+        // Freezing empty
+        m.freeze();
+        EXPECT_TRUE(m.find(1) == m.end());
+
+        // Keys modified directly (here keeping the order) require explicit unfreeze()
+        m[1] = 10;
+        m[3] = 30;
+        m.freeze();
+        m.frontKey() = 2;
+        m.unfreeze();
+        EXPECT_TRUE(m.find(1) == m.end());
+        EXPECT_EQ(10, m.find(2)->second);
+    }
+} // unnamed namespace
+
+TEST(dfgCont, MapVector_freeze)
+{
+    using namespace DFG_MODULE_NS(cont);
+    testFrozenMap<DFG_CLASS_NAME(MapVectorAoS)<int, int>>();
+    testFrozenMap<DFG_CLASS_NAME(MapVectorSoA)<int, int>>();
+
+    // String keys with heterogeneous lookup
+    {
+        DFG_CLASS_NAME(MapVectorSoA)<std::string, int> m;
+        m["b"] = 2;
+        m["a"] = 1;
+        m["c"] = 3;
+        m.freeze();
+        EXPECT_EQ(1, m.find("a")->second);
+        EXPECT_EQ(3, m.find(std::string("c"))->second);
+        EXPECT_TRUE(m.find("d") == m.end());
+    }
+}
+
+namespace
+{
+    template <class Map_T>
+    bool isSortedByKey(const Map_T& m)
+    {
+        for (size_t i = 1; i < m.size(); ++i)
+        {
+            if ((m.begin() + i)->first < (m.begin() + (i - 1))->first)
+                return false;
+        }
+        return true;
+    }
+
+    template <class Map_T>
+    void testMapInsertRange()
+    {
+        typedef typename Map_T::DuplicatePolicy DuplicatePolicy;
+        const std::vector<std::pair<int, int>> items = { { 5, 0 }, { 1, 1 }, { 3, 2 }, { 5, 3 }, { 0, 4 }, { 3, 5 } };
+        for (const bool bSorted : { true, false })
+        {
+            Map_T mKeepFirst;
+            Map_T mKeepLast;
+            mKeepFirst.setSorting(bSorted);
+            mKeepLast.setSorting(bSorted);
+            mKeepFirst[3] = 10;
+            mKeepLast[3] = 10;
+            mKeepFirst.insertRange(items.begin(), items.end());
+            mKeepLast.insertRange(items.begin(), items.end(), Map_T::DuplicatePolicyKeepLast);
+            ASSERT_EQ(4, mKeepFirst.size());
+            ASSERT_EQ(4, mKeepLast.size());
+            EXPECT_EQ(bSorted, mKeepFirst.isSorted());
+            EXPECT_EQ(0, mKeepFirst.frontKey() * int(bSorted));
+            EXPECT_EQ(4, mKeepFirst[0]);
+            EXPECT_EQ(1, mKeepFirst[1]);
+            EXPECT_EQ(10, mKeepFirst[3]);
+            EXPECT_EQ(0, mKeepFirst[5]);
+            EXPECT_EQ(4, mKeepLast[0]);
+            EXPECT_EQ(1, mKeepLast[1]);
+            EXPECT_EQ(5, mKeepLast[3]);
+            EXPECT_EQ(3, mKeepLast[5]);
+            if (bSorted)
+            {
+                EXPECT_TRUE(isSortedByKey(mKeepFirst));
+            }
+
+            // assign()
+            Map_T m2;
+            m2.setSorting(bSorted);
+            m2[100] = 100;
+            m2.assign(items.begin(), items.end(), DuplicatePolicy::DuplicatePolicyKeepLast);
+            EXPECT_EQ(4, m2.size());
+            EXPECT_FALSE(m2.hasKey(100));
+            EXPECT_EQ(5, m2[3]);
+        }
+
+        // merge()
+        {
+            Map_T m0;
+            Map_T m1;
+            for (int i = 0; i < 10; i += 2)
+                m0[i] = i;
+            for (int i = 0; i < 10; i += 3)
+                m1[i] = -i;
+            auto m0KeepLast = m0;
+            m0.merge(m1);
+            m0KeepLast.merge(m1, Map_T::DuplicatePolicyKeepLast);
+            EXPECT_EQ(7, m0.size()); // 0, 2, 3, 4, 6, 8, 9
+            EXPECT_EQ(7, m0KeepLast.size());
+            EXPECT_TRUE(isSortedByKey(m0));
+            EXPECT_EQ(6, m0[6]);
+            EXPECT_EQ(-6, m0KeepLast[6]);
+            EXPECT_EQ(-9, m0[9]);
+            EXPECT_EQ(4, m1.size());
+            m0.merge(m0);
+            EXPECT_EQ(7, m0.size());
+        }
+
+        // Appending after existing keys and moving from source
+        {
+            Map_T m;
+            m[1] = 1;
+            std::vector<std::pair<int, int>> v = { { 3, 3 }, { 2, 2 } };
+            m.insertRange(std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+            EXPECT_EQ(3, m.size());
+            EXPECT_EQ(3, m.backKey());
+        }
+    }
+} // unnamed namespace
+
+TEST(dfgCont, MapVector_insertRange)
+{
+    using namespace DFG_MODULE_NS(cont);
+    testMapInsertRange<DFG_CLASS_NAME(MapVectorAoS)<int, int>>();
+    testMapInsertRange<DFG_CLASS_NAME(MapVectorSoA)<int, int>>();
+
+    // Non-trivial types
+    {
+        DFG_CLASS_NAME(MapVectorSoA)<std::string, std::string> m;
+        m["b"] = "b";
+        std::map<std::string, std::string> src = { { "a", "a" }, { "b", "x" }, { "c", "c" } };
+        m.insertRange(src.begin(), src.end());
+        ASSERT_EQ(3, m.size());
+        EXPECT_EQ("a", m.frontKey());
+        EXPECT_EQ("b", m["b"]);
+        EXPECT_EQ("c", m.backValue());
+    }
+
+    // Large input, exercising parallel sort
+    {
+        DFG_CLASS_NAME(MapVectorAoS)<int, int> m;
+        std::vector<std::pair<int, int>> v;
+        for (int i = 0; i < 300000; ++i)
+            v.push_back(std::pair<int, int>(static_cast<int>((int64_t(i) * 7919) % 200000), i));
+        m.insertRange(v.begin(), v.end(), DFG_CLASS_NAME(MapVectorAoS)<int, int>::DuplicatePolicyKeepLast);
+        ASSERT_EQ(200000, m.size());
+        EXPECT_TRUE(isSortedByKey(m));
+        std::map<int, int> mExpected;
+        for (const auto& item : v)
+            mExpected[item.first] = item.second;
+        EXPECT_TRUE(std::equal(mExpected.begin(), mExpected.end(), m.begin(), [](const std::pair<const int, int>& a, const DFG_CLASS_NAME(TrivialPair)<int, int>& b) { return a.first == b.first && a.second == b.second; }));
+    }
+}
+
+TEST(dfgCont, SetVector_insertRange)
+{
+    using namespace DFG_MODULE_NS(cont);
+    const std::vector<int> items = { 5, 1, 3, 5, 0, 3 };
+    for (const bool bSorted : { true, false })
+    {
+        DFG_CLASS_NAME(SetVector)<int> se;
+        se.setSorting(bSorted);
+        se.insert(3);
+        se.insert(7);
+        se.insertRange(items.begin(), items.end());
+        EXPECT_EQ(5, se.size());
+        for (const int i : { 0, 1, 3, 5, 7 })
+            EXPECT_TRUE(se.hasKey(i));
+        if (bSorted)
+        {
+            EXPECT_EQ(std::vector<int>({ 0, 1, 3, 5, 7 }), se.m_storage);
+        }
+
+        se.assign(items.begin(), items.end());
+        EXPECT_EQ(4, se.size());
+        EXPECT_FALSE(se.hasKey(7));
+    }
+
+    // merge()
+    {
+        DFG_CLASS_NAME(SetVector)<std::string> se0;
+        DFG_CLASS_NAME(SetVector)<std::string> se1;
+        se0.insert("a");
+        se0.insert("c");
+        se1.insert("b");
+        se1.insert("c");
+        se1.insert("d");
+        se0.merge(se1);
+        EXPECT_EQ(std::vector<std::string>({ "a", "b", "c", "d" }), se0.m_storage);
+        se0.merge(se0);
+        EXPECT_EQ(4, se0.size());
+    }
+}
+
+TEST(dfgCont, SetVector_freeze)
+{
+    using namespace DFG_MODULE_NS(cont);
+    DFG_CLASS_NAME(SetVector)<int> se;
+    se.setSorting(false);
+    for (int i = 0; i < 100; ++i)
+        se.insert(99 - i);
+    se.freeze();
+    EXPECT_TRUE(se.isSorted());
+    EXPECT_EQ(0, se.front());
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i, *se.find(i));
+    EXPECT_TRUE(se.find(100) == se.end());
+    se.insert(100);
+    EXPECT_FALSE(se.isFrozen());
+    EXPECT_EQ(100, *se.find(100));
+}
+
 namespace
 {
     template <class T0, class T1, bool IsTrivial>
@@ -1784,6 +2986,258 @@ namespace
     }
 }
 
+TEST(dfgCont, IntervalSet)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(cont);
+    DFG_CLASS_NAME(IntervalSet)<int> is;
+    EXPECT_TRUE(is.empty());
+    const auto intervals = [&]()
+    {
+        std::vector<std::pair<int, int>> v;
+        is.forEachInterval([&](const int a, const int b) { v.push_back(std::make_pair(a, b)); });
+        return v;
+    };
+    typedef std::vector<std::pair<int, int>> PairVec;
+    is.insert(5);
+    is.insert(7);
+    EXPECT_EQ(PairVec({ { 5, 5 }, { 7, 7 } }), intervals());
+    is.insert(6); // Joins adjacent intervals.
+    EXPECT_EQ(PairVec({ { 5, 7 } }), intervals());
+    is.insertClosed(10, 20);
+    is.insertClosed(0, 2);
+    is.insertClosed(12, 15); // Already included.
+    EXPECT_EQ(PairVec({ { 0, 2 }, { 5, 7 }, { 10, 20 } }), intervals());
+    is.insertClosed(4, 11); // Overlaps with two intervals.
+    EXPECT_EQ(PairVec({ { 0, 2 }, { 4, 20 } }), intervals());
+    is.insertClosed(3, 2); // Invalid interval, should be ignored.
+    EXPECT_EQ(2, is.intervalCount());
+    EXPECT_EQ(20, is.sizeOfSet());
+    EXPECT_TRUE(is.hasValue(0));
+    EXPECT_TRUE(is.hasValue(2));
+    EXPECT_FALSE(is.hasValue(3));
+    EXPECT_TRUE(is.hasValue(20));
+    EXPECT_FALSE(is.hasValue(21));
+    EXPECT_FALSE(is.hasValue(-1));
+    is.insertClosed(-5, 100);
+    EXPECT_EQ(PairVec({ { -5, 100 } }), intervals());
+
+    // Testing extreme values.
+    DFG_CLASS_NAME(IntervalSet)<int> is2;
+    is2.insert(NumericTraits<int>::maxValue);
+    is2.insert(NumericTraits<int>::maxValue - 1);
+    is2.insert(NumericTraits<int>::minValue);
+    EXPECT_EQ(2, is2.intervalCount());
+    EXPECT_TRUE(is2.hasValue(NumericTraits<int>::maxValue - 1));
+    is2.clear();
+    EXPECT_TRUE(is2.empty());
+    EXPECT_NE(is, is2);
+}
+
+TEST(dfgCont, FlatHashMap)
+{
+    using namespace DFG_MODULE_NS(cont);
+    // Random operations compared against std::unordered_map
+    {
+        DFG_CLASS_NAME(FlatHashMap)<int, int> m;
+        std::unordered_map<int, int> mExpected;
+        auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+        auto keyDistr = DFG_MODULE_NS(rand)::makeDistributionEngineUniform(&randEng, -2000, 2000);
+        for (int i = 0; i < 20000; ++i)
+        {
+            const auto key = keyDistr();
+            const auto op = i % 4;
+            if (op == 0 || op == 1)
+            {
+                m[key] = i;
+                mExpected[key] = i;
+            }
+            else if (op == 2)
+                EXPECT_EQ(mExpected.erase(key), m.erase(key));
+            else
+            {
+                auto iter = m.find(key);
+                auto iterExpected = mExpected.find(key);
+                ASSERT_EQ(iterExpected != mExpected.end(), iter != m.end());
+                if (iter != m.end())
+                {
+                    EXPECT_EQ(iterExpected->second, iter->second);
+                }
+            }
+            ASSERT_EQ(mExpected.size(), m.size());
+        }
+        size_t nIterated = 0;
+        for (auto iter = m.cbegin(); iter != m.cend(); ++iter, ++nIterated)
+            EXPECT_EQ(mExpected[iter->first], iter->second);
+        EXPECT_EQ(m.size(), nIterated);
+        m.clear();
+        EXPECT_TRUE(m.empty());
+        EXPECT_TRUE(m.begin() == m.end());
+        EXPECT_FALSE(m.hasKey(1));
+    }
+
+    // insert() doesn't overwrite, erase by iterator
+    {
+        DFG_CLASS_NAME(FlatHashMap)<int, std::string> m;
+        EXPECT_TRUE(m.insert(1, "a").second);
+        EXPECT_FALSE(m.insert(1, "b").second);
+        EXPECT_EQ("a", m[1]);
+        m[2] = "b";
+        auto iter = m.erase(m.find(1));
+        EXPECT_EQ(1, m.size());
+        EXPECT_TRUE(iter == m.end() || iter->first == 2);
+        EXPECT_TRUE(m.erase(m.end()) == m.end());
+    }
+
+    // Heterogeneous lookup
+    {
+        DFG_CLASS_NAME(FlatHashMap)<std::string, int> m;
+        m["abc"] = 1;
+        m[std::string("a long string key that doesn't fit in sso buffer")] = 2;
+        EXPECT_EQ(1, m.find("abc")->second);
+        EXPECT_EQ(1, m.find(DFG_ROOT_NS::DFG_CLASS_NAME(StringViewC)("abcd", 3))->second);
+        EXPECT_EQ(2, m.find("a long string key that doesn't fit in sso buffer")->second);
+        EXPECT_TRUE(m.find("ab") == m.end());
+        EXPECT_EQ(1, m.erase("abc"));
+        EXPECT_FALSE(m.hasKey("abc"));
+    }
+
+    // reserve(): no rehash, i.e. references remain valid
+    {
+        DFG_CLASS_NAME(FlatHashMap)<int, int> m;
+        m.reserve(1000);
+        const auto nCapacity = m.capacity();
+        EXPECT_GE(m.maxSizeWithoutRehash(), 1000);
+        int* p = &m[0];
+        for (int i = 1; i < 1000; ++i)
+            m[i] = i;
+        EXPECT_EQ(nCapacity, m.capacity());
+        EXPECT_EQ(p, &m[0]);
+        m.reserve(10); // Should not shrink
+        EXPECT_EQ(nCapacity, m.capacity());
+    }
+
+    // Erase-insert cycles with capacity staying bounded
+    {
+        DFG_CLASS_NAME(FlatHashMap)<int, int> m;
+        for (int i = 0; i < 100000; ++i)
+        {
+            m[i] = i;
+            if (i >= 10)
+            {
+                EXPECT_EQ(1, m.erase(i - 10));
+            }
+        }
+        EXPECT_EQ(10, m.size());
+        EXPECT_LE(m.capacity(), 64);
+    }
+
+    // Copy and move
+    {
+        DFG_CLASS_NAME(FlatHashMap)<int, int> m;
+        m[1] = 10;
+        auto m2 = m;
+        m2[2] = 20;
+        EXPECT_EQ(1, m.size());
+        EXPECT_EQ(2, m2.size());
+        auto m3 = std::move(m2);
+        EXPECT_TRUE(m2.empty());
+        EXPECT_EQ(20, m3[2]);
+    }
+}
+
+TEST(dfgCont, FlatHashSet)
+{
+    using namespace DFG_MODULE_NS(cont);
+    DFG_CLASS_NAME(FlatHashSet)<std::string> se;
+    EXPECT_TRUE(se.insert("a").second);
+    EXPECT_FALSE(se.insert(std::string("a")).second);
+    EXPECT_TRUE(se.insert("b").second);
+    EXPECT_EQ(2, se.size());
+    EXPECT_TRUE(se.hasKey("a"));
+    EXPECT_EQ("b", *se.find("b"));
+    EXPECT_TRUE(se.find("c") == se.end());
+    std::set<std::string> items(se.begin(), se.end());
+    EXPECT_EQ(std::set<std::string>({ "a", "b" }), items);
+    EXPECT_EQ(1, se.erase("a"));
+    EXPECT_EQ(0, se.erase("a"));
+    EXPECT_EQ(1, se.size());
+}
+
+TEST(dfgCont, OrderStatisticsMultiset)
+{
+    using namespace DFG_MODULE_NS(cont);
+
+    // Basic operations
+    {
+        DFG_CLASS_NAME(OrderStatisticsMultiset)<int> oms;
+        EXPECT_TRUE(oms.empty());
+        oms.insert(3);
+        oms.insert(1);
+        oms.insert(2);
+        oms.insert(2);
+        EXPECT_EQ(4, oms.size());
+        EXPECT_EQ(1, oms.nth(0));
+        EXPECT_EQ(2, oms.nth(1));
+        EXPECT_EQ(2, oms.nth(2));
+        EXPECT_EQ(3, oms.nth(3));
+        EXPECT_EQ(1, oms.front());
+        EXPECT_EQ(3, oms.back());
+        EXPECT_EQ(1, oms.countLessThan(2));
+        EXPECT_EQ(4, oms.countLessThan(4));
+        EXPECT_FALSE(oms.erase(5));
+        EXPECT_TRUE(oms.erase(2));
+        EXPECT_EQ(3, oms.size());
+        EXPECT_EQ(2, oms.nth(1));
+        oms.replace(1, 10);
+        EXPECT_EQ(2, oms.front());
+        EXPECT_EQ(10, oms.back());
+        oms.clear();
+        EXPECT_TRUE(oms.empty());
+        EXPECT_EQ(0, oms.blockCount());
+    }
+
+    // Random operations compared to std::multiset, small block size so that block splits and merges get exercised.
+    {
+        auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+        DFG_CLASS_NAME(OrderStatisticsMultiset)<int> oms(4);
+        std::multiset<int> expected;
+        for (int i = 0; i < 5000; ++i)
+        {
+            const int nOp = DFG_MODULE_NS(rand)::rand(randEng, 0, 2);
+            const int nVal = DFG_MODULE_NS(rand)::rand(randEng, 0, 200);
+            if (nOp != 0 || expected.size() < 10)
+            {
+                oms.insert(nVal);
+                expected.insert(nVal);
+            }
+            else
+            {
+                const auto iter = expected.find(nVal);
+                EXPECT_EQ(iter != expected.end(), oms.erase(nVal));
+                if (iter != expected.end())
+                    expected.erase(iter);
+            }
+            if (i % 100 == 0)
+            {
+                ASSERT_EQ(expected.size(), oms.size());
+                size_t k = 0;
+                for (const auto& val : expected)
+                    ASSERT_EQ(val, oms.nth(k++));
+                std::vector<int> inOrder;
+                oms.forEachInOrder([&](const int val) { inOrder.push_back(val); });
+                EXPECT_TRUE(std::equal(inOrder.begin(), inOrder.end(), expected.begin()));
+                EXPECT_EQ(static_cast<size_t>(std::distance(expected.begin(), expected.lower_bound(nVal))), oms.countLessThan(nVal));
+            }
+        }
+        // Erasing everything
+        for (const auto& val : expected)
+            EXPECT_TRUE(oms.erase(val));
+        EXPECT_TRUE(oms.empty());
+        EXPECT_EQ(0, oms.blockCount());
+    }
+}
+
 TEST(dfgCont, TrivialPair)
 {
     using namespace DFG_MODULE_NS(cont);
@@ -2074,6 +3528,91 @@ TEST(dfgCont, UniqueResourceHolder)
     }
 }
 
+TEST(dfgCont, CellBlockJournal)
+{
+    using namespace DFG_MODULE_NS(cont);
+    typedef DFG_CLASS_NAME(CellBlockJournal)<int> JournalT;
+    typedef std::tuple<int, int, std::string, bool> CellT; // (row, column, content, isNull)
+
+    const auto collectCells = [](const JournalT& journal)
+    {
+        std::vector<CellT> cells;
+        EXPECT_TRUE(journal.forEachCell([&](const int r, const int c, const char* psz, const size_t nLength)
+        {
+            EXPECT_TRUE(psz == nullptr || std::strlen(psz) == nLength);
+            cells.push_back(CellT(r, c, (psz) ? std::string(psz, nLength) : std::string(), psz == nullptr));
+        }));
+        return cells;
+    };
+
+    // Basic test with blocks in both directions
+    {
+        JournalT journal;
+        EXPECT_TRUE(journal.empty());
+        std::vector<CellT> expected;
+        const auto add = [&](const int r, const int c, const char* psz)
+        {
+            journal.add(r, c, psz);
+            expected.push_back(CellT(r, c, (psz) ? psz : "", psz == nullptr));
+        };
+        add(0, 0, "a");
+        add(1, 0, "");
+        add(2, 0, nullptr);
+        add(3, 0, "abc"); // End of first block (down)
+        add(5, 1, "d");
+        add(5, 2, "e");
+        add(5, 3, "f"); // End of second block (right)
+        add(0, 0, "g"); // Third block
+        EXPECT_EQ(8, journal.cellCount());
+        EXPECT_EQ(3, journal.blockCount());
+        EXPECT_FALSE(journal.hasSpilled());
+        EXPECT_EQ(expected, collectCells(journal));
+    }
+
+    // Spilling to temporary file with in-memory limit.
+    {
+        JournalT journal(nullptr, 100000);
+        std::vector<CellT> expected;
+        const std::string sLong(300, 'x');
+        for (int c = 0; c < 10; ++c)
+        {
+            for (int r = 0; r < 1000; ++r)
+            {
+                const auto s = (r % 100 == 0) ? sLong : std::to_string(r * c);
+                journal.add(r, c, s.c_str(), s.size());
+                expected.push_back(CellT(r, c, s, false));
+            }
+        }
+        EXPECT_EQ(10000, journal.cellCount());
+        EXPECT_TRUE(journal.hasSpilled());
+        EXPECT_FALSE(journal.hasSpillFailed());
+        EXPECT_GE(100000u, journal.inMemoryByteCount());
+        EXPECT_EQ(expected, collectCells(journal));
+    }
+
+    // Shared memory budget
+    {
+        auto spBudget = std::make_shared<JournalT::MemoryBudget>(200000);
+        {
+            JournalT journal0(spBudget);
+            JournalT journal1(spBudget);
+            const std::string s(1000, 'a');
+            for (int r = 0; r < 100; ++r)
+                journal0.add(r, 0, s.c_str());
+            EXPECT_FALSE(journal0.hasSpilled());
+            EXPECT_LT(0u, spBudget->used());
+            EXPECT_GE(spBudget->limit(), spBudget->used());
+            for (int r = 0; r < 150; ++r)
+                journal1.add(r, 0, s.c_str());
+            EXPECT_TRUE(journal1.hasSpilled());
+            EXPECT_GE(spBudget->limit(), spBudget->used());
+            EXPECT_EQ(150, collectCells(journal1).size());
+            EXPECT_EQ(s, std::get<2>(collectCells(journal1).back()));
+        }
+        EXPECT_EQ(0, spBudget->used());
+    }
+}
+
 TEST(dfgCont, CsvConfig)
 {
     DFG_MODULE_NS(cont)::DFG_CLASS_NAME(CsvConfig) config;
@@ -2108,6 +3647,60 @@ TEST(dfgCont, CsvConfig)
     EXPECT_EQ(19, config.entryCount());
 }
 
+TEST(dfgCont, CsvConfigCompiled)
+{
+    using namespace DFG_MODULE_NS(cont);
+    DFG_CLASS_NAME(CsvConfig) config;
+    config.loadFromFile("testfiles/csvConfigTest_0.csv");
+
+    DFG_CLASS_NAME(CsvConfigKeySet) keys;
+    const auto hEncoding = keys.addKey(DFG_UTF8("encoding"));
+    const auto hWidth = keys.addKey(DFG_UTF8("channels/0/width"));
+    const auto hNonExistent = keys.addKey(DFG_UTF8("a/non_existent_item"));
+    EXPECT_EQ(hEncoding, keys.addKey(DFG_UTF8("encoding")));
+    EXPECT_EQ(hWidth, keys.handle(DFG_UTF8("channels/0/width")));
+    EXPECT_TRUE(keys.handle(DFG_UTF8("not_added")) == DFG_CLASS_NAME(CsvConfigKeySet)::s_invalidHandle);
+    EXPECT_EQ(3, keys.size());
+
+    const DFG_CLASS_NAME(CsvConfigCompiled) compiled(config, keys);
+    EXPECT_EQ(config.entryCount(), compiled.entryCount());
+    EXPECT_LT(compiled.internedValueCount(), compiled.entryCount()); // Config has several empty values.
+
+    // Handle and URI lookups give the same results as CsvConfig
+    EXPECT_EQ(DFG_UTF8("UTF8"), compiled.value(hEncoding));
+    EXPECT_EQ(DFG_UTF8("50"), compiled.value(hWidth));
+    EXPECT_EQ(nullptr, compiled.valueStrOrNull(hNonExistent));
+    EXPECT_EQ(nullptr, compiled.valueStrOrNull(CsvConfigKeyHandle(1000)));
+    EXPECT_EQ(DFG_UTF8("default_value"), compiled.value(hNonExistent, DFG_UTF8("default_value")));
+    config.forEachStartingWith(DFG_UTF8(""), [&](const DFG_CLASS_NAME(CsvConfig)::StringViewT& uri, const DFG_CLASS_NAME(CsvConfig)::StringViewT& value)
+    {
+        const auto p = compiled.valueStrOrNull(uri);
+        ASSERT_TRUE(p != nullptr);
+        EXPECT_EQ(value.toString(), *p);
+    });
+    EXPECT_EQ(nullptr, compiled.valueStrOrNull(DFG_UTF8("a/non_existent_item")));
+    EXPECT_EQ(compiled.valueStrOrNull(DFG_UTF8("channels")), compiled.valueStrOrNull(DFG_UTF8("channels/0"))); // Equal values are interned.
+
+    // Holder: reset publishes new snapshot while old snapshot stays valid for its users.
+    DFG_CLASS_NAME(CsvConfigCompiledHolder) holder(keys);
+    EXPECT_FALSE(holder.snapshot());
+    holder.reloadFromFile("testfiles/csvConfigTest_0.csv");
+    auto spViewer = holder.createViewer();
+    auto spOld = spViewer->viewCached();
+    ASSERT_TRUE(spOld != nullptr);
+    EXPECT_EQ(DFG_UTF8("UTF8"), spOld->value(hEncoding));
+    const auto nVersion = holder.version();
+
+    DFG_CLASS_NAME(CsvConfig) config2;
+    config2.setKeyValue(DFG_UTF8("encoding"), DFG_UTF8("Latin1"));
+    holder.reset(config2);
+    EXPECT_NE(nVersion, holder.version());
+    EXPECT_EQ(DFG_UTF8("UTF8"), spOld->value(hEncoding));
+    ASSERT_TRUE(spViewer->viewCached() != nullptr);
+    EXPECT_EQ(DFG_UTF8("Latin1"), spViewer->viewCached()->value(hEncoding));
+    EXPECT_EQ(nullptr, holder.snapshot()->valueStrOrNull(hWidth));
+}
+
 TEST(dfgCont, CsvConfig_forEachStartingWith)
 {
     typedef DFG_ROOT_NS::DFG_CLASS_NAME(StringUtf8) StringUTf8;
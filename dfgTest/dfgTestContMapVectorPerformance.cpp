@@ -21,6 +21,7 @@ DFG_ROOT_NS_BEGIN{ DFG_SUB_NS(TypeTraits)
 #include <dfg/cont/valueArray.hpp>
 #include <dfg/str/strTo.hpp>
 
+#include <dfg/cont/FlatHashMap.hpp>
 #include <dfg/cont/MapVector.hpp>
 #include <dfg/cont/TrivialPair.hpp>
 #include <dfg/cont/Vector.hpp>
@@ -69,14 +70,17 @@ std::string containerDescription(const boost::container::flat_map<Key_T, Val_T>&
 template <class Key_T, class Val_T>
 std::string containerDescription(const DFG_MODULE_NS(cont)::MapVectorAoS<Key_T, Val_T>& cont)
 {
-    return DFG_ROOT_NS::format_fmt("MapVectorAoS<{},{}>, sorted: {}", typeToName<Key_T>::name(), typeToName<Val_T>::name(), int(cont.isSorted()));
+    return DFG_ROOT_NS::format_fmt("MapVectorAoS<{},{}>, sorted: {}{}", typeToName<Key_T>::name(), typeToName<Val_T>::name(), int(cont.isSorted()), (cont.isFrozen()) ? ", frozen" : "");
 }
 template <class Key_T, class Val_T>
 std::string containerDescription(const DFG_MODULE_NS(cont)::MapVectorSoA<Key_T, Val_T>& cont)
 {
-    return DFG_ROOT_NS::format_fmt("MapVectorSoA<{},{}>, sorted: {}", typeToName<Key_T>::name(), typeToName<Val_T>::name(), int(cont.isSorted()));
+    return DFG_ROOT_NS::format_fmt("MapVectorSoA<{},{}>, sorted: {}{}", typeToName<Key_T>::name(), typeToName<Val_T>::name(), int(cont.isSorted()), (cont.isFrozen()) ? ", frozen" : "");
 }
 
+template <class Key_T, class Val_T>
+std::string containerDescription(const DFG_MODULE_NS(cont)::FlatHashMap<Key_T, Val_T>&) { return "FlatHashMap<" + typeToName<Key_T>::name() + "," + typeToName<Val_T>::name() + ">"; }
+
 template <class Val_T>
 std::string containerDescription(const DFG_MODULE_NS(cont)::Vector<Val_T>&)
 {
@@ -522,7 +526,7 @@ TEST(dfgCont, MapVectorPerformance)
                 table.addString(sInsertCount, r, 5);
             }
 
-            for (int et = 1; et <= 11; ++et)
+            for (int et = 1; et <= 14; ++et)
             {
                 const auto r = tableFindBench.rowCountByMaxRowIndex();
                 tableFindBench.addString(sTime, r, 0);
@@ -659,6 +663,20 @@ TEST(dfgCont, MapVectorPerformance)
             EXPECT_EQ(findings, findPerformanceTester(mStd, randEngSeedFind, nFindCount, 9, tableFindBench));
             EXPECT_EQ(findings, findPerformanceTester(mStdUnordered, randEngSeedFind, nFindCount, 10, tableFindBench));
             EXPECT_EQ(findings, findPerformanceTester(mBoostFlatMap, randEngSeedFind, nFindCount, 11, tableFindBench));
+
+            // Frozen (Eytzinger-indexed) variants of sorted MapVectors.
+            auto mAoS_frozen = mAoS_rs;
+            mAoS_frozen.freeze();
+            auto mSoA_frozen = mSoA_rs;
+            mSoA_frozen.freeze();
+            EXPECT_EQ(findings, findPerformanceTester(mAoS_frozen, randEngSeedFind, nFindCount, 12, tableFindBench));
+            EXPECT_EQ(findings, findPerformanceTester(mSoA_frozen, randEngSeedFind, nFindCount, 13, tableFindBench));
+
+            FlatHashMap<int, int> mFlatHash;
+            mFlatHash.reserve(mStd.size());
+            for (const auto& item : mStd)
+                mFlatHash[item.first] = item.second;
+            EXPECT_EQ(findings, findPerformanceTester(mFlatHash, randEngSeedFind, nFindCount, 14, tableFindBench));
         }
     }
 
@@ -743,10 +761,11 @@ TEST(dfgCont, MapPerformanceComparisonWithStdStringKeyAndConstCharLookUp)
     MapVectorSoA<std::string, int> mSoA_unsorted; mSoA_unsorted.setSorting(false);
     fc::vector_map<std::string, int> pubbyVectorMap;
     std::flat_map<std::string, int> smFlatMap;
+    FlatHashMap<std::string, int> flatHashMap;
 
     const size_t nMapSize = 3;
     //const size_t nMapSize = 1000;
-    const auto nContainerCount = 9;
+    const auto nContainerCount = 10;
 
 #ifdef _DEBUG
     const size_t nFindCount = Max<size_t>(10, 100 / nMapSize);
@@ -803,6 +822,7 @@ TEST(dfgCont, MapPerformanceComparisonWithStdStringKeyAndConstCharLookUp)
         CALL_ELEMENTARY_TEST(boostFlatMap,      "boost::flat_map",          7);
         CALL_ELEMENTARY_TEST(smFlatMap,         "smFlatMap",                8);
         CALL_ELEMENTARY_TEST(pubbyVectorMap,    "pubbyVectorMap",           9);
+        CALL_ELEMENTARY_TEST(flatHashMap,       "FlatHashMap",              10);
 #undef CALL_ELEMENTARY_TEST
 
         EXPECT_EQ(nContainerCount, results.size());
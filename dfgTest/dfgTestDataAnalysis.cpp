@@ -4,6 +4,9 @@
 #include <dfg/rand.hpp>
 #include <deque>
 #include <dfg/numeric/average.hpp>
+#include <dfg/numeric/percentile.hpp>
+#include <dfg/cont/tableCsv.hpp>
+#include <cstdio>
 
 TEST(dfgDataAnalysis, correlation)
 {
@@ -23,6 +26,23 @@ TEST(dfgDataAnalysis, correlation)
     val = correlation(data3, data4);
 
     EXPECT_NEAR(0.176197, val, 0.00001);
+    EXPECT_NEAR(val, correlationParallel(data3, data4), 1e-14);
+    EXPECT_TRUE(std::isnan(correlationParallel(data3, data1)));
+
+    // Parallel version with multiple chunks
+    {
+        auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+        std::vector<double> vals0(300000);
+        std::vector<double> vals1(vals0.size());
+        for (size_t i = 0; i < vals0.size(); ++i)
+        {
+            vals0[i] = DFG_MODULE_NS(rand)::rand(randEng, -10.0, 10.0);
+            vals1[i] = vals0[i] + DFG_MODULE_NS(rand)::rand(randEng, -10.0, 10.0);
+        }
+        const auto corrParallel = correlationParallel(vals0, vals1, 3);
+        EXPECT_NEAR(correlation(vals0, vals1), corrParallel, 1e-10);
+        EXPECT_EQ(corrParallel, correlationParallel(vals0, vals1, 1));
+    }
 
     {
         const double arr0[] = { 5, 4, 3, 2, 0 };
@@ -75,6 +95,188 @@ TEST(dfgDataAnalysis, correlation)
     }
 }
 
+TEST(dfgDataAnalysis, coMoments)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(dataAnalysis);
+
+    // Basic values, compared against two-pass computation.
+    {
+        const double data1[] = { 0.206380011, 0.146362211, 0.198662166, 0.806195132, 0.971970961, 0.794326782, 0.416097218 };
+        const double data2[] = { 0.628101805, 0.77934745, 0.339630401, 0.737591227, 0.969400793, 0.175145224, 0.294738711 };
+        const double data3[] = { 3, -1, 4, 1, -5, 9, 2 };
+        const double* columns[] = { data1, data2, data3 };
+        const size_t n = DFG_COUNTOF(data1);
+
+        CoMomentAccumulator accRows(3);
+        CoMomentAccumulator accBlock(3);
+        for (size_t r = 0; r < n; ++r)
+        {
+            const double row[] = { data1[r], data2[r], data3[r] };
+            accRows.addRow(row);
+        }
+        accBlock.addBlock(columns, n);
+        EXPECT_EQ(n, accRows.count());
+        EXPECT_EQ(n, accBlock.count());
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                double meanI = 0, meanJ = 0;
+                for (size_t r = 0; r < n; ++r)
+                {
+                    meanI += columns[i][r] / n;
+                    meanJ += columns[j][r] / n;
+                }
+                double coMoment = 0;
+                for (size_t r = 0; r < n; ++r)
+                    coMoment += (columns[i][r] - meanI) * (columns[j][r] - meanJ);
+                EXPECT_NEAR(coMoment / (n - 1), accRows.covariance(i, j), 1e-12);
+                EXPECT_NEAR(coMoment / (n - 1), accBlock.covariance(i, j), 1e-12);
+                EXPECT_NEAR(coMoment / n, accBlock.covariance(i, j, 0), 1e-12);
+            }
+        }
+        EXPECT_NEAR(correlation(data1, data2), accRows.correlation(0, 1), 1e-12);
+        EXPECT_NEAR(correlation(data1, data3), accBlock.correlation(0, 2), 1e-12);
+        EXPECT_NEAR(correlation(data2, data3), accBlock.correlation(2, 1), 1e-12);
+
+        const auto corrMatrix = accBlock.correlationMatrix();
+        ASSERT_EQ(9, corrMatrix.size());
+        EXPECT_NEAR(1, corrMatrix[0], 1e-12);
+        EXPECT_NEAR(1, corrMatrix[4], 1e-12);
+        EXPECT_EQ(corrMatrix[1], corrMatrix[3]);
+        EXPECT_EQ(accBlock.covariance(1, 2), accBlock.covarianceMatrix()[5]);
+
+        // Merging
+        CoMomentAccumulator accA(3);
+        CoMomentAccumulator accB(3);
+        const double* columnsB[] = { data1 + 3, data2 + 3, data3 + 3 };
+        accA.addBlock(columns, 3);
+        accB.addBlock(columnsB, n - 3);
+        accA.merge(accB);
+        EXPECT_EQ(n, accA.count());
+        for (size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(accRows.mean(i), accA.mean(i), 1e-12);
+            for (size_t j = 0; j < 3; ++j)
+                EXPECT_NEAR(accRows.coMoment(i, j), accA.coMoment(i, j), 1e-12);
+        }
+
+        // Empty accumulator
+        CoMomentAccumulator accEmpty(2);
+        EXPECT_TRUE(std::isnan(accEmpty.covariance(0, 1)));
+        EXPECT_TRUE(std::isnan(accEmpty.correlation(0, 1)));
+    }
+
+    // Missing values skip the whole row
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double col0[] = { 1, 2, nan, 4, 5 };
+        const double col1[] = { 2, 1, 7, nan, 3 };
+        const double* columns[] = { col0, col1 };
+        CoMomentAccumulator acc(2);
+        acc.addBlock(columns, 5);
+        EXPECT_EQ(3, acc.count());
+        const double expected0[] = { 1, 2, 5 };
+        const double expected1[] = { 2, 1, 3 };
+        EXPECT_NEAR(correlation(expected0, expected1), acc.correlation(0, 1), 1e-12);
+    }
+
+    // Numerical stability with large offset
+    {
+        std::vector<double> vals0;
+        std::vector<double> vals1;
+        for (int i = 0; i < 1000; ++i)
+        {
+            vals0.push_back(1e9 + (i % 7));
+            vals1.push_back(1e9 + (i % 5));
+        }
+        const auto acc = coMomentsParallel(std::vector<std::vector<double>>({ vals0, vals1 }));
+        double mean0 = 0;
+        for (const auto v : vals0)
+            mean0 += (v - 1e9) / vals0.size();
+        double var0 = 0;
+        for (const auto v : vals0)
+            var0 += (v - 1e9 - mean0) * (v - 1e9 - mean0);
+        EXPECT_NEAR(var0 / (vals0.size() - 1), acc.covariance(0, 0), 1e-9);
+    }
+
+    // Parallel and table versions
+    {
+        auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+        const size_t nRowCount = 150000;
+        const size_t nColCount = 4;
+        std::vector<std::vector<double>> columns(nColCount, std::vector<double>(nRowCount));
+        for (size_t r = 0; r < nRowCount; ++r)
+        {
+            columns[0][r] = DFG_MODULE_NS(rand)::rand(randEng, -10.0, 10.0);
+            columns[1][r] = columns[0][r] + DFG_MODULE_NS(rand)::rand(randEng, -10.0, 10.0);
+            columns[2][r] = DFG_MODULE_NS(rand)::rand(randEng, 0.0, 1.0);
+            columns[3][r] = -2 * columns[0][r];
+        }
+        const auto acc1 = coMomentsParallel(columns, 1);
+        const auto acc3 = coMomentsParallel(columns, 3);
+        EXPECT_EQ(acc1.covarianceMatrix(), acc3.covarianceMatrix()); // Result must not depend on thread count.
+        EXPECT_NEAR(correlation(columns[0], columns[1]), acc3.correlation(0, 1), 1e-10);
+        EXPECT_NEAR(correlation(columns[1], columns[2]), acc3.correlation(1, 2), 1e-10);
+        EXPECT_NEAR(-1, acc3.correlation(0, 3), 1e-12);
+
+        DFG_MODULE_NS(cont)::TableCsv<char, uint32> table;
+        const size_t nTableRows = 20000;
+        for (size_t c = 0; c < nColCount; ++c)
+        {
+            for (size_t r = 0; r < nTableRows; ++r)
+            {
+                if (c == 1 && r == 5)
+                    continue; // Missing cell
+                char buffer[32] = "abc";
+                if (c != 2 || r != 7)
+                    std::sprintf(buffer, "%.17g", columns[c][r]);
+                table.setElement(r, c, SzPtrUtf8(buffer));
+            }
+        }
+        const std::vector<uint32> tableCols = { 0, 1, 3 };
+        const auto accTable = coMomentsFromTableColumns(table, tableCols, 2, 1000);
+        EXPECT_EQ(nTableRows - 1, accTable.count());
+        EXPECT_EQ(3, accTable.variableCount());
+        EXPECT_NEAR(-1, accTable.correlation(0, 2), 1e-9);
+        std::vector<double> expected0(columns[0].begin(), columns[0].begin() + nTableRows);
+        std::vector<double> expected1(columns[1].begin(), columns[1].begin() + nTableRows);
+        expected0.erase(expected0.begin() + 5);
+        expected1.erase(expected1.begin() + 5);
+        EXPECT_NEAR(correlation(expected0, expected1), accTable.correlation(0, 1), 1e-9);
+
+        const std::vector<uint32> tableColsWithText = { 0, 2 };
+        EXPECT_EQ(nTableRows - 1, coMomentsFromTableColumns(table, tableColsWithText).count());
+    }
+
+    // Cell parsing
+    {
+        using DFG_MODULE_NS(dataAnalysis)::DFG_DETAIL_NS::cellToDouble;
+        using DFG_MODULE_NS(math)::isNan;
+        EXPECT_EQ(1.5, cellToDouble("1.5"));
+        EXPECT_EQ(-0.25, cellToDouble(" -0.25\t"));
+        EXPECT_EQ(1000, cellToDouble("1e3"));
+        EXPECT_EQ(2.5e-3, cellToDouble("+2.5E-3"));
+        EXPECT_EQ(0.5, cellToDouble(".5"));
+        EXPECT_TRUE(isNan(cellToDouble(nullptr)));
+        EXPECT_TRUE(isNan(cellToDouble("")));
+        EXPECT_TRUE(isNan(cellToDouble("  ")));
+        EXPECT_TRUE(isNan(cellToDouble("1,5")));
+        EXPECT_TRUE(isNan(cellToDouble("1.5 2")));
+        EXPECT_TRUE(isNan(cellToDouble("1.5a")));
+        EXPECT_TRUE(isNan(cellToDouble("inf")));
+        EXPECT_TRUE(isNan(cellToDouble("-infinity")));
+        EXPECT_TRUE(isNan(cellToDouble("nan")));
+        EXPECT_TRUE(isNan(cellToDouble("0x10")));
+        EXPECT_TRUE(isNan(cellToDouble("e")));
+        EXPECT_TRUE(isNan(cellToDouble("1e")));
+        EXPECT_TRUE(isNan(cellToDouble("--1")));
+        EXPECT_TRUE(isNan(cellToDouble("1.2.3")));
+    }
+}
+
 TEST(dfgDataAnalysis, smoothWithNeighbourAverages)
 {
     using namespace DFG_ROOT_NS;
@@ -295,3 +497,165 @@ TEST(dfgDataAnalysis, smoothWithNeighbourMedians)
     testWithRandomData(22000);
     testWithRandomData(NumericTraits<size_t>::maxValue);
 }
+
+TEST(dfgDataAnalysis, smoothWithNeighbourPercentiles)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(dataAnalysis);
+
+    {
+        std::vector<double> vals = { 5, 1, 4, 2, 3 };
+        smoothWithNeighbourPercentiles(vals, 1, 0);
+        EXPECT_EQ(std::vector<double>({ 1, 1, 1, 2, 2 }), vals);
+        vals = { 5, 1, 4, 2, 3 };
+        smoothWithNeighbourPercentiles(vals, 1, 100);
+        EXPECT_EQ(std::vector<double>({ 5, 5, 4, 4, 3 }), vals);
+    }
+
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    std::vector<double> data(300);
+    std::generate(data.begin(), data.end(), [&]() { return DFG_MODULE_NS(rand)::rand(randEng, -100.0, 100.0); });
+    for (const size_t nRadius : { size_t(1), size_t(2), size_t(7), size_t(50), size_t(400) })
+    {
+        for (const double percentile : { 0.0, 10.0, 25.0, 50.0, 90.0, 100.0 })
+        {
+            auto smoothed = data;
+            smoothWithNeighbourPercentiles(smoothed, nRadius, percentile);
+            for (size_t i = 0; i < data.size(); ++i)
+            {
+                const size_t nLeft = i - Min(i, nRadius);
+                const size_t nRight = i + Min(data.size() - i - 1, nRadius) + 1;
+                std::vector<double> window(data.begin() + nLeft, data.begin() + nRight);
+                std::sort(window.begin(), window.end());
+                ASSERT_EQ(DFG_MODULE_NS(numeric)::percentileInSorted_enclosingElem(window, percentile), smoothed[i]);
+            }
+        }
+    }
+}
+
+TEST(dfgDataAnalysis, smoothWithNeighbourMediansParallel)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(dataAnalysis);
+
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    std::vector<double> data(10000);
+    std::generate(data.begin(), data.end(), [&]() { return DFG_MODULE_NS(rand)::rand(randEng, -100.0, 100.0); });
+    for (const size_t nRadius : { size_t(1), size_t(3), size_t(100), size_t(6000), NumericTraits<size_t>::maxValue })
+    {
+        auto expected = data;
+        smoothWithNeighbourMedians(expected, nRadius);
+        auto smoothed = data;
+        smoothWithNeighbourMediansParallel(smoothed, nRadius, 4, 100);
+        EXPECT_EQ(expected, smoothed);
+
+        expected = data;
+        smoothWithNeighbourPercentiles(expected, nRadius, 75);
+        smoothed = data;
+        smoothWithNeighbourPercentilesParallel(smoothed, nRadius, 75, 3, 100);
+        EXPECT_EQ(expected, smoothed);
+    }
+}
+
+TEST(dfgDataAnalysis, decimateIndexesMinMax)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(dataAnalysis);
+
+    // Small input -> all indexes
+    {
+        const std::vector<double> vals = { 1, 2, 3 };
+        EXPECT_EQ(std::vector<size_t>({ 0, 1, 2 }), decimateIndexesMinMax(vals, 2));
+        EXPECT_TRUE(decimateIndexesMinMax(std::vector<double>(), 10).empty());
+    }
+
+    // Extremes are kept and returned in ascending order.
+    {
+        const std::vector<double> vals = { 0, 5, 1, -3, 2, 2, 2, 2, 9, 1, 0, 0 };
+        // Buckets: [0, 4[, [4, 8[, [8, 12[
+        const auto indexes = decimateIndexesMinMax(vals, 3);
+        EXPECT_EQ(std::vector<size_t>({ 1, 3, 4, 8, 10 }), indexes);
+    }
+
+    // NaN handling
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const std::vector<double> vals = { nan, nan, nan, 1, 4, nan };
+        EXPECT_EQ(std::vector<size_t>({ 3, 4 }), decimateIndexesMinMax(vals, 2));
+    }
+
+    // Large input
+    {
+        std::vector<double> vals(100000);
+        for (size_t i = 0; i < vals.size(); ++i)
+            vals[i] = std::sin(static_cast<double>(i) / 1000);
+        vals[54321] = 100;
+        const auto indexes = decimateIndexesMinMax(vals, 500);
+        EXPECT_GE(1000u, indexes.size());
+        EXPECT_TRUE(std::is_sorted(indexes.begin(), indexes.end()));
+        EXPECT_TRUE(std::find(indexes.begin(), indexes.end(), 54321) != indexes.end());
+    }
+}
+
+TEST(dfgDataAnalysis, decimateIndexesMinMaxByX)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(dataAnalysis);
+
+    // Buckets are by x-distance: with gap in x, first six points are in the first bucket ([0, 51.5[) and the rest in the second.
+    {
+        const std::vector<double> x = { 0, 1, 2, 3, 4, 5, 100, 101, 102, 103 };
+        const std::vector<double> y = { 0, 5, 1, -3, 2, 2, 9, 1, 0, 0 };
+        EXPECT_EQ(std::vector<size_t>({ 1, 3, 6, 8 }), decimateIndexesMinMaxByX(x, y, 2));
+        EXPECT_EQ(std::vector<size_t>({ 3, 6 }), decimateIndexesMinMaxByX(x, y, 1));
+        const std::vector<double> y2 = { 0, 0, 0, 0, 0, 7, -1, 0, 0, 0 };
+        EXPECT_EQ(std::vector<size_t>({ 0, 5, 6, 7 }), decimateIndexesMinMaxByX(x, y2, 2));
+        EXPECT_EQ(std::vector<size_t>({ 0, 5, 6 }), decimateIndexesMinMax(y2, 2)); // Index buckets [0, 5[ and [5, 10[ lose the 0 after the dip.
+    }
+
+    // Small input -> all indexes, unordered x -> same as decimateIndexesMinMax()
+    {
+        const std::vector<double> x = { 3, 2, 1, 0, 5, 4, 6 };
+        const std::vector<double> y = { 0, 5, 1, -3, 2, 8, 1 };
+        EXPECT_EQ(std::vector<size_t>({ 0, 1, 2, 3, 4, 5, 6 }), decimateIndexesMinMaxByX(x, y, 4));
+        EXPECT_EQ(decimateIndexesMinMax(y, 2), decimateIndexesMinMaxByX(x, y, 2));
+    }
+}
+
+TEST(dfgDataAnalysis, decimateIndexesLttb)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(dataAnalysis);
+
+    {
+        const std::vector<double> x = { 0, 1, 2, 3 };
+        const std::vector<double> y = { 0, 1, 2, 3 };
+        EXPECT_EQ(std::vector<size_t>({ 0, 1, 2, 3 }), decimateIndexesLttb(x, y, 4));
+        EXPECT_EQ(3u, decimateIndexesLttb(x, y, 1).size()); // Output count less than 3 is treated as 3.
+    }
+
+    // Spike should be chosen from its bucket.
+    {
+        const std::vector<double> x = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        const std::vector<double> y = { 0, 0, 0, 0, 0, 10, 0, 0, 0, 0 };
+        const auto indexes = decimateIndexesLttb(x, y, 4);
+        ASSERT_EQ(4u, indexes.size());
+        EXPECT_EQ(0u, indexes.front());
+        EXPECT_EQ(9u, indexes.back());
+        EXPECT_EQ(5u, indexes[2]);
+        EXPECT_TRUE(std::is_sorted(indexes.begin(), indexes.end()));
+    }
+
+    {
+        std::vector<double> x(10000);
+        std::vector<double> y(x.size());
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            x[i] = static_cast<double>(i);
+            y[i] = std::cos(x[i] / 100);
+        }
+        const auto indexes = decimateIndexesLttb(x, y, 200);
+        EXPECT_EQ(200u, indexes.size());
+        EXPECT_TRUE(std::adjacent_find(indexes.begin(), indexes.end(), [](size_t a, size_t b) { return a >= b; }) == indexes.end());
+    }
+}
@@ -77,7 +77,7 @@ TEST(dfgDebug, printToDebugDisplay)
 
 TEST(dfgDebug, setThreadName)
 {
-#ifdef _MSC_VER
+#if DFG_THREAD_SET_THREAD_NAME_AVAILABLE
     DFG_MODULE_NS(thread)::setThreadName("NewThreadName");
 #endif
 }
@@ -114,6 +114,126 @@ TEST(dfgFunc, MemFuncMedian)
     }
 }
 
+namespace
+{
+    // Returns the fraction of values in sorted 'vals' that are less than or equal to 'val'.
+    double fractionOfValuesNotGreaterThan(const std::vector<double>& sortedVals, const double val)
+    {
+        return static_cast<double>(std::upper_bound(sortedVals.begin(), sortedVals.end(), val) - sortedVals.begin()) / sortedVals.size();
+    }
+
+    template <class Sketch_T>
+    void testQuantileSketch(const Sketch_T& emptySketch, const double maxRankError)
+    {
+        using namespace DFG_ROOT_NS;
+        using namespace DFG_MODULE_NS(func);
+        auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+        const size_t nCount = 200000;
+        const size_t nShardCount = 4;
+        std::vector<double> vals(nCount);
+        Sketch_T sketch = emptySketch;
+        std::vector<Sketch_T> shards(nShardCount, emptySketch);
+        for (size_t i = 0; i < nCount; ++i)
+        {
+            // Skewed distribution to make tails different from the middle.
+            const auto r = DFG_MODULE_NS(rand)::rand(randEng, 0.0, 1.0);
+            vals[i] = r * r * r * 1000;
+            sketch(vals[i]);
+            shards[i % nShardCount](vals[i]);
+        }
+        sketch(std::numeric_limits<double>::quiet_NaN()); // NaN's are ignored.
+        EXPECT_EQ(nCount, sketch.callCount());
+
+        Sketch_T merged = emptySketch;
+        for (const auto& shard : shards)
+            merged.merge(shard);
+        EXPECT_EQ(nCount, merged.callCount());
+
+        std::vector<char> bytes;
+        merged.serialize(bytes);
+        Sketch_T deserialized;
+        EXPECT_TRUE(deserialized.deserialize(bytes.data(), bytes.size()));
+        EXPECT_FALSE(deserialized.deserialize(bytes.data(), bytes.size() / 2));
+        EXPECT_FALSE(deserialized.deserialize(bytes.data() + 1, bytes.size() - 1));
+
+        std::sort(vals.begin(), vals.end());
+        EXPECT_EQ(vals.front(), sketch.minValue());
+        EXPECT_EQ(vals.back(), sketch.maxValue());
+        EXPECT_EQ(vals.front(), sketch.quantile(0));
+        EXPECT_EQ(vals.back(), sketch.quantile(1));
+        const double quantiles[] = { 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999 };
+        for (const auto q : quantiles)
+        {
+            EXPECT_NEAR(q, fractionOfValuesNotGreaterThan(vals, sketch.quantile(q)), maxRankError);
+            EXPECT_NEAR(q, fractionOfValuesNotGreaterThan(vals, merged.quantile(q)), maxRankError);
+            EXPECT_EQ(merged.quantile(q), deserialized.quantile(q));
+        }
+        EXPECT_EQ(sketch.quantile(0.5), sketch.median());
+    }
+}
+
+TEST(dfgFunc, MemFuncQuantileSketches)
+{
+    using namespace DFG_MODULE_NS(func);
+    using namespace DFG_MODULE_NS(math);
+
+    // t-digest
+    {
+        DFG_CLASS_NAME(MemFuncQuantileTDigest)<double> mf;
+        EXPECT_TRUE(isNan(mf.median()));
+        const std::array<double, 4> arr = { 4, 1, 3, 2 };
+        for (const auto v : arr)
+            mf(v);
+        EXPECT_EQ(2.5, mf.median()); // Small input is represented exactly.
+        EXPECT_EQ(4, mf.centroidCount());
+        mf.clear();
+        EXPECT_EQ(0, mf.callCount());
+
+        testQuantileSketch(DFG_CLASS_NAME(MemFuncQuantileTDigest)<double>(), 0.005);
+
+        // Memory usage is bounded
+        DFG_CLASS_NAME(MemFuncQuantileTDigest)<int> mfInt(50);
+        for (int i = 0; i < 1000000; ++i)
+            mfInt(i);
+        EXPECT_GE(50u, mfInt.centroidCount());
+        EXPECT_NEAR(990000, mfInt.quantile(0.99), 100);
+
+        // Const queries with buffered values give the same results as after explicit compress().
+        for (int i = 0; i < 123; ++i)
+            mfInt(i % 7);
+        const auto& mfConst = mfInt;
+        const auto p10 = mfConst.quantile(0.1);
+        const auto nCentroidCount = mfConst.centroidCount();
+        std::string sSerialized;
+        mfConst.serialize(sSerialized);
+        mfInt.compress();
+        EXPECT_EQ(p10, mfInt.quantile(0.1));
+        EXPECT_EQ(nCentroidCount, mfInt.centroidCount());
+        std::string sSerialized2;
+        mfInt.serialize(sSerialized2);
+        EXPECT_EQ(sSerialized, sSerialized2);
+    }
+
+    // KLL
+    {
+        DFG_CLASS_NAME(MemFuncQuantileKll)<double> mf;
+        EXPECT_TRUE(isNan(mf.median()));
+        const std::array<double, 5> arr = { 9, 6, 3, 5, 1 };
+        for (const auto v : arr)
+            mf(v);
+        EXPECT_EQ(5, mf.median());
+        EXPECT_EQ(0.6, mf.rank(5));
+
+        testQuantileSketch(DFG_CLASS_NAME(MemFuncQuantileKll)<double>(), 0.02);
+
+        DFG_CLASS_NAME(MemFuncQuantileKll)<int> mfInt(100);
+        for (int i = 0; i < 1000000; ++i)
+            mfInt(i);
+        EXPECT_GE(500u, mfInt.retainedItemCount());
+        EXPECT_NEAR(0.5, mfInt.rank(500000), 0.03);
+    }
+}
+
 TEST(dfgFunc, CastStatic)
 {
     using namespace DFG_ROOT_NS;
@@ -11,8 +11,8 @@ TEST(dfgHash, HashCreator)
 	using namespace DFG_MODULE_NS(str);
 	
 	DFG_DEFINE_STRING_LITERAL_C(szTest1, "BOOST_AUTO_TEST_CASE( TestHashCreator )");
-	DFG_DEFINE_STRING_LITERAL_C(szTest1_Md5_expected, "8c6af274c06f1e5685ad0e2808eda0f5");
-	DFG_DEFINE_STRING_LITERAL_C(szTest1_Sha1_expected, "82ba8da53c54e6ec22a0fe003deea088bf2f91e6");
+	DFG_DEFINE_STRING_LITERAL_C(szTest1_Md5_expected, "8C6AF274C06F1E5685AD0E2808EDA0F5");
+	DFG_DEFINE_STRING_LITERAL_C(szTest1_Sha1_expected, "82BA8DA53C54E6EC22A0FE003DEEA088BF2F91E6");
 
 	auto szHashMd5 = DFG_CLASS_NAME(HashCreator)(HashTypeMd5).process(szTest1, DFG_COUNTOF_CSL(szTest1)).toStr<char>();
 	DFG_MODULE_NS(str)::toLower(szHashMd5);
@@ -23,3 +23,124 @@ TEST(dfgHash, HashCreator)
 	EXPECT_EQ(strCmp(szHashSha1, szTest1_Sha1_expected), 0);
 }
 #endif
+
+#include <dfg/io/fileToByteContainer.hpp>
+#include <dfg/io/OfStream.hpp>
+
+TEST(dfgHash, xxHash64)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(hash);
+
+    // Reference values from xxHash
+    EXPECT_EQ(0xEF46DB3751D8E999ULL, xxHash64("", 0));
+    EXPECT_EQ(0xD24EC4F1A98C6E5BULL, xxHash64("a", 1));
+    EXPECT_EQ(0x44BC2CF5AD770999ULL, xxHash64("abc", 3));
+    EXPECT_EQ("44BC2CF5AD770999", DFG_CLASS_NAME(Xxh64Hasher)().process("abc", 3).toStr());
+    EXPECT_NE(xxHash64("abc", 3), xxHash64("abc", 3, 1));
+
+    // Streaming in pieces of different sizes gives the same result as one-shot hashing.
+    std::vector<char> data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i * 31 + 7);
+    for (size_t nLength = 0; nLength <= data.size(); nLength += 37)
+    {
+        const auto nExpected = xxHash64(data.data(), nLength, 5);
+        for (size_t nPiece = 1; nPiece < 70; nPiece += 13)
+        {
+            DFG_CLASS_NAME(Xxh64Hasher) hasher(5);
+            for (size_t i = 0; i < nLength; i += nPiece)
+                hasher.process(data.data() + i, Min(nPiece, nLength - i));
+            EXPECT_EQ(nExpected, hasher.hashValue());
+        }
+    }
+}
+
+TEST(dfgHash, sha256)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(hash);
+
+    // Test vectors from FIPS 180-2
+    EXPECT_EQ("E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855", sha256Str("", 0));
+    EXPECT_EQ("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD", sha256Str("abc", 3));
+    const char szTwoBlocks[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    EXPECT_EQ("248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1", sha256Str(szTwoBlocks, DFG_COUNTOF_SZ(szTwoBlocks)));
+    {
+        DFG_CLASS_NAME(Sha256Hasher) hasher;
+        const std::string sChunk(1000, 'a');
+        for (int i = 0; i < 1000; ++i)
+            hasher.process(sChunk.data(), sChunk.size());
+        EXPECT_EQ("CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0", hasher.toStr());
+        // Digest can be queried in the middle of processing.
+        hasher.reset();
+        hasher.process("ab", 2);
+        EXPECT_EQ(sha256Str("ab", 2), hasher.toStr());
+        hasher.process("c", 1);
+        EXPECT_EQ(sha256Str("abc", 3), hasher.toStr());
+    }
+}
+
+TEST(dfgHash, fileAndTreeHash)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(hash);
+
+    const char szPath[] = "testfiles/matrix_200x200.txt";
+    const auto bytes = DFG_MODULE_NS(io)::fileToVector(szPath);
+    ASSERT_FALSE(bytes.empty());
+
+    // hashFile() equals hash of content.
+    {
+        DFG_CLASS_NAME(Sha256Hasher) hasher;
+        EXPECT_TRUE(hashFile(szPath, hasher));
+        EXPECT_EQ(sha256Str(bytes.data(), bytes.size()), hasher.toStr());
+        DFG_CLASS_NAME(Xxh64Hasher) xxHasher;
+        EXPECT_TRUE(hashFile(szPath, xxHasher));
+        EXPECT_EQ(xxHash64(bytes.data(), bytes.size()), xxHasher.hashValue());
+        EXPECT_FALSE(hashFile("testfiles/nonExistingFile.txt", hasher));
+        // Directory can't be mapped and reading it fails (or it can't be opened at all), so it must not be reported as hashed content.
+        EXPECT_FALSE(hashFile("testfiles", hasher));
+        DFG_CLASS_NAME(Sha256Hasher)::DigestBytes digest;
+        EXPECT_FALSE(treeHashFile<DFG_CLASS_NAME(Sha256Hasher)>("testfiles", digest));
+    }
+
+    // Tree hash doesn't depend on thread count, but depends on leaf size and content.
+    {
+        const auto digest1 = treeHash<DFG_CLASS_NAME(Sha256Hasher)>(bytes.data(), bytes.size(), 1000, 1);
+        EXPECT_EQ(digest1, (treeHash<DFG_CLASS_NAME(Sha256Hasher)>(bytes.data(), bytes.size(), 1000, 4)));
+        EXPECT_EQ(digest1, (treeHash<DFG_CLASS_NAME(Sha256Hasher)>(bytes.data(), bytes.size(), 1000)));
+        EXPECT_NE(digest1, (treeHash<DFG_CLASS_NAME(Sha256Hasher)>(bytes.data(), bytes.size(), 1001)));
+        EXPECT_NE(digest1, (treeHash<DFG_CLASS_NAME(Sha256Hasher)>(bytes.data(), bytes.size() - 1, 1000)));
+
+        DFG_CLASS_NAME(Sha256Hasher)::DigestBytes fileDigest;
+        EXPECT_TRUE(treeHashFile<DFG_CLASS_NAME(Sha256Hasher)>(szPath, fileDigest, 1000));
+        EXPECT_EQ(digest1, fileDigest);
+
+        DFG_CLASS_NAME(Xxh64Hasher)::DigestBytes xxDigest;
+        EXPECT_TRUE(treeHashFile<DFG_CLASS_NAME(Xxh64Hasher)>(szPath, xxDigest));
+        EXPECT_EQ((treeHash<DFG_CLASS_NAME(Xxh64Hasher)>(bytes.data(), bytes.size())), xxDigest);
+
+        // Incremental tree hash with pieces that don't align with leaves.
+        DFG_CLASS_NAME(TreeHasher)<DFG_CLASS_NAME(Sha256Hasher)> treeHasher(1000);
+        for (size_t i = 0; i < bytes.size(); i += 777)
+            treeHasher.process(bytes.data() + i, Min(size_t(777), bytes.size() - i));
+        EXPECT_EQ(digest1, treeHasher.digestBytes());
+        DFG_CLASS_NAME(TreeHasher)<DFG_CLASS_NAME(Sha256Hasher)> treeHasherEmpty;
+        EXPECT_EQ((treeHash<DFG_CLASS_NAME(Sha256Hasher)>("", 0)), treeHasherEmpty.digestBytes());
+    }
+
+    // Empty file
+    {
+        const char szEmptyPath[] = "testfiles/generated/hashTestEmpty.txt";
+        {
+            DFG_MODULE_NS(io)::DFG_CLASS_NAME(OfStream) ostrm(szEmptyPath);
+        }
+        DFG_CLASS_NAME(Sha256Hasher) hasher;
+        EXPECT_TRUE(hashFile(szEmptyPath, hasher));
+        EXPECT_EQ(sha256Str("", 0), hasher.toStr());
+        DFG_CLASS_NAME(Sha256Hasher)::DigestBytes digest;
+        EXPECT_TRUE(treeHashFile<DFG_CLASS_NAME(Sha256Hasher)>(szEmptyPath, digest));
+        EXPECT_EQ((treeHash<DFG_CLASS_NAME(Sha256Hasher)>("", 0)), digest);
+    }
+}
@@ -1147,6 +1147,244 @@ TEST(dfgNumeric, accumulate)
     EXPECT_EQ(accD, accumulateTyped<double>(vecF));
 }
 
+TEST(dfgNumeric, simdKernels)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(numeric);
+
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    // Odd size so that all tail handling gets exercised.
+    const size_t nSize = 10007;
+    std::vector<double> vecD(nSize);
+    std::generate(vecD.begin(), vecD.end(), [&]() { return DFG_MODULE_NS(rand)::rand(randEng, -1000.0, 1000.0); });
+    const std::vector<float> vecF(vecD.begin(), vecD.end());
+    std::vector<int32> vecI(nSize);
+    std::generate(vecI.begin(), vecI.end(), [&]() { return DFG_MODULE_NS(rand)::rand(randEng, int32_min, int32_max); });
+
+    long double refSumD = 0;
+    long double refSumF = 0;
+    int64 refSumI = 0;
+    for (size_t i = 0; i < nSize; ++i)
+    {
+        refSumD += vecD[i];
+        refSumF += vecF[i];
+        refSumI += vecI[i];
+    }
+
+    const auto detectedLevel = detectSimdLevel();
+    for (int nLevel = SimdLevelScalar; nLevel <= detectedLevel; ++nLevel)
+    {
+        setSimdLevelLimit(static_cast<SimdLevel>(nLevel));
+        EXPECT_EQ(nLevel, simdLevel());
+
+        // Sums
+        for (const auto method : { SummationMethodMultiAccumulator, SummationMethodKahan, SummationMethodPairwise })
+        {
+            EXPECT_NEAR(static_cast<double>(refSumD), sumSimd(vecD, method), 1e-8);
+            EXPECT_NEAR(static_cast<double>(refSumF), sumSimd(vecF, method), (method == SummationMethodMultiAccumulator) ? 1 : 0.1);
+            EXPECT_EQ(0, sumSimd(vecD.data(), 0, method));
+            EXPECT_EQ(vecD[0], sumSimd(vecD.data(), 1, method));
+        }
+        EXPECT_EQ(refSumI, sumSimd(vecI));
+        EXPECT_EQ(0, sumSimd(vecI.data(), 0));
+
+        // Kahan accuracy: 1 + n * 1e-16 where each small item is lost in naive summation.
+        {
+            std::vector<double> vals(4096, 1e-16);
+            vals[0] = 1;
+            EXPECT_EQ(1.0 + 4095 * 1e-16, sumSimd(vals, SummationMethodKahan));
+        }
+
+        // Summary statistics
+        {
+            const auto statsD = summaryStatistics(vecD);
+            EXPECT_EQ(nSize, statsD.count);
+            EXPECT_EQ(*std::min_element(vecD.begin(), vecD.end()), statsD.minValue);
+            EXPECT_EQ(*std::max_element(vecD.begin(), vecD.end()), statsD.maxValue);
+            EXPECT_NEAR(static_cast<double>(refSumD), statsD.sum, 1e-8);
+            long double refSumSq = 0;
+            for (const auto val : vecD)
+                refSumSq += static_cast<long double>(val) * val;
+            EXPECT_NEAR(1, statsD.sumOfSquares / static_cast<double>(refSumSq), 1e-14);
+
+            const auto statsF = summaryStatistics(vecF);
+            EXPECT_EQ(*std::min_element(vecF.begin(), vecF.end()), statsF.minValue);
+            EXPECT_EQ(*std::max_element(vecF.begin(), vecF.end()), statsF.maxValue);
+            EXPECT_NEAR(static_cast<double>(refSumF), statsF.sum, 1e-8);
+
+            const auto statsEmpty = summaryStatistics(vecD.data(), 0);
+            EXPECT_EQ(0, statsEmpty.count);
+            EXPECT_TRUE(DFG_MODULE_NS(math)::isNan(statsEmpty.minValue));
+            EXPECT_TRUE(DFG_MODULE_NS(math)::isNan(statsEmpty.mean()));
+
+            const double arr[] = { 1, 2, 3, 4, 5 };
+            const auto stats5 = summaryStatistics(arr);
+            EXPECT_EQ(3, stats5.mean());
+            EXPECT_EQ(2, stats5.variance());
+        }
+
+        // minMax
+        for (size_t n = 1; n < 20; ++n)
+        {
+            const auto minMaxD = minMaxSimd(vecD.data(), n);
+            EXPECT_EQ(*std::min_element(vecD.begin(), vecD.begin() + n), minMaxD.first);
+            EXPECT_EQ(*std::max_element(vecD.begin(), vecD.begin() + n), minMaxD.second);
+            const auto minMaxF = minMaxSimd(vecF.data(), n);
+            EXPECT_EQ(*std::min_element(vecF.begin(), vecF.begin() + n), minMaxF.first);
+            EXPECT_EQ(*std::max_element(vecF.begin(), vecF.begin() + n), minMaxF.second);
+        }
+
+        // NaN propagates to min and max regardless of its position and SIMD level.
+        for (size_t n = 1; n < 20; ++n)
+        {
+            for (size_t iNan = 0; iNan < n; ++iNan)
+            {
+                std::vector<double> d(vecD.begin(), vecD.begin() + n);
+                std::vector<float> f(vecF.begin(), vecF.begin() + n);
+                d[iNan] = std::numeric_limits<double>::quiet_NaN();
+                f[iNan] = std::numeric_limits<float>::quiet_NaN();
+                const auto minMaxD = minMaxSimd(d.data(), n);
+                const auto minMaxF = minMaxSimd(f.data(), n);
+                const auto statsD = summaryStatistics(d);
+                const auto statsF = summaryStatistics(f);
+                ASSERT_TRUE(DFG_MODULE_NS(math)::isNan(minMaxD.first) && DFG_MODULE_NS(math)::isNan(minMaxD.second));
+                ASSERT_TRUE(DFG_MODULE_NS(math)::isNan(minMaxF.first) && DFG_MODULE_NS(math)::isNan(minMaxF.second));
+                ASSERT_TRUE(DFG_MODULE_NS(math)::isNan(statsD.minValue) && DFG_MODULE_NS(math)::isNan(statsD.maxValue));
+                ASSERT_TRUE(DFG_MODULE_NS(math)::isNan(statsF.minValue) && DFG_MODULE_NS(math)::isNan(statsF.maxValue));
+            }
+        }
+
+        // Element-wise operations must be identical to plain loop.
+        {
+            auto d = vecD;
+            auto f = vecF;
+            auto iv = vecI;
+            addSimd(d.data(), d.size(), 1.25);
+            multiplySimd(f.data(), f.size(), 3.5f);
+            subtractSimd(iv.data(), iv.size(), 12345);
+            for (size_t i = 0; i < nSize; ++i)
+            {
+                ASSERT_EQ(vecD[i] + 1.25, d[i]);
+                ASSERT_EQ(vecF[i] * 3.5f, f[i]);
+                ASSERT_EQ(static_cast<int32>(static_cast<int64>(vecI[i]) - 12345), iv[i]) << " i = " << i;
+            }
+            divideSimd(d.data(), d.size(), 7.0);
+            affineTransformSimd(f.data(), f.size(), 2.0f, 0.25f, -1.0f);
+            for (size_t i = 0; i < nSize; ++i)
+            {
+                ASSERT_EQ((vecD[i] + 1.25) / 7.0, d[i]);
+                ASSERT_EQ(-1.0f + (vecF[i] * 3.5f - 2.0f) * 0.25f, f[i]);
+            }
+        }
+
+        // forEach-functions and rescale use SIMD kernels for double/float arrays, verify that they're consistent with plain loop.
+        {
+            auto d = vecD;
+            forEachAdd(d, 3);
+            forEachMultiply(d, 2.0);
+            forEachSubtract(d, 1.5);
+            forEachDivide(d, 3);
+            rescale(d, -1.0, 1.0);
+            auto expected = vecD;
+            for (auto& val : expected)
+                val = ((val + 3) * 2.0 - 1.5) / 3;
+            const auto minMax = std::minmax_element(expected.begin(), expected.end());
+            const double oldMin = *minMax.first;
+            const double scale = 2.0 / (*minMax.second - oldMin);
+            for (size_t i = 0; i < nSize; ++i)
+                ASSERT_EQ(-1.0 + (expected[i] - oldMin) * scale, d[i]);
+        }
+    }
+    setSimdLevelLimit(SimdLevelAvx2);
+    EXPECT_EQ(detectedLevel, simdLevel());
+}
+
+TEST(dfgNumeric, parallelAlgorithms)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(numeric);
+
+    auto randEng = DFG_MODULE_NS(rand)::createDefaultRandEngineUnseeded();
+    // Size is large enough for multiple selection rounds.
+    const size_t nSize = 600011;
+    std::vector<double> vecD(nSize);
+    std::generate(vecD.begin(), vecD.end(), [&]() { return DFG_MODULE_NS(rand)::rand(randEng, -1000.0, 1000.0); });
+    // Integer valued doubles for testing handling of duplicates in selection.
+    std::vector<double> vecDup(nSize);
+    std::generate(vecDup.begin(), vecDup.end(), [&]() { return static_cast<double>(DFG_MODULE_NS(rand)::rand(randEng, 0, 100)); });
+    std::vector<int32> vecI(nSize);
+    std::generate(vecI.begin(), vecI.end(), [&]() { return DFG_MODULE_NS(rand)::rand(randEng, -1000, 1000); });
+
+    // accumulate and average: exact for integers, reproducible regardless of thread count for floating points.
+    {
+        EXPECT_EQ(accumulate(vecI, int64(5)), accumulateParallel(vecI, int64(5)));
+        const auto sum1 = accumulateParallel(vecD, 0.0, 1);
+        EXPECT_EQ(sum1, accumulateParallel(vecD, 0.0, 2));
+        EXPECT_EQ(sum1, accumulateParallel(vecD, 0.0, 7));
+        EXPECT_NEAR(accumulate(vecD, 0.0), sum1, 1e-6);
+        EXPECT_EQ(sum1 / nSize, averageParallel(vecD, 3));
+        EXPECT_TRUE(DFG_MODULE_NS(math)::isNan(averageParallel(std::vector<double>())));
+        EXPECT_EQ(0, accumulateParallel(std::vector<int>(), 0));
+    }
+
+    // summaryStatistics
+    {
+        const auto stats = summaryStatisticsParallel(vecD, 4);
+        EXPECT_EQ(nSize, stats.count);
+        EXPECT_EQ(*std::min_element(vecD.begin(), vecD.end()), stats.minValue);
+        EXPECT_EQ(*std::max_element(vecD.begin(), vecD.end()), stats.maxValue);
+        EXPECT_EQ(stats.sum, summaryStatisticsParallel(vecD, 1).sum);
+        EXPECT_NEAR(accumulate(vecD, 0.0), stats.sum, 1e-6);
+
+        // NaN in the last chunk propagates through chunk merging.
+        auto vecNan = vecD;
+        vecNan.back() = std::numeric_limits<double>::quiet_NaN();
+        const auto statsNan = summaryStatisticsParallel(vecNan, 4);
+        EXPECT_TRUE(DFG_MODULE_NS(math)::isNan(statsNan.minValue));
+        EXPECT_TRUE(DFG_MODULE_NS(math)::isNan(statsNan.maxValue));
+    }
+
+    // transform and rescale
+    {
+        std::vector<double> dest(nSize);
+        transform1Parallel(vecD, dest.data(), [](const double d) { return 2 * d; }, 3);
+        EXPECT_TRUE(std::equal(vecD.begin(), vecD.end(), dest.begin(), [](const double a, const double b) { return 2 * a == b; }));
+        auto expected = vecD;
+        rescale(expected, -1.0, 2.0);
+        auto rescaled = vecD;
+        rescaleParallel(rescaled, -1.0, 2.0, 4);
+        EXPECT_EQ(expected, rescaled);
+        std::vector<double> constVals(100000, 3.0);
+        rescaleParallel(constVals, 5.0, 6.0);
+        EXPECT_EQ(std::vector<double>(100000, 5.0), constVals);
+    }
+
+    // Selection: median and percentile
+    {
+        for (const auto* pVec : { &vecD, &vecDup })
+        {
+            const auto& vec = *pVec;
+            EXPECT_EQ(median(vec), medianParallel(vec, 4));
+            const std::vector<double> vecEven(vec.begin(), vec.end() - 1);
+            EXPECT_EQ(median(vecEven), medianParallel(vecEven, 3));
+            auto sorted = vec;
+            std::sort(sorted.begin(), sorted.end());
+            for (const double percentile : { 0.0, 0.1, 25.0, 50.0, 99.9, 100.0 })
+                EXPECT_EQ(percentileInSorted_enclosingElem(sorted, percentile), percentileParallel_enclosingElem(vec, percentile, 2));
+            EXPECT_EQ(sorted[12345], nthSmallestParallel(vec, 12345));
+        }
+        EXPECT_TRUE(DFG_MODULE_NS(math)::isNan(medianParallel(std::vector<double>())));
+        // Even size with medians on both sides of a value boundary: lower median must come from the items below the pivot.
+        std::vector<double> twoVals(400000);
+        for (size_t i = 0; i < twoVals.size(); ++i)
+            twoVals[i] = (i % 2 == 0) ? 1.0 + static_cast<double>(i % 7) / 100 : 2.0;
+        EXPECT_EQ(median(twoVals), medianParallel(twoVals, 4));
+        const std::vector<double> small = { 3, 1, 2 };
+        EXPECT_EQ(2, medianParallel(small));
+        EXPECT_EQ(3, percentileParallel_enclosingElem(small, 90));
+    }
+}
+
 TEST(dfgNumeric, rescale)
 {
     using namespace DFG_ROOT_NS;
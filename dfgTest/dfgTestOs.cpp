@@ -289,6 +289,55 @@ TEST(dfgOs, OutputFile_completeOrNone)
         EXPECT_TRUE(isPathFileAvailable(szFilePath, FileModeExists));
         EXPECT_EQ(0, fileSize(szFilePath));
     }
+
+    // Test externally written intermediate file and that discarding doesn't modify destination.
+    {
+        const char szFilePath[] = "testfiles/generated/OutputFileTest_6.txt";
+        OfStream::dumpBytesToFile_overwriting(szFilePath, "a", 1);
+        {
+            OutputFile_completeOrNone<> outputFile(szFilePath);
+            const auto sIntermediatePath = outputFile.intermediateFilePathForExternalWrite();
+            ASSERT_FALSE(sIntermediatePath.empty());
+            OfStream::dumpBytesToFile_overwriting(sIntermediatePath, "abc", 3);
+            outputFile.discardIntermediate();
+            EXPECT_FALSE(isPathFileAvailable(sIntermediatePath, FileModeExists));
+            EXPECT_TRUE(outputFile.isIntermediateDiscarded());
+            EXPECT_FALSE(outputFile.isFinalDestinationWritten());
+        }
+        EXPECT_EQ("a", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szFilePath));
+        {
+            OutputFile_completeOrNone<> outputFile(szFilePath);
+            const auto sIntermediatePath = outputFile.intermediateFilePathForExternalWrite();
+            OfStream::dumpBytesToFile_overwriting(sIntermediatePath, "abc", 3);
+            EXPECT_EQ(1, fileSize(szFilePath));
+            EXPECT_EQ(0, outputFile.writeIntermediateToFinalLocation());
+            EXPECT_FALSE(isPathFileAvailable(sIntermediatePath, FileModeExists));
+            EXPECT_TRUE(outputFile.isFinalDestinationWritten());
+        }
+        EXPECT_EQ("abc", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szFilePath));
+    }
+
+    // Test that discarded memory intermediate doesn't modify destination and that requesting new intermediate after discard writes again.
+    {
+        const char szFilePath[] = "testfiles/generated/OutputFileTest_7.txt";
+        OfStream::dumpBytesToFile_overwriting(szFilePath, "a", 1);
+        {
+            OutputFile_completeOrNone<> outputFile(szFilePath);
+            outputFile.intermediateMemoryStream().write("abc", 3);
+            outputFile.discardIntermediate();
+            EXPECT_TRUE(outputFile.isIntermediateDiscarded());
+            EXPECT_FALSE(outputFile.isFinalDestinationWritten());
+        }
+        EXPECT_EQ("a", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szFilePath));
+        {
+            OutputFile_completeOrNone<> outputFile(szFilePath);
+            outputFile.intermediateMemoryStream().write("abc", 3);
+            outputFile.discardIntermediate();
+            outputFile.intermediateMemoryStream().write("de", 2);
+            EXPECT_FALSE(outputFile.isIntermediateDiscarded());
+        }
+        EXPECT_EQ("de", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szFilePath));
+    }
 }
 
 #ifdef _WIN32 // TODO: remove #ifdef once available on other platforms
@@ -1,8 +1,11 @@
 #include <stdafx.h>
 #include <dfg/rand.hpp>
+#include <dfg/rand/bulkRand.hpp>
 #include <dfg/func.hpp>
 #include <ctime>
 #include <unordered_set>
+#include <algorithm>
+#include <vector>
 
 TEST(dfgRand, dfgRand)
 {
@@ -95,3 +98,125 @@ TEST(dfgRand, simpleRand)
         vals.insert(DFG_MODULE_NS(rand)::rand(randEng));
     EXPECT_EQ(vals.size(), nCount);
 }
+
+TEST(dfgRand, PhiloxEngine)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(rand);
+
+    // Known answer tests from Random123 (kat_vectors, philox4x32_10)
+    {
+        uint32 ctr[4] = { 0, 0, 0, 0 };
+        uint32 key[2] = { 0, 0 };
+        DFG_CLASS_NAME(PhiloxEngine)::philox4x32_10(ctr, key);
+        EXPECT_EQ(0x6627e8d5u, ctr[0]);
+        EXPECT_EQ(0xe169c58du, ctr[1]);
+        EXPECT_EQ(0xbc57ac4cu, ctr[2]);
+        EXPECT_EQ(0x9b00dbd8u, ctr[3]);
+    }
+    {
+        uint32 ctr[4] = { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u };
+        uint32 key[2] = { 0xa4093822u, 0x299f31d0u };
+        DFG_CLASS_NAME(PhiloxEngine)::philox4x32_10(ctr, key);
+        EXPECT_EQ(0xd16cfe09u, ctr[0]);
+        EXPECT_EQ(0x94fdccebu, ctr[1]);
+        EXPECT_EQ(0x5001e420u, ctr[2]);
+        EXPECT_EQ(0x24126ea1u, ctr[3]);
+    }
+
+    // generate(), operator() and seek() give consistent streams.
+    DFG_CLASS_NAME(PhiloxEngine) eng(123, 4);
+    std::vector<uint64> vals(101);
+    for (auto& v : vals)
+        v = eng();
+    EXPECT_EQ(101u, eng.position());
+    for (size_t nBegin = 0; nBegin < 4; ++nBegin)
+    {
+        DFG_CLASS_NAME(PhiloxEngine) eng2(123, 4);
+        eng2.seek(nBegin);
+        std::vector<uint64> vals2(vals.size() - nBegin);
+        eng2.generate(vals2.data(), vals2.size());
+        EXPECT_TRUE(std::equal(vals2.begin(), vals2.end(), vals.begin() + nBegin));
+        EXPECT_EQ(vals.size(), eng2.position());
+    }
+    // Different streams and seeds differ.
+    EXPECT_NE(vals[0], DFG_CLASS_NAME(PhiloxEngine)(123, 5)());
+    EXPECT_NE(vals[0], DFG_CLASS_NAME(PhiloxEngine)(124, 4)());
+
+    // Works with std distributions.
+    std::uniform_int_distribution<int> distr(1, 6);
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto n = distr(eng);
+        EXPECT_TRUE(n >= 1 && n <= 6);
+    }
+}
+
+TEST(dfgRand, fillUniform)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(rand);
+
+    const size_t nCount = 200003;
+
+    // Doubles
+    {
+        std::vector<double> vals(nCount);
+        DFG_CLASS_NAME(PhiloxEngine) eng(1);
+        fillUniform(eng, vals.data(), vals.size(), -2.0, 3.0);
+        const auto minMax = std::minmax_element(vals.begin(), vals.end());
+        EXPECT_LE(-2.0, *minMax.first);
+        EXPECT_GT(3.0, *minMax.second);
+        EXPECT_GT(-1.99, *minMax.first);
+        EXPECT_LT(2.99, *minMax.second);
+        double sum = 0;
+        for (const auto v : vals)
+            sum += v;
+        EXPECT_NEAR(0.5, sum / nCount, 0.02);
+    }
+
+    // Integers including full and single value ranges.
+    {
+        std::vector<int> vals(nCount);
+        DFG_CLASS_NAME(PhiloxEngine) eng(2);
+        fillUniform(eng, vals.data(), vals.size(), -3, 3);
+        std::vector<size_t> counts(7, 0);
+        for (const auto v : vals)
+        {
+            ASSERT_TRUE(v >= -3 && v <= 3);
+            ++counts[static_cast<size_t>(v + 3)];
+        }
+        for (const auto n : counts)
+            EXPECT_NEAR(nCount / 7.0, static_cast<double>(n), nCount / 7.0 * 0.05);
+
+        fillUniform(eng, vals.data(), vals.size(), 5, 5);
+        EXPECT_EQ(nCount, static_cast<size_t>(std::count(vals.begin(), vals.end(), 5)));
+
+        std::vector<int64> vals64(1000);
+        fillUniform(eng, vals64.data(), vals64.size(), int64_min, int64_max);
+        EXPECT_TRUE(std::any_of(vals64.begin(), vals64.end(), [](const int64 v) { return v < 0; }));
+        EXPECT_TRUE(std::any_of(vals64.begin(), vals64.end(), [](const int64 v) { return v > 0; }));
+
+        std::vector<uint8> vals8(1000);
+        fillUniform(eng, vals8.data(), vals8.size(), uint8(250), uint8(255));
+        EXPECT_TRUE(std::all_of(vals8.begin(), vals8.end(), [](const uint8 v) { return v >= 250; }));
+    }
+
+    // Parallel: result doesn't depend on thread count.
+    {
+        std::vector<double> vals1(nCount), vals4(nCount), valsDefault(nCount);
+        fillUniformParallel(vals1.data(), nCount, 0.0, 1.0, 55, 1, 1);
+        fillUniformParallel(vals4.data(), nCount, 0.0, 1.0, 55, 1, 4);
+        fillUniformParallel(valsDefault.data(), nCount, 0.0, 1.0, 55, 1);
+        EXPECT_EQ(vals1, vals4);
+        EXPECT_EQ(vals1, valsDefault);
+        std::vector<double> valsOtherStream(nCount);
+        fillUniformParallel(valsOtherStream.data(), nCount, 0.0, 1.0, 55, 2);
+        EXPECT_NE(vals1, valsOtherStream);
+
+        std::vector<int> ints1(nCount), ints3(nCount);
+        fillUniformParallel(ints1.data(), nCount, 0, 9, 7, 0, 1);
+        fillUniformParallel(ints3.data(), nCount, 0, 9, 7, 0, 3);
+        EXPECT_EQ(ints1, ints3);
+    }
+}
@@ -0,0 +1,181 @@
+#include <stdafx.h>
+#include <dfg/threadAll.hpp>
+#include <dfg/numeric/parallel.hpp>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+    #include <pthread.h>
+#endif
+
+TEST(dfgThread, ThreadPool)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(thread);
+
+    ThreadPool pool(3, "dfgTestPool");
+    EXPECT_EQ(3, pool.threadCount());
+    EXPECT_FALSE(pool.isWorkerThread());
+
+    // Plain tasks through TaskGroup
+    {
+        std::atomic<int> nSum(0);
+        TaskGroup group(pool);
+        for (int i = 1; i <= 1000; ++i)
+            group.run([&, i]() { nSum += i; });
+        group.wait();
+        EXPECT_EQ(500500, nSum.load());
+    }
+
+    // Nested groups don't deadlock even when there are more nested waits than workers.
+    {
+        std::atomic<int> nCount(0);
+        TaskGroup outer(pool);
+        for (int i = 0; i < 20; ++i)
+        {
+            outer.run([&]()
+            {
+                TaskGroup inner(pool);
+                for (int j = 0; j < 50; ++j)
+                    inner.run([&]() { ++nCount; });
+                inner.wait();
+            });
+        }
+        outer.wait();
+        EXPECT_EQ(1000, nCount.load());
+    }
+
+    // Exception propagation
+    {
+        TaskGroup group(pool);
+        group.run([]() { throw std::runtime_error("test"); });
+        EXPECT_THROW(group.wait(), std::runtime_error);
+        EXPECT_TRUE(group.isCancelled());
+        EXPECT_NO_THROW(group.wait()); // Exception is rethrown only once.
+    }
+
+    // Cancellation: tasks that haven't started are skipped.
+    {
+        CancellationToken token;
+        std::atomic<int> nRunCount(0);
+        TaskGroup group(pool, token);
+        token.cancel();
+        for (int i = 0; i < 100; ++i)
+            group.run([&]() { ++nRunCount; });
+        group.wait();
+        EXPECT_EQ(0, nRunCount.load());
+    }
+
+#if defined(__linux__)
+    // Thread naming
+    {
+        // Using plain submit() and future since TaskGroup::wait() may run the task in the calling thread.
+        std::promise<std::string> namePromise;
+        auto nameFuture = namePromise.get_future();
+        pool.submit([&]()
+        {
+            char szName[16] = "";
+            pthread_getname_np(pthread_self(), szName, sizeof(szName));
+            namePromise.set_value(szName);
+        });
+        EXPECT_EQ(0, nameFuture.get().find("dfgTestPool"));
+    }
+#endif
+}
+
+TEST(dfgThread, parallelFor)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(thread);
+
+    ThreadPool pool(4);
+    const size_t nSize = 100003;
+
+    // Every index gets visited exactly once and ranges respect grain size.
+    const size_t grainSizes[] = { 0, 1, 7, 1000, nSize, 2 * nSize };
+    for (const auto nGrainSize : grainSizes)
+    {
+        std::vector<int> visitCounts(nSize, 0);
+        std::atomic<bool> bGrainSizeExceeded(false);
+        parallelFor(pool, 0, nSize, nGrainSize, [&](const size_t i0, const size_t i1)
+        {
+            if (nGrainSize != 0 && i1 - i0 > nGrainSize)
+                bGrainSizeExceeded = true;
+            for (size_t i = i0; i < i1; ++i)
+                ++visitCounts[i];
+        });
+        EXPECT_FALSE(bGrainSizeExceeded.load());
+        EXPECT_EQ(nSize, static_cast<size_t>(std::count(visitCounts.begin(), visitCounts.end(), 1)));
+    }
+
+    // Empty range
+    parallelFor(pool, 5, 5, 1, [](const size_t, const size_t) { ADD_FAILURE(); });
+
+    // Cancellation before the call: nothing is processed.
+    {
+        CancellationToken token;
+        token.cancel();
+        std::atomic<size_t> nProcessed(0);
+        parallelFor(pool, 0, nSize, 10, [&](const size_t i0, const size_t i1) { nProcessed += i1 - i0; }, token);
+        EXPECT_EQ(0u, nProcessed.load());
+    }
+
+    // Cancellation from within: the first range to run cancels. After that each thread (workers and the calling thread) can start
+    // at most the one range whose cancellation check it had already passed.
+    {
+        CancellationToken token;
+        std::atomic<bool> bFirst(true);
+        std::atomic<size_t> nRangeCount(0);
+        parallelFor(pool, 0, nSize, 10, [&](const size_t, const size_t)
+        {
+            ++nRangeCount;
+            if (bFirst.exchange(false))
+                token.cancel();
+        }, token);
+        EXPECT_TRUE(token.isCancelled());
+        EXPECT_LE(nRangeCount.load(), pool.threadCount() + 1);
+    }
+
+    // Exception
+    EXPECT_THROW(parallelFor(pool, 0, nSize, 100, [](const size_t i0, const size_t i1) { if (i0 <= 5000 && 5000 < i1) throw std::runtime_error("test"); }), std::runtime_error);
+}
+
+TEST(dfgThread, parallelReduce)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(thread);
+
+    std::vector<double> vals(200000);
+    for (size_t i = 0; i < vals.size(); ++i)
+        vals[i] = 1.0 / (1 + static_cast<double>(i));
+
+    const auto sumRange = [&](const size_t i0, const size_t i1) { return std::accumulate(vals.begin() + i0, vals.begin() + i1, 0.0); };
+    const auto plus = [](const double a, const double b) { return a + b; };
+
+    // Result doesn't depend on thread count for fixed grain size.
+    ThreadPool pool1(1);
+    ThreadPool pool4(4);
+    const auto sum1 = parallelReduce(pool1, 0, vals.size(), 1000, 0.0, sumRange, plus);
+    const auto sum4 = parallelReduce(pool4, 0, vals.size(), 1000, 0.0, sumRange, plus);
+    EXPECT_EQ(sum1, sum4);
+    EXPECT_NEAR(std::accumulate(vals.begin(), vals.end(), 0.0), sum4, 1e-10);
+
+    EXPECT_EQ(-1.0, parallelReduce(pool4, 10, 10, 0, -1.0, sumRange, plus));
+
+    // Non-commutative combine: order must be preserved.
+    const auto concatenated = parallelReduce(pool4, 0, 26, 3, std::string(), [](const size_t i0, const size_t i1)
+    {
+        std::string s;
+        for (size_t i = i0; i < i1; ++i)
+            s.push_back(static_cast<char>('a' + i));
+        return s;
+    }, [](const std::string& a, const std::string& b) { return a + b; });
+    EXPECT_EQ("abcdefghijklmnopqrstuvwxyz", concatenated);
+
+    // Default pool is used by numeric parallel algorithms when thread count is not given.
+    EXPECT_LE(1u, defaultThreadPool().threadCount());
+    EXPECT_EQ(DFG_MODULE_NS(numeric)::accumulateParallel(vals, 0.0, 1), DFG_MODULE_NS(numeric)::accumulateParallel(vals, 0.0));
+}
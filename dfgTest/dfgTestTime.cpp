@@ -1,6 +1,10 @@
 #include <stdafx.h>
 #include <dfg/time.hpp>
 #include <dfg/time/DateTime.hpp>
+#include <dfg/time/profiling.hpp>
+#include <dfg/time/timestampFormat.hpp>
+#include <dfg/cont/tableCsv.hpp>
+#include <thread>
 #include <ctime>
 
 #if DFG_LANGFEAT_CHRONO_11
@@ -74,3 +78,330 @@ TEST(dfgTime, DataTime_systemTime_local)
 #endif
 
 #endif // DFG_LANGFEAT_CHRONO_11
+
+#if DFG_BUILD_OPT_USE_PROFILING
+
+TEST(dfgTime, profiling)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(time);
+
+    auto& profiler = DFG_CLASS_NAME(Profiler)::instance();
+    profiler.clear();
+
+    // Disabled by default: nothing gets recorded.
+    EXPECT_FALSE(DFG_CLASS_NAME(Profiler)::isEnabled());
+    {
+        DFG_PROFILE_ZONE("disabledZone");
+        DFG_PROFILE_COUNTER("disabledCounter", 1);
+    }
+    EXPECT_TRUE(profiler.summary().empty());
+
+    DFG_CLASS_NAME(Profiler)::setEnabled(true);
+    const auto worker = [&](const int nId)
+    {
+        profiler.setCurrentThreadName("worker \"" + std::to_string(nId) + "\"");
+        for (int i = 0; i < 100; ++i)
+        {
+            DFG_PROFILE_ZONE("testZone");
+            DFG_PROFILE_COUNTER("testCounter", i);
+        }
+    };
+    std::thread t1(worker, 1);
+    std::thread t2(worker, 2);
+    t1.join();
+    t2.join();
+    {
+        DFG_PROFILE_ZONE("outerZone");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    const auto items = profiler.summary();
+    ASSERT_EQ(3u, items.size());
+    // Zones come first ordered by total time.
+    EXPECT_EQ("outerZone", items[0].m_sName);
+    EXPECT_EQ(ProfileEventTypeZone, items[0].m_type);
+    EXPECT_EQ(1u, items[0].m_nCount);
+    EXPECT_LE(2000000, items[0].m_nTotal);
+    EXPECT_EQ("testZone", items[1].m_sName);
+    EXPECT_EQ(200u, items[1].m_nCount);
+    EXPECT_EQ("testCounter", items[2].m_sName);
+    EXPECT_EQ(ProfileEventTypeCounter, items[2].m_type);
+    EXPECT_EQ(200u, items[2].m_nCount);
+    EXPECT_EQ(2 * 4950, items[2].m_nTotal);
+    EXPECT_EQ(0, items[2].m_nMin);
+    EXPECT_EQ(99, items[2].m_nMax);
+    EXPECT_EQ(0u, profiler.droppedEventCount());
+
+    const auto sJson = profiler.chromeTraceJson();
+    EXPECT_NE(std::string::npos, sJson.find("\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, sJson.find("\"name\":\"outerZone\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, sJson.find("\"name\":\"testCounter\",\"ph\":\"C\""));
+    EXPECT_NE(std::string::npos, sJson.find("worker \\\"1\\\"")); // Thread name gets escaped.
+
+    const auto sTable = profiler.summaryTable();
+    EXPECT_NE(std::string::npos, sTable.find("outerZone"));
+    EXPECT_NE(std::string::npos, sTable.find("testCounter"));
+
+    // Instrumented library code
+    profiler.clear();
+    EXPECT_TRUE(profiler.summary().empty());
+    EXPECT_EQ(std::string::npos, profiler.chromeTraceJson().find("worker")); // Buffers of ended threads are released on clear().
+    {
+        DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableCsv)<char, uint32> table;
+        const char szCsv[] = "a,b,c\n1,2,3\n4,5,6";
+        table.readFromMemory(szCsv, DFG_COUNTOF_SZ(szCsv));
+        std::ostringstream ostrm;
+        table.writeToStream(ostrm);
+    }
+    bool bReadZoneFound = false;
+    int64 nReadCellCount = -1;
+    int64 nWriteRowCount = -1;
+    for (const auto& item : profiler.summary())
+    {
+        if (item.m_sName == "TableCsv::read")
+            bReadZoneFound = true;
+        else if (item.m_sName == "TableCsv::read cells")
+            nReadCellCount = item.m_nTotal;
+        else if (item.m_sName == "TableCsv::writeToStream rows")
+            nWriteRowCount = item.m_nTotal;
+    }
+    EXPECT_TRUE(bReadZoneFound);
+    EXPECT_EQ(9, nReadCellCount);
+    EXPECT_EQ(3, nWriteRowCount);
+
+    DFG_CLASS_NAME(Profiler)::setEnabled(false);
+    profiler.clear();
+}
+
+#endif // DFG_BUILD_OPT_USE_PROFILING
+
+#if DFG_LANGFEAT_CHRONO_11
+
+TEST(dfgTime, TimestampFormat)
+{
+    using namespace DFG_ROOT_NS;
+    using namespace DFG_MODULE_NS(time);
+    typedef DFG_CLASS_NAME(TimestampFormat) FormatT;
+    typedef DFG_CLASS_NAME(TimestampFields) FieldsT;
+
+    // Epoch conversions
+    {
+        FieldsT fields;
+        EXPECT_EQ(0, fields.toEpoch(EpochUnitSecond));
+        fields.m_year = 2000; fields.m_month = 2; fields.m_day = 29; fields.m_hour = 12; fields.m_minute = 34; fields.m_second = 56; fields.m_nanosecond = 789000000;
+        EXPECT_EQ(951827696789, fields.toEpoch(EpochUnitMillisecond));
+        EXPECT_EQ(951827696789000000, fields.toEpoch(EpochUnitNanosecond));
+        EXPECT_EQ(951827696789 - 3600000, fields.toEpoch(EpochUnitMillisecond, DFG_CLASS_NAME(UtcOffsetInfo)(std::chrono::seconds(3600))));
+        const auto fields2 = FieldsT::fromEpoch(951827696789, EpochUnitMillisecond);
+        EXPECT_EQ(2000, fields2.m_year);
+        EXPECT_EQ(2, fields2.m_month);
+        EXPECT_EQ(29, fields2.m_day);
+        EXPECT_EQ(12, fields2.m_hour);
+        EXPECT_EQ(789000000, fields2.m_nanosecond);
+        // Dates before epoch
+        const auto fieldsNeg = FieldsT::fromEpoch(-1, EpochUnitMillisecond);
+        EXPECT_EQ(1969, fieldsNeg.m_year);
+        EXPECT_EQ(12, fieldsNeg.m_month);
+        EXPECT_EQ(31, fieldsNeg.m_day);
+        EXPECT_EQ(23, fieldsNeg.m_hour);
+        EXPECT_EQ(59, fieldsNeg.m_second);
+        EXPECT_EQ(999000000, fieldsNeg.m_nanosecond);
+        EXPECT_EQ(-1, fieldsNeg.toEpoch(EpochUnitMillisecond));
+        // Round trip over a range of days.
+        for (int64 nDay = -800000; nDay < 800000; nDay += 997)
+        {
+            const auto f = FieldsT::fromEpoch(nDay * 86400 + 3661, EpochUnitSecond);
+            ASSERT_TRUE(f.isValid());
+            ASSERT_EQ(nDay * 86400 + 3661, f.toEpoch(EpochUnitSecond));
+        }
+        // Times not representable as int64 nanoseconds
+        {
+            FieldsT f;
+            f.m_year = 2262; f.m_month = 4; f.m_day = 11; f.m_hour = 23; f.m_minute = 47; f.m_second = 16; f.m_nanosecond = 854775807;
+            int64 nEpoch = 0;
+            EXPECT_TRUE(f.toEpoch(EpochUnitNanosecond, nEpoch));
+            EXPECT_EQ(int64_max, nEpoch);
+            f.m_nanosecond = 854775808;
+            EXPECT_FALSE(f.toEpoch(EpochUnitNanosecond, nEpoch));
+            EXPECT_EQ(int64_max, nEpoch); // Not modified on failure
+            EXPECT_EQ(-1, f.toEpoch(EpochUnitNanosecond, DFG_CLASS_NAME(UtcOffsetInfo)(), -1));
+            EXPECT_TRUE(f.toEpoch(EpochUnitMicrosecond, nEpoch));
+            f.m_year = 1677; f.m_month = 9; f.m_day = 21; f.m_hour = 0; f.m_minute = 12; f.m_second = 42;
+            EXPECT_FALSE(f.toEpoch(EpochUnitNanosecond, nEpoch));
+            f.m_second = 44;
+            EXPECT_TRUE(f.toEpoch(EpochUnitNanosecond, nEpoch));
+            f.m_year = 9999;
+            EXPECT_FALSE(FormatT::iso8601().parseToEpoch("9999-01-01T00:00:00Z", nEpoch, EpochUnitNanosecond));
+            EXPECT_TRUE(FormatT::iso8601().parseToEpoch("9999-01-01T00:00:00Z", nEpoch, EpochUnitMicrosecond));
+        }
+    }
+
+    // Fixed width format
+    {
+        const FormatT format("yyyy-MM-dd hh:mm:ss.zzz");
+        EXPECT_TRUE(format.isValid());
+        EXPECT_EQ(23u, format.fixedWidth());
+        FieldsT fields;
+        EXPECT_TRUE(format.parse("2019-03-04 05:06:07.089", fields));
+        EXPECT_EQ(2019, fields.m_year);
+        EXPECT_EQ(3, fields.m_month);
+        EXPECT_EQ(4, fields.m_day);
+        EXPECT_EQ(5, fields.m_hour);
+        EXPECT_EQ(6, fields.m_minute);
+        EXPECT_EQ(7, fields.m_second);
+        EXPECT_EQ(89000000, fields.m_nanosecond);
+        EXPECT_FALSE(fields.m_utcOffset.isSet());
+        EXPECT_EQ("2019-03-04 05:06:07.089", format.format(fields));
+        EXPECT_FALSE(format.parse("2019-03-04 05:06:07.08", fields));   // Too short
+        EXPECT_FALSE(format.parse("2019-03-04T05:06:07.089", fields));  // Wrong separator
+        EXPECT_FALSE(format.parse("2019-03-04 05:06:0a.089", fields));  // Non-digit
+        EXPECT_FALSE(format.parse("2019-02-29 05:06:07.089", fields));  // Invalid date
+        EXPECT_FALSE(format.parse("2019-03-04 24:06:07.089", fields));  // Invalid hour
+        EXPECT_TRUE(format.parse("2020-02-29 23:59:59.999", fields));
+        int64 nEpoch = 0;
+        EXPECT_TRUE(format.parseToEpoch("1970-01-02 00:00:01.500", nEpoch));
+        EXPECT_EQ(86401500, nEpoch);
+        EXPECT_TRUE(format.parseToEpoch("1970-01-02 00:00:01.500", nEpoch, EpochUnitSecond));
+        EXPECT_EQ(86401, nEpoch);
+        EXPECT_EQ("1970-01-02 00:00:01.500", format.formatEpoch(86401500));
+        // Years that don't fit to 4 digits are not formatted.
+        fields.m_year = -1;
+        EXPECT_EQ("", format.format(fields));
+        fields.m_year = 10000;
+        EXPECT_EQ("", format.format(fields));
+        EXPECT_EQ("", FormatT::iso8601().format(fields));
+        char szBuffer[32] = "abc";
+        EXPECT_EQ(0u, format.format(fields, szBuffer, sizeof(szBuffer)));
+        EXPECT_STREQ("", szBuffer);
+    }
+
+    // Variable width fields, quoted literals and UTC offset
+    {
+        const FormatT format("d.M.yyyy 'klo' h:mm t");
+        EXPECT_TRUE(format.isValid());
+        EXPECT_EQ(0u, format.fixedWidth());
+        FieldsT fields;
+        EXPECT_TRUE(format.parse("4.3.2019 klo 5:06 +02:00", fields));
+        EXPECT_EQ(4, fields.m_day);
+        EXPECT_EQ(3, fields.m_month);
+        EXPECT_EQ(5, fields.m_hour);
+        EXPECT_EQ(7200, fields.m_utcOffset.offsetInSeconds());
+        EXPECT_EQ("4.3.2019 klo 5:06 +02:00", format.format(fields));
+        EXPECT_TRUE(format.parse("14.12.2019 klo 15:06 Z", fields));
+        EXPECT_EQ(14, fields.m_day);
+        EXPECT_EQ(0, fields.m_utcOffset.offsetInSeconds());
+        EXPECT_TRUE(fields.m_utcOffset.isSet());
+        EXPECT_TRUE(format.parse("14.12.2019 klo 15:06 -0130", fields));
+        EXPECT_EQ(-5400, fields.m_utcOffset.offsetInSeconds());
+        EXPECT_FALSE(format.parse("14.12.2019 klo 15:06", fields));
+        EXPECT_FALSE(format.parse("14.12.2019 klo 15:06 Z ", fields));
+
+        const FormatT formatQuote("hh''mm");
+        EXPECT_TRUE(formatQuote.parse("12'34", fields));
+        EXPECT_EQ(34, fields.m_minute);
+    }
+
+    // Invalid formats
+    EXPECT_FALSE(FormatT("yy-MM-dd").isValid());
+    EXPECT_FALSE(FormatT("yyyy-MMM-dd").isValid());
+    EXPECT_FALSE(FormatT("yyyy 'abc").isValid());
+    EXPECT_FALSE(FormatT("").isValid());
+    EXPECT_FALSE(FormatT("zzzzzzzzzz").isValid());
+
+    // ISO 8601
+    {
+        const auto iso = FormatT::iso8601();
+        const int64 nBase = 1552367106000; // 2019-03-12T05:05:06Z
+        int64 nEpoch = 0;
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T05:05:06Z", nEpoch));
+        EXPECT_EQ(nBase, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12 05:05:06", nEpoch));
+        EXPECT_EQ(nBase, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T07:05:06.25+02:00", nEpoch));
+        EXPECT_EQ(nBase + 250, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T05:05:06,123456789123Z", nEpoch, EpochUnitNanosecond));
+        EXPECT_EQ(nBase * 1000000 + 123456789, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T05:05", nEpoch));
+        EXPECT_EQ(nBase - 6000, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12", nEpoch));
+        EXPECT_EQ(1552348800000, nEpoch);
+        // Default offset is used only when string has no offset.
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T06:05:06", nEpoch, EpochUnitMillisecond, DFG_CLASS_NAME(UtcOffsetInfo)(std::chrono::seconds(3600))));
+        EXPECT_EQ(nBase, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T05:05:06Z", nEpoch, EpochUnitMillisecond, DFG_CLASS_NAME(UtcOffsetInfo)(std::chrono::seconds(3600))));
+        EXPECT_EQ(nBase, nEpoch);
+        EXPECT_FALSE(iso.parseToEpoch("2019-03-12T05", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("2019-03-12T05:05:06.", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("2019-3-12", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("2019-03-12T05:05:06+2", nEpoch));
+        // Fixed width shapes
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12T05:05:06.250Z", nEpoch));
+        EXPECT_EQ(nBase + 250, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12 05:05:06.250", nEpoch, EpochUnitMillisecond, DFG_CLASS_NAME(UtcOffsetInfo)(std::chrono::seconds(0))));
+        EXPECT_EQ(nBase + 250, nEpoch);
+        EXPECT_TRUE(iso.parseToEpoch("2019-03-12Z", nEpoch));
+        EXPECT_EQ(1552348800000, nEpoch);
+        EXPECT_FALSE(iso.parseToEpoch("2019-02-29T05:05:06Z", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("2019-03-12X05:05:06Z", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("2019-03-12T05:05:06ZZ", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("Z", nEpoch));
+        EXPECT_FALSE(iso.parseToEpoch("", nEpoch));
+        {
+            FieldsT fieldsZ;
+            EXPECT_TRUE(iso.parse("2019-03-12T05:05:06Z", fieldsZ));
+            EXPECT_TRUE(fieldsZ.m_utcOffset.isSet());
+            EXPECT_TRUE(iso.parse("2019-03-12T05:05:06", fieldsZ));
+            EXPECT_FALSE(fieldsZ.m_utcOffset.isSet());
+        }
+
+        EXPECT_EQ("2019-03-12T05:05:06Z", iso.formatEpoch(nBase, EpochUnitMillisecond, DFG_CLASS_NAME(UtcOffsetInfo)(std::chrono::seconds(0))));
+        EXPECT_EQ("2019-03-12T07:05:06.250+02:00", iso.formatEpoch(nBase + 250, EpochUnitMillisecond, DFG_CLASS_NAME(UtcOffsetInfo)(std::chrono::seconds(7200))));
+        EXPECT_EQ("2019-03-12T05:05:06.000001", iso.formatEpoch(nBase * 1000 + 1, EpochUnitMicrosecond));
+
+        // DateTime conversion
+        FieldsT fields;
+        EXPECT_TRUE(iso.parse("2019-03-12T07:05:06.25+02:00", fields));
+        const auto dt = fields.toDateTime();
+        EXPECT_EQ(2019, dt.year());
+        EXPECT_EQ(7, dt.hour());
+        EXPECT_EQ(250, dt.millisecond());
+        EXPECT_EQ(7200, dt.utcOffsetInfo().offsetInSeconds());
+        EXPECT_EQ(nBase + 250, FieldsT::fromDateTime(dt).toEpoch(EpochUnitMillisecond));
+    }
+
+    // Bulk
+    {
+        const FormatT format("yyyy-MM-dd hh:mm:ss");
+        const char* inputs[] = { "1970-01-01 00:00:10", "invalid", "1970-01-01 00:01:00" };
+        int64 outputs[3];
+        EXPECT_EQ(2u, format.parseToEpochBulk(std::begin(inputs), std::end(inputs), outputs, EpochUnitSecond, -1));
+        EXPECT_EQ(10, outputs[0]);
+        EXPECT_EQ(-1, outputs[1]);
+        EXPECT_EQ(60, outputs[2]);
+
+        DFG_MODULE_NS(cont)::DFG_CLASS_NAME(TableCsv)<char, uint32> table;
+        char szBuffer[64];
+        const uint32 nRowCount = 20000;
+        for (uint32 r = 0; r < nRowCount; ++r)
+        {
+            if (r % 1000 == 999)
+                continue; // Leaves missing cells.
+            format.format(FieldsT::fromEpoch(int64(r) * 60, EpochUnitSecond), szBuffer, sizeof(szBuffer));
+            table.setElement(r, 1, SzPtrUtf8(szBuffer));
+        }
+        table.setElement(5, 1, SzPtrUtf8("bad"));
+        const auto epochs = timestampColumnToEpoch(table, 1, format, EpochUnitSecond, -1, DFG_CLASS_NAME(UtcOffsetInfo)(), 0, 1000);
+        ASSERT_EQ(nRowCount - 1, epochs.size()); // Last row is missing
+        for (uint32 r = 0; r < epochs.size(); ++r)
+        {
+            if (r == 5 || r % 1000 == 999)
+                EXPECT_EQ(-1, epochs[r]);
+            else
+                EXPECT_EQ(int64(r) * 60, epochs[r]);
+        }
+        EXPECT_TRUE(timestampColumnToEpoch(table, 3, format).size() == nRowCount - 1);
+    }
+}
+
+#endif // DFG_LANGFEAT_CHRONO_11
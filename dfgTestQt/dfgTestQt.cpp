@@ -1,5 +1,7 @@
 //#include <stdafx.h>
 #include <dfg/qt/CsvItemModel.hpp>
+#include <dfg/qt/CsvTableViewSortFilterProxyModel.hpp>
+#include <dfg/qt/StringMatchDefinition.hpp>
 #include <dfg/io.hpp>
 #include <dfg/io/OmcByteStream.hpp>
 
@@ -109,6 +111,197 @@ TEST(dfgQt, CsvItemModel_readFormatUsageOnWrite)
 #undef DFG_TEMP_BOM
 }
 
+TEST(dfgQt, CsvItemModel_incrementalSave)
+{
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel) ModelT;
+    typedef DFG_MODULE_NS(io)::DFG_CLASS_NAME(OfStream) OfStream;
+    // Unmodified rows are copied as such in incremental save so unnecessary enclosing in "x" tells whether incremental save was used.
+    const std::string sContent = "a,b\n\"x\",1\n2,3\n";
+    const std::string sExpectedIncremental = "a,b\n\"x\",1\ny,3\n";
+    const std::string sBom = DFG_UTF_BOM_STR_UTF8;
+    const char szPath[] = "testfiles/generated/csvItemModelIncrementalSave.csv";
+
+    // File with BOM: default save options match the source.
+    {
+        OfStream::dumpBytesToFile_overwriting(szPath, (sBom + sContent).data(), sBom.size() + sContent.size());
+        ModelT model;
+        ASSERT_TRUE(model.openFile(szPath));
+        model.setDataNoUndo(1, 0, QString("y"));
+        EXPECT_TRUE(model.saveToFile(szPath, ModelT::SaveOptions(&model)));
+        EXPECT_EQ(sBom + sExpectedIncremental, DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szPath));
+        // Saving again after another edit uses the previously saved file as source.
+        model.setDataNoUndo(1, 1, QString("4"));
+        EXPECT_TRUE(model.saveToFile(szPath, ModelT::SaveOptions(&model)));
+        EXPECT_EQ(sBom + "a,b\n\"x\",1\ny,4\n", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szPath));
+    }
+
+    // File without BOM (unknown encoding, ASCII content): incremental save is used when saving without BOM.
+    {
+        OfStream::dumpBytesToFile_overwriting(szPath, sContent.data(), sContent.size());
+        ModelT model;
+        ASSERT_TRUE(model.openFile(szPath));
+        model.setDataNoUndo(1, 0, QString("y"));
+        auto saveOptions = ModelT::SaveOptions(&model);
+        saveOptions.bomWriting(false);
+        EXPECT_TRUE(model.saveToFile(szPath, saveOptions));
+        EXPECT_EQ(sExpectedIncremental, DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szPath));
+    }
+
+    // File without BOM saved with BOM: full save must be used since BOM gets added.
+    {
+        OfStream::dumpBytesToFile_overwriting(szPath, sContent.data(), sContent.size());
+        ModelT model;
+        ASSERT_TRUE(model.openFile(szPath));
+        model.setDataNoUndo(1, 0, QString("y"));
+        auto saveOptions = ModelT::SaveOptions(&model);
+        saveOptions.bomWriting(true);
+        EXPECT_TRUE(model.saveToFile(szPath, saveOptions));
+        EXPECT_EQ(sBom + "a,b\nx,1\ny,3\n", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szPath));
+    }
+
+    // Non-ASCII file without BOM is read as Latin-1 but saved as UTF-8: full save must be used to avoid mixing encodings.
+    {
+        const std::string sLatin1Content = "a,b\n\"\xE4\",1\n2,3\n";
+        OfStream::dumpBytesToFile_overwriting(szPath, sLatin1Content.data(), sLatin1Content.size());
+        ModelT model;
+        ASSERT_TRUE(model.openFile(szPath));
+        model.setDataNoUndo(1, 0, QString("y"));
+        auto saveOptions = ModelT::SaveOptions(&model);
+        saveOptions.bomWriting(false);
+        EXPECT_TRUE(model.saveToFile(szPath, saveOptions));
+        EXPECT_EQ("a,b\n\xC3\xA4,1\ny,3\n", DFG_MODULE_NS(io)::fileToByteContainer<std::string>(szPath));
+    }
+}
+
+TEST(dfgQt, StringMatchDefinition)
+{
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(StringMatchDefinition) MatchDef;
+    typedef DFG_ROOT_NS::DFG_CLASS_NAME(StringViewUtf8) SvU8;
+
+    // Case sensitive
+    {
+        const MatchDef def("aB", Qt::CaseSensitive, QRegExp::FixedString);
+        EXPECT_TRUE(def.isMatchWith(SvU8(SzPtrUtf8("xaBx"))));
+        EXPECT_FALSE(def.isMatchWith(SvU8(SzPtrUtf8("xabx"))));
+        EXPECT_FALSE(def.isMatchWith(SvU8(SzPtrUtf8("a"))));
+        EXPECT_FALSE(def.isMatchWith(SvU8()));
+    }
+
+    // Case insensitive with ASCII search string; both ASCII and non-ASCII input.
+    {
+        const MatchDef def("aB", Qt::CaseInsensitive, QRegExp::FixedString);
+        EXPECT_TRUE(def.isMatchWith(SvU8(SzPtrUtf8("xabx"))));
+        EXPECT_TRUE(def.isMatchWith(SvU8(SzPtrUtf8("XABX"))));
+        EXPECT_TRUE(def.isMatchWith(SvU8(SzPtrUtf8("\xc3\xa4" "Ab"))));
+        EXPECT_FALSE(def.isMatchWith(SvU8(SzPtrUtf8("a b"))));
+        EXPECT_FALSE(def.isMatchWith(SvU8(SzPtrUtf8("\xc3\xa4" "a"))));
+        EXPECT_TRUE(def.isMatchWith(QString("xABx")));
+    }
+
+    // Case insensitive with non-ASCII search string (a with diaeresis).
+    {
+        const MatchDef def(QString::fromUtf8("\xc3\x84" "b"), Qt::CaseInsensitive, QRegExp::FixedString);
+        EXPECT_TRUE(def.isMatchWith(SvU8(SzPtrUtf8("x\xc3\xa4" "Bx"))));
+        EXPECT_TRUE(def.isMatchWith(SvU8(SzPtrUtf8("\xc3\x84" "b"))));
+        EXPECT_FALSE(def.isMatchWith(SvU8(SzPtrUtf8("ab"))));
+    }
+
+    // Case insensitive wildcard without special characters behaves like substring match, with special characters like wildcard.
+    {
+        const MatchDef defPlain("aB", Qt::CaseInsensitive, QRegExp::Wildcard);
+        EXPECT_TRUE(defPlain.isMatchWith(SvU8(SzPtrUtf8("xABx"))));
+        const MatchDef defWildcard("a*B", Qt::CaseInsensitive, QRegExp::Wildcard);
+        EXPECT_TRUE(defWildcard.isMatchWith(SvU8(SzPtrUtf8("xA12bx"))));
+        EXPECT_FALSE(defWildcard.isMatchWith(SvU8(SzPtrUtf8("xb12ax"))));
+    }
+
+    // isKnownToMatchSubsetOf
+    {
+        const MatchDef defA("a", Qt::CaseInsensitive, QRegExp::FixedString);
+        const MatchDef defAb("Ab", Qt::CaseInsensitive, QRegExp::FixedString);
+        const MatchDef defAbSensitive("Ab", Qt::CaseSensitive, QRegExp::FixedString);
+        const MatchDef defWildcard("a*", Qt::CaseInsensitive, QRegExp::Wildcard);
+        EXPECT_TRUE(defAb.isKnownToMatchSubsetOf(defA));
+        EXPECT_FALSE(defA.isKnownToMatchSubsetOf(defAb));
+        EXPECT_FALSE(defAbSensitive.isKnownToMatchSubsetOf(defA)); // Different case sensitivity
+        EXPECT_FALSE(defAb.isKnownToMatchSubsetOf(defWildcard));
+        EXPECT_FALSE(defWildcard.isKnownToMatchSubsetOf(defA));
+    }
+}
+
+TEST(dfgQt, CsvTableViewSortFilterProxyModel)
+{
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvItemModel) ModelT;
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(CsvTableViewSortFilterProxyModel) ProxyT;
+    typedef DFG_MODULE_NS(qt)::DFG_CLASS_NAME(StringMatchDefinition) MatchDef;
+    typedef ProxyT::ColumnFilter ColumnFilter;
+
+    ModelT model;
+    ASSERT_TRUE(model.openString("Name,Value\n"
+                                 "abc,1\n"
+                                 "Abd,2\n"
+                                 "xyz,12\n"
+                                 "b,\n"
+                                 "aXc,21\n"));
+    ASSERT_EQ(5, model.getRowCount());
+
+    ProxyT proxy;
+    proxy.setSourceModel(&model);
+    EXPECT_EQ(5, proxy.rowCount());
+
+    const auto makeDef = [](const char* psz) { return MatchDef(psz, Qt::CaseInsensitive, QRegExp::FixedString); };
+
+    // Single column filter
+    proxy.setColumnFilter(makeDef("a"), 0);
+    EXPECT_EQ(3, proxy.rowCount());
+
+    // Refinement
+    proxy.setColumnFilter(makeDef("ab"), 0);
+    EXPECT_EQ(2, proxy.rowCount());
+    proxy.setColumnFilter(makeDef("abc"), 0);
+    EXPECT_EQ(1, proxy.rowCount());
+    EXPECT_EQ(QString("abc"), proxy.data(proxy.index(0, 0)).toString());
+
+    // Any column
+    proxy.setColumnFilter(makeDef("1"), -1);
+    EXPECT_EQ(3, proxy.rowCount());
+
+    // AND and OR combination
+    {
+        ProxyT::ColumnFilterContainer filters;
+        filters.push_back(ColumnFilter(makeDef("a"), 0));
+        filters.push_back(ColumnFilter(makeDef("2"), 1));
+        proxy.setColumnFilters(filters, ProxyT::FilterCombineModeAnd);
+        EXPECT_EQ(2, proxy.rowCount()); // Abd,2 and aXc,21
+        proxy.setColumnFilters(filters, ProxyT::FilterCombineModeOr);
+        EXPECT_EQ(4, proxy.rowCount()); // All but b
+    }
+
+    // Filters with empty match string are ignored.
+    proxy.setColumnFilter(makeDef(""), 0);
+    EXPECT_EQ(5, proxy.rowCount());
+
+    // Structural changes and edits while filter is active
+    proxy.setColumnFilter(makeDef("a"), 0);
+    EXPECT_EQ(3, proxy.rowCount());
+    EXPECT_TRUE(model.insertRows(0, 2));
+    EXPECT_EQ(3, proxy.rowCount());
+    model.setDataNoUndo(0, 0, QString("aaa"));
+    EXPECT_EQ(4, proxy.rowCount());
+    model.setDataNoUndo(1, 0, QString("A"));
+    EXPECT_EQ(5, proxy.rowCount());
+    model.setDataNoUndo(0, 0, QString("bbb"));
+    EXPECT_EQ(4, proxy.rowCount());
+    EXPECT_TRUE(model.removeRows(1, 2)); // Removes rows "A" and "abc"
+    EXPECT_EQ(2, proxy.rowCount());
+    EXPECT_EQ(QString("Abd"), proxy.data(proxy.index(0, 0)).toString());
+    EXPECT_EQ(QString("aXc"), proxy.data(proxy.index(1, 0)).toString());
+
+    // Clearing filters
+    proxy.clearColumnFilters();
+    EXPECT_EQ(model.getRowCount(), proxy.rowCount());
+}
+
 TEST(dfgQt, SpanSlider)
 {
     // Simply test that this compiles and links.